@@ -21,17 +21,27 @@ struct UserCreatedEvent {
     timestamp_t created_at;
     
     string get_event_type() const { return "UserCreated"; }
-    string serialize() const {
-        return R"({"user_id":")" + user_id + R"(","email":")" + email + 
-               R"(","name":")" + name + R"("})";
-    }
+    string serialize() const;
     
-    static optional<UserCreatedEvent> deserialize(string_view data) {
-        UserCreatedEvent event;
-        return event;
-    }
+    static optional<UserCreatedEvent> deserialize(string_view data);
+};
+
+template<>
+struct json::Fields<UserCreatedEvent> {
+    static constexpr auto value = std::make_tuple(
+        json::field("user_id", &UserCreatedEvent::user_id),
+        json::field("email", &UserCreatedEvent::email),
+        json::field("name", &UserCreatedEvent::name));
 };
 
+inline string UserCreatedEvent::serialize() const {
+    return json::serialize(*this);
+}
+
+inline optional<UserCreatedEvent> UserCreatedEvent::deserialize(string_view data) {
+    return json::parse<UserCreatedEvent>(data);
+}
+
 struct CreateUserCommand {
     string email;
     string name;
@@ -47,6 +57,13 @@ private:
     }
 };
 
+template<>
+struct json::Fields<CreateUserCommand> {
+    static constexpr auto value = std::make_tuple(
+        json::field("email", &CreateUserCommand::email),
+        json::field("name", &CreateUserCommand::name));
+};
+
 class User {
 public:
     User() = default;
@@ -291,11 +308,12 @@ private:
         
         router_->post("/users", [this](const Request& req, Response& res) -> async::Task<void> {
             try {
-                auto body = req.body_as_string();
-                auto email = extract_field(body, "email");
-                auto name = extract_field(body, "name");
+                auto command = req.body_as_json<CreateUserCommand>();
+                if (!command || !command->validate()) {
+                    throw std::invalid_argument("Expected a JSON object with email and name");
+                }
                 
-                auto user_id = co_await user_service_->create_user(email, name);
+                auto user_id = co_await user_service_->create_user(command->email, command->name);
                 
                 res.set_status_code(201);
                 res.set_json_body(R"({"id":")" + user_id + R"(","status":"created"})");
@@ -444,23 +462,6 @@ private:
             }
         }).detach();
     }
-    
-    string extract_field(string_view json, string_view field) {
-        size_t start = json.find("\"" + string(field) + "\"");
-        if (start == string::npos) return "";
-        
-        start = json.find(":", start);
-        if (start == string::npos) return "";
-        
-        start = json.find("\"", start);
-        if (start == string::npos) return "";
-        start++;
-        
-        size_t end = json.find("\"", start);
-        if (end == string::npos) return "";
-        
-        return string(json.substr(start, end - start));
-    }
 };
 
 struct CreateUserRequest {
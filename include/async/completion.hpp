@@ -0,0 +1,77 @@
+#pragma once
+
+#include "core/types.hpp"
+#include <coroutine>
+#include <exception>
+
+namespace http_framework::async {
+    // A value or exception delivered once and awaited by at most one coroutine. The
+    // first set_value or set_exception wins and resumes the waiting coroutine on the
+    // calling thread; later calls return false. Hold it in a shared_ptr when the
+    // producer may outlive the awaiting frame.
+    template<typename T>
+    class Completion {
+    public:
+        Completion() = default;
+        Completion(const Completion&) = delete;
+        Completion& operator=(const Completion&) = delete;
+        
+        template<typename... Args>
+        bool set_value(Args&&... args) {
+            return settle([&]() { value_.emplace(std::forward<Args>(args)...); });
+        }
+        
+        bool set_exception(std::exception_ptr error) {
+            return settle([&]() { error_ = std::move(error); });
+        }
+        
+        bool is_set() const noexcept { return set_.load(std::memory_order_acquire); }
+        
+        bool await_ready() const noexcept { return is_set(); }
+        
+        bool await_suspend(std::coroutine_handle<> handle) {
+            lock_guard lock(mutex_);
+            if (set_.load(std::memory_order_relaxed)) {
+                return false;
+            }
+            waiter_ = handle;
+            return true;
+        }
+        
+        T await_resume() {
+            if (error_) {
+                std::rethrow_exception(error_);
+            }
+            if constexpr (!std::is_void_v<T>) {
+                return std::move(*value_);
+            }
+        }
+        
+    private:
+        using Storage = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+        
+        mutex mutex_;
+        atomic<bool> set_{false};
+        optional<Storage> value_;
+        std::exception_ptr error_;
+        std::coroutine_handle<> waiter_;
+        
+        template<typename Store>
+        bool settle(Store&& store) {
+            std::coroutine_handle<> waiter;
+            {
+                lock_guard lock(mutex_);
+                if (set_.load(std::memory_order_relaxed)) {
+                    return false;
+                }
+                store();
+                set_.store(true, std::memory_order_release);
+                waiter = std::exchange(waiter_, {});
+            }
+            if (waiter) {
+                waiter.resume();
+            }
+            return true;
+        }
+    };
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "core/types.hpp"
+#include <coroutine>
+#include <map>
+
+namespace http_framework::async {
+    // A small set of worker threads plus one timer thread, shared by everything that
+    // needs to resume a coroutine or run a callback later without owning a thread of
+    // its own. Timers only hand their callbacks to the workers, so user code never runs
+    // on the timer thread. Work still queued when the scheduler is destroyed is
+    // dropped without running.
+    class Scheduler {
+    public:
+        struct Config {
+            size_type worker_threads{2};
+            // Threads are named "<name>-<n>" and "<name>-timer"
+            string thread_name{"sched"};
+        };
+        
+        // Orders by deadline first, so cancel is one lookup in the timer queue
+        struct TimerId {
+            timestamp_t deadline{};
+            std::uint64_t sequence{0};
+            
+            explicit operator bool() const noexcept { return sequence != 0; }
+            auto operator<=>(const TimerId&) const = default;
+        };
+        
+        class SleepAwaiter {
+        public:
+            bool await_ready() const noexcept { return deadline_ <= std::chrono::steady_clock::now(); }
+            void await_suspend(std::coroutine_handle<> handle) {
+                scheduler_.post_at(deadline_, [handle]() { handle.resume(); });
+            }
+            void await_resume() const noexcept {}
+            
+        private:
+            Scheduler& scheduler_;
+            timestamp_t deadline_;
+            
+            SleepAwaiter(Scheduler& scheduler, timestamp_t deadline) : scheduler_(scheduler), deadline_(deadline) {}
+            
+            friend class Scheduler;
+        };
+        
+        class ScheduleAwaiter {
+        public:
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) { scheduler_.resume(handle); }
+            void await_resume() const noexcept {}
+            
+        private:
+            Scheduler& scheduler_;
+            
+            explicit ScheduleAwaiter(Scheduler& scheduler) : scheduler_(scheduler) {}
+            
+            friend class Scheduler;
+        };
+        
+        Scheduler();
+        explicit Scheduler(Config config);
+        Scheduler(const Scheduler&) = delete;
+        Scheduler& operator=(const Scheduler&) = delete;
+        ~Scheduler();
+        
+        // Process-wide instance, started on first use
+        static Scheduler& shared();
+        
+        void post(function<void()> task);
+        void resume(std::coroutine_handle<> handle) {
+            post([handle]() { handle.resume(); });
+        }
+        
+        TimerId post_at(timestamp_t deadline, function<void()> task);
+        TimerId post_after(std::chrono::steady_clock::duration delay, function<void()> task) {
+            return post_at(std::chrono::steady_clock::now() + delay, std::move(task));
+        }
+        // False once the timer has fired or been cancelled
+        bool cancel(TimerId id);
+        
+        // co_await to continue on a worker, or to resume there after a delay
+        ScheduleAwaiter schedule() { return ScheduleAwaiter{*this}; }
+        SleepAwaiter sleep_until(timestamp_t deadline) { return SleepAwaiter{*this, deadline}; }
+        SleepAwaiter sleep_for(std::chrono::steady_clock::duration delay) {
+            return SleepAwaiter{*this, std::chrono::steady_clock::now() + delay};
+        }
+        
+        size_type worker_count() const noexcept { return workers_.size(); }
+        size_type pending_tasks() const;
+        size_type pending_timers() const;
+        
+    private:
+        Config config_;
+        
+        mutable mutex tasks_mutex_;
+        condition_variable tasks_condition_;
+        deque<function<void()>> tasks_;
+        
+        mutable mutex timers_mutex_;
+        condition_variable timers_condition_;
+        std::map<TimerId, function<void()>> timers_;
+        std::uint64_t next_sequence_{1};
+        
+        atomic<bool> stopping_{false};
+        vector<std::thread> workers_;
+        std::thread timer_thread_;
+        
+        void worker_loop(size_type index);
+        void timer_loop();
+    };
+}
@@ -0,0 +1,393 @@
+#pragma once
+
+#include "core/types.hpp"
+#include "async/future.hpp"
+#include "async/promise.hpp"
+#include "async/task.hpp"
+#include <bit>
+#include <coroutine>
+#include <exception>
+
+namespace http_framework::async {
+    struct SingleFlightMetrics {
+        size_type total_calls{0};
+        size_type upstream_calls{0};
+        size_type coalesced_calls{0};
+        size_type cache_hits{0};
+        size_type upstream_failures{0};
+        size_type in_flight{0};
+        size_type cached_entries{0};
+        
+        double coalescing_ratio() const noexcept {
+            return total_calls == 0 ? 0.0 : 1.0 - static_cast<double>(upstream_calls) / static_cast<double>(total_calls);
+        }
+    };
+    
+    // Collapses concurrent loads of the same key into one upstream call.
+    // The instance must outlive every call it has started.
+    template<typename Key, typename T>
+    class SingleFlight {
+        static_assert(!std::is_void_v<T>, "SingleFlight requires a value type");
+        
+        struct Call;
+        
+    public:
+        struct Config {
+            size_type shard_count{16};
+            duration_t result_ttl{duration_t::zero()};
+            size_type max_cached_entries{10000};
+            bool cache_errors{false};
+            function<bool(const T&)> cacheable;
+        };
+        
+        class Awaiter {
+        public:
+            bool await_ready() const noexcept { return call_->ready.load(std::memory_order_acquire); }
+            bool await_suspend(std::coroutine_handle<> handle);
+            T await_resume();
+            
+        private:
+            shared_ptr<Call> call_;
+            
+            explicit Awaiter(shared_ptr<Call> call) : call_(std::move(call)) {}
+            
+            friend class SingleFlight;
+        };
+        
+        SingleFlight();
+        explicit SingleFlight(Config config);
+        SingleFlight(const SingleFlight&) = delete;
+        SingleFlight& operator=(const SingleFlight&) = delete;
+        ~SingleFlight();
+        
+        // F may return T, Future<T> or Task<T>; it only runs for the leading caller
+        template<typename F>
+        Awaiter execute(const Key& key, F&& fetch);
+        
+        template<typename F>
+        Future<T> execute_future(const Key& key, F&& fetch);
+        
+        bool forget(const Key& key);
+        void clear();
+        
+        size_type in_flight() const noexcept { return in_flight_.load(std::memory_order_relaxed); }
+        const Config& config() const noexcept { return config_; }
+        
+        SingleFlightMetrics metrics() const;
+        void reset_metrics();
+        
+    private:
+        struct Call {
+            mutex state_mutex;
+            atomic<bool> ready{false};
+            optional<T> value;
+            std::exception_ptr error;
+            timestamp_t expires_at{};
+            vector<function<void()>> continuations;
+        };
+        
+        struct alignas(64) Shard {
+            mutable mutex calls_mutex;
+            hash_map<Key, shared_ptr<Call>> calls;
+        };
+        
+        Config config_;
+        size_type shard_mask_;
+        unique_ptr<Shard[]> shards_;
+        
+        atomic<size_type> in_flight_{0};
+        mutex drain_mutex_;
+        condition_variable drained_;
+        atomic<size_type> total_calls_{0};
+        atomic<size_type> upstream_calls_{0};
+        atomic<size_type> coalesced_calls_{0};
+        atomic<size_type> cache_hits_{0};
+        atomic<size_type> upstream_failures_{0};
+        
+        Shard& shard_for(const Key& key) const noexcept;
+        size_type shard_capacity() const noexcept;
+        
+        template<typename F>
+        shared_ptr<Call> join_or_start(const Key& key, F&& fetch);
+        
+        template<typename R>
+        void await_upstream(const Key& key, const shared_ptr<Call>& call, R&& upstream);
+        
+        template<typename Upstream>
+        Task<void> watch_upstream(Key key, shared_ptr<Call> call, Upstream upstream);
+        
+        void complete(const Key& key, const shared_ptr<Call>& call, optional<T> value, std::exception_ptr error);
+        static void evict_expired(Shard& shard, timestamp_t now);
+        static void deliver(Call& call, Promise<T>& promise);
+    };
+    
+    template<typename Key, typename T>
+    SingleFlight<Key, T>::SingleFlight() : SingleFlight(Config{}) {}
+    
+    template<typename Key, typename T>
+    SingleFlight<Key, T>::SingleFlight(Config config)
+        : config_(std::move(config)),
+          shard_mask_(std::bit_ceil(std::max<size_type>(config_.shard_count, 1)) - 1),
+          shards_(std::make_unique<Shard[]>(shard_mask_ + 1)) {}
+          
+    template<typename Key, typename T>
+    SingleFlight<Key, T>::~SingleFlight() {
+        unique_lock lock(drain_mutex_);
+        drained_.wait(lock, [this]() { return in_flight_.load(std::memory_order_acquire) == 0; });
+    }
+    
+    template<typename Key, typename T>
+    bool SingleFlight<Key, T>::Awaiter::await_suspend(std::coroutine_handle<> handle) {
+        lock_guard lock(call_->state_mutex);
+        if (call_->ready.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        call_->continuations.push_back([handle] { handle.resume(); });
+        return true;
+    }
+    
+    template<typename Key, typename T>
+    T SingleFlight<Key, T>::Awaiter::await_resume() {
+        if (call_->error) {
+            std::rethrow_exception(call_->error);
+        }
+        return *call_->value;
+    }
+    
+    template<typename Key, typename T>
+    template<typename F>
+    auto SingleFlight<Key, T>::execute(const Key& key, F&& fetch) -> Awaiter {
+        return Awaiter{join_or_start(key, std::forward<F>(fetch))};
+    }
+    
+    template<typename Key, typename T>
+    template<typename F>
+    Future<T> SingleFlight<Key, T>::execute_future(const Key& key, F&& fetch) {
+        auto call = join_or_start(key, std::forward<F>(fetch));
+        auto promise = std::make_shared<Promise<T>>();
+        auto future = promise->get_future();
+        
+        {
+            lock_guard lock(call->state_mutex);
+            if (!call->ready.load(std::memory_order_relaxed)) {
+                call->continuations.push_back([call, promise] { deliver(*call, *promise); });
+                return future;
+            }
+        }
+        
+        deliver(*call, *promise);
+        return future;
+    }
+    
+    template<typename Key, typename T>
+    bool SingleFlight<Key, T>::forget(const Key& key) {
+        auto& shard = shard_for(key);
+        lock_guard lock(shard.calls_mutex);
+        return shard.calls.erase(key) > 0;
+    }
+    
+    template<typename Key, typename T>
+    void SingleFlight<Key, T>::clear() {
+        for (size_type i = 0; i <= shard_mask_; ++i) {
+            lock_guard lock(shards_[i].calls_mutex);
+            shards_[i].calls.clear();
+        }
+    }
+    
+    template<typename Key, typename T>
+    SingleFlightMetrics SingleFlight<Key, T>::metrics() const {
+        SingleFlightMetrics result;
+        result.total_calls = total_calls_.load(std::memory_order_relaxed);
+        result.upstream_calls = upstream_calls_.load(std::memory_order_relaxed);
+        result.coalesced_calls = coalesced_calls_.load(std::memory_order_relaxed);
+        result.cache_hits = cache_hits_.load(std::memory_order_relaxed);
+        result.upstream_failures = upstream_failures_.load(std::memory_order_relaxed);
+        result.in_flight = in_flight_.load(std::memory_order_relaxed);
+        
+        for (size_type i = 0; i <= shard_mask_; ++i) {
+            lock_guard lock(shards_[i].calls_mutex);
+            for (const auto& [key, call] : shards_[i].calls) {
+                if (call->ready.load(std::memory_order_acquire)) {
+                    ++result.cached_entries;
+                }
+            }
+        }
+        
+        return result;
+    }
+    
+    template<typename Key, typename T>
+    void SingleFlight<Key, T>::reset_metrics() {
+        total_calls_.store(0, std::memory_order_relaxed);
+        upstream_calls_.store(0, std::memory_order_relaxed);
+        coalesced_calls_.store(0, std::memory_order_relaxed);
+        cache_hits_.store(0, std::memory_order_relaxed);
+        upstream_failures_.store(0, std::memory_order_relaxed);
+    }
+    
+    template<typename Key, typename T>
+    auto SingleFlight<Key, T>::shard_for(const Key& key) const noexcept -> Shard& {
+        auto hash = static_cast<std::uint64_t>(std::hash<Key>{}(key)) * 0x9E3779B97F4A7C15ULL;
+        return shards_[static_cast<size_type>(hash >> 32) & shard_mask_];
+    }
+    
+    template<typename Key, typename T>
+    size_type SingleFlight<Key, T>::shard_capacity() const noexcept {
+        return std::max<size_type>(config_.max_cached_entries / (shard_mask_ + 1), 1);
+    }
+    
+    template<typename Key, typename T>
+    template<typename F>
+    auto SingleFlight<Key, T>::join_or_start(const Key& key, F&& fetch) -> shared_ptr<Call> {
+        total_calls_.fetch_add(1, std::memory_order_relaxed);
+        
+        auto& shard = shard_for(key);
+        shared_ptr<Call> call;
+        
+        {
+            lock_guard lock(shard.calls_mutex);
+            auto now = std::chrono::steady_clock::now();
+            
+            auto it = shard.calls.find(key);
+            if (it != shard.calls.end()) {
+                auto existing = it->second;
+                if (!existing->ready.load(std::memory_order_acquire)) {
+                    coalesced_calls_.fetch_add(1, std::memory_order_relaxed);
+                    return existing;
+                }
+                if (now < existing->expires_at) {
+                    cache_hits_.fetch_add(1, std::memory_order_relaxed);
+                    return existing;
+                }
+                shard.calls.erase(it);
+            }
+            
+            if (config_.result_ttl > duration_t::zero() && shard.calls.size() >= shard_capacity()) {
+                evict_expired(shard, now);
+            }
+            
+            call = std::make_shared<Call>();
+            shard.calls.emplace(key, call);
+            in_flight_.fetch_add(1, std::memory_order_relaxed);
+        }
+        
+        upstream_calls_.fetch_add(1, std::memory_order_relaxed);
+        
+        try {
+            await_upstream(key, call, std::invoke(std::forward<F>(fetch)));
+        } catch (...) {
+            complete(key, call, std::nullopt, std::current_exception());
+        }
+        
+        return call;
+    }
+    
+    template<typename Key, typename T>
+    template<typename R>
+    void SingleFlight<Key, T>::await_upstream(const Key& key, const shared_ptr<Call>& call, R&& upstream) {
+        using Upstream = std::decay_t<R>;
+        
+        if constexpr (requires(Upstream& pending) { pending.is_ready(); pending.get(); }) {
+            auto settle = [this, key, call](Upstream& pending) {
+                optional<T> value;
+                std::exception_ptr error;
+                try {
+                    value.emplace(pending.get());
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                complete(key, call, std::move(value), error);
+            };
+            
+            if (upstream.is_ready()) {
+                settle(upstream);
+                return;
+            }
+            
+            watch_upstream(key, call, Upstream(std::forward<R>(upstream))).detach();
+        } else {
+            complete(key, call, optional<T>(std::in_place, std::forward<R>(upstream)), nullptr);
+        }
+    }
+    
+    template<typename Key, typename T>
+    template<typename Upstream>
+    Task<void> SingleFlight<Key, T>::watch_upstream(Key key, shared_ptr<Call> call, Upstream upstream) {
+        // Resumed by the upstream Task's completion; a Future upstream is polled by the
+        // shared scheduler since std::future offers no callback
+        optional<T> value;
+        std::exception_ptr error;
+        try {
+            value.emplace(co_await upstream);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        complete(key, call, std::move(value), error);
+    }
+    
+    template<typename Key, typename T>
+    void SingleFlight<Key, T>::complete(const Key& key, const shared_ptr<Call>& call, optional<T> value, std::exception_ptr error) {
+        auto ttl = config_.result_ttl;
+        bool cache = ttl > duration_t::zero() &&
+            (error ? config_.cache_errors : !config_.cacheable || config_.cacheable(*value));
+            
+        if (error) {
+            upstream_failures_.fetch_add(1, std::memory_order_relaxed);
+        }
+        
+        vector<function<void()>> continuations;
+        {
+            lock_guard lock(call->state_mutex);
+            call->value = std::move(value);
+            call->error = error;
+            if (cache) {
+                call->expires_at = std::chrono::steady_clock::now() + ttl;
+            }
+            call->ready.store(true, std::memory_order_release);
+            continuations.swap(call->continuations);
+        }
+        
+        {
+            auto& shard = shard_for(key);
+            lock_guard lock(shard.calls_mutex);
+            auto it = shard.calls.find(key);
+            if (it != shard.calls.end() && it->second == call && (!cache || shard.calls.size() > shard_capacity())) {
+                shard.calls.erase(it);
+            }
+        }
+        
+        // Waiters never touch the flight itself, so the destructor may proceed once this
+        // drops. The decrement happens under drain_mutex_ so the destructor cannot return
+        // between it and the notify.
+        {
+            lock_guard lock(drain_mutex_);
+            if (in_flight_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                drained_.notify_all();
+            }
+        }
+        
+        for (auto& continuation : continuations) {
+            continuation();
+        }
+    }
+    
+    template<typename Key, typename T>
+    void SingleFlight<Key, T>::evict_expired(Shard& shard, timestamp_t now) {
+        for (auto it = shard.calls.begin(); it != shard.calls.end();) {
+            if (it->second->ready.load(std::memory_order_acquire) && it->second->expires_at <= now) {
+                it = shard.calls.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    
+    template<typename Key, typename T>
+    void SingleFlight<Key, T>::deliver(Call& call, Promise<T>& promise) {
+        if (call.error) {
+            promise.set_exception(call.error);
+        } else {
+            promise.set_value(*call.value);
+        }
+    }
+}
@@ -2,100 +2,208 @@
 
 #include "core/types.hpp"
 #include "async/future.hpp"
+#include "async/promise.hpp"
+#include "async/completion.hpp"
+#include "async/scheduler.hpp"
 #include <coroutine>
 #include <exception>
 
 namespace http_framework::async {
     template<typename T = void>
-    class Task {
-    public:
-        struct promise_type {
-            Task get_return_object() {
-                return Task{std::coroutine_handle<promise_type>::from_promise(*this)};
+    class Task;
+        
+    namespace task_detail {
+        inline char completed_marker;
+        inline char detached_marker;
+
+        // A task's continuation slot holds nullptr while it runs, the address of the
+        // coroutine awaiting it, or one of these markers
+        inline void* const COMPLETED = &completed_marker;
+        inline void* const DETACHED = &detached_marker;
+
+        template<typename F, typename T>
+        struct continuation_result {
+            using type = std::invoke_result_t<F, T>;
+        };
+
+        template<typename F>
+        struct continuation_result<F, void> {
+            using type = std::invoke_result_t<F>;
+        };
+
+        // Awaitables pass through await_transform as values: rvalues are moved into the
+        // frame and lvalues wrapped by reference. GCC 12 mishandles awaiters that
+        // await_transform returns by reference, copying or dropping them early.
+        template<typename U>
+        struct AwaitableRef {
+            U& awaitable;
+
+            decltype(auto) await_ready() { return awaitable.await_ready(); }
+            decltype(auto) await_suspend(std::coroutine_handle<> handle) { return awaitable.await_suspend(handle); }
+            decltype(auto) await_resume() { return awaitable.await_resume(); }
+        };
+
+        // std::future has no completion callback, so an awaited Future is polled from
+        // shared scheduler timers, backing off to MAX_POLL_INTERVAL. Prefer Tasks for
+        // anything on a hot path.
+        template<typename U>
+        struct FutureAwaiter {
+            static constexpr std::chrono::microseconds FIRST_POLL_INTERVAL{50};
+            static constexpr std::chrono::microseconds MAX_POLL_INTERVAL{5000};
+
+            Future<U>& future;
+
+            bool await_ready() const { return future.is_ready(); }
+
+            void await_suspend(std::coroutine_handle<> handle) {
+                poll(future, handle, FIRST_POLL_INTERVAL);
+            }
+
+            static void poll(Future<U>& future, std::coroutine_handle<> handle, std::chrono::microseconds interval) {
+                Scheduler::shared().post_after(interval, [&future, handle, interval]() {
+                    if (future.is_ready()) {
+                        handle.resume();
+                    } else {
+                        poll(future, handle, std::min(interval * 2, MAX_POLL_INTERVAL));
+                    }
+                });
             }
             
+            U await_resume() { return future.get(); }
+        };
+
+        class PromiseBase {
+        public:
+            struct FinalAwaiter {
+                bool await_ready() const noexcept { return false; }
+
+                template<typename Promise>
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+                    auto& promise = handle.promise();
+                    auto* waiter = promise.continuation_.exchange(COMPLETED, std::memory_order_acq_rel);
+                    promise.continuation_.notify_all();
+
+                    if (waiter == DETACHED) {
+                        handle.destroy();
+                        return std::noop_coroutine();
+                    }
+                    if (waiter) {
+                        return std::coroutine_handle<>::from_address(waiter);
+                    }
+                    return std::noop_coroutine();
+                }
+
+                void await_resume() const noexcept {}
+            };
+
             std::suspend_never initial_suspend() noexcept { return {}; }
-            std::suspend_never final_suspend() noexcept { return {}; }
+            FinalAwaiter final_suspend() noexcept { return {}; }
             
-            void unhandled_exception() {
+            void unhandled_exception() noexcept {
                 exception_ = std::current_exception();
             }
             
             template<typename U>
-            void return_value(U&& value) requires(!std::is_void_v<T>) {
-                value_ = std::forward<U>(value);
+            U await_transform(U&& awaitable) noexcept(std::is_nothrow_move_constructible_v<U>) {
+                return std::move(awaitable);
             }
             
-            void return_void() requires(std::is_void_v<T>) {}
-            
             template<typename U>
-            auto await_transform(U&& awaitable) {
-                return std::forward<U>(awaitable);
+            AwaitableRef<U> await_transform(U& awaitable) noexcept {
+                return {awaitable};
             }
-            
-            template<typename U>
-            auto await_transform(Future<U>&& future) {
-                struct Awaiter {
-                    Future<U> future_;
-                    
-                    bool await_ready() const noexcept {
-                        return future_.is_ready();
-                    }
                     
-                    void await_suspend(std::coroutine_handle<> handle) {
-                        std::thread([future = std::move(future_), handle]() mutable {
-                            try {
-                                future.wait();
-                                handle.resume();
-                            } catch (...) {
-                                handle.resume();
-                            }
-                        }).detach();
-                    }
-                    
-                    U await_resume() {
-                        if constexpr (std::is_void_v<U>) {
-                            future_.get();
-                        } else {
-                            return future_.get();
-                        }
-                    }
-                };
-                
-                return Awaiter{std::move(future)};
-            }
-            
             template<typename U>
-            auto await_transform(Task<U>&& task) {
-                struct Awaiter {
-                    Task<U> task_;
-                    
-                    bool await_ready() const noexcept {
-                        return task_.is_ready();
-                    }
-                    
-                    void await_suspend(std::coroutine_handle<> handle) {
-                        task_.then([handle](auto&&...) mutable {
-                            handle.resume();
-                        });
-                    }
+            FutureAwaiter<U> await_transform(Future<U>& future) noexcept {
+                return {future};
+            }
                     
-                    U await_resume() {
-                        if constexpr (std::is_void_v<U>) {
-                            task_.get();
-                        } else {
-                            return task_.get();
-                        }
-                    }
-                };
+            template<typename U>
+            FutureAwaiter<U> await_transform(Future<U>&& future) noexcept {
+                return {future};
+            }
+
+            bool is_completed() const noexcept {
+                return continuation_.load(std::memory_order_acquire) == COMPLETED;
+            }
+
+            void wait() const noexcept {
+                auto current = continuation_.load(std::memory_order_acquire);
+                while (current != COMPLETED) {
+                    continuation_.wait(current, std::memory_order_acquire);
+                    current = continuation_.load(std::memory_order_acquire);
+                }
+            }
+
+            // Registers the awaiting coroutine; false if the task already finished
+            bool set_continuation(std::coroutine_handle<> continuation) noexcept {
+                void* expected = nullptr;
+                return continuation_.compare_exchange_strong(expected, continuation.address(),
+                                                             std::memory_order_acq_rel, std::memory_order_acquire);
+            }
+
+            // False if the task already finished and its frame must be destroyed by the caller
+            bool set_detached() noexcept {
+                void* expected = nullptr;
+                return continuation_.compare_exchange_strong(expected, DETACHED,
+                                                             std::memory_order_acq_rel, std::memory_order_acquire);
+            }
+
+        protected:
+            atomic<void*> continuation_{nullptr};
+            std::exception_ptr exception_;
+
+            void rethrow_if_failed() const {
+                if (exception_) {
+                    std::rethrow_exception(exception_);
+                }
+            }
+        };
                 
-                return Awaiter{std::move(task)};
+        template<typename T>
+        class TaskPromise : public PromiseBase {
+        public:
+            Task<T> get_return_object() noexcept;
+
+            template<typename U>
+            void return_value(U&& value) {
+                value_.emplace(std::forward<U>(value));
             }
             
+            T result() {
+                rethrow_if_failed();
+                if (!value_) {
+                    throw std::runtime_error("Task has no value");
+                }
+                return std::move(*value_);
+            }
+                    
+        private:
             optional<T> value_;
-            std::exception_ptr exception_;
         };
-        
+
+        template<>
+        class TaskPromise<void> : public PromiseBase {
+        public:
+            Task<void> get_return_object() noexcept;
+
+            void return_void() noexcept {}
+
+            void result() {
+                rethrow_if_failed();
+            }
+        };
+    }
+                    
+    // An eagerly started coroutine. Awaiting a Task registers the awaiting coroutine as
+    // its continuation, which then runs on whichever thread finishes the task; no
+    // thread is created for either. Destroying a Task that has not finished destroys
+    // its coroutine, so hand unfinished work to detach() instead.
+    template<typename T>
+    class Task {
+    public:
+        using value_type = T;
+        using promise_type = task_detail::TaskPromise<T>;
         using handle_type = std::coroutine_handle<promise_type>;
         
         Task() = default;
@@ -124,41 +232,30 @@ namespace http_framework::async {
         }
         
         bool is_ready() const noexcept {
-            return handle_ && handle_.done();
+            return handle_ && handle_.promise().is_completed();
         }
         
         bool is_valid() const noexcept {
             return handle_ != nullptr;
         }
         
-        void wait() {
-            if (!handle_) return;
-            
-            while (!handle_.done()) {
-                std::this_thread::yield();
+        void wait() const {
+            if (handle_) {
+                handle_.promise().wait();
             }
         }
         
         template<typename Rep, typename Period>
-        bool wait_for(const std::chrono::duration<Rep, Period>& timeout) {
-            if (!handle_) return true;
-            
-            auto start = std::chrono::steady_clock::now();
-            while (!handle_.done()) {
-                if (std::chrono::steady_clock::now() - start > timeout) {
-                    return false;
-                }
-                std::this_thread::yield();
-            }
-            return true;
+        bool wait_for(const std::chrono::duration<Rep, Period>& timeout) const {
+            return wait_until(std::chrono::steady_clock::now() + timeout);
         }
         
         template<typename Clock, typename Duration>
-        bool wait_until(const std::chrono::time_point<Clock, Duration>& abs_time) {
+        bool wait_until(const std::chrono::time_point<Clock, Duration>& abs_time) const {
             if (!handle_) return true;
             
-            while (!handle_.done()) {
-                if (std::chrono::steady_clock::now() > abs_time) {
+            while (!is_ready()) {
+                if (Clock::now() > abs_time) {
                     return false;
                 }
                 std::this_thread::yield();
@@ -167,41 +264,115 @@ namespace http_framework::async {
         }
         
         T get() {
-            wait();
-            
             if (!handle_) {
                 throw std::runtime_error("Task is not valid");
             }
             
-            auto& promise = handle_.promise();
-            
-            if (promise.exception_) {
-                std::rethrow_exception(promise.exception_);
-            }
+            wait();
+            return handle_.promise().result();
+        }
             
-            if constexpr (std::is_void_v<T>) {
+        // then, catch_exception and finally take over the task, so they can be chained
+        // on a temporary
+        template<typename F>
+        auto then(F func) -> Task<typename task_detail::continuation_result<F, T>::type> {
+            return then_impl(std::move(*this), std::move(func));
+        }
+
+        template<typename F>
+        Task<T> catch_exception(F func) {
+            return catch_impl(std::move(*this), std::move(func));
+        }
+
+        template<typename F>
+        Task<T> finally(F func) {
+            return finally_impl(std::move(*this), std::move(func));
+        }
+
+        // Moves the task into a detached coroutine that fulfils the returned future
+        Future<T> to_future() {
+            auto pair = Promise<T>::create_pair();
+            fulfill(std::move(*this), std::move(pair.first)).detach();
+            return std::move(pair.second);
+        }
+
+        // Lets the coroutine run on and free itself when it finishes
+        void detach() noexcept {
+            if (!handle_) {
                 return;
-            } else {
-                if (!promise.value_) {
-                    throw std::runtime_error("Task has no value");
-                }
-                return std::move(*promise.value_);
+            }
+            auto handle = std::exchange(handle_, {});
+            if (!handle.promise().set_detached()) {
+                handle.destroy();
             }
         }
         
+        template<typename U = T>
+        static Task<T> from_value(U value) requires(!std::is_void_v<T>) {
+            co_return std::move(value);
+        }
+
+        static Task<void> from_void() requires(std::is_void_v<T>) {
+            co_return;
+        }
+
+        static Task<T> from_exception(std::exception_ptr ex) {
+            co_await std::suspend_never{};
+            std::rethrow_exception(ex);
+        }
+
+        template<typename Exception>
+        static Task<T> from_exception(Exception&& ex) {
+            return from_exception(std::make_exception_ptr(std::forward<Exception>(ex)));
+        }
+
+        template<typename... Tasks>
+        static Task<std::tuple<typename Tasks::value_type...>> when_all(Tasks... tasks) {
+            co_return std::make_tuple((co_await tasks)...);
+        }
+
+        // Completes with the first of the tasks to finish, value or exception; the
+        // others keep running detached
+        template<typename... Tasks>
+        static Task<variant<typename Tasks::value_type...>> when_any(Tasks... tasks) {
+            using Result = variant<typename Tasks::value_type...>;
+
+            auto completion = std::make_shared<Completion<Result>>();
+            [&]<size_type... Indices>(std::index_sequence<Indices...>) {
+                (watch_any<Indices>(std::move(tasks), completion).detach(), ...);
+            }(std::index_sequence_for<Tasks...>{});
+
+            co_return co_await *completion;
+        }
+
+        bool await_ready() const noexcept {
+            return !handle_ || is_ready();
+        }
+
+        bool await_suspend(std::coroutine_handle<> continuation) noexcept {
+            return handle_.promise().set_continuation(continuation);
+        }
+
+        T await_resume() {
+            return get();
+        }
+
+    private:
+        handle_type handle_;
+
         template<typename F>
-        auto then(F&& func) -> Task<std::invoke_result_t<F, T>> {
-            using ReturnType = std::invoke_result_t<F, T>;
+        static auto then_impl(Task task, F func) -> Task<typename task_detail::continuation_result<F, T>::type> {
+            using ReturnType = typename task_detail::continuation_result<F, T>::type;
             
             if constexpr (std::is_void_v<T>) {
-                co_await *this;
+                co_await task;
                 if constexpr (std::is_void_v<ReturnType>) {
                     func();
                 } else {
                     co_return func();
                 }
             } else {
-                auto result = co_await *this;
+                auto result = co_await task;
                 if constexpr (std::is_void_v<ReturnType>) {
                     func(std::move(result));
                 } else {
@@ -211,12 +382,12 @@ namespace http_framework::async {
         }
         
         template<typename F>
-        auto catch_exception(F&& func) -> Task<T> {
+        static Task<T> catch_impl(Task task, F func) {
             try {
                 if constexpr (std::is_void_v<T>) {
-                    co_await *this;
+                    co_await task;
                 } else {
-                    co_return co_await *this;
+                    co_return co_await task;
                 }
             } catch (...) {
                 if constexpr (std::is_void_v<T>) {
@@ -228,13 +399,13 @@ namespace http_framework::async {
         }
         
         template<typename F>
-        auto finally(F&& func) -> Task<T> {
+        static Task<T> finally_impl(Task task, F func) {
             try {
                 if constexpr (std::is_void_v<T>) {
-                    co_await *this;
+                    co_await task;
                     func();
                 } else {
-                    auto result = co_await *this;
+                    auto result = co_await task;
                     func();
                     co_return result;
                 }
@@ -244,147 +415,39 @@ namespace http_framework::async {
             }
         }
         
-        Future<T> to_future() {
-            auto [promise, future] = Promise<T>::create_pair();
-            
-            std::thread([task = std::move(*this), promise = std::move(promise)]() mutable {
-                try {
-                    if constexpr (std::is_void_v<T>) {
-                        task.get();
-                        promise.set_value();
-                    } else {
-                        promise.set_value(task.get());
-                    }
-                } catch (...) {
-                    promise.set_exception(std::current_exception());
+        static Task<void> fulfill(Task task, Promise<T> promise) {
+            try {
+                if constexpr (std::is_void_v<T>) {
+                    co_await task;
+                    promise.set_value();
+                } else {
+                    promise.set_value(co_await task);
                 }
-            }).detach();
-            
-            return future;
-        }
-        
-        void detach() {
-            if (handle_) {
-                std::thread([handle = std::exchange(handle_, {})]() mutable {
-                    Task task{handle};
-                    try {
-                        task.wait();
-                    } catch (...) {
-                    }
-                }).detach();
+            } catch (...) {
+                promise.set_exception(std::current_exception());
             }
         }
         
-        static Task<T> from_value(T value) requires(!std::is_void_v<T>) {
-            co_return value;
-        }
-        
-        static Task<void> from_void() requires(std::is_void_v<T>) {
-            co_return;
-        }
-        
-        static Task<T> from_exception(std::exception_ptr ex) {
-            std::rethrow_exception(ex);
-            co_return;
-        }
-        
-        template<typename Exception>
-        static Task<T> from_exception(Exception&& ex) {
-            throw std::forward<Exception>(ex);
-            co_return;
-        }
-        
-        template<typename... Tasks>
-        static Task<std::tuple<typename Tasks::value_type...>> when_all(Tasks&&... tasks) {
-            co_return std::make_tuple((co_await tasks)...);
-        }
-        
-        template<typename... Tasks>
-        static Task<variant<typename Tasks::value_type...>> when_any(Tasks&&... tasks) {
-            return when_any_impl(std::forward<Tasks>(tasks)...);
-        }
-        
-        bool await_ready() const noexcept {
-            return is_ready();
-        }
-        
-        void await_suspend(std::coroutine_handle<> continuation) {
-            if (handle_) {
-                std::thread([handle = handle_, continuation]() mutable {
-                    Task task{handle};
-                    task.wait();
-                    continuation.resume();
-                }).detach();
-            } else {
-                continuation.resume();
+        template<size_type Index, typename Source, typename Result>
+        static Task<void> watch_any(Source task, shared_ptr<Completion<Result>> completion) {
+            try {
+                completion->set_value(std::in_place_index<Index>, co_await task);
+            } catch (...) {
+                completion->set_exception(std::current_exception());
             }
         }
-        
-        T await_resume() {
-            return get();
-        }
-        
-    private:
-        handle_type handle_;
-        
-        template<typename... Tasks>
-        static Task<variant<typename Tasks::value_type...>> when_any_impl(Tasks&&... tasks) {
-            struct AnyAwaiter {
-                std::tuple<Tasks...> tasks_;
-                atomic<bool> completed_{false};
-                variant<typename Tasks::value_type...> result_;
-                std::exception_ptr exception_;
-                
-                bool await_ready() const noexcept {
-                    return std::apply([](auto&&... t) {
-                        return (t.is_ready() || ...);
-                    }, tasks_);
-                }
-                
-                void await_suspend(std::coroutine_handle<> handle) {
-                    std::apply([&](auto&&... t) {
-                        auto process_task = [&](auto&& task, auto index) {
-                            std::thread([&task, &completed = completed_, &result = result_, 
-                                       &exception = exception_, handle, index]() mutable {
-                                try {
-                                    if constexpr (std::is_void_v<typename std::decay_t<decltype(task)>::value_type>) {
-                                        task.wait();
-                                        if (!completed.exchange(true)) {
-                                            result = index;
-                                            handle.resume();
-                                        }
-                                    } else {
-                                        auto value = task.get();
-                                        if (!completed.exchange(true)) {
-                                            result = std::move(value);
-                                            handle.resume();
-                                        }
-                                    }
-                                } catch (...) {
-                                    if (!completed.exchange(true)) {
-                                        exception = std::current_exception();
-                                        handle.resume();
-                                    }
-                                }
-                            }).detach();
-                        };
-                        
-                        size_t index = 0;
-                        (process_task(t, std::integral_constant<size_t, index++>{}), ...);
-                    }, tasks_);
-                }
-                
-                variant<typename Tasks::value_type...> await_resume() {
-                    if (exception_) {
-                        std::rethrow_exception(exception_);
-                    }
-                    return std::move(result_);
-                }
-            };
+    };
             
-            co_return co_await AnyAwaiter{std::make_tuple(std::forward<Tasks>(tasks)...)};
+    namespace task_detail {
+        template<typename T>
+        Task<T> TaskPromise<T>::get_return_object() noexcept {
+            return Task<T>{std::coroutine_handle<TaskPromise<T>>::from_promise(*this)};
         }
-    };
+
+        inline Task<void> TaskPromise<void>::get_return_object() noexcept {
+            return Task<void>{std::coroutine_handle<TaskPromise<void>>::from_promise(*this)};
+        }
+    }
     
     template<typename F>
     auto make_task(F&& func) -> Task<std::invoke_result_t<F>> {
@@ -406,6 +469,16 @@ namespace http_framework::async {
         }
     }
     
+    // Adapts a Future for code that takes Tasks; see FutureAwaiter for the cost
+    template<typename T>
+    Task<T> make_task_from_future(Future<T> future) {
+        if constexpr (std::is_void_v<T>) {
+            co_await future;
+        } else {
+            co_return co_await future;
+        }
+    }
+
     template<typename T>
     Task<T> make_ready_task(T value) requires(!std::is_void_v<T>) {
         co_return value;
@@ -417,28 +490,12 @@ namespace http_framework::async {
     
     template<typename T, typename Exception>
     Task<T> make_exceptional_task(Exception&& ex) {
-        throw std::forward<Exception>(ex);
-        co_return;
+        return Task<T>::from_exception(std::forward<Exception>(ex));
     }
     
     template<typename Rep, typename Period>
     Task<void> sleep_for(const std::chrono::duration<Rep, Period>& duration) {
-        struct SleepAwaiter {
-            std::chrono::duration<Rep, Period> duration_;
-            
-            bool await_ready() const noexcept { return duration_.count() <= 0; }
-            
-            void await_suspend(std::coroutine_handle<> handle) {
-                std::thread([duration = duration_, handle]() {
-                    std::this_thread::sleep_for(duration);
-                    handle.resume();
-                }).detach();
-            }
-            
-            void await_resume() const noexcept {}
-        };
-        
-        co_await SleepAwaiter{duration};
+        co_await Scheduler::shared().sleep_for(std::chrono::ceil<std::chrono::steady_clock::duration>(duration));
     }
     
     template<typename Clock, typename Duration>
@@ -449,4 +506,4 @@ namespace http_framework::async {
         }
         co_await sleep_for(abs_time - now);
     }
-} 
\ No newline at end of file
+} 
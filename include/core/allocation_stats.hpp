@@ -0,0 +1,93 @@
+#pragma once
+
+#include "core/types.hpp"
+#include "core/request_phases.hpp"
+
+// Set to 1 to replace the global operator new/delete with counting versions. Meant for
+// profiling builds: every allocation in the process then pays a thread-local increment.
+#ifndef HTTP_FRAMEWORK_ALLOCATION_TRACKING
+#define HTTP_FRAMEWORK_ALLOCATION_TRACKING 0
+#endif
+
+namespace http_framework::core {
+    struct AllocationCounters {
+        std::uint64_t allocations{0};
+        std::uint64_t deallocations{0};
+        std::uint64_t bytes{0};
+        
+        AllocationCounters operator-(const AllocationCounters& other) const noexcept {
+            return {allocations - other.allocations, deallocations - other.deallocations, bytes - other.bytes};
+        }
+    };
+    
+    // Running totals for the calling thread, updated by the operator new hooks in
+    // allocation_stats.cpp. Constant-initialized so the hooks never trigger TLS setup.
+    inline constinit thread_local AllocationCounters thread_allocations{};
+    
+    // Allocations made by one request, in total and per phase. Counts come from the
+    // thread-local totals, so work a request hands to another thread is not attributed
+    // to it; marks must be made on the thread that ran the phase.
+    class RequestAllocations {
+    public:
+        static constexpr bool compiled_in() noexcept { return HTTP_FRAMEWORK_ALLOCATION_TRACKING != 0; }
+        
+        void begin() noexcept {
+            if constexpr (compiled_in()) {
+                active_ = true;
+                marked_.fill(false);
+                start_ = thread_allocations;
+                last_ = start_;
+            }
+        }
+        
+        // Attributes everything since the previous mark (or begin) to this phase
+        void mark(Phase phase) noexcept {
+            if (compiled_in() && active_) {
+                auto now = thread_allocations;
+                auto index = static_cast<size_type>(phase);
+                phases_[index] = now - last_;
+                marked_[index] = true;
+                last_ = now;
+            }
+        }
+        
+        void reset() noexcept { active_ = false; }
+        
+        bool is_active() const noexcept { return compiled_in() && active_; }
+        bool is_marked(Phase phase) const noexcept { return marked_[static_cast<size_type>(phase)]; }
+        
+        AllocationCounters phase(Phase phase) const noexcept {
+            return is_marked(phase) ? phases_[static_cast<size_type>(phase)] : AllocationCounters{};
+        }
+        // Up to the latest mark
+        AllocationCounters total() const noexcept { return last_ - start_; }
+        
+        // "total=14/3120, parse=3/412, handler=9/2304": allocations/bytes for the
+        // request so far and for each marked phase
+        string to_header_value() const;
+        
+        // Calls func(phase, counters) for each marked phase, in order
+        template<typename Func>
+        void for_each(Func&& func) const;
+        
+    private:
+        AllocationCounters start_{};
+        AllocationCounters last_{};
+        array<AllocationCounters, PHASE_COUNT> phases_{};
+        array<bool, PHASE_COUNT> marked_{};
+        bool active_{false};
+    };
+    
+    template<typename Func>
+    void RequestAllocations::for_each(Func&& func) const {
+        if (!is_active()) {
+            return;
+        }
+        
+        for (size_type i = 0; i < PHASE_COUNT; ++i) {
+            if (marked_[i]) {
+                func(static_cast<Phase>(i), phases_[i]);
+            }
+        }
+    }
+}
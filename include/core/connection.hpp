@@ -1,6 +1,10 @@
 #pragma once
 
 #include "core/types.hpp"
+#include "core/request_phases.hpp"
+#include "core/allocation_stats.hpp"
+#include "core/io_buffer.hpp"
+#include "core/context.hpp"
 #include "network/socket.hpp"
 #include "http/request.hpp"
 #include "http/response.hpp"
@@ -109,6 +113,25 @@ namespace http_framework::core {
         void remove_attribute(string_view name);
         void clear_attributes();
         
+        // Typed per-connection values such as a negotiated session; like request_phases(),
+        // only touched by the thread serving the connection, so not locked
+        template<typename T, typename U = T>
+        T& set_context(const ContextKey<T>& key, U&& value) { return context_.set(key, std::forward<U>(value)); }
+        
+        template<typename T>
+        T* context(const ContextKey<T>& key) noexcept { return context_.get(key); }
+        
+        template<typename T>
+        const T* context(const ContextKey<T>& key) const noexcept { return context_.get(key); }
+        
+        template<typename T>
+        bool has_context(const ContextKey<T>& key) const noexcept { return context_.has(key); }
+        
+        template<typename T>
+        void remove_context(const ContextKey<T>& key) noexcept { context_.erase(key); }
+        
+        void clear_context() noexcept { context_.clear(); }
+        
         string to_string() const;
         hash_map<string, variant<string, int64_t, double, bool>> get_info() const;
         
@@ -121,6 +144,12 @@ namespace http_framework::core {
         
         void enable_request_tracing(bool enable = true);
         void trace_event(string_view event, const hash_map<string, string>& data = {});
+        // Begun when a request starts arriving; READ and PARSE are marked here, the rest by the server
+        RequestPhases& request_phases() noexcept { return request_phases_; }
+        const RequestPhases& request_phases() const noexcept { return request_phases_; }
+        // Begun and marked alongside request_phases(); inert unless built with HTTP_FRAMEWORK_ALLOCATION_TRACKING
+        RequestAllocations& request_allocations() noexcept { return request_allocations_; }
+        const RequestAllocations& request_allocations() const noexcept { return request_allocations_; }
         
         void reset_connection();
         void prepare_for_reuse();
@@ -147,16 +176,19 @@ namespace http_framework::core {
         duration_t read_timeout_{std::chrono::seconds(30)};
         duration_t write_timeout_{std::chrono::seconds(30)};
         
-        buffer_t read_buffer_;
-        buffer_t write_buffer_;
-        size_type read_buffer_offset_{0};
-        size_type write_buffer_offset_{0};
+        // Socket reads land in pooled blocks via prepare/commit, and request bodies are
+        // split off the read buffer; queued writes are drained with consume
+        IoBuffer read_buffer_;
+        IoBuffer write_buffer_;
+        RequestPhases request_phases_;
+        RequestAllocations request_allocations_;
         
         CompressionType compression_type_{CompressionType::NONE};
         optional<string> websocket_protocol_;
         
         variant<std::monostate, string, int64_t, double, bool> user_data_;
         hash_map<string, variant<string, int64_t, double, bool>> attributes_;
+        ContextSlots context_;
         
         bool health_monitoring_enabled_{false};
         atomic<bool> is_healthy_{true};
@@ -0,0 +1,243 @@
+#pragma once
+
+#include "core/types.hpp"
+#include <new>
+#include <stdexcept>
+#include <typeinfo>
+
+namespace http_framework::core {
+    // Hands out dense slot indices to context keys in registration order. A name is bound
+    // to the value type it was first registered with for the life of the process.
+    class ContextKeyRegistry {
+    public:
+        static constexpr size_type MAX_KEYS = 4096;
+        
+        static ContextKeyRegistry& instance();
+        
+        // Returns the existing index for name, or throws std::invalid_argument if it was
+        // registered with a different type
+        size_type intern(string_view name, const std::type_info& type);
+        optional<size_type> find(string_view name) const;
+        string_view name(size_type index) const;
+        size_type size() const;
+        
+    private:
+        ContextKeyRegistry() = default;
+        
+        mutable shared_mutex mutex_;
+        deque<string> names_;
+        vector<const std::type_info*> types_;
+        hash_map<string_view, size_type> indices_;
+    };
+    
+    // A typed handle to one context slot. Keys are meant to be namespace-scope constants,
+    // so registration happens during static initialization:
+    //
+    //     inline const core::ContextKey<AuthenticatedUser> CURRENT_USER{"auth.user"};
+    //
+    // Two keys with the same name and type share a slot.
+    template<typename T>
+    class ContextKey {
+        static_assert(std::is_object_v<T> && !std::is_const_v<T> && !std::is_array_v<T>,
+                      "Context values must be non-const object types");
+                      
+    public:
+        using value_type = T;
+        
+        explicit ContextKey(string_view name)
+            : index_(ContextKeyRegistry::instance().intern(name, typeid(T))) {}
+            
+        size_type index() const noexcept { return index_; }
+        string_view name() const { return ContextKeyRegistry::instance().name(index_); }
+        
+    private:
+        size_type index_;
+    };
+    
+    namespace context_detail {
+        inline constexpr size_type SLOT_STORAGE = 24;
+        
+        struct Slot;
+        
+        struct SlotOps {
+            void (*destroy)(Slot& slot) noexcept;
+            void (*copy)(Slot& to, const Slot& from);
+            // Leaves from empty
+            void (*move)(Slot& to, Slot& from) noexcept;
+        };
+        
+        struct Slot {
+            alignas(void*) unsigned char storage[SLOT_STORAGE];
+            const SlotOps* ops{nullptr};
+        };
+        
+        // Everything else lives on the heap and the slot holds the pointer
+        template<typename T>
+        inline constexpr bool STORED_INLINE = sizeof(T) <= SLOT_STORAGE && alignof(T) <= alignof(void*) &&
+                                              std::is_nothrow_move_constructible_v<T>;
+                                              
+        template<typename T>
+        T* value_of(Slot& slot) noexcept {
+            if constexpr (STORED_INLINE<T>) {
+                return std::launder(reinterpret_cast<T*>(slot.storage));
+            } else {
+                return *std::launder(reinterpret_cast<T**>(slot.storage));
+            }
+        }
+        
+        template<typename T>
+        const T* value_of(const Slot& slot) noexcept {
+            return value_of<T>(const_cast<Slot&>(slot));
+        }
+        
+        template<typename T>
+        void destroy_slot(Slot& slot) noexcept {
+            if constexpr (STORED_INLINE<T>) {
+                value_of<T>(slot)->~T();
+            } else {
+                delete value_of<T>(slot);
+            }
+            slot.ops = nullptr;
+        }
+        
+        template<typename T>
+        void copy_slot(Slot& to, const Slot& from);
+        
+        template<typename T>
+        void move_slot(Slot& to, Slot& from) noexcept {
+            if constexpr (STORED_INLINE<T>) {
+                ::new (static_cast<void*>(to.storage)) T(std::move(*value_of<T>(from)));
+                value_of<T>(from)->~T();
+            } else {
+                ::new (static_cast<void*>(to.storage)) T*(value_of<T>(from));
+            }
+            to.ops = from.ops;
+            from.ops = nullptr;
+        }
+        
+        template<typename T>
+        inline constexpr SlotOps OPS{&destroy_slot<T>, &copy_slot<T>, &move_slot<T>};
+        
+        template<typename T>
+        void copy_slot(Slot& to, const Slot& from) {
+            if constexpr (!std::is_copy_constructible_v<T>) {
+                throw std::logic_error("Context value is not copyable");
+            } else if constexpr (STORED_INLINE<T>) {
+                ::new (static_cast<void*>(to.storage)) T(*value_of<T>(from));
+            } else {
+                ::new (static_cast<void*>(to.storage)) T*(new T(*value_of<T>(from)));
+            }
+            to.ops = &OPS<T>;
+        }
+    }
+    
+    // Values indexed by ContextKey. The first INLINE_SLOTS keys registered map to inline
+    // slots, so lookups are an index and a null check; later keys go to an overflow
+    // array grown on first use. Small nothrow-movable values are stored in the slot,
+    // anything else is boxed. Copying throws std::logic_error if a stored value is
+    // move-only.
+    class ContextSlots {
+    public:
+        static constexpr size_type INLINE_SLOTS = 8;
+        
+        ContextSlots() = default;
+        ContextSlots(const ContextSlots& other);
+        ContextSlots(ContextSlots&& other) noexcept;
+        ContextSlots& operator=(const ContextSlots& other);
+        ContextSlots& operator=(ContextSlots&& other) noexcept;
+        ~ContextSlots() { clear(); }
+        
+        // Replaces any existing value
+        template<typename T, typename... Args>
+        T& emplace(const ContextKey<T>& key, Args&&... args);
+        
+        template<typename T, typename U = T>
+        T& set(const ContextKey<T>& key, U&& value) { return emplace(key, std::forward<U>(value)); }
+        
+        template<typename T>
+        T* get(const ContextKey<T>& key) noexcept {
+            auto* slot = find_slot(key.index());
+            return slot && slot->ops ? context_detail::value_of<T>(*slot) : nullptr;
+        }
+        
+        template<typename T>
+        const T* get(const ContextKey<T>& key) const noexcept {
+            auto* slot = find_slot(key.index());
+            return slot && slot->ops ? context_detail::value_of<T>(*slot) : nullptr;
+        }
+        
+        template<typename T>
+        bool has(const ContextKey<T>& key) const noexcept { return get(key) != nullptr; }
+        
+        template<typename T>
+        bool erase(const ContextKey<T>& key) noexcept;
+        
+        // Keeps the overflow array for reuse
+        void clear() noexcept;
+        size_type size() const noexcept { return count_; }
+        bool empty() const noexcept { return count_ == 0; }
+        
+    private:
+        using Slot = context_detail::Slot;
+        
+        array<Slot, INLINE_SLOTS> inline_;
+        unique_ptr<Slot[]> overflow_;
+        size_type overflow_capacity_{0};
+        size_type count_{0};
+        
+        Slot* find_slot(size_type index) noexcept {
+            if (index < INLINE_SLOTS) {
+                return &inline_[index];
+            }
+            index -= INLINE_SLOTS;
+            return index < overflow_capacity_ ? &overflow_[index] : nullptr;
+        }
+        
+        const Slot* find_slot(size_type index) const noexcept {
+            return const_cast<ContextSlots*>(this)->find_slot(index);
+        }
+        
+        // Like find_slot, growing the overflow array when index is past its end
+        Slot& slot_for(size_type index);
+        void take(ContextSlots& other) noexcept;
+    };
+    
+    template<typename T, typename... Args>
+    T& ContextSlots::emplace(const ContextKey<T>& key, Args&&... args) {
+        using namespace context_detail;
+        
+        auto& slot = slot_for(key.index());
+        if constexpr (STORED_INLINE<T>) {
+            if (slot.ops) {
+                // Built before the old value goes, since args may refer to it
+                T value(std::forward<Args>(args)...);
+                slot.ops->destroy(slot);
+                ::new (static_cast<void*>(slot.storage)) T(std::move(value));
+            } else {
+                ::new (static_cast<void*>(slot.storage)) T(std::forward<Args>(args)...);
+                ++count_;
+            }
+        } else {
+            auto* value = new T(std::forward<Args>(args)...);
+            if (slot.ops) {
+                slot.ops->destroy(slot);
+            } else {
+                ++count_;
+            }
+            ::new (static_cast<void*>(slot.storage)) T*(value);
+        }
+        slot.ops = &OPS<T>;
+        return *value_of<T>(slot);
+    }
+    
+    template<typename T>
+    bool ContextSlots::erase(const ContextKey<T>& key) noexcept {
+        auto* slot = find_slot(key.index());
+        if (!slot || !slot->ops) {
+            return false;
+        }
+        slot->ops->destroy(*slot);
+        --count_;
+        return true;
+    }
+}
@@ -0,0 +1,770 @@
+#pragma once
+
+// Included by core/types.hpp ahead of its aliases, so only standard types are used here
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define HTTP_FRAMEWORK_FLAT_HASH_SSE2 1
+#else
+#define HTTP_FRAMEWORK_FLAT_HASH_SSE2 0
+#endif
+
+namespace http_framework::core {
+    // std::hash, made transparent for string keys so lookups by string_view or a literal
+    // hash the characters in place instead of building a temporary std::string
+    template<typename K>
+    struct FlatHash {
+        std::size_t operator()(const K& key) const noexcept(noexcept(std::hash<K>{}(key))) {
+            return std::hash<K>{}(key);
+        }
+    };
+    
+    template<>
+    struct FlatHash<std::string> {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view key) const noexcept { return std::hash<std::string_view>{}(key); }
+    };
+    
+    template<>
+    struct FlatHash<std::string_view> : FlatHash<std::string> {};
+    
+    namespace flat_hash_detail {
+        // Control bytes: 0..127 is a full slot holding the low seven hash bits; the
+        // negative values are chosen so "empty or deleted" is a signed compare with SENTINEL
+        using ctrl_t = std::int8_t;
+        inline constexpr ctrl_t EMPTY = -128;
+        inline constexpr ctrl_t DELETED = -2;
+        inline constexpr ctrl_t SENTINEL = -1;
+        
+        inline constexpr std::size_t GROUP_WIDTH = 16;
+        
+        // Capacity zero points here so begin() == end() without an allocation
+        alignas(16) inline constexpr ctrl_t EMPTY_GROUP[GROUP_WIDTH] = {
+            SENTINEL, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY,
+            EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY
+        };
+        
+        // Sixteen control bytes compared at once; each result bit is one slot
+        struct Group {
+#if HTTP_FRAMEWORK_FLAT_HASH_SSE2
+            explicit Group(const ctrl_t* ctrl) noexcept
+                : bytes(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl))) {}
+                
+            std::uint32_t match(ctrl_t h2) const noexcept {
+                return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), bytes)));
+            }
+            
+            std::uint32_t match_empty() const noexcept { return match(EMPTY); }
+            
+            std::uint32_t match_empty_or_deleted() const noexcept {
+                return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(SENTINEL), bytes)));
+            }
+            
+            __m128i bytes;
+#else
+            explicit Group(const ctrl_t* ctrl) noexcept { std::memcpy(bytes, ctrl, GROUP_WIDTH); }
+            
+            std::uint32_t match(ctrl_t h2) const noexcept {
+                std::uint32_t mask = 0;
+                for (std::size_t i = 0; i < GROUP_WIDTH; ++i) {
+                    mask |= static_cast<std::uint32_t>(bytes[i] == h2) << i;
+                }
+                return mask;
+            }
+            
+            std::uint32_t match_empty() const noexcept { return match(EMPTY); }
+            
+            std::uint32_t match_empty_or_deleted() const noexcept {
+                std::uint32_t mask = 0;
+                for (std::size_t i = 0; i < GROUP_WIDTH; ++i) {
+                    mask |= static_cast<std::uint32_t>(bytes[i] < SENTINEL) << i;
+                }
+                return mask;
+            }
+            
+            ctrl_t bytes[GROUP_WIDTH];
+#endif
+        };
+        
+        // Spreads weak hashes (std::hash of an integer is the identity) over all bits,
+        // since the low seven select the control byte and the rest the probe start
+        inline std::size_t mix(std::size_t hash) noexcept {
+            auto mixed = static_cast<std::uint64_t>(hash);
+            mixed ^= mixed >> 33;
+            mixed *= 0xFF51AFD7ED558CCDull;
+            mixed ^= mixed >> 33;
+            return static_cast<std::size_t>(mixed);
+        }
+        
+        inline ctrl_t h2(std::size_t hash) noexcept { return static_cast<ctrl_t>(hash & 0x7F); }
+        inline std::size_t h1(std::size_t hash) noexcept { return hash >> 7; }
+        
+        // Capacities are 2^k - 1 so the probe mask is the capacity itself and the clone of
+        // the first group lands right after the sentinel
+        inline std::size_t max_load(std::size_t capacity) noexcept {
+            return capacity < GROUP_WIDTH ? capacity : capacity - capacity / 8;
+        }
+        
+        inline std::size_t capacity_for(std::size_t size) noexcept {
+            std::size_t capacity = 1;
+            while (max_load(capacity) < size) {
+                capacity = capacity * 2 + 1;
+            }
+            return capacity;
+        }
+        
+        template<typename Hash>
+        concept transparent = requires { typename Hash::is_transparent; };
+        
+        // Open-addressing table shared by flat_hash_map and flat_hash_set. Slots live in
+        // one array after the control bytes. Tables smaller than a group are probed as a
+        // single group from slot 0; larger ones start at the hash and probe quadratically
+        // by group. Element addresses change on rehash, unlike std::unordered_map.
+        template<typename Key, typename Slot, typename Exposed, typename Hash, typename KeyEqual>
+        class RawTable {
+        public:
+            using key_type = Key;
+            using value_type = std::remove_const_t<Exposed>;
+            using size_type = std::size_t;
+            using difference_type = std::ptrdiff_t;
+            using hasher = Hash;
+            using key_equal = KeyEqual;
+            using reference = value_type&;
+            using const_reference = const value_type&;
+            
+            template<bool Const>
+            class Iterator {
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = std::remove_const_t<Exposed>;
+                using difference_type = std::ptrdiff_t;
+                using reference = std::conditional_t<Const, const Exposed&, Exposed&>;
+                using pointer = std::conditional_t<Const, const Exposed*, Exposed*>;
+                
+                Iterator() = default;
+                template<bool OtherConst, typename = std::enable_if_t<Const && !OtherConst>>
+                Iterator(const Iterator<OtherConst>& other) noexcept : ctrl_(other.ctrl_), slot_(other.slot_) {}
+                
+                reference operator*() const noexcept { return *operator->(); }
+                pointer operator->() const noexcept { return std::launder(reinterpret_cast<pointer>(slot_)); }
+                
+                Iterator& operator++() noexcept {
+                    ++ctrl_;
+                    ++slot_;
+                    skip_empty();
+                    return *this;
+                }
+                
+                Iterator operator++(int) noexcept {
+                    auto copy = *this;
+                    ++*this;
+                    return copy;
+                }
+                
+                friend bool operator==(const Iterator& a, const Iterator& b) noexcept { return a.ctrl_ == b.ctrl_; }
+                
+            private:
+                const ctrl_t* ctrl_{nullptr};
+                Slot* slot_{nullptr};
+                
+                Iterator(const ctrl_t* ctrl, Slot* slot) noexcept : ctrl_(ctrl), slot_(slot) {}
+                
+                // The sentinel after the last slot stops the scan
+                void skip_empty() noexcept {
+                    while (*ctrl_ < SENTINEL) {
+                        ++ctrl_;
+                        ++slot_;
+                    }
+                }
+                
+                friend class RawTable;
+                template<bool>
+                friend class Iterator;
+            };
+            
+            using iterator = Iterator<false>;
+            using const_iterator = Iterator<true>;
+            
+            RawTable() = default;
+            
+            RawTable(std::initializer_list<Slot> values) {
+                reserve(values.size());
+                for (const auto& value : values) {
+                    insert_slot(value);
+                }
+            }
+            
+            template<typename InputIt>
+            RawTable(InputIt first, InputIt last) {
+                insert(first, last);
+            }
+            
+            RawTable(const RawTable& other) : hash_(other.hash_), equal_(other.equal_) {
+                if (other.size_ == 0) {
+                    return;
+                }
+                allocate(other.capacity_);
+                std::memcpy(ctrl_, other.ctrl_, capacity_ + GROUP_WIDTH);
+                size_type constructed = 0;
+                try {
+                    for (; constructed < capacity_; ++constructed) {
+                        if (ctrl_[constructed] >= 0) {
+                            ::new (static_cast<void*>(slots_ + constructed)) Slot(other.slots_[constructed]);
+                        }
+                    }
+                } catch (...) {
+                    for (size_type i = 0; i < constructed; ++i) {
+                        if (ctrl_[i] >= 0) {
+                            slots_[i].~Slot();
+                        }
+                    }
+                    deallocate();
+                    throw;
+                }
+                size_ = other.size_;
+                growth_left_ = other.growth_left_;
+            }
+            
+            RawTable(RawTable&& other) noexcept
+                : ctrl_(std::exchange(other.ctrl_, const_cast<ctrl_t*>(EMPTY_GROUP))),
+                  slots_(std::exchange(other.slots_, nullptr)),
+                  capacity_(std::exchange(other.capacity_, 0)),
+                  size_(std::exchange(other.size_, 0)),
+                  growth_left_(std::exchange(other.growth_left_, 0)),
+                  hash_(other.hash_), equal_(other.equal_) {}
+                  
+            RawTable& operator=(const RawTable& other) {
+                if (this != &other) {
+                    RawTable copy(other);
+                    swap(copy);
+                }
+                return *this;
+            }
+            
+            RawTable& operator=(RawTable&& other) noexcept {
+                if (this != &other) {
+                    destroy();
+                    ctrl_ = std::exchange(other.ctrl_, const_cast<ctrl_t*>(EMPTY_GROUP));
+                    slots_ = std::exchange(other.slots_, nullptr);
+                    capacity_ = std::exchange(other.capacity_, 0);
+                    size_ = std::exchange(other.size_, 0);
+                    growth_left_ = std::exchange(other.growth_left_, 0);
+                }
+                return *this;
+            }
+            
+            RawTable& operator=(std::initializer_list<Slot> values) {
+                clear();
+                reserve(values.size());
+                for (const auto& value : values) {
+                    insert_slot(value);
+                }
+                return *this;
+            }
+            
+            ~RawTable() { destroy(); }
+            
+            iterator begin() noexcept {
+                iterator it(ctrl_, slots_);
+                it.skip_empty();
+                return it;
+            }
+            const_iterator begin() const noexcept { return const_cast<RawTable*>(this)->begin(); }
+            const_iterator cbegin() const noexcept { return begin(); }
+            iterator end() noexcept { return iterator(ctrl_ + capacity_, slots_ + capacity_); }
+            const_iterator end() const noexcept { return const_cast<RawTable*>(this)->end(); }
+            const_iterator cend() const noexcept { return end(); }
+            
+            bool empty() const noexcept { return size_ == 0; }
+            size_type size() const noexcept { return size_; }
+            size_type capacity() const noexcept { return capacity_; }
+            size_type max_size() const noexcept { return std::numeric_limits<difference_type>::max() / sizeof(Slot); }
+            hasher hash_function() const { return hash_; }
+            key_equal key_eq() const { return equal_; }
+            
+            void clear() noexcept {
+                if (capacity_ == 0) {
+                    return;
+                }
+                destroy_slots();
+                reset_ctrl();
+                size_ = 0;
+                growth_left_ = max_load(capacity_);
+            }
+            
+            void reserve(size_type count) {
+                if (count > size_ + growth_left_) {
+                    rehash_to(capacity_for(count));
+                }
+            }
+            
+            void rehash(size_type count) {
+                rehash_to(capacity_for(std::max(count, size_)));
+            }
+            
+            // Lookups accept any type the hash and equality accept, e.g. string_view for
+            // std::string keys, without converting it to the key type
+            template<typename Q>
+            iterator find(const Q& key) {
+                auto index = find_index(key);
+                return index == capacity_ ? end() : iterator_at(index);
+            }
+            
+            template<typename Q>
+            const_iterator find(const Q& key) const {
+                return const_cast<RawTable*>(this)->find(key);
+            }
+            
+            template<typename Q>
+            bool contains(const Q& key) const { return find_index(key) != capacity_; }
+            
+            template<typename Q>
+            size_type count(const Q& key) const { return contains(key) ? 1 : 0; }
+            
+            template<typename Q>
+            size_type erase(const Q& key) {
+                auto index = find_index(key);
+                if (index == capacity_) {
+                    return 0;
+                }
+                erase_at(index);
+                return 1;
+            }
+            
+            iterator erase(const_iterator position) {
+                auto index = static_cast<size_type>(position.ctrl_ - ctrl_);
+                iterator next(position.ctrl_, position.slot_);
+                ++next;
+                erase_at(index);
+                return next;
+            }
+            
+            iterator erase(iterator position) { return erase(const_iterator(position)); }
+            
+            iterator erase(const_iterator first, const_iterator last) {
+                while (first != last) {
+                    first = erase(first);
+                }
+                return iterator(last.ctrl_, last.slot_);
+            }
+            
+            template<typename InputIt>
+            void insert(InputIt first, InputIt last) {
+                if constexpr (std::is_base_of_v<std::forward_iterator_tag,
+                                                typename std::iterator_traits<InputIt>::iterator_category>) {
+                    reserve(size_ + static_cast<size_type>(std::distance(first, last)));
+                }
+                for (; first != last; ++first) {
+                    insert_slot(*first);
+                }
+            }
+            
+            void swap(RawTable& other) noexcept {
+                std::swap(ctrl_, other.ctrl_);
+                std::swap(slots_, other.slots_);
+                std::swap(capacity_, other.capacity_);
+                std::swap(size_, other.size_);
+                std::swap(growth_left_, other.growth_left_);
+                std::swap(hash_, other.hash_);
+                std::swap(equal_, other.equal_);
+            }
+            
+            friend void swap(RawTable& a, RawTable& b) noexcept { a.swap(b); }
+            
+        protected:
+            ctrl_t* ctrl_{const_cast<ctrl_t*>(EMPTY_GROUP)};
+            Slot* slots_{nullptr};
+            size_type capacity_{0};
+            size_type size_{0};
+            size_type growth_left_{0};
+            [[no_unique_address]] Hash hash_{};
+            [[no_unique_address]] KeyEqual equal_{};
+            
+            // Slots, and whatever insert was given to build one, expose their key here
+            template<typename S>
+            static decltype(auto) key_of(const S& slot) noexcept {
+                if constexpr (std::is_same_v<Slot, Key>) {
+                    return (slot);
+                } else {
+                    return (slot.first);
+                }
+            }
+            
+            template<typename Q>
+            std::size_t hash_key(const Q& key) const {
+                if constexpr (transparent<Hash> || std::is_same_v<Q, Key>) {
+                    return mix(hash_(key));
+                } else {
+                    return mix(hash_(Key(key)));
+                }
+            }
+            
+            iterator iterator_at(size_type index) noexcept { return iterator(ctrl_ + index, slots_ + index); }
+            size_type index_of(const_iterator it) const noexcept { return static_cast<size_type>(it.ctrl_ - ctrl_); }
+            
+            struct PreparedInsert {
+                size_type index;
+                std::size_t hash;
+                bool inserted;
+            };
+            
+            size_type probe_start(std::size_t hash) const noexcept {
+                return capacity_ < GROUP_WIDTH ? 0 : h1(hash) & capacity_;
+            }
+            
+            size_type group_count() const noexcept {
+                return capacity_ < GROUP_WIDTH ? 1 : (capacity_ + 1) / GROUP_WIDTH;
+            }
+            
+            template<typename Q>
+            size_type find_index(const Q& key, std::size_t hash) const {
+                if (size_ == 0) {
+                    return capacity_;
+                }
+                auto tag = h2(hash);
+                auto offset = probe_start(hash);
+                for (size_type step = 0, groups = group_count(); step < groups; ++step) {
+                    Group group(ctrl_ + offset);
+                    for (auto mask = group.match(tag); mask != 0; mask &= mask - 1) {
+                        auto index = (offset + static_cast<size_type>(std::countr_zero(mask))) & capacity_;
+                        if (equal_(key_of(slots_[index]), key)) {
+                            return index;
+                        }
+                    }
+                    if (group.match_empty() != 0) {
+                        break;
+                    }
+                    offset = (offset + GROUP_WIDTH * (step + 1)) & capacity_;
+                }
+                return capacity_;
+            }
+            
+            template<typename Q>
+            size_type find_index(const Q& key) const { return find_index(key, hash_key(key)); }
+            
+            size_type find_first_non_full(std::size_t hash) const noexcept {
+                auto offset = probe_start(hash);
+                for (size_type step = 0;; ++step) {
+                    auto mask = Group(ctrl_ + offset).match_empty_or_deleted();
+                    if (mask != 0) {
+                        return (offset + static_cast<size_type>(std::countr_zero(mask))) & capacity_;
+                    }
+                    offset = (offset + GROUP_WIDTH * (step + 1)) & capacity_;
+                }
+            }
+            
+            // Writes the byte and, for the first group, its clone after the sentinel
+            void set_ctrl(size_type index, ctrl_t value) noexcept {
+                ctrl_[index] = value;
+                if (capacity_ >= GROUP_WIDTH && index < GROUP_WIDTH - 1) {
+                    ctrl_[capacity_ + 1 + index] = value;
+                }
+            }
+            
+            // Finds the key, or a free slot for it (growing first if needed) with inserted
+            // set; the caller constructs the slot there and then calls commit_insert
+            template<typename Q>
+            PreparedInsert find_or_prepare_insert(const Q& key) {
+                auto hash = hash_key(key);
+                auto index = find_index(key, hash);
+                if (index != capacity_) {
+                    return {index, hash, false};
+                }
+                if (growth_left_ == 0) {
+                    rehash_to(capacity_for(std::max(size_ + 1, size_ * 2)));
+                }
+                return {find_first_non_full(hash), hash, true};
+            }
+            
+            void commit_insert(const PreparedInsert& prepared) noexcept {
+                if (ctrl_[prepared.index] == EMPTY) {
+                    --growth_left_;
+                }
+                set_ctrl(prepared.index, h2(prepared.hash));
+                ++size_;
+            }
+            
+            template<typename... Args>
+            std::pair<iterator, bool> emplace_slot(Args&&... args) {
+                Slot slot(std::forward<Args>(args)...);
+                return insert_slot(std::move(slot));
+            }
+            
+            template<typename S>
+            std::pair<iterator, bool> insert_slot(S&& slot) {
+                auto prepared = find_or_prepare_insert(key_of(slot));
+                if (prepared.inserted) {
+                    ::new (static_cast<void*>(slots_ + prepared.index)) Slot(std::forward<S>(slot));
+                    commit_insert(prepared);
+                }
+                return {iterator_at(prepared.index), prepared.inserted};
+            }
+            
+            void erase_at(size_type index) noexcept {
+                slots_[index].~Slot();
+                --size_;
+                // An empty byte may only replace a full one if no probe can have passed
+                // over it, i.e. the empties around it leave no full window of GROUP_WIDTH
+                bool never_full = capacity_ < GROUP_WIDTH;
+                if (!never_full) {
+                    auto before = Group(ctrl_ + ((index - GROUP_WIDTH) & capacity_)).match_empty();
+                    auto after = Group(ctrl_ + index).match_empty();
+                    never_full = before != 0 && after != 0 &&
+                                 static_cast<size_type>(std::countl_zero(static_cast<std::uint16_t>(before)) +
+                                                        std::countr_zero(after)) < GROUP_WIDTH;
+                }
+                if (never_full) {
+                    set_ctrl(index, EMPTY);
+                    ++growth_left_;
+                } else {
+                    set_ctrl(index, DELETED);
+                }
+            }
+            
+            void allocate(size_type capacity) {
+                auto slot_offset = slots_offset(capacity);
+                auto* memory = static_cast<unsigned char*>(
+                    ::operator new(slot_offset + capacity * sizeof(Slot), std::align_val_t{alignment()}));
+                ctrl_ = reinterpret_cast<ctrl_t*>(memory);
+                slots_ = reinterpret_cast<Slot*>(memory + slot_offset);
+                capacity_ = capacity;
+            }
+            
+            void deallocate() noexcept {
+                if (capacity_ != 0) {
+                    ::operator delete(static_cast<void*>(ctrl_), std::align_val_t{alignment()});
+                }
+                ctrl_ = const_cast<ctrl_t*>(EMPTY_GROUP);
+                slots_ = nullptr;
+                capacity_ = 0;
+            }
+            
+            void reset_ctrl() noexcept {
+                std::memset(ctrl_, static_cast<unsigned char>(EMPTY), capacity_ + GROUP_WIDTH);
+                ctrl_[capacity_] = SENTINEL;
+                if (capacity_ < GROUP_WIDTH) {
+                    // Small tables probe one group from slot 0; the bytes past the end
+                    // must never match as empty
+                    std::memset(ctrl_ + capacity_, static_cast<unsigned char>(SENTINEL), GROUP_WIDTH);
+                }
+            }
+            
+            void destroy_slots() noexcept {
+                if constexpr (!std::is_trivially_destructible_v<Slot>) {
+                    for (size_type i = 0; i < capacity_; ++i) {
+                        if (ctrl_[i] >= 0) {
+                            slots_[i].~Slot();
+                        }
+                    }
+                }
+            }
+            
+            void destroy() noexcept {
+                destroy_slots();
+                deallocate();
+                size_ = 0;
+                growth_left_ = 0;
+            }
+            
+            void rehash_to(size_type capacity) {
+                auto* old_ctrl = ctrl_;
+                auto* old_slots = slots_;
+                auto old_capacity = capacity_;
+                
+                allocate(capacity);
+                reset_ctrl();
+                growth_left_ = max_load(capacity_) - size_;
+                for (size_type i = 0; i < old_capacity; ++i) {
+                    if (old_ctrl[i] >= 0) {
+                        auto hash = hash_key(key_of(old_slots[i]));
+                        auto index = find_first_non_full(hash);
+                        ::new (static_cast<void*>(slots_ + index)) Slot(std::move(old_slots[i]));
+                        old_slots[i].~Slot();
+                        set_ctrl(index, h2(hash));
+                    }
+                }
+                if (old_capacity != 0) {
+                    ::operator delete(static_cast<void*>(old_ctrl), std::align_val_t{alignment()});
+                }
+            }
+            
+            static constexpr std::size_t alignment() noexcept { return std::max(alignof(Slot), std::size_t{16}); }
+            
+            static constexpr std::size_t slots_offset(size_type capacity) noexcept {
+                auto bytes = capacity + GROUP_WIDTH;
+                return (bytes + alignof(Slot) - 1) / alignof(Slot) * alignof(Slot);
+            }
+        };
+    }
+    
+    // Swiss-table style open-addressing map: one allocation of control bytes and slots,
+    // probed sixteen control bytes at a time with SSE2 where available. Lookups, erase
+    // and try_emplace take any key type the hasher accepts, so FlatHash<std::string>
+    // keys are found by string_view without allocating. Unlike std::unordered_map,
+    // inserting may move elements, so references and iterators do not survive it.
+    template<typename K, typename V, typename Hash = FlatHash<K>, typename KeyEqual = std::equal_to<>>
+    class flat_hash_map : public flat_hash_detail::RawTable<K, std::pair<K, V>, std::pair<const K, V>, Hash, KeyEqual> {
+        using Base = flat_hash_detail::RawTable<K, std::pair<K, V>, std::pair<const K, V>, Hash, KeyEqual>;
+        
+    public:
+        using mapped_type = V;
+        using typename Base::value_type;
+        using typename Base::iterator;
+        using typename Base::const_iterator;
+        using typename Base::size_type;
+        
+        flat_hash_map() = default;
+        flat_hash_map(std::initializer_list<std::pair<K, V>> values) : Base(values) {}
+        template<typename InputIt>
+        flat_hash_map(InputIt first, InputIt last) : Base(first, last) {}
+        
+        flat_hash_map& operator=(std::initializer_list<std::pair<K, V>> values) {
+            Base::operator=(values);
+            return *this;
+        }
+        
+        template<typename Q, typename... Args>
+        std::pair<iterator, bool> try_emplace(Q&& key, Args&&... args) {
+            auto prepared = this->find_or_prepare_insert(key);
+            if (prepared.inserted) {
+                ::new (static_cast<void*>(this->slots_ + prepared.index))
+                    std::pair<K, V>(std::piecewise_construct, std::forward_as_tuple(std::forward<Q>(key)),
+                                    std::forward_as_tuple(std::forward<Args>(args)...));
+                this->commit_insert(prepared);
+            }
+            return {this->iterator_at(prepared.index), prepared.inserted};
+        }
+        
+        template<typename... Args>
+        std::pair<iterator, bool> emplace(Args&&... args) {
+            return this->emplace_slot(std::forward<Args>(args)...);
+        }
+        
+        std::pair<iterator, bool> insert(const value_type& value) { return try_emplace(value.first, value.second); }
+        std::pair<iterator, bool> insert(value_type&& value) { return try_emplace(value.first, std::move(value.second)); }
+        template<typename P, typename = std::enable_if_t<std::is_constructible_v<std::pair<K, V>, P&&>>>
+        std::pair<iterator, bool> insert(P&& value) { return emplace(std::forward<P>(value)); }
+        void insert(std::initializer_list<std::pair<K, V>> values) { Base::insert(values.begin(), values.end()); }
+        template<typename InputIt>
+        void insert(InputIt first, InputIt last) { Base::insert(first, last); }
+        
+        template<typename Q, typename M>
+        std::pair<iterator, bool> insert_or_assign(Q&& key, M&& value) {
+            auto result = try_emplace(std::forward<Q>(key), std::forward<M>(value));
+            if (!result.second) {
+                result.first->second = std::forward<M>(value);
+            }
+            return result;
+        }
+        
+        template<typename Q>
+        V& operator[](Q&& key) { return try_emplace(std::forward<Q>(key)).first->second; }
+        
+        template<typename Q>
+        V& at(const Q& key) {
+            auto it = this->find(key);
+            if (it == this->end()) {
+                throw std::out_of_range("flat_hash_map::at");
+            }
+            return it->second;
+        }
+        
+        template<typename Q>
+        const V& at(const Q& key) const { return const_cast<flat_hash_map*>(this)->at(key); }
+        
+        // Moves over the entries whose keys are not already present, like std::unordered_map::merge
+        void merge(flat_hash_map& source) {
+            for (auto it = source.begin(); it != source.end();) {
+                if (this->contains(it->first)) {
+                    ++it;
+                    continue;
+                }
+                this->insert_slot(std::move(source.slots_[source.index_of(it)]));
+                it = source.erase(it);
+            }
+        }
+        
+        void merge(flat_hash_map&& source) { merge(source); }
+        
+        friend bool operator==(const flat_hash_map& a, const flat_hash_map& b) {
+            if (a.size() != b.size()) {
+                return false;
+            }
+            for (const auto& [key, value] : a) {
+                auto it = b.find(key);
+                if (it == b.end() || !(it->second == value)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+    
+    template<typename K, typename Hash = FlatHash<K>, typename KeyEqual = std::equal_to<>>
+    class flat_hash_set : public flat_hash_detail::RawTable<K, K, const K, Hash, KeyEqual> {
+        using Base = flat_hash_detail::RawTable<K, K, const K, Hash, KeyEqual>;
+        
+    public:
+        using typename Base::iterator;
+        using typename Base::const_iterator;
+        
+        flat_hash_set() = default;
+        flat_hash_set(std::initializer_list<K> values) : Base(values) {}
+        template<typename InputIt>
+        flat_hash_set(InputIt first, InputIt last) : Base(first, last) {}
+        
+        flat_hash_set& operator=(std::initializer_list<K> values) {
+            Base::operator=(values);
+            return *this;
+        }
+        
+        template<typename Q>
+        std::pair<iterator, bool> insert(Q&& key) {
+            auto prepared = this->find_or_prepare_insert(key);
+            if (prepared.inserted) {
+                ::new (static_cast<void*>(this->slots_ + prepared.index)) K(std::forward<Q>(key));
+                this->commit_insert(prepared);
+            }
+            return {this->iterator_at(prepared.index), prepared.inserted};
+        }
+        
+        void insert(std::initializer_list<K> values) { Base::insert(values.begin(), values.end()); }
+        template<typename InputIt>
+        void insert(InputIt first, InputIt last) { Base::insert(first, last); }
+        
+        template<typename... Args>
+        std::pair<iterator, bool> emplace(Args&&... args) {
+            return this->emplace_slot(std::forward<Args>(args)...);
+        }
+        
+        friend bool operator==(const flat_hash_set& a, const flat_hash_set& b) {
+            if (a.size() != b.size()) {
+                return false;
+            }
+            for (const auto& key : a) {
+                if (!b.contains(key)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "core/types.hpp"
+#include "core/request_phases.hpp"
+
+namespace http_framework::core {
+    // Summary of one finished request. Fixed-size and trivially copyable, so rings can
+    // copy it word by word; the route is truncated to ROUTE_CAPACITY bytes.
+    struct FlightRecord {
+        static constexpr size_type ROUTE_CAPACITY = 52;
+        
+        std::uint64_t finished_at_ns{0};  // system_clock, nanoseconds since the epoch
+        std::uint64_t connection_id{0};
+        std::uint64_t total_ns{0};
+        std::uint64_t queue_wait_ns{0};
+        std::uint64_t bytes_in{0};
+        std::uint64_t bytes_out{0};
+        array<std::uint64_t, PHASE_COUNT> phase_ns{};
+        status_code_t status{0};
+        std::uint8_t method{0};
+        std::uint8_t route_length{0};
+        array<char, ROUTE_CAPACITY> route{};
+        
+        void set_route(string_view value) noexcept;
+        string_view route_view() const noexcept { return {route.data(), route_length}; }
+        void set_phases(const RequestPhases& phases) noexcept;
+    };
+    
+    static_assert(std::is_trivially_copyable_v<FlightRecord> && sizeof(FlightRecord) % sizeof(std::uint64_t) == 0);
+    
+    // A request that crossed the slow threshold, kept with its full target
+    struct SlowRequestRecord {
+        FlightRecord summary;
+        string uri;
+        string request_id;
+    };
+    
+    // Keeps the most recent requests of every recording thread in a per-thread seqlock
+    // ring: the owner thread writes without locks or fences beyond two sequence stores,
+    // and readers retry past slots that were being rewritten. Requests at or above
+    // slow_threshold are also copied, with their full URI, into a bounded store that
+    // survives ring wrap-around. Dumps are JSON or a compact binary stream.
+    //
+    // Binary layout: "HFFR", then little-endian u32 version, record size, summary count
+    // and slow count; the summaries as raw FlightRecords in host byte order; then per
+    // slow request its FlightRecord, u32 uri length, uri, u32 request id length, id.
+    class FlightRecorder {
+    public:
+        static constexpr std::uint32_t BINARY_VERSION = 1;
+        
+        struct Config {
+            // Per recording thread, rounded up to a power of two
+            size_type records_per_thread{1024};
+            duration_t slow_threshold{std::chrono::milliseconds(250)};
+            size_type slow_capacity{256};
+            // Where install_signal_handler writes its dumps
+            string dump_directory{"."};
+        };
+        
+        FlightRecorder();
+        explicit FlightRecorder(Config config);
+        FlightRecorder(const FlightRecorder&) = delete;
+        FlightRecorder& operator=(const FlightRecorder&) = delete;
+        ~FlightRecorder();
+        
+        void record(const FlightRecord& record, string_view uri = {}, string_view request_id = {});
+        // Lets callers skip building the full-record fields for requests that will not be kept
+        bool is_slow(std::uint64_t total_ns) const noexcept { return total_ns >= slow_threshold_ns_; }
+        
+        // Consistent copies of every ring's records, oldest first
+        vector<FlightRecord> snapshot() const;
+        vector<SlowRequestRecord> slow_requests() const;
+        
+        void dump_json(string& out) const;
+        void dump_binary(buffer_t& out) const;
+        
+        // On SIGUSR2, writes flight-recorder-<pid>-<unix ms>.json into dump_directory from a
+        // helper thread. Only one recorder owns the signal at a time.
+        bool install_signal_handler();
+        void remove_signal_handler();
+        
+        const Config& config() const noexcept { return config_; }
+        
+    private:
+        static constexpr size_type RECORD_WORDS = sizeof(FlightRecord) / sizeof(std::uint64_t);
+        
+        struct Slot {
+            atomic<std::uint64_t> sequence{0};
+            alignas(std::uint64_t) array<std::uint64_t, RECORD_WORDS> words{};
+        };
+        
+        struct Ring {
+            std::thread::id owner;
+            unique_ptr<Slot[]> slots;
+            size_type mask;
+            atomic<std::uint64_t> head{0};
+            
+            Ring(std::thread::id thread, size_type capacity);
+        };
+        
+        Config config_;
+        std::uint64_t id_;
+        std::uint64_t slow_threshold_ns_;
+        
+        mutable mutex rings_mutex_;
+        vector<unique_ptr<Ring>> rings_;
+        
+        mutable mutex slow_mutex_;
+        deque<SlowRequestRecord> slow_;
+        
+        std::thread signal_thread_;
+        int signal_pipe_[2]{-1, -1};
+        
+        Ring& local_ring();
+        Ring& register_ring();
+        void write_dump_file() const;
+    };
+}
@@ -0,0 +1,189 @@
+#pragma once
+
+// Included by core/types.hpp ahead of its aliases, so only standard types are used here
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <source_location>
+#include <string>
+#include <type_traits>
+
+namespace http_framework::core {
+    // Counters shared by every mutex constructed at one site. Sites are created once and
+    // never destroyed, so mutexes can hold a plain pointer to theirs.
+    struct LockSite {
+        // Wait histogram bucket i holds waits in [2^(i-1), 2^i) nanoseconds; the last is open-ended
+        static constexpr std::size_t WAIT_BUCKETS = 36;
+        
+        std::string name;
+        std::atomic<std::uint64_t> acquisitions{0};
+        std::atomic<std::uint64_t> contended{0};
+        std::atomic<std::uint64_t> wait_ns{0};
+        std::atomic<std::uint64_t> hold_ns{0};
+        std::atomic<std::uint64_t> max_hold_ns{0};
+        std::array<std::atomic<std::uint64_t>, WAIT_BUCKETS> wait_buckets{};
+        
+        explicit LockSite(std::string site_name) : name(std::move(site_name)) {}
+        
+        // Explicit names are used as given; anonymous mutexes are keyed by the constructor
+        // that initialized them, which for members is the owning class
+        static LockSite& resolve(const char* name);
+        static LockSite& resolve(const std::source_location& location);
+        
+        // Visits every site in name order
+        template<typename Func>
+        static void for_each(Func&& func);
+        
+        static std::size_t wait_bucket(std::uint64_t wait_ns) noexcept {
+            return std::min<std::size_t>(static_cast<std::size_t>(std::bit_width(wait_ns)), WAIT_BUCKETS - 1);
+        }
+        
+        static std::uint64_t now_ns() noexcept {
+            return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+        
+        void record_acquire(std::uint64_t waited_ns, bool was_contended) noexcept {
+            acquisitions.fetch_add(1, std::memory_order_relaxed);
+            if (was_contended) {
+                contended.fetch_add(1, std::memory_order_relaxed);
+                wait_ns.fetch_add(waited_ns, std::memory_order_relaxed);
+            }
+            wait_buckets[wait_bucket(waited_ns)].fetch_add(1, std::memory_order_relaxed);
+        }
+        
+        void record_hold(std::uint64_t held_ns) noexcept {
+            hold_ns.fetch_add(held_ns, std::memory_order_relaxed);
+            auto previous = max_hold_ns.load(std::memory_order_relaxed);
+            while (held_ns > previous &&
+                   !max_hold_ns.compare_exchange_weak(previous, held_ns, std::memory_order_relaxed)) {
+            }
+        }
+        
+    private:
+        static void visit(void (*visitor)(LockSite&, void*), void* context);
+    };
+    
+    // Drop-in for std::mutex that records acquisitions, contention, wait time and hold
+    // time into its LockSite. An uncontended lock is a try_lock plus two clock reads.
+    class InstrumentedMutex {
+    public:
+        InstrumentedMutex(std::source_location location = std::source_location::current())
+            : site_(&LockSite::resolve(location)) {}
+        explicit InstrumentedMutex(const char* name) : site_(&LockSite::resolve(name)) {}
+        InstrumentedMutex(const InstrumentedMutex&) = delete;
+        InstrumentedMutex& operator=(const InstrumentedMutex&) = delete;
+        
+        void lock() {
+            if (mutex_.try_lock()) {
+                acquired_at_ = LockSite::now_ns();
+                site_->record_acquire(0, false);
+                return;
+            }
+            auto started = LockSite::now_ns();
+            mutex_.lock();
+            acquired_at_ = LockSite::now_ns();
+            site_->record_acquire(acquired_at_ - started, true);
+        }
+        
+        bool try_lock() {
+            if (!mutex_.try_lock()) {
+                return false;
+            }
+            acquired_at_ = LockSite::now_ns();
+            site_->record_acquire(0, false);
+            return true;
+        }
+        
+        void unlock() {
+            auto held = LockSite::now_ns() - acquired_at_;
+            mutex_.unlock();
+            site_->record_hold(held);
+        }
+        
+        const LockSite& site() const noexcept { return *site_; }
+        
+    private:
+        std::mutex mutex_;
+        LockSite* site_;
+        std::uint64_t acquired_at_{0};
+    };
+    
+    // Drop-in for std::shared_mutex. Shared acquisitions count toward acquisitions,
+    // contention and wait time; hold time is tracked for exclusive ownership only,
+    // since readers overlap.
+    class InstrumentedSharedMutex {
+    public:
+        InstrumentedSharedMutex(std::source_location location = std::source_location::current())
+            : site_(&LockSite::resolve(location)) {}
+        explicit InstrumentedSharedMutex(const char* name) : site_(&LockSite::resolve(name)) {}
+        InstrumentedSharedMutex(const InstrumentedSharedMutex&) = delete;
+        InstrumentedSharedMutex& operator=(const InstrumentedSharedMutex&) = delete;
+        
+        void lock() {
+            if (mutex_.try_lock()) {
+                acquired_at_ = LockSite::now_ns();
+                site_->record_acquire(0, false);
+                return;
+            }
+            auto started = LockSite::now_ns();
+            mutex_.lock();
+            acquired_at_ = LockSite::now_ns();
+            site_->record_acquire(acquired_at_ - started, true);
+        }
+        
+        bool try_lock() {
+            if (!mutex_.try_lock()) {
+                return false;
+            }
+            acquired_at_ = LockSite::now_ns();
+            site_->record_acquire(0, false);
+            return true;
+        }
+        
+        void unlock() {
+            auto held = LockSite::now_ns() - acquired_at_;
+            mutex_.unlock();
+            site_->record_hold(held);
+        }
+        
+        void lock_shared() {
+            if (mutex_.try_lock_shared()) {
+                site_->record_acquire(0, false);
+                return;
+            }
+            auto started = LockSite::now_ns();
+            mutex_.lock_shared();
+            site_->record_acquire(LockSite::now_ns() - started, true);
+        }
+        
+        bool try_lock_shared() {
+            if (!mutex_.try_lock_shared()) {
+                return false;
+            }
+            site_->record_acquire(0, false);
+            return true;
+        }
+        
+        void unlock_shared() { mutex_.unlock_shared(); }
+        
+        const LockSite& site() const noexcept { return *site_; }
+        
+    private:
+        std::shared_mutex mutex_;
+        LockSite* site_;
+        std::uint64_t acquired_at_{0};
+    };
+    
+    template<typename Func>
+    void LockSite::for_each(Func&& func) {
+        visit([](LockSite& site, void* context) { (*static_cast<std::remove_reference_t<Func>*>(context))(site); },
+              const_cast<void*>(static_cast<const void*>(&func)));
+    }
+}
@@ -0,0 +1,210 @@
+#pragma once
+
+#include "core/types.hpp"
+#include <utility>
+
+namespace http_framework::core {
+    // Fixed-size blocks carved from large slabs, one free list per size class. Each
+    // thread keeps a small cache per class and trades batches with a shared central
+    // list, so the common allocate/free pair takes no lock. Blocks may be freed on any
+    // thread. Slabs are never returned to the system.
+    class SlabPool {
+    public:
+        static constexpr size_type SIZE_CLASS_COUNT = 8;
+        static constexpr array<size_type, SIZE_CLASS_COUNT> SIZE_CLASSES = {
+            512, 1024, 2048, 4096, 8192, 16384, 32768, 65536
+        };
+        // Returned by size_class_for when the request is larger than every class
+        static constexpr size_type LARGE = SIZE_CLASS_COUNT;
+        
+        struct Config {
+            size_type slab_size{2 * 1024 * 1024};
+            // Try MAP_HUGETLB first, then fall back to transparent huge pages via madvise
+            bool huge_pages{false};
+            // Per thread and class; half is returned to the central list on overflow
+            size_type thread_cache_blocks{64};
+        };
+        
+        struct Stats {
+            size_type slabs{0};
+            size_type huge_page_slabs{0};
+            size_type reserved_bytes{0};
+        };
+        
+        // Takes effect for slabs carved after the call; call it before serving traffic
+        static void configure(const Config& config);
+        static Config config();
+        static Stats stats() noexcept;
+        
+        static size_type size_class_for(size_type bytes) noexcept {
+            for (size_type i = 0; i < SIZE_CLASS_COUNT; ++i) {
+                if (bytes <= SIZE_CLASSES[i]) {
+                    return i;
+                }
+            }
+            return LARGE;
+        }
+        
+        static void* allocate(size_type size_class);
+        static void deallocate(void* block, size_type size_class) noexcept;
+    };
+    
+    // Header at the start of every pooled or large block; the bytes follow it. Writers
+    // claim space by advancing reserved, so buffers sharing a block never overwrite
+    // each other's data, and bytes below reserved are immutable once published.
+    struct alignas(16) IoBlock {
+        atomic<std::uint32_t> refs{1};
+        std::uint32_t size_class{0};
+        size_type capacity{0};
+        atomic<size_type> reserved{0};
+        
+        byte_t* data() noexcept { return reinterpret_cast<byte_t*>(this + 1); }
+        const byte_t* data() const noexcept { return reinterpret_cast<const byte_t*>(this + 1); }
+        
+        // Capacity is at least min_capacity; pooled classes round up
+        static IoBlock* create(size_type min_capacity);
+        
+        void retain() noexcept { refs.fetch_add(1, std::memory_order_relaxed); }
+        void release() noexcept;
+        
+        // Claims [offset, offset + length) if offset is the current end of reserved space
+        bool try_reserve(size_type offset, size_type length) noexcept {
+            if (length > capacity - offset) {
+                return false;
+            }
+            auto expected = offset;
+            return reserved.compare_exchange_strong(expected, offset + length, std::memory_order_relaxed);
+        }
+    };
+    
+    // A refcounted view of bytes in one IoBlock. Copies share the block; splitting and
+    // trimming only move the view, so slices can be handed between stages and threads
+    // without copying the bytes.
+    class IoSlice {
+    public:
+        IoSlice() = default;
+        IoSlice(const IoSlice& other) noexcept
+            : block_(other.block_), offset_(other.offset_), length_(other.length_) {
+            if (block_) {
+                block_->retain();
+            }
+        }
+        IoSlice(IoSlice&& other) noexcept
+            : block_(std::exchange(other.block_, nullptr)), offset_(other.offset_),
+              length_(std::exchange(other.length_, 0)) {}
+        IoSlice& operator=(IoSlice other) noexcept {
+            std::swap(block_, other.block_);
+            std::swap(offset_, other.offset_);
+            std::swap(length_, other.length_);
+            return *this;
+        }
+        ~IoSlice() {
+            if (block_) {
+                block_->release();
+            }
+        }
+        
+        // Copies bytes into a fresh block
+        static IoSlice copy_of(byte_span bytes);
+        
+        const byte_t* data() const noexcept { return block_ ? block_->data() + offset_ : nullptr; }
+        size_type size() const noexcept { return length_; }
+        bool empty() const noexcept { return length_ == 0; }
+        byte_span span() const noexcept { return {data(), length_}; }
+        string_view view() const noexcept { return {reinterpret_cast<const char*>(data()), length_}; }
+        
+        IoSlice subslice(size_type offset, size_type length = static_cast<size_type>(-1)) const;
+        // Returns the first length bytes and keeps the rest
+        IoSlice split_front(size_type length);
+        void remove_prefix(size_type length) noexcept;
+        void remove_suffix(size_type length) noexcept;
+        
+    private:
+        IoBlock* block_{nullptr};
+        size_type offset_{0};
+        size_type length_{0};
+        
+        IoSlice(IoBlock* block, size_type offset, size_type length) noexcept
+            : block_(block), offset_(offset), length_(length) {}
+            
+        friend class IoBuffer;
+    };
+    
+    // A chain of slices read or written as one byte sequence. Appending copies into the
+    // tail block while it has room; appending slices or other buffers shares them.
+    // prepare/commit expose tail space for reading straight from a socket.
+    class IoBuffer {
+    public:
+        // Block size for small appends; larger ones get a block of their own size class
+        static constexpr size_type DEFAULT_BLOCK_SIZE = 4096;
+        
+        IoBuffer() = default;
+        explicit IoBuffer(string_view bytes) { append(bytes); }
+        explicit IoBuffer(byte_span bytes) { append(bytes); }
+        explicit IoBuffer(IoSlice slice) { append(std::move(slice)); }
+        IoBuffer(const IoBuffer& other) : slices_(other.slices_), size_(other.size_) {}
+        IoBuffer(IoBuffer&& other) noexcept
+            : slices_(std::move(other.slices_)), size_(std::exchange(other.size_, 0)),
+              prepared_(std::exchange(other.prepared_, nullptr)),
+              prepared_offset_(other.prepared_offset_), prepared_length_(std::exchange(other.prepared_length_, 0)) {}
+        IoBuffer& operator=(const IoBuffer& other);
+        IoBuffer& operator=(IoBuffer&& other) noexcept;
+        ~IoBuffer() { release_prepared(); }
+        
+        size_type size() const noexcept { return size_; }
+        bool empty() const noexcept { return size_ == 0; }
+        size_type slice_count() const noexcept { return slices_.size(); }
+        const vector<IoSlice>& slices() const noexcept { return slices_; }
+        
+        void append(byte_span bytes);
+        void append(string_view bytes) { append(byte_span(reinterpret_cast<const byte_t*>(bytes.data()), bytes.size())); }
+        void append(IoSlice slice);
+        void append(const IoBuffer& other);
+        void append(IoBuffer&& other);
+        
+        // At least min_bytes of writable space after the last byte: the rest of the tail
+        // block when it has room, else a fresh block. Valid until commit, the next
+        // prepare or any other mutation.
+        mutable_byte_span prepare(size_type min_bytes = 1);
+        // Publishes the first bytes of the prepared span and gives back the rest
+        void commit(size_type bytes);
+        
+        // Drops bytes from the front, releasing blocks no longer referenced
+        void consume(size_type bytes);
+        // Removes and returns the first bytes, sharing the slice that straddles the cut
+        IoBuffer split(size_type bytes);
+        void clear() noexcept;
+        
+        // Copies up to out.size() bytes starting at offset; returns the number copied
+        size_type copy_to(mutable_byte_span out, size_type offset = 0) const noexcept;
+        buffer_t to_vector() const;
+        string to_string() const;
+        
+        // A single span over the contents, merging slices into one block when needed
+        byte_span linearize();
+        
+        // Calls func(byte_span) for each non-empty slice in order, e.g. to fill an iovec
+        template<typename Func>
+        void for_each_slice(Func&& func) const;
+        
+    private:
+        vector<IoSlice> slices_;
+        size_type size_{0};
+        IoBlock* prepared_{nullptr};
+        size_type prepared_offset_{0};
+        size_type prepared_length_{0};
+        
+        void release_prepared() noexcept;
+        // Grows the last slice in place when it ends at its block's reserved end
+        size_type extend_tail(byte_span bytes) noexcept;
+    };
+    
+    template<typename Func>
+    void IoBuffer::for_each_slice(Func&& func) const {
+        for (const auto& slice : slices_) {
+            if (!slice.empty()) {
+                func(slice.span());
+            }
+        }
+    }
+}
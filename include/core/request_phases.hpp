@@ -0,0 +1,121 @@
+#pragma once
+
+#include "core/types.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#endif
+
+// Set to 0 to compile phase timing out entirely; otherwise it is still off until enabled at runtime
+#ifndef HTTP_FRAMEWORK_PHASE_TIMING
+#define HTTP_FRAMEWORK_PHASE_TIMING 1
+#endif
+
+namespace http_framework::core {
+    enum class Phase : std::uint8_t {
+        READ = 0,
+        PARSE = 1,
+        ROUTE = 2,
+        MIDDLEWARE = 3,
+        HANDLER = 4,
+        SERIALIZE = 5,
+        WRITE = 6
+    };
+    
+    inline constexpr size_type PHASE_COUNT = 7;
+    
+    string_view to_string(Phase phase) noexcept;
+    
+    // Unserialized cycle counter where the CPU has one, steady_clock nanoseconds elsewhere.
+    // Reads cost a few nanoseconds, which keeps per-phase stamps cheap enough to leave on.
+    class TscClock {
+    public:
+        static std::uint64_t now() noexcept {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+            return __rdtsc();
+#elif defined(__aarch64__)
+            std::uint64_t ticks;
+            asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+            return ticks;
+#else
+            return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+        }
+        
+        // Calibrated once against steady_clock on first use
+        static double nanoseconds_per_tick() noexcept;
+        
+        static std::uint64_t to_nanoseconds(std::uint64_t ticks) noexcept {
+            return static_cast<std::uint64_t>(static_cast<double>(ticks) * nanoseconds_per_tick());
+        }
+    };
+    
+    // Marks the end of each phase of one request. A phase lasts from the previous mark
+    // (or begin) to its own; phases that were never marked have zero duration.
+    class RequestPhases {
+    public:
+        static constexpr bool compiled_in() noexcept { return HTTP_FRAMEWORK_PHASE_TIMING != 0; }
+        static bool enabled() noexcept {
+            return compiled_in() && enabled_.load(std::memory_order_relaxed);
+        }
+        static void set_enabled(bool enabled) noexcept { enabled_.store(enabled, std::memory_order_relaxed); }
+        
+        void begin() noexcept {
+            active_ = enabled();
+            if (active_) {
+                ends_.fill(0);
+                started_at_ = std::chrono::steady_clock::now();
+                start_ = TscClock::now();
+            }
+        }
+        
+        void mark(Phase phase) noexcept {
+            if (compiled_in() && active_) {
+                ends_[static_cast<size_type>(phase)] = TscClock::now();
+            }
+        }
+        
+        void reset() noexcept { active_ = false; }
+        
+        bool is_active() const noexcept { return compiled_in() && active_; }
+        bool is_marked(Phase phase) const noexcept { return ends_[static_cast<size_type>(phase)] != 0; }
+        
+        std::uint64_t duration_ns(Phase phase) const noexcept;
+        std::uint64_t total_ns() const noexcept;
+        // Wall position of the phase's mark, for trace events
+        timestamp_t timestamp_of(Phase phase) const noexcept;
+        
+        // Calls func(phase, duration_ns) for each marked phase, in order
+        template<typename Func>
+        void for_each(Func&& func) const;
+        
+    private:
+        static inline atomic<bool> enabled_{false};
+        
+        std::uint64_t start_{0};
+        timestamp_t started_at_{};
+        array<std::uint64_t, PHASE_COUNT> ends_{};
+        bool active_{false};
+    };
+    
+    template<typename Func>
+    void RequestPhases::for_each(Func&& func) const {
+        if (!is_active()) {
+            return;
+        }
+        
+        auto previous = start_;
+        for (size_type i = 0; i < PHASE_COUNT; ++i) {
+            if (ends_[i] == 0) {
+                continue;
+            }
+            // Cores can disagree by a few ticks when a request migrates between them
+            auto ticks = ends_[i] > previous ? ends_[i] - previous : 0;
+            func(static_cast<Phase>(i), TscClock::to_nanoseconds(ticks));
+            previous = std::max(previous, ends_[i]);
+        }
+    }
+}
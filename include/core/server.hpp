@@ -4,11 +4,18 @@
 #include "core/connection.hpp"
 #include "core/thread_pool.hpp"
 #include "core/event_loop.hpp"
+#include "core/request_phases.hpp"
+#include "core/allocation_stats.hpp"
+#include "core/flight_recorder.hpp"
 #include "http/router.hpp"
 #include "http/middleware.hpp"
+#include "http/access_log.hpp"
+#include "metrics/http_metrics.hpp"
 #include "utils/config.hpp"
 #include "utils/logger.hpp"
+#include "utils/profiler.hpp"
 #include "network/socket.hpp"
+#include "tracing/server_tracing.hpp"
 
 namespace http_framework::core {
     class Server {
@@ -107,6 +114,7 @@ namespace http_framework::core {
         
         void enable_request_logging(bool enable = true);
         void enable_access_logging(string_view log_file);
+        void enable_access_logging(http::AccessLog::Config config);
         void disable_access_logging();
         
         void set_static_file_handler(string_view path, string_view root_dir);
@@ -118,6 +126,23 @@ namespace http_framework::core {
         
         void enable_metrics(string_view endpoint = "/metrics");
         void disable_metrics();
+        // Server-owned series; Registry::instance() is rendered after them on the same endpoint
+        metrics::Registry& metrics_registry() noexcept { return metrics_registry_; }
+        // Null until enable_metrics; register route labels here to keep them out of "other"
+        metrics::HttpServerMetrics* http_metrics() noexcept { return http_metrics_.get(); }
+        
+        // Serves the recorder's dump as JSON, or the binary form with ?format=binary, and
+        // writes a JSON dump on SIGUSR2 when no other recorder owns the signal
+        void enable_flight_recorder(string_view endpoint = "/debug/flight-recorder", FlightRecorder::Config config = {});
+        void disable_flight_recorder();
+        // Null until enable_flight_recorder
+        FlightRecorder* flight_recorder() noexcept { return flight_recorder_.get(); }
+        
+        // GET <endpoint>?seconds=30&hz=99[&backend=perf|itimer][&per_thread=1] answers with folded
+        // stacks after sampling every thread. Sampling and symbolization run on a "profiler"
+        // thread; the request suspends until they finish instead of holding a worker
+        void enable_profiling(string_view endpoint = "/debug/profile", duration_t max_duration = std::chrono::minutes(5));
+        void disable_profiling();
         
         string get_server_info() const;
         hash_map<string, variant<string, int64_t, double, bool>> get_stats() const;
@@ -148,7 +173,12 @@ namespace http_framework::core {
         void set_max_header_count(size_type max_headers);
         
         void enable_request_tracing(bool enable = true);
+        void enable_request_tracing(tracing::TracerProvider& provider, tracing::ServerRequestTracer::Config config);
+        // Starts the request's SERVER span and makes its context current for outbound calls
+        tracing::RequestTrace begin_request_trace(const http::Request& request, timestamp_t received_at);
         void enable_performance_monitoring(bool enable = true);
+        // Process-wide; has no effect when built with HTTP_FRAMEWORK_PHASE_TIMING=0
+        void enable_phase_timing(bool enable = true);
         
         void add_virtual_host(string_view host, shared_ptr<http::Router> router);
         void remove_virtual_host(string_view host);
@@ -166,7 +196,7 @@ namespace http_framework::core {
         http::MiddlewareChain middleware_chain_;
         
         vector<shared_ptr<Connection>> connections_;
-        mutable shared_mutex connections_mutex_;
+        mutable shared_mutex connections_mutex_ HTTP_FRAMEWORK_LOCK_SITE("Server::connections_mutex_");
         
         atomic<size_type> total_requests_{0};
         atomic<size_type> failed_requests_{0};
@@ -191,14 +221,21 @@ namespace http_framework::core {
         
         optional<size_type> rate_limit_;
         hash_map<string, std::pair<size_type, timestamp_t>> rate_limit_counters_;
-        mutable mutex rate_limit_mutex_;
+        mutable mutex rate_limit_mutex_ HTTP_FRAMEWORK_LOCK_SITE("Server::rate_limit_mutex_");
         
         bool request_logging_enabled_{false};
         bool access_logging_enabled_{false};
         optional<string> access_log_file_;
+        unique_ptr<http::AccessLog> access_log_;
         
         optional<string> health_check_endpoint_;
         optional<string> metrics_endpoint_;
+        metrics::Registry metrics_registry_;
+        unique_ptr<metrics::HttpServerMetrics> http_metrics_;
+        optional<string> flight_recorder_endpoint_;
+        unique_ptr<FlightRecorder> flight_recorder_;
+        optional<string> profile_endpoint_;
+        duration_t max_profile_duration_{std::chrono::minutes(5)};
         
         bool ssl_enabled_{false};
         bool ssl_verification_enabled_{true};
@@ -213,6 +250,7 @@ namespace http_framework::core {
         size_type max_header_count_{100};
         
         bool request_tracing_enabled_{false};
+        unique_ptr<tracing::ServerRequestTracer> request_tracer_;
         bool performance_monitoring_enabled_{false};
         
         atomic<size_type> active_request_count_{0};
@@ -232,6 +270,11 @@ namespace http_framework::core {
         
         void log_request(const http::Request& request, const http::Response& response, duration_t processing_time);
         void log_access(const http::Request& request, const http::Response& response);
+        void handle_flight_recorder(const http::Request& request, http::Response& response);
+        async::Task<void> handle_profile(const http::Request& request, http::Response& response);
+        // The caller fills total_ns, queue_wait_ns and the byte counts; the rest comes from here
+        void record_flight(const http::Request& request, const http::Response& response, const Connection& connection,
+                           FlightRecord record);
         
         void handle_health_check(const http::Request& request, http::Response& response);
         void handle_metrics(const http::Request& request, http::Response& response);
@@ -245,6 +288,11 @@ namespace http_framework::core {
         void trace_request(const http::Request& request, string_view event);
         
         void collect_performance_metrics(const http::Request& request, const http::Response& response, duration_t processing_time);
+        void record_request_phases(const http::Request& request, const RequestPhases& phases, tracing::RequestTrace& trace);
+        // Before serialization: answers an X-Debug-Allocations request header with X-Allocations
+        void annotate_allocations(const http::Request& request, http::Response& response, const RequestAllocations& allocations);
+        // After the write, once every phase is marked
+        void record_request_allocations(const http::Request& request, const RequestAllocations& allocations);
         
         static void signal_handler(int signal);
         static Server* instance_;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core/types.hpp"
+#include "core/tracepoints.hpp"
 #include "async/future.hpp"
 #include "async/task.hpp"
 
@@ -76,7 +77,7 @@ namespace http_framework::core {
         
         vector<unique_ptr<WorkerThread>> workers_;
         queue<function<void()>> global_queue_;
-        mutable mutex global_queue_mutex_;
+        mutable mutex global_queue_mutex_ HTTP_FRAMEWORK_LOCK_SITE("ThreadPool::global_queue_mutex_");
         condition_variable global_condition_;
         
         atomic<bool> shutdown_requested_{false};
@@ -127,7 +128,14 @@ namespace http_framework::core {
         
         auto future = async::Future<ReturnType>(task->get_future());
         
-        auto wrapper = [task]() {
+        // Clock reads only while a tracer holds the probe's semaphore; steady_clock rather
+        // than TscClock, whose one-off calibration must not land on a worker
+        auto enqueued_at = tracepoints::threadpool_dequeue_enabled() ? std::chrono::steady_clock::now() : timestamp_t{};
+        auto wrapper = [task, enqueued_at]() {
+            if (enqueued_at != timestamp_t{} && tracepoints::threadpool_dequeue_enabled()) {
+                auto queued = std::chrono::steady_clock::now() - enqueued_at;
+                tracepoints::threadpool_dequeue(std::chrono::duration_cast<std::chrono::nanoseconds>(queued).count());
+            }
             try {
                 (*task)();
             } catch (...) {
@@ -138,6 +146,7 @@ namespace http_framework::core {
         if (!enqueue_task(std::move(wrapper))) {
             throw std::runtime_error("Failed to enqueue task");
         }
+        tracepoints::threadpool_enqueue(pending_tasks_.load(std::memory_order_relaxed));
         
         return future;
     }
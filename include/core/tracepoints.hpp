@@ -0,0 +1,109 @@
+#pragma once
+
+#include "core/types.hpp"
+
+// Static user-level tracepoints (USDT) under the "http_framework" provider. Each probe
+// is a single nop plus an entry in the ELF .note.stapsdt section, the same layout that
+// <sys/sdt.h> emits, so perf, bpftrace and SystemTap attach to them without this tree
+// depending on systemtap-sdt-dev. With nothing attached a probe costs the nop and the
+// register moves for its arguments; compile them out entirely with -DENABLE_USDT=OFF.
+//
+//   bpftrace -l 'usdt:./http-framework:http_framework:*'
+//   perf buildid-cache --add ./http-framework && perf list sdt_http_framework:*
+//
+// Every argument is widened to a signed 64-bit integer.
+//
+// A probe whose arguments cost more than register moves also gets a semaphore: a
+// counter in the .probes section that bpftrace and SystemTap increment while attached,
+// so the call site can skip that work until someone is listening.
+
+#ifndef HTTP_FRAMEWORK_USDT
+#if defined(__ELF__) && (defined(__x86_64__) || defined(__aarch64__)) && (defined(__GNUC__) || defined(__clang__))
+#define HTTP_FRAMEWORK_USDT 1
+#else
+#define HTTP_FRAMEWORK_USDT 0
+#endif
+#endif
+
+#if HTTP_FRAMEWORK_USDT
+
+// The .stapsdt.base symbol lets tools compute the load bias of prelinked binaries.
+// Label 990 marks the probe address; the note records it together with the
+// semaphore address (0 for none), the provider, the probe name and one
+// "-8@<operand>" argument descriptor per value.
+#define HTTP_FRAMEWORK_USDT_ASM(provider, name, semaphore, args) \
+    "990: nop\n" \
+    ".pushsection .note.stapsdt,\"?\",\"note\"\n" \
+    ".balign 4\n" \
+    ".4byte 992f-991f, 994f-993f, 3\n" \
+    "991: .asciz \"stapsdt\"\n" \
+    "992: .balign 4\n" \
+    "993: .8byte 990b\n" \
+    ".8byte _.stapsdt.base\n" \
+    ".8byte " semaphore "\n" \
+    ".asciz \"" #provider "\"\n" \
+    ".asciz \"" #name "\"\n" \
+    ".asciz \"" args "\"\n" \
+    "994: .balign 4\n" \
+    ".popsection\n" \
+    ".ifndef _.stapsdt.base\n" \
+    ".pushsection .stapsdt.base,\"aG\",\"progbits\",.stapsdt.base,comdat\n" \
+    ".weak _.stapsdt.base\n" \
+    ".hidden _.stapsdt.base\n" \
+    "_.stapsdt.base: .space 1\n" \
+    ".size _.stapsdt.base, 1\n" \
+    ".popsection\n" \
+    ".endif\n"
+
+#define HTTP_FRAMEWORK_USDT_ARG(value) "nor"(static_cast<std::int64_t>(value))
+
+// Weak so every translation unit including this header shares one counter per probe
+#define HTTP_FRAMEWORK_USDT_SEMAPHORE(name) \
+    extern "C" { \
+        [[gnu::weak, gnu::visibility("hidden"), gnu::section(".probes")]] \
+        volatile unsigned short http_framework_##name##_semaphore = 0; \
+    }
+#define HTTP_FRAMEWORK_PROBE_ENABLED(name) (http_framework_##name##_semaphore != 0)
+
+#define HTTP_FRAMEWORK_PROBE1(name, a0) \
+    __asm__ __volatile__(HTTP_FRAMEWORK_USDT_ASM(http_framework, name, "0", "-8@%0") \
+        :: HTTP_FRAMEWORK_USDT_ARG(a0))
+#define HTTP_FRAMEWORK_SEMAPHORE_PROBE1(name, a0) \
+    __asm__ __volatile__(HTTP_FRAMEWORK_USDT_ASM(http_framework, name, "http_framework_" #name "_semaphore", "-8@%0") \
+        :: HTTP_FRAMEWORK_USDT_ARG(a0))
+
+// Probes live in inline functions, so they must always be inlined: an out-of-line copy
+// discarded by COMDAT folding would leave its note pointing into a dropped section
+#define HTTP_FRAMEWORK_PROBE_INLINE [[gnu::always_inline]] inline
+
+#else
+
+#define HTTP_FRAMEWORK_PROBE1(name, a0) ((void)(a0))
+#define HTTP_FRAMEWORK_USDT_SEMAPHORE(name)
+#define HTTP_FRAMEWORK_PROBE_ENABLED(name) false
+#define HTTP_FRAMEWORK_SEMAPHORE_PROBE1(name, a0) ((void)(a0))
+#define HTTP_FRAMEWORK_PROBE_INLINE inline
+
+#endif
+
+HTTP_FRAMEWORK_USDT_SEMAPHORE(threadpool_dequeue)
+
+namespace http_framework::core::tracepoints {
+    constexpr bool compiled_in = HTTP_FRAMEWORK_USDT != 0;
+    
+    // threadpool_enqueue(pending_tasks)
+    HTTP_FRAMEWORK_PROBE_INLINE void threadpool_enqueue(size_type pending_tasks) noexcept {
+        HTTP_FRAMEWORK_PROBE1(threadpool_enqueue, pending_tasks);
+    }
+    
+    // threadpool_dequeue(queued_ns): time the task spent waiting for a worker. Measuring
+    // it costs two clock reads per task, so callers check threadpool_dequeue_enabled first
+    inline bool threadpool_dequeue_enabled() noexcept {
+        return HTTP_FRAMEWORK_PROBE_ENABLED(threadpool_dequeue);
+    }
+    
+    HTTP_FRAMEWORK_PROBE_INLINE void threadpool_dequeue(std::uint64_t queued_ns) noexcept {
+        HTTP_FRAMEWORK_SEMAPHORE_PROBE1(threadpool_dequeue, queued_ns);
+    }
+}
+    
\ No newline at end of file
@@ -12,6 +12,7 @@
 #include <thread>
 #include <atomic>
 #include <mutex>
+#include <shared_mutex>
 #include <condition_variable>
 #include <future>
 #include <queue>
@@ -20,6 +21,20 @@
 #include <span>
 #include <concepts>
 #include <coroutine>
+#include "core/flat_hash_map.hpp"
+
+// Set to 1 to put InstrumentedMutex behind the mutex aliases; lock sites then show up
+// on the metrics endpoint. HTTP_FRAMEWORK_LOCK_SITE names a member's site explicitly.
+#ifndef HTTP_FRAMEWORK_LOCK_PROFILING
+#define HTTP_FRAMEWORK_LOCK_PROFILING 0
+#endif
+
+#if HTTP_FRAMEWORK_LOCK_PROFILING
+#include "core/instrumented_mutex.hpp"
+#define HTTP_FRAMEWORK_LOCK_SITE(name) {name}
+#else
+#define HTTP_FRAMEWORK_LOCK_SITE(name)
+#endif
 
 namespace http_framework {
     using byte_t = std::uint8_t;
@@ -53,8 +68,13 @@ namespace http_framework {
     template<typename... Args>
     using variant = std::variant<Args...>;
     
+    // Open-addressing, so inserts may move elements; keep std::unordered_map for values
+    // that cannot move or whose addresses are handed out
     template<typename K, typename V>
-    using hash_map = std::unordered_map<K, V>;
+    using hash_map = core::flat_hash_map<K, V>;
+    
+    template<typename K>
+    using hash_set = core::flat_hash_set<K>;
     
     template<typename T>
     using vector = std::vector<T>;
@@ -77,12 +97,22 @@ namespace http_framework {
     template<typename T>
     using promise = std::promise<T>;
     
+#if HTTP_FRAMEWORK_LOCK_PROFILING
+    using mutex = core::InstrumentedMutex;
+    using shared_mutex = core::InstrumentedSharedMutex;
+#else
     using mutex = std::mutex;
     using shared_mutex = std::shared_mutex;
+#endif
     using lock_guard = std::lock_guard<mutex>;
     using unique_lock = std::unique_lock<mutex>;
     using shared_lock = std::shared_lock<shared_mutex>;
+#if HTTP_FRAMEWORK_LOCK_PROFILING
+    // std::condition_variable only waits on std::unique_lock<std::mutex>
+    using condition_variable = std::condition_variable_any;
+#else
     using condition_variable = std::condition_variable;
+#endif
     
     template<typename T>
     using atomic = std::atomic<T>;
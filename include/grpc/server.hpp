@@ -4,6 +4,7 @@
 #include "core/thread_pool.hpp"
 #include "async/future.hpp"
 #include "async/task.hpp"
+#include "resilience/hedging.hpp"
 #include "grpc/service.hpp"
 #include "grpc/context.hpp"
 
@@ -337,7 +338,8 @@ namespace http_framework::grpc {
         unique_ptr<class CompletionQueue> completion_queue_;
         
         atomic<size_type> total_requests_{0};
-        hash_map<string, atomic<size_type>> method_counters_;
+        // Node-based because atomics cannot be moved by a rehash
+        std::unordered_map<string, atomic<size_type>> method_counters_;
         mutable shared_mutex services_mutex_;
         
         optional<function<void(const std::exception&)>> error_handler_;
@@ -432,6 +434,9 @@ namespace http_framework::grpc {
         template<typename Request, typename Response>
         async::Future<ServerResult<Response>> unary_call(string_view service_name, string_view method_name, const Request& request, const Metadata& metadata = {});
         
+        template<typename Request, typename Response>
+        async::Future<ServerResult<Response>> unary_call(resilience::HedgingPolicy<ServerResult<Response>>& policy, string_view service_name, string_view method_name, const Request& request, const Metadata& metadata = {});
+        
         template<typename Request, typename Response>
         class StreamingCall {
         public:
@@ -451,4 +456,11 @@ namespace http_framework::grpc {
         Config config_;
         unique_ptr<class GrpcChannel> channel_;
     };
+    
+    template<typename Request, typename Response>
+    async::Future<ServerResult<Response>> GrpcClientStub::unary_call(resilience::HedgingPolicy<ServerResult<Response>>& policy, string_view service_name, string_view method_name, const Request& request, const Metadata& metadata) {
+        return policy.execute([this, service = string(service_name), method = string(method_name), request, metadata](const resilience::CancellationToken&) {
+            return async::make_task_from_future(unary_call<Request, Response>(service, method, request, metadata));
+        }).to_future();
+    }
 } 
\ No newline at end of file
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "core/types.hpp"
+#include "http/request.hpp"
+#include "http/response.hpp"
+#include <cstdio>
+
+namespace http_framework::http {
+    enum class AccessLogFormat : std::uint8_t {
+        COMMON = 0,
+        COMBINED = 1,
+        JSON = 2,
+        CUSTOM = 3
+    };
+    
+    struct AccessLogRecord {
+        const Request& request;
+        const Response& response;
+        std::chrono::system_clock::time_point completed_at;
+        std::chrono::microseconds duration;
+    };
+    
+    // A log format compiled once into field writers. Patterns use nginx-style variables:
+    // $remote_addr, $remote_port, $time_local, $time_iso8601, $msec, $request, $method,
+    // $uri, $path, $query, $protocol, $status, $body_bytes_sent, $request_time,
+    // $request_time_us, $request_id, $http_<header> and $sent_http_<header>.
+    // Anything else is copied literally; ${name} delimits a variable inside text.
+    class AccessLogFormatter {
+    public:
+        enum class Escape : std::uint8_t {
+            DEFAULT = 0,
+            JSON = 1
+        };
+        
+        static AccessLogFormatter compile(AccessLogFormat format);
+        static AccessLogFormatter compile(string_view pattern, Escape escape = Escape::DEFAULT);
+        
+        static string_view common_pattern() noexcept;
+        static string_view combined_pattern() noexcept;
+        static string_view json_pattern() noexcept;
+        
+        // Appends one line, including the trailing newline
+        void append(string& out, const AccessLogRecord& record) const;
+        
+        size_type field_count() const noexcept { return fields_.size(); }
+        
+    private:
+        struct Field;
+        using FieldWriter = void (*)(string& out, const AccessLogRecord& record, const Field& field);
+        
+        struct Field {
+            FieldWriter writer;
+            string argument;
+            Escape escape;
+        };
+        
+        vector<Field> fields_;
+    };
+    
+    struct AccessLogMetrics {
+        size_type records_logged{0};
+        size_type records_sampled_out{0};
+        size_type bytes_written{0};
+        size_type batches_written{0};
+        size_type write_failures{0};
+        size_type reopens{0};
+        
+        string to_json() const;
+    };
+    
+    // Formats on the calling thread into a large per-thread buffer; full buffers are
+    // handed to a flusher thread that writes them in batches and reopens the file on SIGHUP
+    class AccessLog {
+    public:
+        struct Config {
+            string path{"access.log"};
+            AccessLogFormat format{AccessLogFormat::COMBINED};
+            // Used when format is CUSTOM
+            string pattern;
+            AccessLogFormatter::Escape escape{AccessLogFormatter::Escape::DEFAULT};
+            // Fraction of requests written; 1.0 logs every request
+            double sample_rate{1.0};
+            // Responses with a status at or above this bypass sampling; 0 disables the bypass
+            status_code_t always_log_status{500};
+            size_type buffer_size{64 * 1024};
+            duration_t flush_interval{std::chrono::seconds(1)};
+            bool reopen_on_sighup{true};
+        };
+        
+        AccessLog();
+        explicit AccessLog(Config config);
+        AccessLog(const AccessLog&) = delete;
+        AccessLog& operator=(const AccessLog&) = delete;
+        ~AccessLog();
+        
+        void log(const Request& request, const Response& response, std::chrono::microseconds duration);
+        void log(const Request& request, const Response& response);
+        
+        // Writes every thread's buffered records before returning
+        void flush();
+        // Reopens the file on the flusher thread, e.g. after logrotate moved it
+        void reopen();
+        void close();
+        
+        bool is_open() const;
+        const Config& config() const noexcept { return config_; }
+        AccessLogMetrics metrics() const;
+        
+        // Routes SIGHUP to every open AccessLog, then to any handler installed before it;
+        // called automatically when reopen_on_sighup is set
+        static void install_sighup_handler();
+        
+    private:
+        struct Flusher;
+        
+        Config config_;
+        AccessLogFormatter formatter_;
+        std::uint32_t sample_threshold_;
+        unique_ptr<Flusher> flusher_;
+        
+        atomic<size_type> records_logged_{0};
+        atomic<size_type> records_sampled_out_{0};
+        atomic<size_type> bytes_written_{0};
+        atomic<size_type> batches_written_{0};
+        atomic<size_type> write_failures_{0};
+        atomic<size_type> reopens_{0};
+        
+        bool should_sample(const Response& response) noexcept;
+        size_type buffer_capacity() const noexcept;
+        void flusher_loop();
+        bool open_file();
+        void write_batch(vector<string>& batch);
+    };
+}
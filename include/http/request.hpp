@@ -1,6 +1,8 @@
 #pragma once
 
 #include "core/types.hpp"
+#include "core/context.hpp"
+#include "json/parser.hpp"
 #include <regex>
 #include <sstream>
 
@@ -31,6 +33,8 @@ namespace http_framework::http {
         void remove_header(string_view name);
         bool has_header(string_view name) const;
         optional<string> get_header(string_view name) const;
+        // Case-insensitive lookup that neither copies the name nor the value
+        optional<string_view> header_view(string_view name) const noexcept;
         const vector<HttpHeader>& headers() const noexcept { return headers_; }
         
         void add_cookie(const HttpCookie& cookie);
@@ -52,6 +56,7 @@ namespace http_framework::http {
         const hash_map<string, string>& path_params() const noexcept { return path_params_; }
         
         string body_as_string() const;
+        // Binds the body straight into T (see json::Fields); nullopt if it is not valid JSON for T
         template<typename T> optional<T> body_as_json() const;
         
         bool is_websocket_upgrade() const;
@@ -93,6 +98,23 @@ namespace http_framework::http {
         bool has_attribute(string_view name) const;
         void remove_attribute(string_view name);
         
+        // Typed values keyed by core::ContextKey, for anything the string attributes
+        // cannot hold without serializing it; cleared by reset()
+        template<typename T, typename U = T>
+        T& set_context(const core::ContextKey<T>& key, U&& value) { return context_.set(key, std::forward<U>(value)); }
+        
+        template<typename T>
+        T* context(const core::ContextKey<T>& key) noexcept { return context_.get(key); }
+        
+        template<typename T>
+        const T* context(const core::ContextKey<T>& key) const noexcept { return context_.get(key); }
+        
+        template<typename T>
+        bool has_context(const core::ContextKey<T>& key) const noexcept { return context_.has(key); }
+        
+        template<typename T>
+        void remove_context(const core::ContextKey<T>& key) noexcept { context_.erase(key); }
+        
         string to_string() const;
         static Request from_string(string_view data);
         
@@ -110,6 +132,7 @@ namespace http_framework::http {
         hash_map<string, string> query_params_;
         hash_map<string, string> path_params_;
         hash_map<string, variant<string, int64_t, double, bool>> attributes_;
+        core::ContextSlots context_;
         timestamp_t timestamp_{std::chrono::steady_clock::now()};
         size_type request_id_{0};
         
@@ -123,14 +146,19 @@ namespace http_framework::http {
         vector<HttpCookie> parse_cookie_header(string_view cookie_header) const;
     };
     
+    template<typename T>
+    optional<T> Request::body_as_json() const {
+        return json::parse<T>(string_view(reinterpret_cast<const char*>(body_.data()), body_.size()));
+    }
+    
     template<typename T>
     void Request::set_attribute(string_view name, T&& value) {
-        attributes_[string(name)] = std::forward<T>(value);
+        attributes_[name] = std::forward<T>(value);
     }
     
     template<typename T>
     optional<T> Request::get_attribute(string_view name) const {
-        auto it = attributes_.find(string(name));
+        auto it = attributes_.find(name);
         if (it == attributes_.end()) {
             return std::nullopt;
         }
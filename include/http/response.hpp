@@ -1,6 +1,8 @@
 #pragma once
 
 #include "core/types.hpp"
+#include "core/io_buffer.hpp"
+#include "json/writer.hpp"
 #include <fstream>
 
 namespace http_framework::http {
@@ -16,20 +18,30 @@ namespace http_framework::http {
         void set_status_code(status_code_t code) noexcept { status_code_ = code; }
         void set_status_message(string_view message) { status_message_ = message; }
         void set_version(HttpVersion version) noexcept { version_ = version; }
-        void set_body(buffer_t body) { body_ = std::move(body); chunked_ = false; }
+        void set_body(buffer_t body) { body_ = std::move(body); body_chain_.clear(); chunked_ = false; }
         void set_body(string_view body);
+        // Shares the buffer's slices instead of copying; the bytes stay in body_chain()
+        // until flatten_body() copies them into body()
+        void set_body(core::IoBuffer body);
         
         status_code_t status_code() const noexcept { return status_code_; }
         const string& status_message() const noexcept { return status_message_; }
         HttpVersion version() const noexcept { return version_; }
+        // Contiguous bytes only: empty while the body is chained, so callers that need the
+        // whole body in one buffer call flatten_body() first
         const buffer_t& body() const noexcept { return body_; }
-        size_type body_size() const noexcept { return body_.size(); }
+        const core::IoBuffer& body_chain() const noexcept { return body_chain_; }
+        // Copies a chained body into body(), giving up the shared slices
+        const buffer_t& flatten_body();
+        size_type body_size() const noexcept { return body_.size() + body_chain_.size(); }
         
         void add_header(string_view name, string_view value);
         void set_header(string_view name, string_view value);
         void remove_header(string_view name);
         bool has_header(string_view name) const;
         optional<string> get_header(string_view name) const;
+        // Case-insensitive lookup that neither normalizes nor copies
+        optional<string_view> header_view(string_view name) const noexcept;
         const vector<HttpHeader>& headers() const noexcept { return headers_; }
         
         void add_cookie(const HttpCookie& cookie);
@@ -59,10 +71,14 @@ namespace http_framework::http {
         
         void append_body_chunk(string_view chunk);
         void append_body_chunk(const buffer_t& chunk);
+        void append_body_chunk(core::IoBuffer chunk);
         void finish_chunked_body();
         
         string body_as_string() const;
         
+        // Strings are taken as already-serialized JSON; anything else goes through
+        // json::write_value straight into the body, in one allocation when the
+        // estimate holds and in pooled blocks past json::STREAMING_THRESHOLD
         template<typename T>
         void set_json_body(const T& data);
         
@@ -86,6 +102,8 @@ namespace http_framework::http {
         
         string to_string() const;
         buffer_t to_buffer() const;
+        // Head in a pooled block followed by the body's slices, shared rather than copied
+        core::IoBuffer to_io_buffer() const;
         static Response from_string(string_view data);
         
         void reset();
@@ -122,6 +140,7 @@ namespace http_framework::http {
         vector<HttpHeader> headers_;
         vector<HttpCookie> cookies_;
         buffer_t body_;
+        core::IoBuffer body_chain_;
         CompressionType compression_type_{CompressionType::NONE};
         bool chunked_{false};
         bool headers_sent_{false};
@@ -129,6 +148,7 @@ namespace http_framework::http {
         hash_map<string, variant<string, int64_t, double, bool>> attributes_;
         
         string normalize_header_name(string_view name) const;
+        string format_head() const;
         string get_status_message(status_code_t code) const;
         buffer_t compress_body(const buffer_t& data, CompressionType type) const;
         string format_timestamp(timestamp_t ts) const;
@@ -136,14 +156,35 @@ namespace http_framework::http {
         void add_default_headers();
     };
     
+    template<typename T>
+    void Response::set_json_body(const T& data) {
+        if constexpr (std::is_convertible_v<const T&, string_view>) {
+            set_body(string_view(data));
+        } else {
+            auto estimate = json::estimate_size(data);
+            body_.clear();
+            body_chain_.clear();
+            chunked_ = false;
+            if (estimate > json::STREAMING_THRESHOLD) {
+                json::Writer writer(body_chain_);
+                json::write_value(writer, data);
+            } else {
+                json::Writer writer(body_, estimate);
+                json::write_value(writer, data);
+            }
+            update_content_length();
+        }
+        set_content_type("application/json");
+    }
+    
     template<typename T>
     void Response::set_attribute(string_view name, T&& value) {
-        attributes_[string(name)] = std::forward<T>(value);
+        attributes_[name] = std::forward<T>(value);
     }
     
     template<typename T>
     optional<T> Response::get_attribute(string_view name) const {
-        auto it = attributes_.find(string(name));
+        auto it = attributes_.find(name);
         if (it == attributes_.end()) {
             return std::nullopt;
         }
@@ -8,6 +8,9 @@
 #include "http/response.hpp"
 #include "http/router.hpp"
 #include "http/middleware.hpp"
+#include "http/access_log.hpp"
+#include "json/parser.hpp"
+#include "json/writer.hpp"
 #include "websocket/websocket.hpp"
 #include "utils/logger.hpp"
 #include "utils/config.hpp"
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "core/types.hpp"
+#include <tuple>
+
+namespace http_framework::json {
+    // One JSON member bound to a data member
+    template<typename Class, typename Member>
+    struct Field {
+        using class_type = Class;
+        using member_type = Member;
+        
+        string_view name;
+        Member Class::*member;
+    };
+    
+    template<typename Class, typename Member>
+    constexpr Field<Class, Member> field(string_view name, Member Class::*member) noexcept {
+        return {name, member};
+    }
+    
+    // Specialize with a constexpr tuple of fields, in the order they are written:
+    //
+    //     template<>
+    //     struct json::Fields<User> {
+    //         static constexpr auto value = std::make_tuple(
+    //             json::field("id", &User::id),
+    //             json::field("name", &User::name));
+    //     };
+    //
+    // The parser and writer both walk this list, so no tree is built either way.
+    template<typename T>
+    struct Fields;
+    
+    template<typename T>
+    concept HasFields = requires { Fields<T>::value; };
+    
+    // Calls func(field) for each declared field of T, in order
+    template<typename T, typename Func>
+    constexpr void for_each_field(Func&& func) {
+        std::apply([&](const auto&... fields) { (func(fields), ...); }, Fields<T>::value);
+    }
+    
+    template<typename T>
+    inline constexpr size_type field_count = std::tuple_size_v<std::remove_cvref_t<decltype(Fields<T>::value)>>;
+}
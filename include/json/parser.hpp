@@ -0,0 +1,284 @@
+#pragma once
+
+#include "core/types.hpp"
+#include "json/fields.hpp"
+#include <limits>
+
+namespace http_framework::json {
+    enum class Error {
+        NONE,
+        EMPTY,
+        CAPACITY,
+        UNCLOSED_STRING,
+        INVALID_UTF8,
+        CONTROL_CHARACTER,
+        UNEXPECTED_CHARACTER,
+        INVALID_ESCAPE,
+        INVALID_NUMBER,
+        INVALID_LITERAL,
+        INCORRECT_TYPE,
+        NUMBER_OUT_OF_RANGE,
+        DEPTH_EXCEEDED,
+        TRAILING_CONTENT
+    };
+    
+    string_view to_string(Error error) noexcept;
+    
+    // Stage one: a single pass over the input, 64 bytes at a time, that finds every
+    // structural character and string quote outside of strings plus the first byte of
+    // each number and literal. Escapes, string spans and UTF-8 are settled here with
+    // bitmask arithmetic, so stage two only ever looks at the recorded offsets.
+    class StructuralIndex {
+    public:
+        // Offsets are 32-bit and one slot is kept for the end-of-input sentinel
+        static constexpr size_type MAX_DOCUMENT_SIZE = std::numeric_limits<std::uint32_t>::max() - 1;
+        
+        Error build(string_view input);
+        // Ends with input.size() as a sentinel
+        const vector<std::uint32_t>& positions() const noexcept { return positions_; }
+        
+        // The classifier compiled into this build: "avx2", "sse2" or "scalar"
+        static string_view kernel() noexcept;
+        
+    private:
+        vector<std::uint32_t> positions_;
+    };
+    
+    // Stage two: an on-demand cursor over the index. Values are decoded only when read
+    // and skipped values are stepped over by bracket counting, without building a tree.
+    // The first failure is kept in error() and every later call returns false.
+    class Cursor {
+    public:
+        static constexpr size_type MAX_DEPTH = 1024;
+        
+        Cursor(string_view input, const StructuralIndex& index) noexcept
+            : data_(input.data()), size_(input.size()), current_(index.positions().data()) {}
+            
+        // The first character of the current token, or '\0' once every token is consumed
+        char peek() const noexcept { return *current_ < size_ ? data_[*current_] : '\0'; }
+        bool at_end() const noexcept { return *current_ >= size_; }
+        
+        Error error() const noexcept { return error_; }
+        bool ok() const noexcept { return error_ == Error::NONE; }
+        bool fail(Error error) noexcept;
+        
+        bool read_bool(bool& out);
+        bool read_int64(std::int64_t& out);
+        bool read_uint64(std::uint64_t& out);
+        bool read_double(double& out);
+        bool read_string(string& out);
+        // Consumes the token and returns true if it is null; otherwise leaves it in place
+        bool consume_null() noexcept;
+        bool skip_value();
+        
+        // Calls func(string_view key) with the cursor on each member's value; func reads
+        // or skips the value and returns false on failure. Keys without escapes point
+        // into the input.
+        template<typename Func>
+        bool for_each_field(Func&& func);
+        
+        // Calls func() with the cursor on each element
+        template<typename Func>
+        bool for_each_element(Func&& func);
+        
+    private:
+        const char* data_;
+        size_type size_;
+        const std::uint32_t* current_;
+        size_type depth_{0};
+        Error error_{Error::NONE};
+        
+        // Bytes from the current offset up to the next delimiter
+        string_view scalar_token() const noexcept;
+        // Between the quotes of the current string token, which is consumed
+        string_view take_raw_string() noexcept;
+        bool read_key(string_view& key, string& scratch);
+        bool skip_key() noexcept;
+        bool skip_scalar() noexcept;
+        // Fails with INCORRECT_TYPE if the current token starts some other value,
+        // otherwise with UNEXPECTED_CHARACTER
+        bool type_mismatch() noexcept;
+        bool enter() noexcept;
+        bool close_or_next(char close, bool& done) noexcept;
+    };
+    
+    namespace parser_detail {
+        template<typename T>
+        struct is_optional : std::false_type {};
+        template<typename T>
+        struct is_optional<std::optional<T>> : std::true_type {};
+        
+        template<typename T>
+        concept StringMap = requires(T& map, string key) {
+            typename T::mapped_type;
+            map.insert_or_assign(std::move(key), std::declval<typename T::mapped_type>());
+        } && std::is_constructible_v<typename T::key_type, string>;
+        
+        template<typename T>
+        concept Sequence = requires(T& sequence) {
+            typename T::value_type;
+            sequence.clear();
+            sequence.emplace_back();
+        } && !std::is_same_v<T, string>;
+        
+        template<typename>
+        inline constexpr bool unsupported = false;
+    }
+    
+    // Reads the value under the cursor into out. Supported: bool, arithmetic types
+    // (range-checked), string, optional<T> (null resets it), sequences such as vector,
+    // maps keyed by string, and any type with json::Fields. Unknown members are skipped
+    // and members missing from the input leave the destination untouched.
+    template<typename T>
+    bool read_value(Cursor& cursor, T& out) {
+        if constexpr (std::is_same_v<T, bool>) {
+            return cursor.read_bool(out);
+        } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+            std::int64_t value = 0;
+            if (!cursor.read_int64(value)) {
+                return false;
+            }
+            if (value < std::numeric_limits<T>::min() || value > std::numeric_limits<T>::max()) {
+                return cursor.fail(Error::NUMBER_OUT_OF_RANGE);
+            }
+            out = static_cast<T>(value);
+            return true;
+        } else if constexpr (std::is_integral_v<T>) {
+            std::uint64_t value = 0;
+            if (!cursor.read_uint64(value)) {
+                return false;
+            }
+            if (value > std::numeric_limits<T>::max()) {
+                return cursor.fail(Error::NUMBER_OUT_OF_RANGE);
+            }
+            out = static_cast<T>(value);
+            return true;
+        } else if constexpr (std::is_floating_point_v<T>) {
+            double value = 0.0;
+            if (!cursor.read_double(value)) {
+                return false;
+            }
+            out = static_cast<T>(value);
+            return true;
+        } else if constexpr (std::is_same_v<T, string>) {
+            return cursor.read_string(out);
+        } else if constexpr (parser_detail::is_optional<T>::value) {
+            if (cursor.consume_null()) {
+                out.reset();
+                return true;
+            }
+            return read_value(cursor, out ? *out : out.emplace());
+        } else if constexpr (HasFields<T>) {
+            return cursor.for_each_field([&](string_view key) {
+                bool matched = false;
+                bool read = false;
+                std::apply([&](const auto&... fields) {
+                    ((!matched && fields.name == key ? (matched = true, read = read_value(cursor, out.*(fields.member))) : false), ...);
+                }, Fields<T>::value);
+                return matched ? read : cursor.skip_value();
+            });
+        } else if constexpr (parser_detail::StringMap<T>) {
+            out.clear();
+            return cursor.for_each_field([&](string_view key) {
+                typename T::mapped_type value{};
+                if (!read_value(cursor, value)) {
+                    return false;
+                }
+                out.insert_or_assign(string(key), std::move(value));
+                return true;
+            });
+        } else if constexpr (parser_detail::Sequence<T>) {
+            out.clear();
+            return cursor.for_each_element([&] {
+                if constexpr (std::is_same_v<typename T::value_type, bool>) {
+                    bool value = false;
+                    if (!cursor.read_bool(value)) {
+                        return false;
+                    }
+                    out.push_back(value);
+                    return true;
+                } else {
+                    return read_value(cursor, out.emplace_back());
+                }
+            });
+        } else {
+            static_assert(parser_detail::unsupported<T>, "No JSON binding for this type; specialize json::Fields");
+        }
+    }
+    
+    // Reused per thread, so steady-state parsing does not allocate for the index
+    StructuralIndex& thread_index();
+    
+    // Parses a complete document into out
+    template<typename T>
+    Error parse_into(string_view input, T& out) {
+        auto& index = thread_index();
+        auto error = index.build(input);
+        if (error != Error::NONE) {
+            return error;
+        }
+        
+        Cursor cursor(input, index);
+        if (!read_value(cursor, out)) {
+            return cursor.ok() ? Error::UNEXPECTED_CHARACTER : cursor.error();
+        }
+        return cursor.at_end() ? Error::NONE : Error::TRAILING_CONTENT;
+    }
+    
+    template<typename T>
+    optional<T> parse(string_view input) {
+        T value{};
+        if (parse_into(input, value) != Error::NONE) {
+            return std::nullopt;
+        }
+        return value;
+    }
+    
+    template<typename Func>
+    bool Cursor::for_each_field(Func&& func) {
+        if (peek() != '{') {
+            return type_mismatch();
+        }
+        if (!enter()) {
+            return false;
+        }
+        if (peek() == '}') {
+            ++current_;
+            --depth_;
+            return true;
+        }
+        
+        string scratch;
+        bool done = false;
+        while (!done) {
+            string_view key;
+            if (!read_key(key, scratch) || !func(key) || !close_or_next('}', done)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    
+    template<typename Func>
+    bool Cursor::for_each_element(Func&& func) {
+        if (peek() != '[') {
+            return type_mismatch();
+        }
+        if (!enter()) {
+            return false;
+        }
+        if (peek() == ']') {
+            ++current_;
+            --depth_;
+            return true;
+        }
+        
+        bool done = false;
+        while (!done) {
+            if (!func() || !close_or_next(']', done)) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
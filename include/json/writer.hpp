@@ -0,0 +1,238 @@
+#pragma once
+
+#include "core/types.hpp"
+#include "core/io_buffer.hpp"
+#include "json/fields.hpp"
+#include <charconv>
+#include <cstring>
+#include <ranges>
+
+namespace http_framework::json {
+    // Above this estimate, Response::set_json_body writes into pooled IoBuffer blocks
+    // instead of one contiguous body
+    inline constexpr size_type STREAMING_THRESHOLD = 256 * 1024;
+    
+    // Appends JSON tokens to a byte vector, a string or an IoBuffer. Output goes through
+    // a raw cursor into space claimed ahead of time, so each token is a bounds check
+    // and a copy or to_chars call. Separators are the caller's job; write_value below
+    // handles them for whole values. The destination must not be touched until
+    // finish(), which the destructor calls.
+    class Writer {
+    public:
+        // Claims size_hint bytes up front; the vector grows by doubling past that
+        explicit Writer(buffer_t& out, size_type size_hint = 0);
+        explicit Writer(string& out, size_type size_hint = 0);
+        // Fills the tail block and then fresh pooled blocks, never one large allocation
+        explicit Writer(core::IoBuffer& out);
+        Writer(const Writer&) = delete;
+        Writer& operator=(const Writer&) = delete;
+        ~Writer() { finish(); }
+        
+        void null() { raw("null"); }
+        void boolean(bool value) { value ? raw("true") : raw("false"); }
+        
+        template<typename T>
+        void integer(T value) {
+            ensure(24);
+            cursor_ = std::to_chars(cursor_, cursor_ + 24, value).ptr;
+        }
+        
+        // Shortest round-trip form; NaN and infinities have no JSON spelling and become null
+        void number(double value);
+        // Quoted, with '"', '\\' and control characters escaped; other bytes pass through
+        void string_value(string_view value);
+        // A member name known not to need escaping, with its quotes and colon
+        void key(string_view name) {
+            ensure(name.size() + 3);
+            *cursor_++ = '"';
+            std::memcpy(cursor_, name.data(), name.size());
+            cursor_ += name.size();
+            *cursor_++ = '"';
+            *cursor_++ = ':';
+        }
+        
+        void put(char c) {
+            ensure(1);
+            *cursor_++ = c;
+        }
+        
+        void raw(string_view text) {
+            ensure(text.size());
+            std::memcpy(cursor_, text.data(), text.size());
+            cursor_ += text.size();
+        }
+        
+        // Gives back the unused claimed space; further writes are an error
+        void finish();
+        
+    private:
+        enum class Target { VECTOR, STRING, CHAIN };
+        
+        Target target_;
+        void* out_;
+        char* begin_{nullptr};
+        char* cursor_{nullptr};
+        char* limit_{nullptr};
+        size_type base_{0};
+        bool finished_{false};
+        
+        void ensure(size_type bytes) {
+            if (static_cast<size_type>(limit_ - cursor_) < bytes) {
+                grow(bytes);
+            }
+        }
+        void grow(size_type bytes);
+    };
+    
+    namespace writer_detail {
+        template<typename T>
+        struct is_optional : std::false_type {};
+        template<typename T>
+        struct is_optional<std::optional<T>> : std::true_type {};
+        
+        template<typename T>
+        struct is_variant : std::false_type {};
+        template<typename... Types>
+        struct is_variant<std::variant<Types...>> : std::true_type {};
+        
+        template<typename T>
+        concept StringLike = std::is_convertible_v<const T&, string_view>;
+        
+        template<typename T>
+        concept StringMap = std::ranges::input_range<const T> && requires {
+            typename T::key_type;
+            typename T::mapped_type;
+        } && std::is_convertible_v<const typename T::key_type&, string_view>;
+        
+        template<typename>
+        inline constexpr bool unsupported = false;
+    }
+    
+    // Writes value as JSON. Supported: bool, arithmetic types, anything convertible to
+    // string_view, nullptr and std::monostate (null), optional (null when empty),
+    // variant, types with json::Fields, maps keyed by strings and other ranges.
+    template<typename T>
+    void write_value(Writer& writer, const T& value) {
+        using namespace writer_detail;
+        
+        if constexpr (std::is_same_v<T, bool>) {
+            writer.boolean(value);
+        } else if constexpr (std::is_integral_v<T>) {
+            writer.integer(value);
+        } else if constexpr (std::is_floating_point_v<T>) {
+            writer.number(static_cast<double>(value));
+        } else if constexpr (std::is_same_v<T, std::nullptr_t> || std::is_same_v<T, std::monostate> ||
+                             std::is_same_v<T, std::nullopt_t>) {
+            writer.null();
+        } else if constexpr (StringLike<T>) {
+            writer.string_value(string_view(value));
+        } else if constexpr (is_optional<T>::value) {
+            if (value) {
+                write_value(writer, *value);
+            } else {
+                writer.null();
+            }
+        } else if constexpr (is_variant<T>::value) {
+            std::visit([&](const auto& alternative) { write_value(writer, alternative); }, value);
+        } else if constexpr (HasFields<T>) {
+            writer.put('{');
+            bool first = true;
+            for_each_field<T>([&](const auto& field) {
+                if (!first) {
+                    writer.put(',');
+                }
+                first = false;
+                writer.key(field.name);
+                write_value(writer, value.*(field.member));
+            });
+            writer.put('}');
+        } else if constexpr (StringMap<T>) {
+            writer.put('{');
+            bool first = true;
+            for (const auto& [key, mapped] : value) {
+                if (!first) {
+                    writer.put(',');
+                }
+                first = false;
+                writer.string_value(string_view(key));
+                writer.put(':');
+                write_value(writer, mapped);
+            }
+            writer.put('}');
+        } else if constexpr (std::ranges::input_range<const T>) {
+            writer.put('[');
+            bool first = true;
+            for (const auto& element : value) {
+                if (!first) {
+                    writer.put(',');
+                }
+                first = false;
+                write_value(writer, element);
+            }
+            writer.put(']');
+        } else {
+            static_assert(writer_detail::unsupported<T>, "No JSON binding for this type; specialize json::Fields");
+        }
+    }
+    
+    // An upper bound on the output size for everything except strings that need
+    // escaping, which only cost a regrow. Walks the value without writing anything.
+    template<typename T>
+    size_type estimate_size(const T& value) {
+        using namespace writer_detail;
+        
+        if constexpr (std::is_same_v<T, bool>) {
+            return 5;
+        } else if constexpr (std::is_integral_v<T>) {
+            return 20;
+        } else if constexpr (std::is_floating_point_v<T>) {
+            return 24;
+        } else if constexpr (std::is_same_v<T, std::nullptr_t> || std::is_same_v<T, std::monostate> ||
+                             std::is_same_v<T, std::nullopt_t>) {
+            return 4;
+        } else if constexpr (StringLike<T>) {
+            return string_view(value).size() + 2;
+        } else if constexpr (is_optional<T>::value) {
+            return value ? estimate_size(*value) : 4;
+        } else if constexpr (is_variant<T>::value) {
+            return std::visit([](const auto& alternative) { return estimate_size(alternative); }, value);
+        } else if constexpr (HasFields<T>) {
+            size_type size = 2;
+            for_each_field<T>([&](const auto& field) {
+                size += field.name.size() + 4 + estimate_size(value.*(field.member));
+            });
+            return size;
+        } else if constexpr (StringMap<T>) {
+            size_type size = 2;
+            for (const auto& [key, mapped] : value) {
+                size += string_view(key).size() + 4 + estimate_size(mapped);
+            }
+            return size;
+        } else if constexpr (std::ranges::input_range<const T>) {
+            size_type size = 2;
+            for (const auto& element : value) {
+                size += estimate_size(element) + 1;
+            }
+            return size;
+        } else {
+            static_assert(writer_detail::unsupported<T>, "No JSON binding for this type; specialize json::Fields");
+        }
+    }
+    
+    // Appends value to out, sized from estimate_size so the common case allocates once
+    template<typename T>
+    void serialize_into(buffer_t& out, const T& value) {
+        Writer writer(out, estimate_size(value));
+        write_value(writer, value);
+    }
+    
+    template<typename T>
+    string serialize(const T& value) {
+        string out;
+        {
+            Writer writer(out, estimate_size(value));
+            write_value(writer, value);
+        }
+        return out;
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "core/types.hpp"
+#include "core/request_phases.hpp"
+#include "core/allocation_stats.hpp"
+#include "metrics/registry.hpp"
+
+namespace http_framework::metrics {
+    // Request counts and latency per route, method and status class. Series are created on
+    // first use and cached in atomic slots, so recording takes no lock after warm-up.
+    class HttpServerMetrics {
+    public:
+        static constexpr size_type METHOD_COUNT = 9;
+        static constexpr size_type STATUS_CLASS_COUNT = 5;
+        
+        struct Config {
+            string prefix{"http_server"};
+            HistogramOptions latency;
+            // Phases recorded in nanoseconds, exported in seconds
+            HistogramOptions phase_latency{{0.00001, 0.000025, 0.00005, 0.0001, 0.00025, 0.0005, 0.001,
+                                            0.0025, 0.005, 0.01, 0.025, 0.1, 1.0}, 1e-9};
+            // Per-request allocation counts and bytes; only registered when allocation tracking is compiled in
+            HistogramOptions allocations{{0, 1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 5000}, 1.0};
+            HistogramOptions allocated_bytes{{256, 1024, 4096, 16384, 65536, 262144, 1048576, 4194304}, 1.0};
+            // Paths beyond this many are folded into other_route_label to bound cardinality
+            size_type max_routes{256};
+            string other_route_label{"other"};
+        };
+        
+        struct RouteMetrics {
+            string route;
+            array<atomic<Counter*>, METHOD_COUNT * STATUS_CLASS_COUNT> requests{};
+            array<atomic<Histogram*>, METHOD_COUNT> latency{};
+            array<atomic<Histogram*>, core::PHASE_COUNT> phases{};
+            atomic<Histogram*> allocations{nullptr};
+            atomic<Histogram*> allocated_bytes{nullptr};
+            array<atomic<Counter*>, core::PHASE_COUNT> phase_allocations{};
+            
+            explicit RouteMetrics(string_view name) : route(name) {}
+        };
+        
+        explicit HttpServerMetrics(Registry& registry);
+        HttpServerMetrics(Registry& registry, Config config);
+        HttpServerMetrics(const HttpServerMetrics&) = delete;
+        HttpServerMetrics& operator=(const HttpServerMetrics&) = delete;
+        
+        // Registers a route label up front; returns the fallback once max_routes is reached
+        RouteMetrics& register_route(string_view route);
+        // Lock-free lookup of a registered route, or the fallback for unknown paths
+        RouteMetrics& route(string_view route) noexcept;
+        
+        void record(RouteMetrics& route, HttpMethod method, status_code_t status, std::uint64_t duration_us);
+        void record(string_view route, HttpMethod method, status_code_t status, std::uint64_t duration_us) {
+            record(this->route(route), method, status, duration_us);
+        }
+        void record_phases(RouteMetrics& route, const core::RequestPhases& phases);
+        // No-op unless built with HTTP_FRAMEWORK_ALLOCATION_TRACKING
+        void record_allocations(RouteMetrics& route, const core::RequestAllocations& allocations);
+        
+        const Config& config() const noexcept { return config_; }
+        
+    private:
+        Config config_;
+        CounterFamily* requests_;
+        HistogramFamily* latency_;
+        HistogramFamily* phases_;
+        HistogramFamily* allocations_{nullptr};
+        HistogramFamily* allocated_bytes_{nullptr};
+        CounterFamily* phase_allocations_{nullptr};
+        
+        mutex routes_mutex_;
+        vector<unique_ptr<RouteMetrics>> routes_;
+        unique_ptr<atomic<RouteMetrics*>[]> table_;
+        size_type table_mask_;
+        RouteMetrics other_;
+        
+        Counter& resolve_counter(RouteMetrics& route, size_type method, size_type status_class);
+        Histogram& resolve_histogram(RouteMetrics& route, size_type method);
+        Histogram& resolve_phase(RouteMetrics& route, core::Phase phase);
+        Counter& resolve_phase_allocations(RouteMetrics& route, core::Phase phase);
+    };
+}
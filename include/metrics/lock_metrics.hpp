@@ -0,0 +1,10 @@
+#pragma once
+
+#include "core/types.hpp"
+
+namespace http_framework::metrics {
+    // Appends Prometheus text for every lock site: acquisitions, contended acquisitions,
+    // a wait-time histogram with power-of-two nanosecond bounds, and total and maximum
+    // hold time. Appends nothing unless HTTP_FRAMEWORK_LOCK_PROFILING is enabled.
+    void render_lock_metrics(string& out, string_view prefix = "http_server");
+}
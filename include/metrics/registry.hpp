@@ -0,0 +1,252 @@
+#pragma once
+
+#include "core/types.hpp"
+#include <bit>
+#include <initializer_list>
+#include <map>
+#include <stdexcept>
+
+namespace http_framework::metrics {
+    inline constexpr size_type COUNTER_SHARDS = 16;
+    inline constexpr size_type HISTOGRAM_SHARDS = 8;
+    
+    size_type assign_shard() noexcept;
+    
+    // Threads are spread round-robin over shards so concurrent updates rarely share a cache line
+    inline size_type shard_index() noexcept {
+        thread_local const size_type index = assign_shard();
+        return index;
+    }
+    
+    class Counter {
+    public:
+        void increment(std::uint64_t amount = 1) noexcept {
+            shards_[shard_index() % COUNTER_SHARDS].value.fetch_add(amount, std::memory_order_relaxed);
+        }
+        
+        std::uint64_t value() const noexcept;
+        
+    private:
+        struct alignas(64) Cell {
+            atomic<std::uint64_t> value{0};
+        };
+        
+        array<Cell, COUNTER_SHARDS> shards_;
+    };
+    
+    class Gauge {
+    public:
+        void set(double value) noexcept { value_.store(value, std::memory_order_relaxed); }
+        void add(double delta) noexcept { value_.fetch_add(delta, std::memory_order_relaxed); }
+        void increment() noexcept { add(1.0); }
+        void decrement() noexcept { add(-1.0); }
+        double value() const noexcept { return value_.load(std::memory_order_relaxed); }
+        
+    private:
+        atomic<double> value_{0.0};
+    };
+    
+    // Log-linear histogram over unsigned integers: 2^SUB_BUCKET_BITS buckets per power of two,
+    // so any recorded value lands in a bucket within 12.5% of it
+    class Histogram {
+    public:
+        static constexpr std::uint32_t SUB_BUCKET_BITS = 3;
+        static constexpr std::uint32_t MAX_VALUE_BITS = 40;
+        static constexpr size_type SUB_BUCKET_COUNT = size_type{1} << SUB_BUCKET_BITS;
+        static constexpr size_type BUCKET_COUNT = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) << SUB_BUCKET_BITS;
+        
+        struct Snapshot {
+            array<std::uint64_t, BUCKET_COUNT> counts{};
+            std::uint64_t count{0};
+            std::uint64_t sum{0};
+            
+            std::uint64_t count_at_or_below(std::uint64_t bound) const noexcept;
+            std::uint64_t quantile(double q) const noexcept;
+        };
+        
+        Histogram();
+        
+        void record(std::uint64_t value) noexcept {
+            auto& shard = shards_[shard_index() % HISTOGRAM_SHARDS];
+            shard.counts[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+            shard.sum.fetch_add(value, std::memory_order_relaxed);
+        }
+        
+        Snapshot snapshot() const;
+        
+        static constexpr size_type bucket_index(std::uint64_t value) noexcept {
+            if (value < SUB_BUCKET_COUNT) {
+                return static_cast<size_type>(value);
+            }
+            auto msb = static_cast<std::uint32_t>(std::bit_width(value)) - 1;
+            if (msb >= MAX_VALUE_BITS) {
+                return BUCKET_COUNT - 1;
+            }
+            auto shift = msb - SUB_BUCKET_BITS;
+            auto sub_bucket = static_cast<size_type>((value >> shift) & (SUB_BUCKET_COUNT - 1));
+            return ((static_cast<size_type>(shift) + 1) << SUB_BUCKET_BITS) + sub_bucket;
+        }
+        
+        // Largest value that maps to the bucket
+        static constexpr std::uint64_t bucket_upper_bound(size_type index) noexcept {
+            if (index < SUB_BUCKET_COUNT) {
+                return index;
+            }
+            if (index >= BUCKET_COUNT - 1) {
+                return ~std::uint64_t{0};
+            }
+            auto shift = (index >> SUB_BUCKET_BITS) - 1;
+            auto lower = static_cast<std::uint64_t>(SUB_BUCKET_COUNT + (index & (SUB_BUCKET_COUNT - 1))) << shift;
+            return lower + (std::uint64_t{1} << shift) - 1;
+        }
+        
+    private:
+        struct alignas(64) Shard {
+            array<atomic<std::uint64_t>, BUCKET_COUNT> counts;
+            atomic<std::uint64_t> sum{0};
+        };
+        
+        unique_ptr<Shard[]> shards_;
+    };
+    
+    struct HistogramOptions {
+        // Exposed bucket boundaries, in the exported unit
+        vector<double> bounds{0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0};
+        // Multiplier from recorded integers to the exported unit; the default turns microseconds into seconds
+        double scale{1e-6};
+    };
+    
+    enum class MetricType : std::uint8_t {
+        COUNTER = 0,
+        GAUGE = 1,
+        HISTOGRAM = 2
+    };
+    
+    // All series of one metric name. Label values are resolved to a series once, at
+    // registration; callers keep the returned reference and update it without locks.
+    template<typename Metric>
+    class MetricFamily {
+    public:
+        MetricFamily(string_view name, string_view help, vector<string> label_names)
+            : name_(name), help_(help), label_names_(std::move(label_names)) {}
+            
+        const string& name() const noexcept { return name_; }
+        const string& help() const noexcept { return help_; }
+        const vector<string>& label_names() const noexcept { return label_names_; }
+        
+        Metric& with(std::initializer_list<string_view> label_values);
+        Metric& with(const vector<string>& label_values);
+        
+        template<typename Func>
+        void for_each(Func&& func) const;
+        
+    private:
+        string name_;
+        string help_;
+        vector<string> label_names_;
+        mutable mutex series_mutex_;
+        vector<std::pair<string, unique_ptr<Metric>>> series_;
+        
+        Metric& resolve(string labels);
+        string render_labels(const string_view* values, size_type count) const;
+    };
+    
+    using CounterFamily = MetricFamily<Counter>;
+    using GaugeFamily = MetricFamily<Gauge>;
+    using HistogramFamily = MetricFamily<Histogram>;
+    
+    class Registry {
+    public:
+        Registry() = default;
+        Registry(const Registry&) = delete;
+        Registry& operator=(const Registry&) = delete;
+        
+        static Registry& instance();
+        
+        // Registering an existing name returns the existing family; a type clash throws
+        CounterFamily& counter_family(string_view name, string_view help, vector<string> label_names = {});
+        GaugeFamily& gauge_family(string_view name, string_view help, vector<string> label_names = {});
+        HistogramFamily& histogram_family(string_view name, string_view help, vector<string> label_names = {},
+                                          HistogramOptions options = {});
+                                          
+        Counter& counter(string_view name, string_view help) { return counter_family(name, help).with({}); }
+        Gauge& gauge(string_view name, string_view help) { return gauge_family(name, help).with({}); }
+        Histogram& histogram(string_view name, string_view help, HistogramOptions options = {}) {
+            return histogram_family(name, help, {}, std::move(options)).with({});
+        }
+        
+        // Sampled when the registry is rendered, for values owned elsewhere
+        void callback_gauge(string_view name, string_view help, function<double()> callback);
+        
+        // Prometheus text exposition format 0.0.4
+        void render_prometheus(string& out) const;
+        string render_prometheus() const;
+        
+    private:
+        struct Entry {
+            MetricType type;
+            unique_ptr<CounterFamily> counters;
+            unique_ptr<GaugeFamily> gauges;
+            unique_ptr<HistogramFamily> histograms;
+            HistogramOptions histogram_options;
+            string help;
+            function<double()> callback;
+        };
+        
+        mutable mutex registry_mutex_;
+        std::map<string, Entry, std::less<>> entries_;
+        
+        Entry& find_or_create(string_view name, MetricType type);
+    };
+    
+    void append_label_value(string& out, string_view value);
+    
+    template<typename Metric>
+    Metric& MetricFamily<Metric>::with(std::initializer_list<string_view> label_values) {
+        return resolve(render_labels(label_values.begin(), label_values.size()));
+    }
+    
+    template<typename Metric>
+    Metric& MetricFamily<Metric>::with(const vector<string>& label_values) {
+        vector<string_view> views(label_values.begin(), label_values.end());
+        return resolve(render_labels(views.data(), views.size()));
+    }
+    
+    template<typename Metric>
+    template<typename Func>
+    void MetricFamily<Metric>::for_each(Func&& func) const {
+        lock_guard lock(series_mutex_);
+        for (const auto& [labels, metric] : series_) {
+            func(string_view(labels), *metric);
+        }
+    }
+    
+    template<typename Metric>
+    Metric& MetricFamily<Metric>::resolve(string labels) {
+        lock_guard lock(series_mutex_);
+        for (auto& [existing, metric] : series_) {
+            if (existing == labels) {
+                return *metric;
+            }
+        }
+        series_.emplace_back(std::move(labels), std::make_unique<Metric>());
+        return *series_.back().second;
+    }
+    
+    template<typename Metric>
+    string MetricFamily<Metric>::render_labels(const string_view* values, size_type count) const {
+        if (count != label_names_.size()) {
+            throw std::invalid_argument("metric " + name_ + " expects " + std::to_string(label_names_.size()) + " label values");
+        }
+        
+        string labels;
+        for (size_type i = 0; i < count; ++i) {
+            labels += i == 0 ? "" : ",";
+            labels += label_names_[i];
+            labels += "=\"";
+            append_label_value(labels, values[i]);
+            labels += '"';
+        }
+        return labels;
+    }
+}
@@ -212,7 +212,7 @@ namespace http_framework::patterns {
     private:
         hash_map<StreamId, vector<Event>> streams_;
         vector<Event> all_events_;
-        mutable shared_mutex streams_mutex_;
+        mutable shared_mutex streams_mutex_ HTTP_FRAMEWORK_LOCK_SITE("InMemoryEventStore::streams_mutex_");
         
         hash_map<string, function<async::Task<void>(const Event&)>> subscriptions_;
         mutable mutex subscriptions_mutex_;
@@ -448,17 +448,17 @@ namespace http_framework::patterns {
         
         void add_item(string_view key, T item) {
             unique_lock lock(data_mutex_);
-            data_[string(key)] = std::move(item);
+            data_[key] = std::move(item);
         }
         
         void remove_item(string_view key) {
             unique_lock lock(data_mutex_);
-            data_.erase(string(key));
+            data_.erase(key);
         }
         
         optional<T> get_item(string_view key) const {
             shared_lock lock(data_mutex_);
-            auto it = data_.find(string(key));
+            auto it = data_.find(key);
             return it != data_.end() ? std::make_optional(it->second) : std::nullopt;
         }
         
@@ -0,0 +1,302 @@
+#pragma once
+
+#include "core/types.hpp"
+#include "async/task.hpp"
+#include "async/scheduler.hpp"
+#include "resilience/call_result.hpp"
+#include <coroutine>
+
+namespace http_framework::resilience {
+    enum class QueueDiscipline : std::uint8_t {
+        FIFO = 0,
+        LIFO = 1
+    };
+    
+    enum class PermitStatus : std::uint8_t {
+        ACQUIRED = 0,
+        REJECTED = 1,
+        TIMED_OUT = 2,
+        SHUTDOWN = 3
+    };
+    
+    struct BulkheadMetrics {
+        static constexpr size_type WAIT_BUCKET_COUNT = 12;
+        static constexpr array<std::uint64_t, WAIT_BUCKET_COUNT - 1> WAIT_BUCKET_BOUNDS_US{
+            100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000
+        };
+        
+        size_type max_concurrent_calls{0};
+        size_type available_permits{0};
+        size_type queued_waiters{0};
+        
+        size_type acquired_immediately{0};
+        size_type acquired_after_wait{0};
+        size_type rejected_queue_full{0};
+        size_type timed_out{0};
+        size_type abandoned_entries{0};
+        
+        std::chrono::microseconds total_wait_time{0};
+        std::chrono::microseconds max_wait_time{0};
+        array<size_type, WAIT_BUCKET_COUNT> wait_time_buckets{};
+        
+        std::chrono::microseconds average_wait_time() const noexcept {
+            return acquired_after_wait + timed_out == 0
+                ? std::chrono::microseconds::zero()
+                : total_wait_time / static_cast<std::int64_t>(acquired_after_wait + timed_out);
+        }
+        
+        string to_json() const;
+    };
+    
+    class AsyncBulkhead {
+        struct WaitNode;
+        
+    public:
+        struct Config {
+            size_type max_concurrent_calls{10};
+            size_type max_queue_size{50};
+            duration_t max_wait_duration{std::chrono::milliseconds(1000)};
+            QueueDiscipline discipline{QueueDiscipline::FIFO};
+            // Resumes granted, timed-out and cancelled waiters and runs wait deadlines;
+            // null uses Scheduler::shared()
+            async::Scheduler* scheduler{nullptr};
+        };
+        
+        class Permit {
+        public:
+            Permit() = default;
+            Permit(const Permit&) = delete;
+            Permit& operator=(const Permit&) = delete;
+            Permit(Permit&& other) noexcept
+                : bulkhead_(std::exchange(other.bulkhead_, nullptr)), status_(other.status_), wait_time_(other.wait_time_) {}
+            Permit& operator=(Permit&& other) noexcept {
+                if (this != &other) {
+                    release();
+                    bulkhead_ = std::exchange(other.bulkhead_, nullptr);
+                    status_ = other.status_;
+                    wait_time_ = other.wait_time_;
+                }
+                return *this;
+            }
+            ~Permit() { release(); }
+            
+            explicit operator bool() const noexcept { return bulkhead_ != nullptr; }
+            PermitStatus status() const noexcept { return status_; }
+            std::chrono::microseconds wait_time() const noexcept { return wait_time_; }
+            
+            void release() noexcept;
+            
+        private:
+            AsyncBulkhead* bulkhead_{nullptr};
+            PermitStatus status_{PermitStatus::REJECTED};
+            std::chrono::microseconds wait_time_{0};
+            
+            Permit(AsyncBulkhead* bulkhead, PermitStatus status, std::chrono::microseconds wait_time)
+                : bulkhead_(bulkhead), status_(status), wait_time_(wait_time) {}
+                
+            friend class AsyncBulkhead;
+        };
+        
+        class AcquireAwaiter {
+        public:
+            bool await_ready();
+            bool await_suspend(std::coroutine_handle<> handle);
+            Permit await_resume();
+            
+        private:
+            AsyncBulkhead& bulkhead_;
+            timestamp_t deadline_;
+            shared_ptr<WaitNode> node_;
+            PermitStatus immediate_status_{PermitStatus::ACQUIRED};
+            
+            AcquireAwaiter(AsyncBulkhead& bulkhead, timestamp_t deadline) : bulkhead_(bulkhead), deadline_(deadline) {}
+            
+            friend class AsyncBulkhead;
+        };
+        
+        explicit AsyncBulkhead(string_view name);
+        AsyncBulkhead(string_view name, Config config);
+        AsyncBulkhead(const AsyncBulkhead&) = delete;
+        AsyncBulkhead(AsyncBulkhead&&) = delete;
+        AsyncBulkhead& operator=(const AsyncBulkhead&) = delete;
+        AsyncBulkhead& operator=(AsyncBulkhead&&) = delete;
+        ~AsyncBulkhead();
+        
+        AcquireAwaiter acquire();
+        AcquireAwaiter acquire(duration_t max_wait);
+        AcquireAwaiter acquire_until(timestamp_t deadline);
+        Permit try_acquire();
+        
+        template<typename F>
+        auto execute(F&& func) -> async::Task<CallResult<std::invoke_result_t<F>>>;
+        
+        template<typename F>
+        auto execute_async(F&& func) -> async::Task<CallResult<typename std::invoke_result_t<F>::value_type>>;
+        
+        const string& name() const noexcept { return name_; }
+        const Config& config() const noexcept { return config_; }
+        
+        size_type available_permits() const noexcept;
+        size_type active_calls() const noexcept { return config_.max_concurrent_calls - available_permits(); }
+        size_type queued_calls() const noexcept { return waiting_.load(std::memory_order_relaxed); }
+        
+        BulkheadMetrics metrics() const;
+        void reset_metrics();
+        
+    private:
+        enum class WaitState : std::uint8_t {
+            WAITING = 0,
+            GRANTED = 1,
+            TIMED_OUT = 2,
+            CANCELLED = 3
+        };
+        
+        struct WaitNode {
+            static constexpr std::uint64_t TIMER_DISARMED = ~std::uint64_t{0};
+            
+            std::coroutine_handle<> handle;
+            atomic<WaitState> state{WaitState::WAITING};
+            timestamp_t enqueued_at;
+            timestamp_t deadline;
+            // Scheduler timer sequence: 0 until armed, TIMER_DISARMED once the waiter
+            // no longer needs it
+            atomic<std::uint64_t> timer_sequence{0};
+        };
+        
+        // Shared with pending deadline timers so they can tell the bulkhead is gone
+        struct Lifetime {
+            mutex guard;
+            AsyncBulkhead* owner;
+        };
+        
+        class WaitQueue {
+        public:
+            WaitQueue(size_type capacity, QueueDiscipline discipline);
+            
+            bool try_push(shared_ptr<WaitNode> node);
+            shared_ptr<WaitNode> try_pop();
+            size_type size() const noexcept;
+            
+        private:
+            struct RingCell {
+                atomic<size_type> sequence{0};
+                shared_ptr<WaitNode> node;
+            };
+            
+            struct StackCell {
+                atomic<std::uint32_t> next{0};
+                shared_ptr<WaitNode> node;
+            };
+            
+            QueueDiscipline discipline_;
+            size_type capacity_;
+            atomic<ssize_type> size_{0};
+            
+            size_type ring_mask_{0};
+            unique_ptr<RingCell[]> ring_;
+            alignas(64) atomic<size_type> enqueue_pos_{0};
+            alignas(64) atomic<size_type> dequeue_pos_{0};
+            
+            unique_ptr<StackCell[]> stack_;
+            alignas(64) atomic<std::uint64_t> stack_head_{0};
+            alignas(64) atomic<std::uint64_t> free_head_{0};
+            
+            bool ring_push(shared_ptr<WaitNode>& node);
+            shared_ptr<WaitNode> ring_pop();
+            
+            static std::uint32_t tagged_index(std::uint64_t tagged) noexcept { return static_cast<std::uint32_t>(tagged); }
+            static std::uint64_t make_tagged(std::uint64_t previous, std::uint32_t index) noexcept {
+                return ((previous >> 32) + 1) << 32 | index;
+            }
+            std::uint32_t pop_index(atomic<std::uint64_t>& head);
+            void push_index(atomic<std::uint64_t>& head, std::uint32_t index);
+        };
+        
+        string name_;
+        Config config_;
+        alignas(64) atomic<ssize_type> available_;
+        alignas(64) atomic<size_type> waiting_{0};
+        WaitQueue wait_queue_;
+        
+        // Live waiters that compaction could not put back into wait_queue_
+        mutex overflow_mutex_;
+        deque<shared_ptr<WaitNode>> overflow_;
+        atomic<size_type> overflow_size_{0};
+        
+        async::Scheduler& scheduler_;
+        shared_ptr<Lifetime> lifetime_;
+        
+        atomic<size_type> acquired_immediately_{0};
+        atomic<size_type> acquired_after_wait_{0};
+        atomic<size_type> rejected_queue_full_{0};
+        atomic<size_type> timed_out_{0};
+        atomic<size_type> abandoned_entries_{0};
+        atomic<std::uint64_t> total_wait_us_{0};
+        atomic<std::uint64_t> max_wait_us_{0};
+        array<atomic<size_type>, BulkheadMetrics::WAIT_BUCKET_COUNT> wait_buckets_{};
+        
+        bool try_take_permit() noexcept;
+        void release_permit() noexcept;
+        void dispatch_waiters() noexcept;
+        bool transition(WaitNode& node, WaitState target) noexcept;
+        bool grant(const shared_ptr<WaitNode>& node, WaitState target) noexcept;
+        
+        bool enqueue_waiter(const shared_ptr<WaitNode>& node);
+        shared_ptr<WaitNode> pop_waiter();
+        shared_ptr<WaitNode> pop_overflow();
+        void compact_wait_queue();
+        void schedule_deadline(const shared_ptr<WaitNode>& node);
+        void disarm_deadline(WaitNode& node) noexcept;
+        void expire(const shared_ptr<WaitNode>& node) noexcept;
+        void cancel_all_waiters();
+        
+        void record_wait(std::chrono::microseconds wait_time) noexcept;
+        static std::chrono::microseconds elapsed_since(timestamp_t start) noexcept;
+    };
+    
+    template<typename F>
+    auto AsyncBulkhead::execute(F&& func) -> async::Task<CallResult<std::invoke_result_t<F>>> {
+        using ReturnType = std::invoke_result_t<F>;
+        
+        auto permit = co_await acquire();
+        if (!permit) {
+            co_return CallResult<ReturnType>::failure(
+                FailureType::BULKHEAD_FULL,
+                permit.status() == PermitStatus::TIMED_OUT ? "Bulkhead wait deadline exceeded" : "Bulkhead is full");
+        }
+        
+        try {
+            if constexpr (std::is_void_v<ReturnType>) {
+                func();
+                co_return CallResult<ReturnType>::succeeded();
+            } else {
+                co_return CallResult<ReturnType>::succeeded(func());
+            }
+        } catch (const std::exception& e) {
+            co_return CallResult<ReturnType>::failure(FailureType::EXCEPTION, e.what());
+        }
+    }
+    
+    template<typename F>
+    auto AsyncBulkhead::execute_async(F&& func) -> async::Task<CallResult<typename std::invoke_result_t<F>::value_type>> {
+        using ReturnType = typename std::invoke_result_t<F>::value_type;
+        
+        auto permit = co_await acquire();
+        if (!permit) {
+            co_return CallResult<ReturnType>::failure(
+                FailureType::BULKHEAD_FULL,
+                permit.status() == PermitStatus::TIMED_OUT ? "Bulkhead wait deadline exceeded" : "Bulkhead is full");
+        }
+        
+        try {
+            if constexpr (std::is_void_v<ReturnType>) {
+                co_await func();
+                co_return CallResult<ReturnType>::succeeded();
+            } else {
+                co_return CallResult<ReturnType>::succeeded(co_await func());
+            }
+        } catch (const std::exception& e) {
+            co_return CallResult<ReturnType>::failure(FailureType::EXCEPTION, e.what());
+        }
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "core/types.hpp"
+
+namespace http_framework::resilience {
+    enum class FailureType : std::uint8_t {
+        TIMEOUT = 0,
+        EXCEPTION = 1,
+        PREDICATE_FAILED = 2,
+        CIRCUIT_OPEN = 3,
+        BULKHEAD_FULL = 4
+    };
+    
+    // Outcome of a call made through a resilience policy. The factories are named
+    // succeeded and failure because success is the flag callers test.
+    template<typename T>
+    struct CallResult {
+        bool success{false};
+        optional<T> value;
+        optional<FailureType> failure_type;
+        duration_t execution_time{duration_t::zero()};
+        string error_message;
+        
+        CallResult() = default;
+        CallResult(T val) : success(true), value(std::move(val)) {}
+        CallResult(FailureType type, string_view msg) : failure_type(type), error_message(msg) {}
+        
+        bool has_value() const noexcept { return success && value.has_value(); }
+        const T& operator*() const { return value.value(); }
+        T& operator*() { return value.value(); }
+        const T* operator->() const { return &value.value(); }
+        T* operator->() { return &value.value(); }
+        
+        static CallResult succeeded(T value) { return CallResult{std::move(value)}; }
+        static CallResult failure(FailureType type, string_view message = "") {
+            return CallResult{type, message};
+        }
+    };
+    
+    template<>
+    struct CallResult<void> {
+        bool success{false};
+        optional<FailureType> failure_type;
+        duration_t execution_time{duration_t::zero()};
+        string error_message;
+        
+        CallResult() = default;
+        CallResult(bool s) : success(s) {}
+        CallResult(FailureType type, string_view msg) : failure_type(type), error_message(msg) {}
+        
+        static CallResult succeeded() { return CallResult{true}; }
+        static CallResult failure(FailureType type, string_view message = "") {
+            return CallResult{type, message};
+        }
+    };
+}
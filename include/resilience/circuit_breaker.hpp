@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core/types.hpp"
+#include "resilience/call_result.hpp"
 #include "async/future.hpp"
 #include "async/task.hpp"
 #include <concepts>
@@ -13,13 +14,6 @@ namespace http_framework::resilience {
         HALF_OPEN = 2
     };
     
-    enum class FailureType : std::uint8_t {
-        TIMEOUT = 0,
-        EXCEPTION = 1,
-        PREDICATE_FAILED = 2,
-        CIRCUIT_OPEN = 3
-    };
-    
     struct CircuitBreakerException : public std::runtime_error {
         FailureType failure_type;
         CircuitState circuit_state;
@@ -44,47 +38,6 @@ namespace http_framework::resilience {
         }
     };
     
-    template<typename T>
-    struct CallResult {
-        bool success{false};
-        optional<T> value;
-        optional<FailureType> failure_type;
-        duration_t execution_time{duration_t::zero()};
-        string error_message;
-        
-        CallResult() = default;
-        CallResult(T val) : success(true), value(std::move(val)) {}
-        CallResult(FailureType type, string_view msg) : failure_type(type), error_message(msg) {}
-        
-        bool has_value() const noexcept { return success && value.has_value(); }
-        const T& operator*() const { return value.value(); }
-        T& operator*() { return value.value(); }
-        const T* operator->() const { return &value.value(); }
-        T* operator->() { return &value.value(); }
-        
-        static CallResult success(T value) { return CallResult{std::move(value)}; }
-        static CallResult failure(FailureType type, string_view message = "") {
-            return CallResult{type, message};
-        }
-    };
-    
-    template<>
-    struct CallResult<void> {
-        bool success{false};
-        optional<FailureType> failure_type;
-        duration_t execution_time{duration_t::zero()};
-        string error_message;
-        
-        CallResult() = default;
-        CallResult(bool s) : success(s) {}
-        CallResult(FailureType type, string_view msg) : failure_type(type), error_message(msg) {}
-        
-        static CallResult success() { return CallResult{true}; }
-        static CallResult failure(FailureType type, string_view message = "") {
-            return CallResult{type, message};
-        }
-    };
-    
     struct CircuitBreakerMetrics {
         CircuitState current_state{CircuitState::CLOSED};
         timestamp_t state_changed_at;
@@ -449,7 +402,7 @@ namespace http_framework::resilience {
                 
                 auto execution_time = std::chrono::steady_clock::now() - start_time;
                 record_success(execution_time);
-                co_return CallResult<ReturnType>::success();
+                co_return CallResult<ReturnType>::succeeded();
             } else {
                 ReturnType result;
                 if (config_.enable_timeout) {
@@ -464,7 +417,7 @@ namespace http_framework::resilience {
                 
                 auto execution_time = std::chrono::steady_clock::now() - start_time;
                 record_success(execution_time);
-                co_return CallResult<ReturnType>::success(std::move(result));
+                co_return CallResult<ReturnType>::succeeded(std::move(result));
             }
         } catch (const std::exception& e) {
             auto execution_time = std::chrono::steady_clock::now() - start_time;
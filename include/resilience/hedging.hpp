@@ -0,0 +1,467 @@
+#pragma once
+
+#include "core/types.hpp"
+#include "async/task.hpp"
+#include "async/scheduler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace http_framework::resilience {
+    class CancellationToken {
+    public:
+        CancellationToken() = default;
+        
+        bool is_cancelled() const noexcept {
+            return state_ && state_->cancelled.load(std::memory_order_acquire);
+        }
+        
+        bool can_be_cancelled() const noexcept { return state_ != nullptr; }
+        
+        void on_cancel(function<void()> callback) const;
+        
+    private:
+        struct State {
+            atomic<bool> cancelled{false};
+            mutex callbacks_mutex;
+            vector<function<void()>> callbacks;
+        };
+        
+        shared_ptr<State> state_;
+        
+        explicit CancellationToken(shared_ptr<State> state) : state_(std::move(state)) {}
+        
+        friend class CancellationSource;
+    };
+    
+    class CancellationSource {
+    public:
+        CancellationSource() : state_(std::make_shared<CancellationToken::State>()) {}
+        
+        CancellationToken token() const { return CancellationToken{state_}; }
+        bool is_cancelled() const noexcept { return state_->cancelled.load(std::memory_order_acquire); }
+        void cancel();
+        
+    private:
+        shared_ptr<CancellationToken::State> state_;
+    };
+    
+    class RetryBudget {
+    public:
+        struct Config {
+            double deposit_per_request{0.1};
+            double min_tokens_per_second{10.0};
+            double max_tokens{100.0};
+        };
+        
+        RetryBudget();
+        explicit RetryBudget(Config config);
+        
+        void record_request() noexcept;
+        bool try_withdraw() noexcept;
+        double available_tokens() const noexcept;
+        
+        size_type requests() const noexcept { return requests_.load(std::memory_order_relaxed); }
+        size_type retries_permitted() const noexcept { return retries_permitted_.load(std::memory_order_relaxed); }
+        size_type retries_throttled() const noexcept { return retries_throttled_.load(std::memory_order_relaxed); }
+        
+        const Config& config() const noexcept { return config_; }
+        
+    private:
+        static constexpr std::int64_t SCALE = 1000;
+        
+        Config config_;
+        std::int64_t max_scaled_;
+        alignas(64) atomic<std::int64_t> scaled_tokens_;
+        alignas(64) atomic<std::int64_t> last_refill_ns_;
+        
+        atomic<size_type> requests_{0};
+        atomic<size_type> retries_permitted_{0};
+        atomic<size_type> retries_throttled_{0};
+        
+        void deposit(std::int64_t scaled) noexcept;
+        void refill() noexcept;
+        static std::int64_t now_ns() noexcept;
+    };
+    
+    class LatencyTracker {
+    public:
+        explicit LatencyTracker(duration_t window = std::chrono::seconds(10));
+        
+        void record(std::chrono::microseconds latency) noexcept;
+        optional<std::chrono::microseconds> percentile(double quantile, size_type min_samples = 1) const noexcept;
+        size_type sample_count() const noexcept;
+        
+    private:
+        static constexpr size_type SUB_BUCKET_BITS = 3;
+        static constexpr size_type SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+        static constexpr size_type BUCKET_COUNT = 40 * SUB_BUCKETS;
+        
+        struct Window {
+            atomic<std::int64_t> epoch{-1};
+            array<atomic<std::uint32_t>, BUCKET_COUNT> buckets{};
+            atomic<std::uint64_t> count{0};
+        };
+        
+        std::int64_t window_ns_;
+        array<Window, 2> windows_;
+        
+        static size_type bucket_for(std::uint64_t micros) noexcept;
+        static std::uint64_t bucket_upper_bound(size_type bucket) noexcept;
+    };
+    
+    struct HedgingMetrics {
+        size_type calls{0};
+        size_type hedges_issued{0};
+        size_type hedges_won{0};
+        size_type hedges_throttled{0};
+        size_type losers_cancelled{0};
+        optional<std::chrono::microseconds> current_hedge_delay;
+    };
+    
+    template<typename T>
+    class HedgingPolicy {
+    public:
+        using AttemptFunction = function<async::Task<T>(const CancellationToken&)>;
+        
+        struct Config {
+            double hedge_quantile{0.95};
+            duration_t initial_hedge_delay{std::chrono::milliseconds(50)};
+            duration_t min_hedge_delay{std::chrono::milliseconds(2)};
+            duration_t max_hedge_delay{std::chrono::seconds(2)};
+            size_type max_hedged_attempts{1};
+            size_type min_samples{100};
+            duration_t latency_window{std::chrono::seconds(10)};
+            // Fires hedge delays and resumes nothing else; null uses Scheduler::shared()
+            async::Scheduler* scheduler{nullptr};
+        };
+        
+        explicit HedgingPolicy(shared_ptr<RetryBudget> budget);
+        HedgingPolicy(shared_ptr<RetryBudget> budget, Config config);
+        
+        async::Task<T> execute(AttemptFunction attempt);
+        async::Task<T> execute(function<async::Task<T>()> attempt);
+        
+        function<async::Task<T>()> wrap(AttemptFunction attempt);
+        
+        duration_t current_hedge_delay() const;
+        HedgingMetrics metrics() const;
+        const Config& config() const noexcept { return core_->config; }
+        
+    private:
+        struct Core {
+            Config config;
+            shared_ptr<RetryBudget> budget;
+            LatencyTracker latency;
+            atomic<size_type> calls{0};
+            atomic<size_type> hedges_issued{0};
+            atomic<size_type> hedges_won{0};
+            atomic<size_type> hedges_throttled{0};
+            atomic<size_type> losers_cancelled{0};
+            
+            Core(Config c, shared_ptr<RetryBudget> b)
+                : config(std::move(c)), budget(std::move(b)), latency(config.latency_window) {}
+                
+            duration_t hedge_delay() const;
+            async::Scheduler& scheduler() const noexcept {
+                return config.scheduler ? *config.scheduler : async::Scheduler::shared();
+            }
+        };
+        
+        struct CallState {
+            async::Completion<T> completion;
+            AttemptFunction attempt;
+            duration_t hedge_delay{};
+            vector<CancellationSource> sources;
+            
+            mutex state_mutex;
+            bool settled{false};
+            size_type outstanding{0};
+            async::Scheduler::TimerId hedge_timer;
+            std::exception_ptr last_exception;
+        };
+        
+        shared_ptr<Core> core_;
+        
+        static void schedule_hedge(const shared_ptr<Core>& core, const shared_ptr<CallState>& state, size_type attempt_index);
+        static void launch_hedge(const shared_ptr<Core>& core, const shared_ptr<CallState>& state, size_type attempt_index);
+        static async::Task<void> watch_attempt(shared_ptr<Core> core, shared_ptr<CallState> state, size_type attempt_index);
+        static bool claim_settlement(const shared_ptr<Core>& core, CallState& state, size_type attempt_index);
+        static void finish_attempt(CallState& state);
+    };
+    
+    template<typename T>
+    class RetryPolicy {
+    public:
+        struct Config {
+            size_type max_attempts{3};
+            duration_t initial_backoff{std::chrono::milliseconds(50)};
+            double backoff_multiplier{2.0};
+            duration_t max_backoff{std::chrono::seconds(2)};
+            bool enable_jitter{true};
+            function<bool(const std::exception&)> retry_predicate;
+            // Runs backoff sleeps; null uses Scheduler::shared()
+            async::Scheduler* scheduler{nullptr};
+        };
+        
+        explicit RetryPolicy(shared_ptr<RetryBudget> budget);
+        RetryPolicy(shared_ptr<RetryBudget> budget, Config config);
+        
+        async::Task<T> execute(function<async::Task<T>()> attempt);
+        function<async::Task<T>()> wrap(function<async::Task<T>()> attempt);
+        
+        const Config& config() const noexcept { return config_; }
+        
+    private:
+        Config config_;
+        shared_ptr<RetryBudget> budget_;
+        
+        static async::Task<T> run(RetryPolicy policy, function<async::Task<T>()> attempt);
+        duration_t backoff_for(size_type retry, std::mt19937& rng) const;
+        bool should_retry(std::exception_ptr error) const;
+    };
+    
+    template<typename T>
+    HedgingPolicy<T>::HedgingPolicy(shared_ptr<RetryBudget> budget) : HedgingPolicy(std::move(budget), Config{}) {}
+    
+    template<typename T>
+    HedgingPolicy<T>::HedgingPolicy(shared_ptr<RetryBudget> budget, Config config)
+        : core_(std::make_shared<Core>(std::move(config), budget ? std::move(budget) : std::make_shared<RetryBudget>())) {}
+        
+    template<typename T>
+    duration_t HedgingPolicy<T>::Core::hedge_delay() const {
+        auto observed = latency.percentile(config.hedge_quantile, config.min_samples);
+        if (!observed) {
+            return config.initial_hedge_delay;
+        }
+        auto delay = std::chrono::ceil<duration_t>(*observed);
+        return std::clamp(delay, config.min_hedge_delay, config.max_hedge_delay);
+    }
+    
+    template<typename T>
+    duration_t HedgingPolicy<T>::current_hedge_delay() const {
+        return core_->hedge_delay();
+    }
+    
+    template<typename T>
+    HedgingMetrics HedgingPolicy<T>::metrics() const {
+        HedgingMetrics snapshot;
+        snapshot.calls = core_->calls.load(std::memory_order_relaxed);
+        snapshot.hedges_issued = core_->hedges_issued.load(std::memory_order_relaxed);
+        snapshot.hedges_won = core_->hedges_won.load(std::memory_order_relaxed);
+        snapshot.hedges_throttled = core_->hedges_throttled.load(std::memory_order_relaxed);
+        snapshot.losers_cancelled = core_->losers_cancelled.load(std::memory_order_relaxed);
+        snapshot.current_hedge_delay = core_->latency.percentile(core_->config.hedge_quantile, core_->config.min_samples);
+        return snapshot;
+    }
+    
+    template<typename T>
+    async::Task<T> HedgingPolicy<T>::execute(function<async::Task<T>()> attempt) {
+        return execute([attempt = std::move(attempt)](const CancellationToken&) { return attempt(); });
+    }
+    
+    template<typename T>
+    async::Task<T> HedgingPolicy<T>::execute(AttemptFunction attempt) {
+        auto core = core_;
+        auto state = std::make_shared<CallState>();
+        state->attempt = std::move(attempt);
+        state->hedge_delay = core->hedge_delay();
+        state->outstanding = 1;
+        
+        core->calls.fetch_add(1, std::memory_order_relaxed);
+        core->budget->record_request();
+        
+        for (size_type i = 0; i < core->config.max_hedged_attempts + 1; ++i) {
+            state->sources.emplace_back();
+        }
+        
+        watch_attempt(core, state, 0).detach();
+        schedule_hedge(core, state, 1);
+        
+        co_return co_await state->completion;
+    }
+            
+    template<typename T>
+    void HedgingPolicy<T>::schedule_hedge(const shared_ptr<Core>& core, const shared_ptr<CallState>& state, size_type attempt_index) {
+        if (attempt_index >= state->sources.size()) {
+            return;
+        }
+        
+        // Held across post_after so a concurrent settle always sees the newest timer
+        lock_guard lock(state->state_mutex);
+        if (state->settled || state->outstanding == 0) {
+            return;
+        }
+        state->hedge_timer = core->scheduler().post_after(state->hedge_delay, [core, state, attempt_index]() {
+            launch_hedge(core, state, attempt_index);
+        });
+    }
+                
+    template<typename T>
+    void HedgingPolicy<T>::launch_hedge(const shared_ptr<Core>& core, const shared_ptr<CallState>& state, size_type attempt_index) {
+        {
+            lock_guard lock(state->state_mutex);
+            if (state->settled || state->outstanding == 0) {
+                return;
+            }
+            if (!core->budget->try_withdraw()) {
+                core->hedges_throttled.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            core->hedges_issued.fetch_add(1, std::memory_order_relaxed);
+            ++state->outstanding;
+        }
+                
+        watch_attempt(core, state, attempt_index).detach();
+        schedule_hedge(core, state, attempt_index + 1);
+    }
+    
+    template<typename T>
+    async::Task<void> HedgingPolicy<T>::watch_attempt(shared_ptr<Core> core, shared_ptr<CallState> state, size_type attempt_index) {
+        auto started_at = std::chrono::steady_clock::now();
+        
+        try {
+            if constexpr (std::is_void_v<T>) {
+                co_await state->attempt(state->sources[attempt_index].token());
+                if (claim_settlement(core, *state, attempt_index)) {
+                    state->completion.set_value();
+                }
+            } else {
+                auto value = co_await state->attempt(state->sources[attempt_index].token());
+                if (claim_settlement(core, *state, attempt_index)) {
+                    state->completion.set_value(std::move(value));
+                }
+            }
+            core->latency.record(std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - started_at));
+        } catch (...) {
+            lock_guard lock(state->state_mutex);
+            state->last_exception = std::current_exception();
+        }
+            
+        finish_attempt(*state);
+    }
+    
+    template<typename T>
+    bool HedgingPolicy<T>::claim_settlement(const shared_ptr<Core>& core, CallState& state, size_type attempt_index) {
+        async::Scheduler::TimerId hedge_timer;
+        {
+            lock_guard lock(state.state_mutex);
+            if (state.settled) {
+                return false;
+            }
+            state.settled = true;
+            hedge_timer = state.hedge_timer;
+        }
+        core->scheduler().cancel(hedge_timer);
+        
+        if (attempt_index > 0) {
+            core->hedges_won.fetch_add(1, std::memory_order_relaxed);
+        }
+        
+        for (size_type i = 0; i < state.sources.size(); ++i) {
+            if (i != attempt_index && !state.sources[i].is_cancelled()) {
+                state.sources[i].cancel();
+                core->losers_cancelled.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        return true;
+    }
+    
+    template<typename T>
+    void HedgingPolicy<T>::finish_attempt(CallState& state) {
+        std::exception_ptr failure;
+        {
+            lock_guard lock(state.state_mutex);
+            if (--state.outstanding > 0 || state.settled) {
+                return;
+            }
+            // Every attempt launched so far failed; a pending hedge sees outstanding == 0
+            // and stands down
+            state.settled = true;
+            failure = state.last_exception;
+        }
+        state.completion.set_exception(failure);
+    }
+    
+    template<typename T>
+    function<async::Task<T>()> HedgingPolicy<T>::wrap(AttemptFunction attempt) {
+        return [policy = *this, attempt = std::move(attempt)]() mutable {
+            return policy.execute(attempt);
+        };
+    }
+    
+    template<typename T>
+    RetryPolicy<T>::RetryPolicy(shared_ptr<RetryBudget> budget) : RetryPolicy(std::move(budget), Config{}) {}
+    
+    template<typename T>
+    RetryPolicy<T>::RetryPolicy(shared_ptr<RetryBudget> budget, Config config)
+        : config_(std::move(config)), budget_(budget ? std::move(budget) : std::make_shared<RetryBudget>()) {}
+        
+    template<typename T>
+    async::Task<T> RetryPolicy<T>::execute(function<async::Task<T>()> attempt) {
+        budget_->record_request();
+        return run(*this, std::move(attempt));
+    }
+        
+    template<typename T>
+    async::Task<T> RetryPolicy<T>::run(RetryPolicy policy, function<async::Task<T>()> attempt) {
+        std::mt19937 rng{std::random_device{}()};
+        auto& scheduler = policy.config_.scheduler ? *policy.config_.scheduler : async::Scheduler::shared();
+            
+        for (size_type attempt_number = 1;; ++attempt_number) {
+            std::exception_ptr error;
+            try {
+                if constexpr (std::is_void_v<T>) {
+                    co_await attempt();
+                    co_return;
+                } else {
+                    co_return co_await attempt();
+                }
+            } catch (...) {
+                error = std::current_exception();
+            }
+            
+            if (attempt_number >= policy.config_.max_attempts || !policy.should_retry(error) ||
+                !policy.budget_->try_withdraw()) {
+                std::rethrow_exception(error);
+            }
+            co_await scheduler.sleep_for(policy.backoff_for(attempt_number, rng));
+        }
+    }
+                
+    template<typename T>
+    function<async::Task<T>()> RetryPolicy<T>::wrap(function<async::Task<T>()> attempt) {
+        return [policy = *this, attempt = std::move(attempt)]() mutable {
+            return policy.execute(attempt);
+        };
+    }
+    
+    template<typename T>
+    duration_t RetryPolicy<T>::backoff_for(size_type retry, std::mt19937& rng) const {
+        auto base = static_cast<double>(config_.initial_backoff.count()) *
+                    std::pow(config_.backoff_multiplier, static_cast<double>(retry - 1));
+        auto capped = std::min(base, static_cast<double>(config_.max_backoff.count()));
+        
+        if (config_.enable_jitter) {
+            std::uniform_real_distribution<double> jitter(0.0, capped);
+            capped = jitter(rng);
+        }
+        
+        return duration_t(static_cast<duration_t::rep>(capped));
+    }
+    
+    template<typename T>
+    bool RetryPolicy<T>::should_retry(std::exception_ptr error) const {
+        if (!config_.retry_predicate) {
+            return true;
+        }
+        try {
+            std::rethrow_exception(error);
+        } catch (const std::exception& e) {
+            return config_.retry_predicate(e);
+        } catch (...) {
+            return false;
+        }
+    }
+}
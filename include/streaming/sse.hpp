@@ -214,7 +214,7 @@ namespace http_framework::streaming {
     private:
         StreamId stream_id_;
         hash_map<ClientId, shared_ptr<SseConnection>> clients_;
-        mutable shared_mutex clients_mutex_;
+        mutable shared_mutex clients_mutex_ HTTP_FRAMEWORK_LOCK_SITE("SseStream::clients_mutex_");
         
         shared_ptr<BasicStreamFilter> filter_;
         
@@ -290,8 +290,8 @@ namespace http_framework::streaming {
         Config config_;
         hash_map<StreamId, shared_ptr<SseStream>> streams_;
         hash_map<ClientId, std::pair<StreamId, shared_ptr<SseConnection>>> client_registry_;
-        mutable shared_mutex streams_mutex_;
-        mutable shared_mutex clients_mutex_;
+        mutable shared_mutex streams_mutex_ HTTP_FRAMEWORK_LOCK_SITE("SseServer::streams_mutex_");
+        mutable shared_mutex clients_mutex_ HTTP_FRAMEWORK_LOCK_SITE("SseServer::clients_mutex_");
         
         optional<function<async::Future<bool>(const http::Request&)>> auth_handler_;
         optional<function<bool(const http::Request&)>> client_filter_;
@@ -375,13 +375,13 @@ namespace http_framework::streaming {
     template<typename T>
     void SseConnection::set_attribute(string_view name, T&& value) {
         unique_lock lock(attributes_mutex_);
-        attributes_[string(name)] = std::forward<T>(value);
+        attributes_[name] = std::forward<T>(value);
     }
     
     template<typename T>
     optional<T> SseConnection::get_attribute(string_view name) const {
         shared_lock lock(attributes_mutex_);
-        auto it = attributes_.find(string(name));
+        auto it = attributes_.find(name);
         if (it != attributes_.end() && std::holds_alternative<T>(it->second)) {
             return std::get<T>(it->second);
         }
@@ -0,0 +1,432 @@
+#pragma once
+
+#include "core/types.hpp"
+#include <cstring>
+#include <shared_mutex>
+
+namespace http_framework::tracing {
+    enum class AttributeType : std::uint8_t {
+        STRING = 0,
+        BOOL = 1,
+        INT64 = 2,
+        DOUBLE = 3,
+        STRING_ARRAY = 4,
+        BOOL_ARRAY = 5,
+        INT64_ARRAY = 6,
+        DOUBLE_ARRAY = 7
+    };
+    
+    struct Attribute {
+        AttributeType type;
+        variant<string, bool, int64_t, double, vector<string>, vector<bool>, vector<int64_t>, vector<double>> value;
+        
+        Attribute() = default;
+        
+        template<typename T>
+        explicit Attribute(T&& val);
+        
+        string to_string() const;
+    };
+    
+    struct AttributeKey {
+        std::uint16_t id{0};
+        
+        constexpr bool is_valid() const noexcept { return id != 0; }
+        constexpr bool operator==(const AttributeKey&) const noexcept = default;
+        
+        string_view name() const;
+        
+        static AttributeKey intern(string_view name);
+        static optional<AttributeKey> find(string_view name);
+    };
+    
+    // OpenTelemetry semantic convention keys, registered in this order at startup
+    inline constexpr array<string_view, 22> WELL_KNOWN_ATTRIBUTE_NAMES{
+        "http.request.method",
+        "http.response.status_code",
+        "http.route",
+        "url.full",
+        "url.path",
+        "url.query",
+        "url.scheme",
+        "server.address",
+        "server.port",
+        "client.address",
+        "client.port",
+        "network.protocol.name",
+        "network.protocol.version",
+        "user_agent.original",
+        "http.request.body.size",
+        "http.response.body.size",
+        "error.type",
+        "exception.type",
+        "exception.message",
+        "exception.stacktrace",
+        "otel.status_code",
+        "otel.status_description"
+    };
+    
+    namespace semconv {
+        inline constexpr AttributeKey HTTP_REQUEST_METHOD{1};
+        inline constexpr AttributeKey HTTP_RESPONSE_STATUS_CODE{2};
+        inline constexpr AttributeKey HTTP_ROUTE{3};
+        inline constexpr AttributeKey URL_FULL{4};
+        inline constexpr AttributeKey URL_PATH{5};
+        inline constexpr AttributeKey URL_QUERY{6};
+        inline constexpr AttributeKey URL_SCHEME{7};
+        inline constexpr AttributeKey SERVER_ADDRESS{8};
+        inline constexpr AttributeKey SERVER_PORT{9};
+        inline constexpr AttributeKey CLIENT_ADDRESS{10};
+        inline constexpr AttributeKey CLIENT_PORT{11};
+        inline constexpr AttributeKey NETWORK_PROTOCOL_NAME{12};
+        inline constexpr AttributeKey NETWORK_PROTOCOL_VERSION{13};
+        inline constexpr AttributeKey USER_AGENT_ORIGINAL{14};
+        inline constexpr AttributeKey HTTP_REQUEST_BODY_SIZE{15};
+        inline constexpr AttributeKey HTTP_RESPONSE_BODY_SIZE{16};
+        inline constexpr AttributeKey ERROR_TYPE{17};
+        inline constexpr AttributeKey EXCEPTION_TYPE{18};
+        inline constexpr AttributeKey EXCEPTION_MESSAGE{19};
+        inline constexpr AttributeKey EXCEPTION_STACKTRACE{20};
+        inline constexpr AttributeKey OTEL_STATUS_CODE{21};
+        inline constexpr AttributeKey OTEL_STATUS_DESCRIPTION{22};
+    }
+    
+    class AttributeKeyRegistry {
+    public:
+        static constexpr size_type MAX_KEYS = 65535;
+        
+        static AttributeKeyRegistry& instance();
+        
+        AttributeKey intern(string_view name);
+        optional<AttributeKey> find(string_view name) const;
+        string_view name(AttributeKey key) const;
+        size_type size() const;
+        
+    private:
+        AttributeKeyRegistry();
+        
+        mutable shared_mutex mutex_;
+        deque<string> names_;
+        hash_map<string_view, std::uint16_t> ids_;
+    };
+    
+    // Resolved view of one stored attribute; string and array data point into the owning set
+    struct AttributeView {
+        AttributeKey key;
+        AttributeType type{AttributeType::STRING};
+        bool boolean{false};
+        std::int64_t integer{0};
+        double real{0.0};
+        std::span<const std::byte> bytes;
+        std::uint32_t count{0};
+        
+        string_view as_string() const noexcept {
+            return {reinterpret_cast<const char*>(bytes.data()), bytes.size()};
+        }
+        std::span<const std::int64_t> as_int64_array() const noexcept {
+            return {reinterpret_cast<const std::int64_t*>(bytes.data()), count};
+        }
+        std::span<const double> as_double_array() const noexcept {
+            return {reinterpret_cast<const double*>(bytes.data()), count};
+        }
+        std::span<const bool> as_bool_array() const noexcept {
+            return {reinterpret_cast<const bool*>(bytes.data()), count};
+        }
+        vector<string_view> as_string_array() const;
+        
+        Attribute to_attribute() const;
+        string to_string() const;
+    };
+    
+    template<size_type InlineBytes>
+    class AttributeArena {
+    public:
+        AttributeArena() = default;
+        AttributeArena(const AttributeArena& other) { append_bytes(other.data(), other.size_); }
+        AttributeArena(AttributeArena&& other) noexcept { take(other); }
+        AttributeArena& operator=(const AttributeArena& other) {
+            if (this != &other) {
+                clear();
+                append_bytes(other.data(), other.size_);
+            }
+            return *this;
+        }
+        AttributeArena& operator=(AttributeArena&& other) noexcept {
+            if (this != &other) {
+                heap_.reset();
+                capacity_ = InlineBytes;
+                take(other);
+            }
+            return *this;
+        }
+        
+        std::uint32_t append(const void* source, size_type length, size_type alignment = 1);
+        
+        const std::byte* data() const noexcept { return heap_ ? heap_.get() : inline_.data(); }
+        size_type size() const noexcept { return size_; }
+        bool on_heap() const noexcept { return heap_ != nullptr; }
+        void clear() noexcept { size_ = 0; }
+        
+    private:
+        alignas(8) array<std::byte, InlineBytes> inline_;
+        unique_ptr<std::byte[]> heap_;
+        std::uint32_t size_{0};
+        std::uint32_t capacity_{InlineBytes};
+        
+        std::byte* mutable_data() noexcept { return heap_ ? heap_.get() : inline_.data(); }
+        void append_bytes(const std::byte* source, size_type length) { append(source, length); }
+        void take(AttributeArena& other) noexcept;
+    };
+    
+    // Flat attribute storage: the first InlineEntries keys live in place, strings in the arena
+    template<size_type InlineEntries, size_type ArenaBytes>
+    class AttributeSet {
+    public:
+        AttributeSet() = default;
+        
+        template<typename T>
+        void set(AttributeKey key, T&& value);
+        
+        template<typename T>
+        void set(string_view key, T&& value) { set(AttributeKey::intern(key), std::forward<T>(value)); }
+        
+        optional<AttributeView> find(AttributeKey key) const noexcept;
+        bool contains(AttributeKey key) const noexcept { return locate(key) != nullptr; }
+        
+        size_type size() const noexcept { return inline_count_ + overflow_.size(); }
+        bool empty() const noexcept { return size() == 0; }
+        bool spilled() const noexcept { return !overflow_.empty() || arena_.on_heap(); }
+        
+        void clear() noexcept {
+            inline_count_ = 0;
+            overflow_.clear();
+            arena_.clear();
+        }
+        
+        template<typename F>
+        void for_each(F&& func) const;
+        
+    private:
+        struct Entry {
+            std::uint16_t key{0};
+            AttributeType type{AttributeType::STRING};
+            std::uint32_t count{0};
+            union {
+                bool boolean;
+                std::int64_t integer;
+                double real;
+                std::uint64_t offset;
+            };
+            
+            Entry() : integer(0) {}
+        };
+        
+        array<Entry, InlineEntries> entries_;
+        std::uint16_t inline_count_{0};
+        vector<Entry> overflow_;
+        AttributeArena<ArenaBytes> arena_;
+        
+        const Entry* locate(AttributeKey key) const noexcept;
+        Entry& slot_for(AttributeKey key);
+        AttributeView view(const Entry& entry) const noexcept;
+    };
+    
+    template<typename T>
+    Attribute::Attribute(T&& val) {
+        if constexpr (std::is_same_v<std::decay_t<T>, string>) {
+            type = AttributeType::STRING;
+            value = std::forward<T>(val);
+        } else if constexpr (std::is_same_v<std::decay_t<T>, bool>) {
+            type = AttributeType::BOOL;
+            value = std::forward<T>(val);
+        } else if constexpr (std::is_integral_v<std::decay_t<T>>) {
+            type = AttributeType::INT64;
+            value = static_cast<int64_t>(val);
+        } else if constexpr (std::is_floating_point_v<std::decay_t<T>>) {
+            type = AttributeType::DOUBLE;
+            value = static_cast<double>(val);
+        }
+    }
+    
+    template<size_type InlineBytes>
+    std::uint32_t AttributeArena<InlineBytes>::append(const void* source, size_type length, size_type alignment) {
+        auto offset = (static_cast<size_type>(size_) + alignment - 1) & ~(alignment - 1);
+        auto required = offset + length;
+        
+        if (required > capacity_) {
+            auto capacity = std::max<size_type>(required, static_cast<size_type>(capacity_) * 2);
+            auto grown = std::make_unique<std::byte[]>(capacity);
+            std::memcpy(grown.get(), data(), size_);
+            heap_ = std::move(grown);
+            capacity_ = static_cast<std::uint32_t>(capacity);
+        }
+        
+        if (length > 0) {
+            std::memcpy(mutable_data() + offset, source, length);
+        }
+        size_ = static_cast<std::uint32_t>(required);
+        return static_cast<std::uint32_t>(offset);
+    }
+    
+    template<size_type InlineBytes>
+    void AttributeArena<InlineBytes>::take(AttributeArena& other) noexcept {
+        if (other.heap_) {
+            heap_ = std::move(other.heap_);
+            capacity_ = other.capacity_;
+        } else {
+            std::memcpy(inline_.data(), other.inline_.data(), other.size_);
+        }
+        size_ = other.size_;
+        other.size_ = 0;
+        other.capacity_ = InlineBytes;
+    }
+    
+    template<size_type InlineEntries, size_type ArenaBytes>
+    template<typename T>
+    void AttributeSet<InlineEntries, ArenaBytes>::set(AttributeKey key, T&& value) {
+        using Value = std::remove_cvref_t<T>;
+        
+        auto& entry = slot_for(key);
+        
+        if constexpr (std::is_same_v<Value, bool>) {
+            entry.type = AttributeType::BOOL;
+            entry.boolean = value;
+        } else if constexpr (std::is_integral_v<Value>) {
+            entry.type = AttributeType::INT64;
+            entry.integer = static_cast<std::int64_t>(value);
+        } else if constexpr (std::is_floating_point_v<Value>) {
+            entry.type = AttributeType::DOUBLE;
+            entry.real = static_cast<double>(value);
+        } else if constexpr (std::is_convertible_v<const Value&, string_view>) {
+            string_view text = value;
+            entry.type = AttributeType::STRING;
+            entry.count = static_cast<std::uint32_t>(text.size());
+            entry.offset = arena_.append(text.data(), text.size());
+        } else if constexpr (std::is_same_v<Value, vector<bool>>) {
+            entry.type = AttributeType::BOOL_ARRAY;
+            entry.count = static_cast<std::uint32_t>(value.size());
+            entry.offset = arena_.size();
+            for (bool element : value) {
+                arena_.append(&element, sizeof(bool));
+            }
+        } else if constexpr (std::is_convertible_v<const Value&, std::span<const std::int64_t>>) {
+            std::span<const std::int64_t> elements = value;
+            entry.type = AttributeType::INT64_ARRAY;
+            entry.count = static_cast<std::uint32_t>(elements.size());
+            entry.offset = arena_.append(elements.data(), elements.size_bytes(), alignof(std::int64_t));
+        } else if constexpr (std::is_convertible_v<const Value&, std::span<const double>>) {
+            std::span<const double> elements = value;
+            entry.type = AttributeType::DOUBLE_ARRAY;
+            entry.count = static_cast<std::uint32_t>(elements.size());
+            entry.offset = arena_.append(elements.data(), elements.size_bytes(), alignof(double));
+        } else if constexpr (std::is_convertible_v<const Value&, std::span<const string>>) {
+            std::span<const string> elements = value;
+            entry.type = AttributeType::STRING_ARRAY;
+            entry.count = static_cast<std::uint32_t>(elements.size());
+            entry.offset = arena_.size();
+            for (const auto& element : elements) {
+                auto length = static_cast<std::uint32_t>(element.size());
+                arena_.append(&length, sizeof(length));
+                arena_.append(element.data(), element.size());
+            }
+        } else {
+            static_assert(sizeof(Value) == 0, "Unsupported attribute value type");
+        }
+    }
+    
+    template<size_type InlineEntries, size_type ArenaBytes>
+    auto AttributeSet<InlineEntries, ArenaBytes>::find(AttributeKey key) const noexcept -> optional<AttributeView> {
+        if (auto* entry = locate(key)) {
+            return view(*entry);
+        }
+        return std::nullopt;
+    }
+    
+    template<size_type InlineEntries, size_type ArenaBytes>
+    template<typename F>
+    void AttributeSet<InlineEntries, ArenaBytes>::for_each(F&& func) const {
+        for (size_type i = 0; i < inline_count_; ++i) {
+            func(view(entries_[i]));
+        }
+        for (const auto& entry : overflow_) {
+            func(view(entry));
+        }
+    }
+    
+    template<size_type InlineEntries, size_type ArenaBytes>
+    auto AttributeSet<InlineEntries, ArenaBytes>::locate(AttributeKey key) const noexcept -> const Entry* {
+        for (size_type i = 0; i < inline_count_; ++i) {
+            if (entries_[i].key == key.id) {
+                return &entries_[i];
+            }
+        }
+        for (const auto& entry : overflow_) {
+            if (entry.key == key.id) {
+                return &entry;
+            }
+        }
+        return nullptr;
+    }
+    
+    template<size_type InlineEntries, size_type ArenaBytes>
+    auto AttributeSet<InlineEntries, ArenaBytes>::slot_for(AttributeKey key) -> Entry& {
+        if (auto* existing = locate(key)) {
+            // Replaced string bytes stay in the arena until the set is cleared
+            return const_cast<Entry&>(*existing);
+        }
+        
+        Entry* entry = nullptr;
+        if (inline_count_ < InlineEntries) {
+            entry = &entries_[inline_count_++];
+        } else {
+            entry = &overflow_.emplace_back();
+        }
+        *entry = Entry{};
+        entry->key = key.id;
+        return *entry;
+    }
+    
+    template<size_type InlineEntries, size_type ArenaBytes>
+    AttributeView AttributeSet<InlineEntries, ArenaBytes>::view(const Entry& entry) const noexcept {
+        AttributeView result;
+        result.key = AttributeKey{entry.key};
+        result.type = entry.type;
+        result.count = entry.count;
+        
+        switch (entry.type) {
+            case AttributeType::BOOL:
+                result.boolean = entry.boolean;
+                break;
+            case AttributeType::INT64:
+                result.integer = entry.integer;
+                break;
+            case AttributeType::DOUBLE:
+                result.real = entry.real;
+                break;
+            case AttributeType::STRING:
+                result.bytes = {arena_.data() + entry.offset, entry.count};
+                break;
+            case AttributeType::BOOL_ARRAY:
+                result.bytes = {arena_.data() + entry.offset, entry.count * sizeof(bool)};
+                break;
+            case AttributeType::INT64_ARRAY:
+                result.bytes = {arena_.data() + entry.offset, entry.count * sizeof(std::int64_t)};
+                break;
+            case AttributeType::DOUBLE_ARRAY:
+                result.bytes = {arena_.data() + entry.offset, entry.count * sizeof(double)};
+                break;
+            case AttributeType::STRING_ARRAY: {
+                size_type end = entry.offset;
+                for (std::uint32_t i = 0; i < entry.count; ++i) {
+                    std::uint32_t length = 0;
+                    std::memcpy(&length, arena_.data() + end, sizeof(length));
+                    end += sizeof(length) + length;
+                }
+                result.bytes = {arena_.data() + entry.offset, end - entry.offset};
+                break;
+            }
+        }
+        
+        return result;
+    }
+}
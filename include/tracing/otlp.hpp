@@ -0,0 +1,117 @@
+#pragma once
+
+#include "core/types.hpp"
+#include "tracing/tracer.hpp"
+#include <cstdio>
+
+namespace http_framework::tracing {
+    // Encodes spans as an OTLP ExportTraceServiceRequest directly in protobuf wire format
+    class OtlpProtobufEncoder {
+    public:
+        struct Config {
+            // Empty fields are taken from the provider's Resource once registered, and
+            // service.name falls back to "unknown_service"
+            string service_name;
+            string service_version;
+            hash_map<string, Attribute> resource_attributes;
+            string scope_name{"http_framework"};
+            string scope_version;
+        };
+        
+        OtlpProtobufEncoder();
+        explicit OtlpProtobufEncoder(Config config);
+        
+        // Fills in what Config left unset; explicit Config values win
+        void set_resource(const Resource& resource);
+        
+        // The returned bytes stay valid until the next call to encode
+        byte_span encode(const vector<Span>& spans);
+        
+        size_type capacity() const noexcept { return buffer_.capacity(); }
+        void shrink_to_fit() { buffer_.clear(); buffer_.shrink_to_fit(); }
+        
+    private:
+        Config config_;
+        buffer_t buffer_;
+        buffer_t resource_message_;
+        buffer_t scope_message_;
+        vector<string> key_names_;
+        std::int64_t steady_to_unix_ns_;
+        
+        void put_byte(byte_t value) { buffer_.push_back(value); }
+        void put_varint(std::uint64_t value);
+        void put_tag(std::uint32_t field, std::uint32_t wire_type);
+        void put_fixed32(std::uint32_t value);
+        void put_fixed64(std::uint64_t value);
+        void put_bytes(std::uint32_t field, const void* data, size_type size);
+        void put_string(std::uint32_t field, string_view value);
+        void put_raw(const buffer_t& bytes) { buffer_.insert(buffer_.end(), bytes.begin(), bytes.end()); }
+        
+        size_type open_message(std::uint32_t field);
+        void close_message(size_type mark);
+        
+        void encode_span(const Span& span);
+        void encode_event(const Span::Event& event);
+        void encode_attribute(std::uint32_t field, const AttributeView& attribute);
+        void encode_attribute(std::uint32_t field, string_view key, const Attribute& attribute);
+        void encode_resource();
+        void encode_scope();
+        
+        string_view key_name(AttributeKey key);
+        std::uint64_t unix_nanos(timestamp_t timestamp) const noexcept;
+    };
+    
+    bool gzip_available() noexcept;
+    // Writes a gzip member into output, reusing its capacity; false if zlib is unavailable or fails
+    bool gzip_compress(byte_span input, buffer_t& output, int level = 6);
+    
+    struct FileSpanExporterMetrics {
+        size_type batches_written{0};
+        size_type spans_written{0};
+        size_type bytes_written{0};
+        size_type write_failures{0};
+        
+        string to_json() const;
+    };
+    
+    // Appends each batch as a varint length prefix followed by an ExportTraceServiceRequest,
+    // gzip-compressed when enabled, to a file or named pipe read by a collector sidecar
+    class FileSpanExporter : public SpanExporter {
+    public:
+        struct Config {
+            string path{"spans.otlp"};
+            bool gzip{false};
+            int gzip_level{6};
+            bool truncate{false};
+            bool flush_each_batch{true};
+            OtlpProtobufEncoder::Config encoder;
+        };
+        
+        FileSpanExporter();
+        explicit FileSpanExporter(Config config);
+        ~FileSpanExporter() override;
+        
+        void set_resource(const Resource& resource) override;
+        // Refused with FAILURE once shutdown() has run
+        ExportResult export_spans(const vector<Span>& spans) override;
+        void shutdown(duration_t timeout = std::chrono::seconds(30)) override;
+        
+        bool is_open() const;
+        FileSpanExporterMetrics metrics() const;
+        
+    private:
+        Config config_;
+        OtlpProtobufEncoder encoder_;
+        buffer_t compressed_;
+        std::FILE* file_{nullptr};
+        bool shut_down_{false};
+        mutable mutex file_mutex_;
+        
+        atomic<size_type> batches_written_{0};
+        atomic<size_type> spans_written_{0};
+        atomic<size_type> bytes_written_{0};
+        atomic<size_type> write_failures_{0};
+        
+        bool write_record(byte_span payload);
+    };
+}
@@ -0,0 +1,188 @@
+#pragma once
+
+#include "core/types.hpp"
+#include "tracing/tracer.hpp"
+
+namespace http_framework::tracing {
+    struct SamplingParameters {
+        const SpanContext* parent_context{nullptr};
+        const TraceId& trace_id;
+        string_view name;
+        SpanKind kind{SpanKind::INTERNAL};
+    };
+    
+    class Sampler {
+    public:
+        virtual ~Sampler() = default;
+        virtual SamplingDecision should_sample(const SamplingParameters& parameters) = 0;
+        virtual string description() const = 0;
+    };
+    
+    class AlwaysOnSampler : public Sampler {
+    public:
+        SamplingDecision should_sample(const SamplingParameters&) override { return SamplingDecision::RECORD_AND_SAMPLE; }
+        string description() const override { return "AlwaysOnSampler"; }
+    };
+    
+    class AlwaysOffSampler : public Sampler {
+    public:
+        SamplingDecision should_sample(const SamplingParameters&) override { return SamplingDecision::DROP; }
+        string description() const override { return "AlwaysOffSampler"; }
+    };
+    
+    // Deterministic on the trace id, so every service keeps the same traces
+    class TraceIdRatioSampler : public Sampler {
+    public:
+        explicit TraceIdRatioSampler(double ratio, SamplingDecision unsampled = SamplingDecision::DROP);
+        
+        SamplingDecision should_sample(const SamplingParameters& parameters) override;
+        string description() const override;
+        
+        double ratio() const noexcept { return ratio_; }
+        
+    private:
+        double ratio_;
+        std::uint64_t threshold_;
+        SamplingDecision unsampled_;
+    };
+    
+    class RateLimitingSampler : public Sampler {
+    public:
+        explicit RateLimitingSampler(double traces_per_second, SamplingDecision unsampled = SamplingDecision::DROP);
+        
+        SamplingDecision should_sample(const SamplingParameters& parameters) override;
+        string description() const override;
+        
+        size_type sampled() const noexcept { return sampled_.load(std::memory_order_relaxed); }
+        size_type throttled() const noexcept { return throttled_.load(std::memory_order_relaxed); }
+        
+    private:
+        static constexpr std::int64_t SCALE = 1000000;
+        
+        double traces_per_second_;
+        std::int64_t max_scaled_;
+        SamplingDecision unsampled_;
+        alignas(64) atomic<std::int64_t> scaled_tokens_;
+        alignas(64) atomic<std::int64_t> last_refill_ns_;
+        atomic<size_type> sampled_{0};
+        atomic<size_type> throttled_{0};
+    };
+    
+    // Children of a local parent that records without sampling (a RECORD_ONLY root held
+    // for tail sampling) are RECORD_ONLY as well, so the buffered trace stays complete
+    class ParentBasedSampler : public Sampler {
+    public:
+        struct Config {
+            shared_ptr<Sampler> remote_parent_sampled{std::make_shared<AlwaysOnSampler>()};
+            shared_ptr<Sampler> remote_parent_not_sampled{std::make_shared<AlwaysOffSampler>()};
+            shared_ptr<Sampler> local_parent_sampled{std::make_shared<AlwaysOnSampler>()};
+            shared_ptr<Sampler> local_parent_not_sampled{std::make_shared<AlwaysOffSampler>()};
+        };
+        
+        explicit ParentBasedSampler(shared_ptr<Sampler> root);
+        ParentBasedSampler(shared_ptr<Sampler> root, Config config);
+        
+        SamplingDecision should_sample(const SamplingParameters& parameters) override;
+        string description() const override;
+        
+    private:
+        shared_ptr<Sampler> root_;
+        Config config_;
+    };
+    
+    struct TailSamplingMetrics {
+        size_type traces_kept{0};
+        size_type traces_dropped{0};
+        size_type traces_kept_slow{0};
+        size_type traces_kept_error{0};
+        size_type spans_buffered{0};
+        size_type spans_forwarded{0};
+        size_type spans_evicted{0};
+        size_type late_spans{0};
+        
+        string to_json() const;
+    };
+    
+    // Buffers recorded but unsampled spans per trace and forwards only slow or failing traces.
+    // Spans the head sampler DROPs never get here, so the root sampler's unsampled decision
+    // must be RECORD_ONLY, e.g. ParentBasedSampler over TraceIdRatioSampler(ratio, RECORD_ONLY).
+    class TailSamplingProcessor : public SpanProcessor {
+    public:
+        struct Config {
+            duration_t decision_wait{std::chrono::seconds(2)};
+            std::chrono::microseconds latency_threshold{std::chrono::milliseconds(500)};
+            bool keep_errors{true};
+            size_type max_buffered_traces{10000};
+            size_type max_spans_per_trace{256};
+            size_type shard_count{16};
+        };
+        
+        explicit TailSamplingProcessor(unique_ptr<SpanProcessor> downstream);
+        TailSamplingProcessor(unique_ptr<SpanProcessor> downstream, Config config);
+        ~TailSamplingProcessor() override;
+        
+        void on_start(const Span& span) override;
+        void on_end(const Span& span) override;
+        void on_end(Span&& span) override;
+        bool takes_ownership() const noexcept override { return true; }
+        void set_resource(const Resource& resource) override;
+        void force_flush(duration_t timeout = std::chrono::seconds(30)) override;
+        void shutdown(duration_t timeout = std::chrono::seconds(30)) override;
+        
+        TailSamplingMetrics metrics() const;
+        
+    private:
+        enum class Verdict : std::uint8_t {
+            DROP = 0,
+            KEEP_SLOW = 1,
+            KEEP_ERROR = 2
+        };
+        
+        struct PendingTrace {
+            vector<Span> spans;
+            timestamp_t first_seen;
+            bool slow{false};
+            bool failed{false};
+        };
+        
+        struct TraceIdHash {
+            size_type operator()(const TraceId& trace_id) const noexcept;
+        };
+        
+        struct TraceIdEqual {
+            bool operator()(const TraceId& lhs, const TraceId& rhs) const noexcept { return lhs.data == rhs.data; }
+        };
+        
+        struct alignas(64) Shard {
+            mutex traces_mutex;
+            std::unordered_map<TraceId, PendingTrace, TraceIdHash, TraceIdEqual> pending;
+            std::unordered_map<TraceId, std::pair<bool, timestamp_t>, TraceIdHash, TraceIdEqual> decided;
+        };
+        
+        unique_ptr<SpanProcessor> downstream_;
+        Config config_;
+        size_type shard_mask_;
+        unique_ptr<Shard[]> shards_;
+        
+        mutex sweeper_mutex_;
+        condition_variable sweeper_condition_;
+        unique_ptr<std::thread> sweeper_thread_;
+        atomic<bool> shutdown_requested_{false};
+        
+        atomic<size_type> traces_kept_{0};
+        atomic<size_type> traces_dropped_{0};
+        atomic<size_type> traces_kept_slow_{0};
+        atomic<size_type> traces_kept_error_{0};
+        atomic<size_type> spans_buffered_{0};
+        atomic<size_type> spans_forwarded_{0};
+        atomic<size_type> spans_evicted_{0};
+        atomic<size_type> late_spans_{0};
+        
+        Shard& shard_for(const TraceId& trace_id) const noexcept;
+        Verdict judge(const PendingTrace& trace) const noexcept;
+        void settle(PendingTrace trace, Verdict verdict);
+        void forward(Span&& span);
+        void sweep(bool flush_all);
+        void sweeper_loop();
+    };
+}
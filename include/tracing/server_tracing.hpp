@@ -0,0 +1,91 @@
+#pragma once
+
+#include "core/types.hpp"
+#include "tracing/tracer.hpp"
+
+namespace http_framework::tracing {
+    enum class RequestPhase : std::uint8_t {
+        PARSE = 0,
+        ROUTE = 1,
+        HANDLER = 2,
+        WRITE = 3
+    };
+    
+    string_view to_string(RequestPhase phase) noexcept;
+    
+    // One server request's trace. Unsampled requests never allocate a span and only
+    // carry the context that outbound calls propagate.
+    class RequestTrace {
+    public:
+        RequestTrace() = default;
+        RequestTrace(const RequestTrace&) = delete;
+        RequestTrace(RequestTrace&& other) noexcept;
+        RequestTrace& operator=(const RequestTrace&) = delete;
+        RequestTrace& operator=(RequestTrace&& other) noexcept;
+        ~RequestTrace();
+        
+        bool is_active() const noexcept { return active_; }
+        bool is_recording() const noexcept { return span_ != nullptr; }
+        const SpanContext& context() const noexcept { return context_; }
+        Span* span() const noexcept { return span_.get(); }
+        
+        void mark(RequestPhase phase);
+        void mark(RequestPhase phase, timestamp_t timestamp);
+        // For phases measured elsewhere, e.g. core::RequestPhases
+        void mark(string_view phase, timestamp_t timestamp);
+        void set_route(string_view route);
+        void record_exception(const std::exception& exception);
+        void finish(const http_framework::http::Response& response);
+        
+    private:
+        SpanContext context_;
+        unique_ptr<Span> span_;
+        optional<SpanContext> previous_context_;
+        Span* previous_span_{nullptr};
+        bool record_phases_{false};
+        bool active_{false};
+        
+        void release() noexcept;
+        
+        friend class ServerRequestTracer;
+    };
+    
+    // Adds an event to the server span active on the calling thread, if it is recording
+    void record_request_event(string_view name);
+    
+    struct ServerTracingMetrics {
+        size_type requests_traced{0};
+        size_type requests_recorded{0};
+        size_type remote_parents{0};
+        size_type rejected_trace_parents{0};
+        
+        string to_json() const;
+    };
+    
+    class ServerRequestTracer {
+    public:
+        struct Config {
+            string tracer_name{"http_framework.server"};
+            bool record_phase_events{true};
+            // Disable at trust boundaries to start a fresh trace for every request
+            bool trust_remote_context{true};
+        };
+        
+        explicit ServerRequestTracer(TracerProvider& provider);
+        ServerRequestTracer(TracerProvider& provider, Config config);
+        
+        RequestTrace begin(const http_framework::http::Request& request);
+        RequestTrace begin(const http_framework::http::Request& request, timestamp_t received_at);
+        
+        ServerTracingMetrics metrics() const;
+        
+    private:
+        Config config_;
+        shared_ptr<Tracer> tracer_;
+        
+        atomic<size_type> requests_traced_{0};
+        atomic<size_type> requests_recorded_{0};
+        atomic<size_type> remote_parents_{0};
+        atomic<size_type> rejected_trace_parents_{0};
+    };
+}
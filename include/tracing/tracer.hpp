@@ -1,10 +1,23 @@
 #pragma once
 
 #include "core/types.hpp"
+#include "tracing/attributes.hpp"
 #include <random>
 
+namespace http_framework::http {
+    class Request;
+    class Response;
+}
+
 namespace http_framework::tracing {
+    class SpanExporter;
+    class Sampler;
+    class TracerProvider;
+    class OtlpProtobufEncoder;
+    
     struct TraceId {
+        static constexpr size_type HEX_LENGTH = 32;
+        
         array<byte_t, 16> data;
         
         TraceId();
@@ -12,11 +25,17 @@ namespace http_framework::tracing {
         string to_string() const;
         bool is_valid() const noexcept;
         
+        // Writes exactly HEX_LENGTH lowercase hex characters
+        void write_hex(char* out) const noexcept;
+        
         static TraceId generate();
         static TraceId invalid();
+        static optional<TraceId> from_hex(string_view hex_string) noexcept;
     };
     
     struct SpanId {
+        static constexpr size_type HEX_LENGTH = 16;
+        
         array<byte_t, 8> data;
         
         SpanId();
@@ -24,8 +43,12 @@ namespace http_framework::tracing {
         string to_string() const;
         bool is_valid() const noexcept;
         
+        // Writes exactly HEX_LENGTH lowercase hex characters
+        void write_hex(char* out) const noexcept;
+        
         static SpanId generate();
         static SpanId invalid();
+        static optional<SpanId> from_hex(string_view hex_string) noexcept;
     };
     
     enum class SpanKind : std::uint8_t {
@@ -36,44 +59,64 @@ namespace http_framework::tracing {
         CONSUMER = 4
     };
     
-    enum class AttributeType : std::uint8_t {
-        STRING = 0,
-        BOOL = 1,
-        INT64 = 2,
-        DOUBLE = 3,
-        STRING_ARRAY = 4,
-        BOOL_ARRAY = 5,
-        INT64_ARRAY = 6,
-        DOUBLE_ARRAY = 7
+    enum class SamplingDecision : std::uint8_t {
+        DROP = 0,
+        RECORD_ONLY = 1,
+        RECORD_AND_SAMPLE = 2
     };
     
-    struct Attribute {
-        AttributeType type;
-        variant<string, bool, int64_t, double, vector<string>, vector<bool>, vector<int64_t>, vector<double>> value;
+    // W3C tracestate kept as its validated header value; lookups scan it in place
+    class TraceState {
+    public:
+        static constexpr size_type MAX_MEMBERS = 32;
+        static constexpr size_type MAX_LENGTH = 512;
         
-        Attribute() = default;
+        TraceState() = default;
         
-        template<typename T>
-        explicit Attribute(T&& val);
+        bool empty() const noexcept { return header_.empty(); }
+        size_type size() const noexcept;
+        const string& header() const noexcept { return header_; }
         
-        string to_string() const;
+        optional<string_view> get(string_view key) const noexcept;
+        // Moves the key to the front, as the W3C spec requires for updated entries
+        bool set(string_view key, string_view value);
+        void erase(string_view key);
+        
+        template<typename F>
+        void for_each(F&& func) const;
+        
+        static optional<TraceState> parse(string_view header);
+        static bool is_valid(string_view header) noexcept;
+        
+    private:
+        string header_;
     };
     
     struct SpanContext {
+        static constexpr size_type TRACE_PARENT_LENGTH = 55;
+        
         TraceId trace_id;
         SpanId span_id;
         bool is_remote{false};
         bool is_sampled{true};
-        hash_map<string, string> trace_state;
+        // Local only, never propagated: the span records even when it is not sampled
+        bool is_recorded{false};
+        TraceState trace_state;
         
         SpanContext() = default;
         SpanContext(TraceId tid, SpanId sid, bool sampled = true);
         
         bool is_valid() const noexcept;
         string to_trace_parent() const;
-        static optional<SpanContext> from_trace_parent(string_view trace_parent);
+        // Writes exactly TRACE_PARENT_LENGTH characters, without allocating
+        void write_trace_parent(char* out) const noexcept;
+        static optional<SpanContext> from_trace_parent(string_view trace_parent) noexcept;
+        static optional<SpanContext> from_headers(string_view trace_parent, string_view trace_state);
     };
     
+    using SpanAttributes = AttributeSet<16, 384>;
+    using EventAttributes = AttributeSet<4, 96>;
+    
     class Span {
     public:
         Span(string_view name, SpanKind kind = SpanKind::INTERNAL);
@@ -85,6 +128,8 @@ namespace http_framework::tracing {
         ~Span();
         
         const SpanContext& context() const noexcept { return context_; }
+        const SpanId& parent_span_id() const noexcept { return parent_span_id_; }
+        bool has_remote_parent() const noexcept { return remote_parent_; }
         const string& name() const noexcept { return name_; }
         SpanKind kind() const noexcept { return kind_; }
         timestamp_t start_time() const noexcept { return start_time_; }
@@ -92,6 +137,8 @@ namespace http_framework::tracing {
         bool is_recording() const noexcept { return recording_; }
         bool is_ended() const noexcept { return end_time_.has_value(); }
         
+        Span& update_name(string_view name);
+        
         Span& set_attribute(string_view key, string_view value);
         Span& set_attribute(string_view key, bool value);
         Span& set_attribute(string_view key, int64_t value);
@@ -101,23 +148,30 @@ namespace http_framework::tracing {
         template<typename T>
         Span& set_attribute(string_view key, T&& value);
         
+        template<typename T>
+        Span& set_attribute(AttributeKey key, T&& value);
+        
         Span& add_event(string_view name);
         Span& add_event(string_view name, const hash_map<string, Attribute>& attributes);
+        Span& add_event(string_view name, EventAttributes attributes);
         Span& add_event(string_view name, timestamp_t timestamp);
         Span& add_event(string_view name, timestamp_t timestamp, const hash_map<string, Attribute>& attributes);
+        Span& add_event(string_view name, timestamp_t timestamp, EventAttributes attributes);
         
         Span& set_status(bool ok, string_view description = "");
         Span& record_exception(const std::exception& exception);
         
+        // Moves the recorded data into the provider's processors; afterwards the span
+        // keeps only its context and end time
         void end();
         void end(timestamp_t end_timestamp);
         
-        const hash_map<string, Attribute>& attributes() const noexcept { return attributes_; }
+        const SpanAttributes& attributes() const noexcept { return attributes_; }
         
         struct Event {
             string name;
             timestamp_t timestamp;
-            hash_map<string, Attribute> attributes;
+            EventAttributes attributes;
         };
         
         const vector<Event>& events() const noexcept { return events_; }
@@ -131,53 +185,160 @@ namespace http_framework::tracing {
         
     private:
         SpanContext context_;
+        SpanId parent_span_id_;
+        bool remote_parent_{false};
         string name_;
         SpanKind kind_;
         timestamp_t start_time_;
         optional<timestamp_t> end_time_;
         bool recording_{true};
-        hash_map<string, Attribute> attributes_;
+        SpanAttributes attributes_;
         vector<Event> events_;
         Status status_;
+        TracerProvider* provider_{nullptr};
+        
+        // Dropped spans skip attribute and event recording entirely
+        void apply_sampling(SamplingDecision decision) noexcept {
+            context_.is_sampled = decision == SamplingDecision::RECORD_AND_SAMPLE;
+            recording_ = decision != SamplingDecision::DROP;
+            context_.is_recorded = recording_;
+        }
+        
+        friend class Tracer;
+        friend class TailSamplingProcessor;
+    };
+    
+    // Identifies the process behind the spans; the provider hands it to each processor
+    struct Resource {
+        string service_name;
+        string service_version;
+        hash_map<string, Attribute> attributes;
     };
     
     class SpanProcessor {
     public:
         virtual ~SpanProcessor() = default;
+        // Called once when the processor is added to a provider
+        virtual void set_resource(const Resource& resource) {}
         virtual void on_start(const Span& span) = 0;
+        // Observers see each ended span here and must not keep a reference to it
         virtual void on_end(const Span& span) = 0;
+        // Ownership handoff: from the provider to its owning processor, which sees the
+        // span after every observer, or from a wrapping processor to its downstream
+        virtual void on_end(Span&& span) { on_end(static_cast<const Span&>(span)); }
+        // True for processors that keep ended spans past on_end; a provider has at most one
+        virtual bool takes_ownership() const noexcept { return false; }
         virtual void force_flush(duration_t timeout = std::chrono::seconds(30)) = 0;
         virtual void shutdown(duration_t timeout = std::chrono::seconds(30)) = 0;
     };
     
+    struct BatchSpanProcessorMetrics {
+        size_type spans_enqueued{0};
+        size_type spans_exported{0};
+        size_type spans_dropped{0};
+        size_type backpressure_waits{0};
+        size_type batches_exported{0};
+        size_type export_failures{0};
+        size_type queued_spans{0};
+        size_type thread_buffers{0};
+        
+        string to_json() const;
+    };
+    
     class BatchSpanProcessor : public SpanProcessor {
     public:
+        enum class OverflowPolicy : std::uint8_t {
+            DROP = 0,
+            BLOCK = 1
+        };
+        
         struct Config {
+            // Capacity of each producer thread's ring
             size_type max_queue_size{2048};
             duration_t schedule_delay{std::chrono::milliseconds(500)};
             size_type max_export_batch_size{512};
             duration_t export_timeout{std::chrono::seconds(30)};
+            OverflowPolicy overflow_policy{OverflowPolicy::DROP};
+            duration_t max_block_duration{std::chrono::milliseconds(5)};
         };
         
-        explicit BatchSpanProcessor(shared_ptr<SpanExporter> exporter, Config config = {});
+        explicit BatchSpanProcessor(shared_ptr<SpanExporter> exporter);
+        BatchSpanProcessor(shared_ptr<SpanExporter> exporter, Config config);
         ~BatchSpanProcessor() override;
         
         void on_start(const Span& span) override;
         void on_end(const Span& span) override;
+        void on_end(Span&& span) override;
+        bool takes_ownership() const noexcept override { return true; }
+        void set_resource(const Resource& resource) override;
         void force_flush(duration_t timeout = std::chrono::seconds(30)) override;
         void shutdown(duration_t timeout = std::chrono::seconds(30)) override;
         
+        BatchSpanProcessorMetrics metrics() const;
+        
     private:
+        // Single-producer ring owned by one thread, drained by the worker
+        class SpanRing {
+        public:
+            explicit SpanRing(size_type capacity);
+            
+            bool try_push(Span&& span);
+            size_type drain(vector<Span>& out, size_type max_spans);
+            size_type size() const noexcept;
+            size_type producer_backlog() const noexcept { return tail_.load(std::memory_order_relaxed) - cached_head_; }
+            
+            void abandon() noexcept { abandoned_.store(true, std::memory_order_release); }
+            bool abandoned() const noexcept { return abandoned_.load(std::memory_order_acquire); }
+            void detach() noexcept { detached_.store(true, std::memory_order_release); }
+            bool detached() const noexcept { return detached_.load(std::memory_order_acquire); }
+            
+        private:
+            size_type mask_;
+            unique_ptr<optional<Span>[]> slots_;
+            alignas(64) atomic<size_type> head_{0};
+            alignas(64) atomic<size_type> tail_{0};
+            size_type cached_head_{0};
+            atomic<bool> abandoned_{false};
+            atomic<bool> detached_{false};
+        };
+        
+        struct ThreadBuffers;
+        
         shared_ptr<SpanExporter> exporter_;
         Config config_;
-        queue<Span> span_queue_;
-        mutex queue_mutex_;
-        condition_variable queue_condition_;
+        std::uint64_t id_;
+        size_type ring_capacity_;
+        
+        vector<shared_ptr<SpanRing>> buffers_;
+        mutable mutex buffers_mutex_;
+        
+        mutex worker_mutex_;
+        condition_variable worker_condition_;
+        condition_variable flush_condition_;
+        size_type flush_requested_{0};
+        size_type flush_completed_{0};
         unique_ptr<std::thread> worker_thread_;
         atomic<bool> shutdown_requested_{false};
-        
+        atomic<bool> wake_pending_{false};
+        // Set before the worker's final drain; producers inside on_end are counted so
+        // shutdown can wait for their pushes to land first
+        atomic<bool> closed_{false};
+        atomic<size_type> producers_in_flight_{0};
+        
+        atomic<size_type> spans_enqueued_{0};
+        atomic<size_type> spans_exported_{0};
+        atomic<size_type> spans_dropped_{0};
+        atomic<size_type> backpressure_waits_{0};
+        atomic<size_type> batches_exported_{0};
+        atomic<size_type> export_failures_{0};
+        
+        SpanRing& local_ring();
+        void wake_worker() noexcept;
         void worker_loop();
+        void drain_buffers(vector<Span>& batch);
         void export_batch(vector<Span>& spans);
+        
+        static ThreadBuffers& thread_buffers();
     };
     
     class SpanExporter {
@@ -189,6 +350,7 @@ namespace http_framework::tracing {
         };
         
         virtual ~SpanExporter() = default;
+        virtual void set_resource(const Resource& resource) {}
         virtual ExportResult export_spans(const vector<Span>& spans) = 0;
         virtual void shutdown(duration_t timeout = std::chrono::seconds(30)) = 0;
     };
@@ -200,9 +362,11 @@ namespace http_framework::tracing {
             hash_map<string, string> headers;
             duration_t timeout{std::chrono::seconds(10)};
             bool use_grpc{true};
+            bool gzip{false};
         };
         
-        explicit OtlpSpanExporter(Config config = {});
+        OtlpSpanExporter();
+        explicit OtlpSpanExporter(Config config);
         ~OtlpSpanExporter() override;
         
         ExportResult export_spans(const vector<Span>& spans) override;
@@ -211,9 +375,12 @@ namespace http_framework::tracing {
     private:
         Config config_;
         unique_ptr<class HttpClient> http_client_;
+        unique_ptr<OtlpProtobufEncoder> encoder_;
+        buffer_t compressed_;
         
-        string serialize_spans(const vector<Span>& spans);
-        ExportResult send_request(const string& payload);
+        // Protobuf payload, valid until the next call
+        byte_span serialize_spans(const vector<Span>& spans);
+        ExportResult send_request(byte_span payload);
     };
     
     class TracerProvider {
@@ -223,13 +390,19 @@ namespace http_framework::tracing {
             string service_version{"unknown_version"};
             hash_map<string, Attribute> resource_attributes;
             double sampling_ratio{1.0};
+            // Defaults to parent-based sampling over a trace-ID ratio of sampling_ratio
+            shared_ptr<Sampler> sampler;
         };
         
-        explicit TracerProvider(Config config = {});
+        TracerProvider();
+        explicit TracerProvider(Config config);
         ~TracerProvider();
         
         shared_ptr<class Tracer> get_tracer(string_view name, string_view version = "");
+        // Observers run in the order added, ahead of the one processor that takes
+        // ownership; adding a second owner throws std::invalid_argument
         void add_span_processor(unique_ptr<SpanProcessor> processor);
+        const shared_ptr<Sampler>& sampler() const noexcept { return config_.sampler; }
         void force_flush(duration_t timeout = std::chrono::seconds(30));
         void shutdown(duration_t timeout = std::chrono::seconds(30));
         
@@ -243,7 +416,7 @@ namespace http_framework::tracing {
         mutable mutex tracers_mutex_;
         
         void process_span_start(const Span& span);
-        void process_span_end(const Span& span);
+        void process_span_end(Span&& span);
         
         friend class Tracer;
         friend class Span;
@@ -256,6 +429,11 @@ namespace http_framework::tracing {
         unique_ptr<Span> start_span(string_view name, SpanKind kind = SpanKind::INTERNAL);
         unique_ptr<Span> start_span(string_view name, const SpanContext& parent_context, SpanKind kind = SpanKind::INTERNAL);
         
+        // Split form for hot paths: sample first, then allocate a span only if the decision records
+        SamplingDecision should_sample(const SpanContext* parent_context, const TraceId& trace_id, string_view name, SpanKind kind) const;
+        unique_ptr<Span> start_span(string_view name, const SpanContext* parent_context, const TraceId& trace_id,
+                                    SpanKind kind, SamplingDecision decision, timestamp_t start_time);
+        
         template<typename F>
         auto with_span(string_view name, F&& func) -> std::invoke_result_t<F, Span&>;
         
@@ -286,6 +464,7 @@ namespace http_framework::tracing {
         
     private:
         unique_ptr<Span> span_;
+        optional<SpanContext> previous_context_;
     };
     
     thread_local extern optional<SpanContext> current_span_context;
@@ -304,8 +483,11 @@ namespace http_framework::tracing {
     
     namespace http {
         hash_map<string, string> extract_trace_headers(const http_framework::http::Request& request);
+        optional<SpanContext> extract_context(const http_framework::http::Request& request);
         void inject_trace_headers(http_framework::http::Response& response, const SpanContext& context);
         void inject_trace_headers(hash_map<string, string>& headers, const SpanContext& context);
+        // Propagates the calling thread's active context into an outbound request
+        bool inject_current_context(hash_map<string, string>& headers);
         
         SpanScope start_server_span(const http_framework::http::Request& request);
         void end_server_span(Span& span, const http_framework::http::Response& response);
@@ -314,27 +496,40 @@ namespace http_framework::tracing {
         void end_client_span(Span& span, status_code_t status_code);
     }
     
-    template<typename T>
-    Attribute::Attribute(T&& val) {
-        if constexpr (std::is_same_v<std::decay_t<T>, string>) {
-            type = AttributeType::STRING;
-            value = std::forward<T>(val);
-        } else if constexpr (std::is_same_v<std::decay_t<T>, bool>) {
-            type = AttributeType::BOOL;
-            value = std::forward<T>(val);
-        } else if constexpr (std::is_integral_v<std::decay_t<T>>) {
-            type = AttributeType::INT64;
-            value = static_cast<int64_t>(val);
-        } else if constexpr (std::is_floating_point_v<std::decay_t<T>>) {
-            type = AttributeType::DOUBLE;
-            value = static_cast<double>(val);
+    template<typename F>
+    void TraceState::for_each(F&& func) const {
+        string_view remaining = header_;
+        while (!remaining.empty()) {
+            auto comma = remaining.find(',');
+            auto member = remaining.substr(0, comma);
+            remaining = comma == string_view::npos ? string_view{} : remaining.substr(comma + 1);
+            
+            while (!member.empty() && (member.front() == ' ' || member.front() == '\t')) {
+                member.remove_prefix(1);
+            }
+            while (!member.empty() && (member.back() == ' ' || member.back() == '\t')) {
+                member.remove_suffix(1);
+            }
+            
+            auto equals = member.find('=');
+            if (equals != string_view::npos) {
+                func(member.substr(0, equals), member.substr(equals + 1));
+            }
         }
     }
     
     template<typename T>
     Span& Span::set_attribute(string_view key, T&& value) {
         if (recording_) {
-            attributes_[string(key)] = Attribute(std::forward<T>(value));
+            attributes_.set(AttributeKey::intern(key), std::forward<T>(value));
+        }
+        return *this;
+    }
+    
+    template<typename T>
+    Span& Span::set_attribute(AttributeKey key, T&& value) {
+        if (recording_) {
+            attributes_.set(key, std::forward<T>(value));
         }
         return *this;
     }
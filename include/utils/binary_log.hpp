@@ -0,0 +1,228 @@
+#pragma once
+
+#include "core/types.hpp"
+#include <cstring>
+#include <type_traits>
+
+// Call sites below this level are removed at compile time (0 = TRACE ... 5 = FATAL)
+#ifndef HTTP_FRAMEWORK_BLOG_MIN_LEVEL
+#define HTTP_FRAMEWORK_BLOG_MIN_LEVEL 0
+#endif
+
+namespace http_framework::utils::blog {
+    // Stream layout: FILE_MAGIC, then records that each start with a RecordKind byte.
+    // A SITE record describes a call site once per file; EVENT records carry only the
+    // site id, timestamp, thread number and raw argument bytes. Integers are little-endian.
+    inline constexpr char FILE_MAGIC[8] = {'H', 'F', 'B', 'L', 'O', 'G', '0', '1'};
+    
+    enum class RecordKind : std::uint8_t {
+        SITE = 1,
+        EVENT = 2
+    };
+    
+    enum class ArgType : std::uint8_t {
+        BOOL = 1,
+        CHAR = 2,
+        INT64 = 3,
+        UINT64 = 4,
+        DOUBLE = 5,
+        STRING = 6,
+        POINTER = 7
+    };
+    
+    // kind, site id, thread number, unix nanoseconds, argument byte count
+    inline constexpr size_type EVENT_HEADER_BYTES = 1 + 4 + 4 + 8 + 4;
+    
+    struct SiteLocation {
+        LogLevel level;
+        const char* format;
+        const char* file;
+        std::uint32_t line;
+        const char* function;
+    };
+    
+    struct SiteInfo {
+        SiteLocation location;
+        std::span<const ArgType> arg_types;
+    };
+    
+    constexpr bool is_compiled_in(LogLevel level) noexcept {
+        int min_level = HTTP_FRAMEWORK_BLOG_MIN_LEVEL;
+        return static_cast<int>(level) >= min_level;
+    }
+    
+    template<typename T>
+    constexpr ArgType arg_type_of() {
+        using U = std::remove_cvref_t<T>;
+        if constexpr (std::is_same_v<U, bool>) {
+            return ArgType::BOOL;
+        } else if constexpr (std::is_same_v<U, char>) {
+            return ArgType::CHAR;
+        } else if constexpr (std::is_enum_v<U>) {
+            return std::is_signed_v<std::underlying_type_t<U>> ? ArgType::INT64 : ArgType::UINT64;
+        } else if constexpr (std::is_integral_v<U>) {
+            return std::is_signed_v<U> ? ArgType::INT64 : ArgType::UINT64;
+        } else if constexpr (std::is_floating_point_v<U>) {
+            return ArgType::DOUBLE;
+        } else if constexpr (std::is_convertible_v<const U&, string_view>) {
+            return ArgType::STRING;
+        } else if constexpr (std::is_pointer_v<U> || std::is_null_pointer_v<U>) {
+            return ArgType::POINTER;
+        } else {
+            static_assert(sizeof(U) == 0, "binary log arguments must be arithmetic, enums, strings or pointers");
+        }
+    }
+    
+    template<typename... Args>
+    inline constexpr array<ArgType, sizeof...(Args)> ARG_TYPES{arg_type_of<Args>()...};
+    
+    template<typename T>
+    size_type encoded_size(const T& value) noexcept {
+        constexpr auto type = arg_type_of<T>();
+        if constexpr (type == ArgType::STRING) {
+            return sizeof(std::uint32_t) + string_view(value).size();
+        } else if constexpr (type == ArgType::BOOL || type == ArgType::CHAR) {
+            return 1;
+        } else {
+            return 8;
+        }
+    }
+    
+    template<typename T>
+    byte_t* encode_arg(byte_t* out, const T& value) noexcept {
+        constexpr auto type = arg_type_of<T>();
+        if constexpr (type == ArgType::STRING) {
+            string_view text(value);
+            auto length = static_cast<std::uint32_t>(text.size());
+            std::memcpy(out, &length, sizeof(length));
+            std::memcpy(out + sizeof(length), text.data(), text.size());
+            return out + sizeof(length) + text.size();
+        } else if constexpr (type == ArgType::BOOL || type == ArgType::CHAR) {
+            *out = static_cast<byte_t>(value);
+            return out + 1;
+        } else {
+            std::uint64_t bits;
+            if constexpr (type == ArgType::DOUBLE) {
+                auto widened = static_cast<double>(value);
+                std::memcpy(&bits, &widened, sizeof(bits));
+            } else if constexpr (type == ArgType::POINTER) {
+                bits = reinterpret_cast<std::uintptr_t>(value);
+            } else if constexpr (type == ArgType::INT64) {
+                bits = static_cast<std::uint64_t>(static_cast<std::int64_t>(value));
+            } else {
+                bits = static_cast<std::uint64_t>(value);
+            }
+            std::memcpy(out, &bits, sizeof(bits));
+            return out + sizeof(bits);
+        }
+    }
+    
+    class BinaryLogger {
+    public:
+        enum class OverflowPolicy : std::uint8_t {
+            BLOCK = 0,
+            DROP = 1
+        };
+        
+        struct Config {
+            string path{"http_framework.blog"};
+            LogLevel level{LogLevel::INFO};
+            size_type buffer_size{256 * 1024};
+            OverflowPolicy overflow_policy{OverflowPolicy::DROP};
+            duration_t flush_interval{std::chrono::milliseconds(50)};
+            bool truncate{false};
+        };
+        
+        BinaryLogger();
+        explicit BinaryLogger(Config config);
+        BinaryLogger(const BinaryLogger&) = delete;
+        BinaryLogger& operator=(const BinaryLogger&) = delete;
+        ~BinaryLogger();
+        
+        bool should_log(LogLevel level) const noexcept {
+            return level >= level_.load(std::memory_order_relaxed);
+        }
+        void set_level(LogLevel level) noexcept { level_.store(level, std::memory_order_relaxed); }
+        LogLevel level() const noexcept { return level_.load(std::memory_order_relaxed); }
+        
+        // Tag is a lambda type unique to each call site, so every site gets its own id
+        template<typename Tag, typename... Args>
+        void write(const SiteLocation& location, Tag, const Args&... args);
+        
+        void flush();
+        void close();
+        bool is_open() const noexcept;
+        
+        size_type records_written() const noexcept { return records_written_; }
+        size_type bytes_written() const noexcept { return bytes_written_; }
+        size_type dropped_count() const noexcept { return dropped_count_; }
+        
+        static std::uint32_t register_site(const SiteLocation& location, std::span<const ArgType> arg_types);
+        static optional<SiteInfo> site(std::uint32_t site_id);
+        
+        // Lock-free once created, so GLOBAL_BLOG_* costs one load before the level check
+        static BinaryLogger& get_global_logger() {
+            if (auto* logger = global_logger_instance_.load(std::memory_order_acquire)) {
+                return *logger;
+            }
+            return create_global_logger();
+        }
+        static void set_global_logger(unique_ptr<BinaryLogger> logger);
+        
+    private:
+        struct Writer;
+        
+        Config config_;
+        atomic<LogLevel> level_;
+        unique_ptr<Writer> writer_;
+        
+        atomic<size_type> records_written_{0};
+        atomic<size_type> bytes_written_{0};
+        atomic<size_type> dropped_count_{0};
+        
+        static unique_ptr<BinaryLogger> global_logger_;
+        static atomic<BinaryLogger*> global_logger_instance_;
+        static mutex global_logger_mutex_;
+        
+        static BinaryLogger& create_global_logger();
+        
+        byte_t* begin_event(std::uint32_t site_id, size_type args_size);
+        void commit_event(std::uint32_t site_id, size_type record_size);
+        void writer_loop();
+    };
+    
+    template<typename Tag, typename... Args>
+    void BinaryLogger::write(const SiteLocation& location, Tag, const Args&... args) {
+        static const std::uint32_t site_id = register_site(location, ARG_TYPES<Args...>);
+        
+        size_type args_size = (size_type{0} + ... + encoded_size(args));
+        [[maybe_unused]] auto* out = begin_event(site_id, args_size);
+        ((out = encode_arg(out, args)), ...);
+        commit_event(site_id, EVENT_HEADER_BYTES + args_size);
+    }
+}
+
+#define HTTP_BLOG(logger, level, format, ...) \
+    do { \
+        if constexpr (http_framework::utils::blog::is_compiled_in(level)) { \
+            if (auto& blog_logger_ = (logger); blog_logger_.should_log(level)) { \
+                static constexpr http_framework::utils::blog::SiteLocation blog_site_{ \
+                    level, format, __FILE__, __LINE__, __func__}; \
+                blog_logger_.write(blog_site_, [] {} __VA_OPT__(,) __VA_ARGS__); \
+            } \
+        } \
+    } while (false)
+
+#define BLOG_TRACE(logger, ...) HTTP_BLOG(logger, http_framework::LogLevel::TRACE, __VA_ARGS__)
+#define BLOG_DEBUG(logger, ...) HTTP_BLOG(logger, http_framework::LogLevel::DEBUG, __VA_ARGS__)
+#define BLOG_INFO(logger, ...) HTTP_BLOG(logger, http_framework::LogLevel::INFO, __VA_ARGS__)
+#define BLOG_WARN(logger, ...) HTTP_BLOG(logger, http_framework::LogLevel::WARN, __VA_ARGS__)
+#define BLOG_ERROR(logger, ...) HTTP_BLOG(logger, http_framework::LogLevel::ERROR, __VA_ARGS__)
+#define BLOG_FATAL(logger, ...) HTTP_BLOG(logger, http_framework::LogLevel::FATAL, __VA_ARGS__)
+
+#define GLOBAL_BLOG_TRACE(...) BLOG_TRACE(http_framework::utils::blog::BinaryLogger::get_global_logger(), __VA_ARGS__)
+#define GLOBAL_BLOG_DEBUG(...) BLOG_DEBUG(http_framework::utils::blog::BinaryLogger::get_global_logger(), __VA_ARGS__)
+#define GLOBAL_BLOG_INFO(...) BLOG_INFO(http_framework::utils::blog::BinaryLogger::get_global_logger(), __VA_ARGS__)
+#define GLOBAL_BLOG_WARN(...) BLOG_WARN(http_framework::utils::blog::BinaryLogger::get_global_logger(), __VA_ARGS__)
+#define GLOBAL_BLOG_ERROR(...) BLOG_ERROR(http_framework::utils::blog::BinaryLogger::get_global_logger(), __VA_ARGS__)
+#define GLOBAL_BLOG_FATAL(...) BLOG_FATAL(http_framework::utils::blog::BinaryLogger::get_global_logger(), __VA_ARGS__)
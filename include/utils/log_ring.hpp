@@ -0,0 +1,123 @@
+#pragma once
+
+#include "core/types.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace http_framework::utils {
+    // Byte ring with one producer thread and one consumer thread. Records are 8-byte
+    // aligned so a header never wraps; a wrapped payload comes back as two segments.
+    class LogRing {
+    public:
+        static constexpr size_type HEADER_BYTES = 8;
+        static constexpr size_type ALIGNMENT = 8;
+        
+        struct Segment {
+            const byte_t* data;
+            size_type size;
+        };
+        
+        struct Record {
+            std::uint32_t tag;
+            Segment first;
+            Segment second;
+            size_type next;
+            
+            size_type size() const noexcept { return first.size + second.size; }
+            void copy_to(byte_t* out) const noexcept;
+        };
+        
+        // capacity must be a power of two
+        explicit LogRing(size_type capacity)
+            : capacity_(capacity), mask_(capacity - 1), storage_(std::make_unique<byte_t[]>(capacity)) {}
+            
+        size_type capacity() const noexcept { return capacity_; }
+        size_type max_payload() const noexcept { return capacity_ / 2 - HEADER_BYTES; }
+        // Producer-side estimate; it only refreshes when a push runs short of space
+        size_type producer_backlog() const noexcept { return tail_.load(std::memory_order_relaxed) - cached_head_; }
+        
+        bool try_push(std::uint32_t tag, const void* payload, size_type size);
+        
+        size_type head() const noexcept { return head_.load(std::memory_order_relaxed); }
+        size_type published_tail() const noexcept { return tail_.load(std::memory_order_acquire); }
+        Record peek(size_type position) const noexcept;
+        void release(size_type position) noexcept { head_.store(position, std::memory_order_release); }
+        bool empty() const noexcept { return head() == published_tail(); }
+        
+        // Set by the producer thread on exit; the consumer frees the ring once drained
+        void abandon() noexcept { abandoned_.store(true, std::memory_order_release); }
+        bool abandoned() const noexcept { return abandoned_.load(std::memory_order_acquire); }
+        // Set by the consumer on shutdown; producers drop their reference lazily
+        void detach() noexcept { detached_.store(true, std::memory_order_release); }
+        bool detached() const noexcept { return detached_.load(std::memory_order_acquire); }
+        
+        static size_type round_capacity(size_type requested) noexcept;
+        
+    private:
+        size_type capacity_;
+        size_type mask_;
+        unique_ptr<byte_t[]> storage_;
+        alignas(64) atomic<size_type> head_{0};
+        alignas(64) atomic<size_type> tail_{0};
+        size_type cached_head_{0};
+        atomic<bool> abandoned_{false};
+        atomic<bool> detached_{false};
+        
+        static constexpr size_type align_record(size_type bytes) noexcept {
+            return (bytes + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+        }
+    };
+    
+    inline void LogRing::Record::copy_to(byte_t* out) const noexcept {
+        std::memcpy(out, first.data, first.size);
+        std::memcpy(out + first.size, second.data, second.size);
+    }
+    
+    inline bool LogRing::try_push(std::uint32_t tag, const void* payload, size_type size) {
+        auto needed = align_record(HEADER_BYTES + size);
+        auto tail = tail_.load(std::memory_order_relaxed);
+        if (tail + needed - cached_head_ > capacity_) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail + needed - cached_head_ > capacity_) {
+                return false;
+            }
+        }
+        
+        auto offset = tail & mask_;
+        auto length = static_cast<std::uint32_t>(size);
+        std::memcpy(storage_.get() + offset, &length, sizeof(length));
+        std::memcpy(storage_.get() + offset + sizeof(length), &tag, sizeof(tag));
+        
+        auto payload_offset = (offset + HEADER_BYTES) & mask_;
+        auto first_part = std::min(size, capacity_ - payload_offset);
+        auto bytes = static_cast<const byte_t*>(payload);
+        std::memcpy(storage_.get() + payload_offset, bytes, first_part);
+        std::memcpy(storage_.get(), bytes + first_part, size - first_part);
+        
+        tail_.store(tail + needed, std::memory_order_release);
+        return true;
+    }
+    
+    inline LogRing::Record LogRing::peek(size_type position) const noexcept {
+        auto offset = position & mask_;
+        std::uint32_t length = 0;
+        Record record{};
+        std::memcpy(&length, storage_.get() + offset, sizeof(length));
+        std::memcpy(&record.tag, storage_.get() + offset + sizeof(length), sizeof(record.tag));
+        
+        auto payload_offset = (offset + HEADER_BYTES) & mask_;
+        auto first_part = std::min<size_type>(length, capacity_ - payload_offset);
+        record.first = Segment{storage_.get() + payload_offset, first_part};
+        record.second = Segment{storage_.get(), length - first_part};
+        record.next = position + align_record(HEADER_BYTES + length);
+        return record;
+    }
+    
+    inline size_type LogRing::round_capacity(size_type requested) noexcept {
+        size_type capacity = 4096;
+        while (capacity < requested) {
+            capacity <<= 1;
+        }
+        return capacity;
+    }
+}
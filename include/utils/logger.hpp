@@ -7,6 +7,12 @@
 namespace http_framework::utils {
     class Logger {
     public:
+        enum class OverflowPolicy : std::uint8_t {
+            BLOCK = 0,
+            DROP = 1,
+            SAMPLE = 2
+        };
+        
         struct Config {
             LogLevel level{LogLevel::INFO};
             bool console_output{true};
@@ -21,6 +27,13 @@ namespace http_framework::utils {
             size_type max_file_size{10 * 1024 * 1024};
             size_type max_backup_files{5};
             bool colored_output{true};
+            // Async mode formats on the calling thread into a per-thread ring and leaves all I/O to one writer thread
+            bool async{false};
+            size_type async_buffer_size{256 * 1024};
+            OverflowPolicy overflow_policy{OverflowPolicy::DROP};
+            // SAMPLE keeps one in sample_rate records below WARN once a ring is three-quarters full
+            size_type sample_rate{8};
+            duration_t async_flush_interval{std::chrono::milliseconds(50)};
         };
         
         Logger();
@@ -93,6 +106,9 @@ namespace http_framework::utils {
         size_type message_count() const noexcept { return message_count_; }
         size_type error_count() const noexcept { return error_count_; }
         size_type bytes_written() const noexcept { return bytes_written_; }
+        size_type dropped_count() const noexcept { return dropped_count_; }
+        size_type sampled_out_count() const noexcept { return sampled_out_count_; }
+        bool is_async() const noexcept { return async_writer_ != nullptr; }
         
         void rotate_log_file();
         void set_max_file_size(size_type max_size) { config_.max_file_size = max_size; }
@@ -110,12 +126,18 @@ namespace http_framework::utils {
         Config config_;
         unique_ptr<std::ofstream> file_stream_;
         hash_map<string, string> context_;
-        mutable mutex logger_mutex_;
+        atomic<shared_ptr<const string>> context_suffix_;
+        mutable mutex logger_mutex_ HTTP_FRAMEWORK_LOCK_SITE("Logger::logger_mutex_");
+        
+        struct AsyncWriter;
+        unique_ptr<AsyncWriter> async_writer_;
         
         atomic<size_type> message_count_{0};
         atomic<size_type> error_count_{0};
         atomic<size_type> bytes_written_{0};
         atomic<size_type> current_file_size_{0};
+        atomic<size_type> dropped_count_{0};
+        atomic<size_type> sampled_out_count_{0};
         
         static unique_ptr<Logger> global_logger_;
         static mutex global_logger_mutex_;
@@ -125,6 +147,8 @@ namespace http_framework::utils {
         void write_to_file(const string& formatted_message);
         
         string format_message(LogLevel level, string_view message, const optional<hash_map<string, string>>& extra_context) const;
+        void append_formatted_message(string& out, LogLevel level, string_view message,
+                                      const optional<hash_map<string, string>>& extra_context) const;
         string format_timestamp() const;
         string format_thread_id() const;
         string get_color_code(LogLevel level) const;
@@ -137,6 +161,12 @@ namespace http_framework::utils {
         bool open_file_stream();
         void close_file_stream();
         
+        void start_async_writer();
+        void stop_async_writer();
+        void enqueue_async(LogLevel level, string_view formatted_message);
+        void async_writer_loop();
+        void rebuild_context_suffix();
+        
         template<typename... Args>
         string format_string(string_view format, Args&&... args) const;
         
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "core/types.hpp"
+
+namespace http_framework::utils {
+    // In-process sampling CPU profiler producing folded stacks ("root;caller;leaf count"
+    // per line) for flamegraph.pl, speedscope or inferno. The root frame is the thread
+    // name, so threads named "<role>-<n>" aggregate by role unless per_thread is set.
+    //
+    // PERF_EVENT opens one task-clock perf event per thread and lets the kernel collect
+    // user call chains, which needs perf_event_paranoid <= 2 and frame pointers. ITIMER
+    // falls back to setitimer(ITIMER_PROF) with a SIGPROF handler that unwinds with
+    // backtrace(). AUTO tries them in that order. Threads started mid-profile are only
+    // sampled by ITIMER. Symbols come from dladdr, so link with -rdynamic for names of
+    // non-library functions; unresolved frames print as module+offset.
+    class CpuProfiler {
+    public:
+        enum class Backend : std::uint8_t {
+            AUTO = 0,
+            PERF_EVENT = 1,
+            ITIMER = 2
+        };
+        
+        struct Options {
+            duration_t duration{std::chrono::seconds(30)};
+            size_type frequency_hz{99};
+            Backend backend{Backend::AUTO};
+            bool per_thread{false};
+            size_type max_stack_depth{64};
+        };
+        
+        struct Profile {
+            Backend backend{Backend::AUTO};
+            size_type samples{0};
+            size_type lost_samples{0};
+            duration_t duration{};
+            string folded;
+        };
+        
+        // Blocks for options.duration. Only one profile runs per process at a time;
+        // throws std::runtime_error if another is running or no backend can start.
+        static Profile run(const Options& options);
+        static bool is_running() noexcept;
+    };
+    
+    string_view to_string(CpuProfiler::Backend backend) noexcept;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "core/types.hpp"
+
+#if defined(__linux__)
+#include <pthread.h>
+#endif
+
+namespace http_framework::utils {
+    // Names show up in profiles, top -H, gdb and /proc/<pid>/task/<tid>/comm. Use
+    // "<role>-<n>" (reactor-0, worker-3) so the profiler can fold threads by role.
+    // Linux truncates names to 15 bytes.
+    inline void set_current_thread_name(string_view name) {
+#if defined(__linux__)
+        char buffer[16];
+        auto length = std::min<size_type>(name.size(), sizeof(buffer) - 1);
+        std::copy_n(name.data(), length, buffer);
+        buffer[length] = '\0';
+        pthread_setname_np(pthread_self(), buffer);
+#endif
+    }
+    
+    inline string current_thread_name() {
+#if defined(__linux__)
+        char buffer[16] = {};
+        if (pthread_getname_np(pthread_self(), buffer, sizeof(buffer)) == 0) {
+            return buffer;
+        }
+#endif
+        return {};
+    }
+}
@@ -0,0 +1,155 @@
+#include "async/scheduler.hpp"
+#include "utils/thread_name.hpp"
+#include <algorithm>
+
+namespace http_framework::async {
+
+Scheduler::Scheduler() : Scheduler(Config{}) {}
+
+Scheduler::Scheduler(Config config) : config_(std::move(config)) {
+    auto count = std::max<size_type>(config_.worker_threads, 1);
+    workers_.reserve(count);
+    for (size_type i = 0; i < count; ++i) {
+        workers_.emplace_back([this, i]() { worker_loop(i); });
+    }
+    timer_thread_ = std::thread([this]() { timer_loop(); });
+}
+
+Scheduler::~Scheduler() {
+    stopping_.store(true, std::memory_order_release);
+    {
+        lock_guard lock(tasks_mutex_);
+        tasks_condition_.notify_all();
+    }
+    {
+        lock_guard lock(timers_mutex_);
+        timers_condition_.notify_all();
+    }
+    
+    if (timer_thread_.joinable()) {
+        timer_thread_.join();
+    }
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+Scheduler& Scheduler::shared() {
+    static Scheduler instance(Config{
+        std::max<size_type>(2, std::thread::hardware_concurrency() / 4),
+        "sched"
+    });
+    return instance;
+}
+
+void Scheduler::post(function<void()> task) {
+    {
+        lock_guard lock(tasks_mutex_);
+        tasks_.push_back(std::move(task));
+    }
+    tasks_condition_.notify_one();
+}
+
+Scheduler::TimerId Scheduler::post_at(timestamp_t deadline, function<void()> task) {
+    TimerId id;
+    bool earliest = false;
+    {
+        lock_guard lock(timers_mutex_);
+        id = TimerId{deadline, next_sequence_++};
+        auto it = timers_.emplace(id, std::move(task)).first;
+        earliest = it == timers_.begin();
+    }
+    
+    if (earliest) {
+        timers_condition_.notify_one();
+    }
+    return id;
+}
+
+bool Scheduler::cancel(TimerId id) {
+    if (!id) {
+        return false;
+    }
+    lock_guard lock(timers_mutex_);
+    return timers_.erase(id) > 0;
+}
+
+size_type Scheduler::pending_tasks() const {
+    lock_guard lock(tasks_mutex_);
+    return tasks_.size();
+}
+
+size_type Scheduler::pending_timers() const {
+    lock_guard lock(timers_mutex_);
+    return timers_.size();
+}
+
+void Scheduler::worker_loop(size_type index) {
+    utils::set_current_thread_name(config_.thread_name + "-" + std::to_string(index));
+    
+    for (;;) {
+        function<void()> task;
+        {
+            unique_lock lock(tasks_mutex_);
+            tasks_condition_.wait(lock, [this]() {
+                return !tasks_.empty() || stopping_.load(std::memory_order_acquire);
+            });
+            if (stopping_.load(std::memory_order_acquire)) {
+                return;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+        
+        try {
+            task();
+        } catch (...) {
+            // Posted work reports its own failures; one task must not take a worker down
+        }
+    }
+}
+
+void Scheduler::timer_loop() {
+    utils::set_current_thread_name(config_.thread_name + "-timer");
+    
+    vector<function<void()>> due;
+    unique_lock lock(timers_mutex_);
+    
+    while (!stopping_.load(std::memory_order_acquire)) {
+        if (timers_.empty()) {
+            timers_condition_.wait(lock);
+            continue;
+        }
+        
+        auto now = std::chrono::steady_clock::now();
+        auto next = timers_.begin()->first.deadline;
+        if (next > now) {
+            timers_condition_.wait_until(lock, next);
+            continue;
+        }
+        
+        while (!timers_.empty() && timers_.begin()->first.deadline <= now) {
+            due.push_back(std::move(timers_.begin()->second));
+            timers_.erase(timers_.begin());
+        }
+        
+        lock.unlock();
+        {
+            lock_guard tasks_lock(tasks_mutex_);
+            for (auto& task : due) {
+                tasks_.push_back(std::move(task));
+            }
+        }
+        if (due.size() == 1) {
+            tasks_condition_.notify_one();
+        } else {
+            tasks_condition_.notify_all();
+        }
+        due.clear();
+        lock.lock();
+    }
+}
+
+}  // namespace http_framework::async
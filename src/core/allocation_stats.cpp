@@ -0,0 +1,147 @@
+#include "core/allocation_stats.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+namespace http_framework::core {
+
+namespace {
+
+void append_counters(string& out, string_view label, const AllocationCounters& counters) {
+    if (!out.empty()) {
+        out += ", ";
+    }
+    out += label;
+    out += '=';
+    out += std::to_string(counters.allocations);
+    out += '/';
+    out += std::to_string(counters.bytes);
+}
+
+}  // namespace
+
+string RequestAllocations::to_header_value() const {
+    string value;
+    if (!is_active()) {
+        return value;
+    }
+    
+    append_counters(value, "total", total());
+    for_each([&](Phase phase, const AllocationCounters& counters) {
+        append_counters(value, to_string(phase), counters);
+    });
+    return value;
+}
+
+}  // namespace http_framework::core
+
+#if HTTP_FRAMEWORK_ALLOCATION_TRACKING
+
+namespace {
+
+using http_framework::core::thread_allocations;
+
+void count_allocation(std::size_t size) noexcept {
+    ++thread_allocations.allocations;
+    thread_allocations.bytes += size;
+}
+
+void count_deallocation(void* ptr) noexcept {
+    if (ptr) {
+        ++thread_allocations.deallocations;
+    }
+}
+
+// Mirrors the standard operator new: retry through the new-handler, then throw
+void* allocate(std::size_t size) {
+    if (size == 0) {
+        size = 1;
+    }
+    for (;;) {
+        if (auto* ptr = std::malloc(size)) {
+            count_allocation(size);
+            return ptr;
+        }
+        auto handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void* allocate_aligned(std::size_t size, std::align_val_t alignment) {
+    auto align = std::max(static_cast<std::size_t>(alignment), sizeof(void*));
+    // aligned_alloc wants the size to be a multiple of the alignment
+    auto rounded = (std::max<std::size_t>(size, 1) + align - 1) & ~(align - 1);
+    for (;;) {
+        if (auto* ptr = std::aligned_alloc(align, rounded)) {
+            count_allocation(size);
+            return ptr;
+        }
+        auto handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void release(void* ptr) noexcept {
+    count_deallocation(ptr);
+    std::free(ptr);
+}
+
+}  // namespace
+
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new[](std::size_t size) { return allocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return allocate_aligned(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return allocate_aligned(size, alignment); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return allocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return allocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    try {
+        return allocate_aligned(size, alignment);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    try {
+        return allocate_aligned(size, alignment);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* ptr) noexcept { release(ptr); }
+void operator delete[](void* ptr) noexcept { release(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { release(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { release(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { release(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { release(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { release(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { release(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { release(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { release(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { release(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { release(ptr); }
+
+#endif
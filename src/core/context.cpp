@@ -0,0 +1,150 @@
+#include "core/context.hpp"
+#include <algorithm>
+
+namespace http_framework::core {
+
+ContextKeyRegistry& ContextKeyRegistry::instance() {
+    static ContextKeyRegistry registry;
+    return registry;
+}
+
+size_type ContextKeyRegistry::intern(string_view name, const std::type_info& type) {
+    std::unique_lock lock(mutex_);
+    auto it = indices_.find(name);
+    if (it != indices_.end()) {
+        if (*types_[it->second] != type) {
+            throw std::invalid_argument("Context key '" + string(name) + "' is registered with another type");
+        }
+        return it->second;
+    }
+    
+    if (names_.size() >= MAX_KEYS) {
+        throw std::length_error("Context key registry is full");
+    }
+    
+    const auto& stored = names_.emplace_back(name);
+    types_.push_back(&type);
+    auto index = names_.size() - 1;
+    indices_.emplace(stored, index);
+    return index;
+}
+
+optional<size_type> ContextKeyRegistry::find(string_view name) const {
+    shared_lock lock(mutex_);
+    auto it = indices_.find(name);
+    if (it == indices_.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+string_view ContextKeyRegistry::name(size_type index) const {
+    shared_lock lock(mutex_);
+    if (index >= names_.size()) {
+        return {};
+    }
+    return names_[index];
+}
+
+size_type ContextKeyRegistry::size() const {
+    shared_lock lock(mutex_);
+    return names_.size();
+}
+
+ContextSlots::ContextSlots(const ContextSlots& other) {
+    if (other.count_ == 0) {
+        return;
+    }
+    
+    try {
+        for (size_type i = 0; i < INLINE_SLOTS; ++i) {
+            if (other.inline_[i].ops) {
+                other.inline_[i].ops->copy(inline_[i], other.inline_[i]);
+                ++count_;
+            }
+        }
+        for (size_type i = 0; i < other.overflow_capacity_; ++i) {
+            if (other.overflow_[i].ops) {
+                auto& slot = slot_for(INLINE_SLOTS + i);
+                other.overflow_[i].ops->copy(slot, other.overflow_[i]);
+                ++count_;
+            }
+        }
+    } catch (...) {
+        clear();
+        throw;
+    }
+}
+
+ContextSlots::ContextSlots(ContextSlots&& other) noexcept {
+    take(other);
+}
+
+ContextSlots& ContextSlots::operator=(const ContextSlots& other) {
+    if (this != &other) {
+        ContextSlots copy(other);
+        clear();
+        take(copy);
+    }
+    return *this;
+}
+
+ContextSlots& ContextSlots::operator=(ContextSlots&& other) noexcept {
+    if (this != &other) {
+        clear();
+        take(other);
+    }
+    return *this;
+}
+
+void ContextSlots::clear() noexcept {
+    if (count_ == 0) {
+        return;
+    }
+    
+    for (auto& slot : inline_) {
+        if (slot.ops) {
+            slot.ops->destroy(slot);
+        }
+    }
+    for (size_type i = 0; i < overflow_capacity_; ++i) {
+        if (overflow_[i].ops) {
+            overflow_[i].ops->destroy(overflow_[i]);
+        }
+    }
+    count_ = 0;
+}
+
+ContextSlots::Slot& ContextSlots::slot_for(size_type index) {
+    if (index < INLINE_SLOTS) {
+        return inline_[index];
+    }
+    
+    auto offset = index - INLINE_SLOTS;
+    if (offset >= overflow_capacity_) {
+        auto capacity = std::max({offset + 1, overflow_capacity_ * 2, INLINE_SLOTS});
+        auto grown = std::make_unique<Slot[]>(capacity);
+        for (size_type i = 0; i < overflow_capacity_; ++i) {
+            if (overflow_[i].ops) {
+                overflow_[i].ops->move(grown[i], overflow_[i]);
+            }
+        }
+        overflow_ = std::move(grown);
+        overflow_capacity_ = capacity;
+    }
+    return overflow_[offset];
+}
+
+// Expects this to be empty; overflow slots move with their array
+void ContextSlots::take(ContextSlots& other) noexcept {
+    for (size_type i = 0; i < INLINE_SLOTS; ++i) {
+        if (other.inline_[i].ops) {
+            other.inline_[i].ops->move(inline_[i], other.inline_[i]);
+        }
+    }
+    overflow_ = std::move(other.overflow_);
+    overflow_capacity_ = std::exchange(other.overflow_capacity_, 0);
+    count_ = std::exchange(other.count_, 0);
+}
+
+}  // namespace http_framework::core
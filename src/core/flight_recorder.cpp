@@ -0,0 +1,352 @@
+#include "core/flight_recorder.hpp"
+#include "utils/thread_name.hpp"
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <signal.h>
+#include <unistd.h>
+
+namespace http_framework::core {
+
+namespace {
+
+constexpr char HEX_DIGITS[] = "0123456789abcdef";
+
+atomic<std::uint64_t> next_recorder_id{1};
+
+// Signal state is process-wide: the handler only writes a byte to the owner's pipe
+atomic<int> signal_write_fd{-1};
+atomic<FlightRecorder*> signal_owner{nullptr};
+struct sigaction previous_action{};
+
+extern "C" void flight_recorder_signal_handler(int) {
+    auto saved_errno = errno;
+    auto fd = signal_write_fd.load(std::memory_order_relaxed);
+    if (fd >= 0) {
+        char byte = 1;
+        [[maybe_unused]] auto written = ::write(fd, &byte, 1);
+    }
+    errno = saved_errno;
+}
+
+string_view method_name(std::uint8_t method) noexcept {
+    static constexpr array<string_view, 9> names = {
+        "GET", "POST", "PUT", "DELETE", "PATCH", "HEAD", "OPTIONS", "TRACE", "CONNECT"
+    };
+    return method < names.size() ? names[method] : "UNKNOWN";
+}
+
+void append_json_string(string& out, string_view value) {
+    out += '"';
+    for (auto c : value) {
+        auto byte = static_cast<unsigned char>(c);
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (byte < 0x20) {
+            out += "\\u00";
+            out += HEX_DIGITS[byte >> 4];
+            out += HEX_DIGITS[byte & 0x0f];
+        } else {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+void append_record_fields(string& out, const FlightRecord& record) {
+    out += "\"finished_at_ns\":";
+    out += std::to_string(record.finished_at_ns);
+    out += ",\"connection_id\":";
+    out += std::to_string(record.connection_id);
+    out += ",\"method\":\"";
+    out += method_name(record.method);
+    out += "\",\"status\":";
+    out += std::to_string(record.status);
+    out += ",\"route\":";
+    append_json_string(out, record.route_view());
+    out += ",\"total_ns\":";
+    out += std::to_string(record.total_ns);
+    out += ",\"queue_wait_ns\":";
+    out += std::to_string(record.queue_wait_ns);
+    out += ",\"bytes_in\":";
+    out += std::to_string(record.bytes_in);
+    out += ",\"bytes_out\":";
+    out += std::to_string(record.bytes_out);
+    out += ",\"phases\":{";
+    bool first = true;
+    for (size_type i = 0; i < PHASE_COUNT; ++i) {
+        if (record.phase_ns[i] == 0) {
+            continue;
+        }
+        if (!first) {
+            out += ',';
+        }
+        first = false;
+        out += '"';
+        out += to_string(static_cast<Phase>(i));
+        out += "\":";
+        out += std::to_string(record.phase_ns[i]);
+    }
+    out += '}';
+}
+
+void append_u32(buffer_t& out, std::uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        out.push_back(static_cast<byte_t>(value >> shift));
+    }
+}
+
+void append_bytes(buffer_t& out, const void* data, size_type size) {
+    auto* bytes = static_cast<const byte_t*>(data);
+    out.insert(out.end(), bytes, bytes + size);
+}
+
+void append_sized(buffer_t& out, string_view value) {
+    append_u32(out, static_cast<std::uint32_t>(value.size()));
+    append_bytes(out, value.data(), value.size());
+}
+
+std::uint64_t wall_clock_ns() noexcept {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+}  // namespace
+
+void FlightRecord::set_route(string_view value) noexcept {
+    auto length = std::min(value.size(), ROUTE_CAPACITY);
+    std::memcpy(route.data(), value.data(), length);
+    route_length = static_cast<std::uint8_t>(length);
+}
+
+void FlightRecord::set_phases(const RequestPhases& phases) noexcept {
+    phases.for_each([&](Phase phase, std::uint64_t duration_ns) {
+        phase_ns[static_cast<size_type>(phase)] = duration_ns;
+    });
+}
+
+FlightRecorder::Ring::Ring(std::thread::id thread, size_type capacity)
+    : owner(thread),
+      slots(std::make_unique<Slot[]>(capacity)),
+      mask(capacity - 1) {}
+
+FlightRecorder::FlightRecorder() : FlightRecorder(Config{}) {}
+
+FlightRecorder::FlightRecorder(Config config)
+    : config_(std::move(config)),
+      id_(next_recorder_id.fetch_add(1, std::memory_order_relaxed)),
+      slow_threshold_ns_(static_cast<std::uint64_t>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(config_.slow_threshold).count())) {
+    config_.records_per_thread = std::bit_ceil(std::max<size_type>(config_.records_per_thread, 1));
+}
+
+FlightRecorder::~FlightRecorder() {
+    remove_signal_handler();
+}
+
+// Seqlock write: an odd sequence marks the slot as being rewritten. The words are
+// stored through atomic_ref so a concurrent reader's copy is a race-free torn read
+// that the sequence check then rejects.
+void FlightRecorder::record(const FlightRecord& record, string_view uri, string_view request_id) {
+    auto& ring = local_ring();
+    auto index = ring.head.load(std::memory_order_relaxed);
+    auto& slot = ring.slots[index & ring.mask];
+    
+    array<std::uint64_t, RECORD_WORDS> words;
+    std::memcpy(words.data(), &record, sizeof(FlightRecord));
+    
+    auto sequence = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_type i = 0; i < RECORD_WORDS; ++i) {
+        std::atomic_ref<std::uint64_t>(slot.words[i]).store(words[i], std::memory_order_relaxed);
+    }
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+    ring.head.store(index + 1, std::memory_order_release);
+    
+    if (is_slow(record.total_ns) && config_.slow_capacity > 0) {
+        lock_guard lock(slow_mutex_);
+        if (slow_.size() >= config_.slow_capacity) {
+            slow_.pop_front();
+        }
+        slow_.push_back({record, string(uri), string(request_id)});
+    }
+}
+
+vector<FlightRecord> FlightRecorder::snapshot() const {
+    vector<FlightRecord> records;
+    lock_guard lock(rings_mutex_);
+    for (const auto& ring : rings_) {
+        auto head = ring->head.load(std::memory_order_acquire);
+        auto capacity = ring->mask + 1;
+        auto first = head > capacity ? head - capacity : 0;
+        
+        for (auto index = first; index < head; ++index) {
+            auto& slot = ring->slots[index & ring->mask];
+            auto before = slot.sequence.load(std::memory_order_acquire);
+            if (before == 0 || (before & 1) != 0) {
+                continue;
+            }
+            
+            array<std::uint64_t, RECORD_WORDS> words;
+            for (size_type i = 0; i < RECORD_WORDS; ++i) {
+                words[i] = std::atomic_ref<std::uint64_t>(slot.words[i]).load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != before) {
+                continue;
+            }
+            
+            auto& record = records.emplace_back();
+            std::memcpy(static_cast<void*>(&record), words.data(), sizeof(FlightRecord));
+        }
+    }
+    
+    std::sort(records.begin(), records.end(), [](const FlightRecord& a, const FlightRecord& b) {
+        return a.finished_at_ns < b.finished_at_ns;
+    });
+    return records;
+}
+
+vector<SlowRequestRecord> FlightRecorder::slow_requests() const {
+    lock_guard lock(slow_mutex_);
+    return {slow_.begin(), slow_.end()};
+}
+
+void FlightRecorder::dump_json(string& out) const {
+    auto records = snapshot();
+    auto slow = slow_requests();
+    out.reserve(out.size() + (records.size() + slow.size()) * 320);
+    
+    out += "{\"captured_at_ns\":";
+    out += std::to_string(wall_clock_ns());
+    out += ",\"slow_threshold_ns\":";
+    out += std::to_string(slow_threshold_ns_);
+    out += ",\"records\":[";
+    for (size_type i = 0; i < records.size(); ++i) {
+        out += i == 0 ? "{" : ",{";
+        append_record_fields(out, records[i]);
+        out += '}';
+    }
+    out += "],\"slow\":[";
+    for (size_type i = 0; i < slow.size(); ++i) {
+        out += i == 0 ? "{" : ",{";
+        append_record_fields(out, slow[i].summary);
+        out += ",\"uri\":";
+        append_json_string(out, slow[i].uri);
+        out += ",\"request_id\":";
+        append_json_string(out, slow[i].request_id);
+        out += '}';
+    }
+    out += "]}\n";
+}
+
+void FlightRecorder::dump_binary(buffer_t& out) const {
+    auto records = snapshot();
+    auto slow = slow_requests();
+    
+    append_bytes(out, "HFFR", 4);
+    append_u32(out, BINARY_VERSION);
+    append_u32(out, static_cast<std::uint32_t>(sizeof(FlightRecord)));
+    append_u32(out, static_cast<std::uint32_t>(records.size()));
+    append_u32(out, static_cast<std::uint32_t>(slow.size()));
+    append_bytes(out, records.data(), records.size() * sizeof(FlightRecord));
+    for (const auto& entry : slow) {
+        append_bytes(out, &entry.summary, sizeof(FlightRecord));
+        append_sized(out, entry.uri);
+        append_sized(out, entry.request_id);
+    }
+}
+
+bool FlightRecorder::install_signal_handler() {
+    FlightRecorder* expected = nullptr;
+    if (!signal_owner.compare_exchange_strong(expected, this)) {
+        return expected == this;
+    }
+    
+    if (::pipe2(signal_pipe_, O_CLOEXEC) != 0) {
+        signal_owner.store(nullptr);
+        return false;
+    }
+    // A burst of signals must never block the handler; one pending byte is enough
+    ::fcntl(signal_pipe_[1], F_SETFL, ::fcntl(signal_pipe_[1], F_GETFL) | O_NONBLOCK);
+    
+    signal_thread_ = std::thread([this] {
+        utils::set_current_thread_name("flight-dump");
+        char byte;
+        for (;;) {
+            auto result = ::read(signal_pipe_[0], &byte, 1);
+            if (result > 0) {
+                write_dump_file();
+            } else if (result == 0 || errno != EINTR) {
+                break;
+            }
+        }
+    });
+    
+    signal_write_fd.store(signal_pipe_[1], std::memory_order_relaxed);
+    struct sigaction action{};
+    action.sa_handler = flight_recorder_signal_handler;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    ::sigaction(SIGUSR2, &action, &previous_action);
+    return true;
+}
+
+void FlightRecorder::remove_signal_handler() {
+    if (signal_owner.load() != this) {
+        return;
+    }
+    
+    ::sigaction(SIGUSR2, &previous_action, nullptr);
+    signal_write_fd.store(-1, std::memory_order_relaxed);
+    // Closing the write end wakes the helper thread with end-of-file
+    ::close(signal_pipe_[1]);
+    if (signal_thread_.joinable()) {
+        signal_thread_.join();
+    }
+    ::close(signal_pipe_[0]);
+    signal_pipe_[0] = signal_pipe_[1] = -1;
+    signal_owner.store(nullptr);
+}
+
+FlightRecorder::Ring& FlightRecorder::local_ring() {
+    // Keyed by recorder id rather than address, so a recorder allocated where a
+    // destroyed one lived never inherits its dangling ring
+    thread_local std::uint64_t cached_recorder = 0;
+    thread_local Ring* cached_ring = nullptr;
+    if (cached_recorder != id_) {
+        cached_ring = &register_ring();
+        cached_recorder = id_;
+    }
+    return *cached_ring;
+}
+
+FlightRecorder::Ring& FlightRecorder::register_ring() {
+    auto thread = std::this_thread::get_id();
+    lock_guard lock(rings_mutex_);
+    for (auto& ring : rings_) {
+        if (ring->owner == thread) {
+            return *ring;
+        }
+    }
+    rings_.push_back(std::make_unique<Ring>(thread, config_.records_per_thread));
+    return *rings_.back();
+}
+
+void FlightRecorder::write_dump_file() const {
+    string body;
+    dump_json(body);
+    
+    auto unix_ms = wall_clock_ns() / 1000000;
+    auto path = config_.dump_directory + "/flight-recorder-" + std::to_string(::getpid()) + "-" +
+                std::to_string(unix_ms) + ".json";
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(body.data(), static_cast<std::streamsize>(body.size()));
+}
+
+}  // namespace http_framework::core
@@ -0,0 +1,101 @@
+#include "core/instrumented_mutex.hpp"
+#include <map>
+#include <memory>
+#include <string_view>
+
+namespace http_framework::core {
+
+namespace {
+
+struct SiteTable {
+    std::mutex mutex;
+    std::map<std::string, std::unique_ptr<LockSite>, std::less<>> sites;
+};
+
+// Leaked so mutexes in other statics can still record during shutdown
+SiteTable& site_table() {
+    static auto* table = new SiteTable();
+    return *table;
+}
+
+// "void ns::Server::Server(const Config&)" -> "Server::Server". Only top-level
+// separators count, so template arguments survive intact.
+std::string_view short_function_name(std::string_view function) {
+    int depth = 0;
+    std::size_t end = function.size();
+    for (std::size_t i = 0; i < function.size(); ++i) {
+        auto c = function[i];
+        if (c == '<') {
+            ++depth;
+        } else if (c == '>') {
+            --depth;
+        } else if (c == '(' && depth == 0) {
+            end = i;
+            break;
+        }
+    }
+    function = function.substr(0, end);
+    
+    std::size_t begin = 0;
+    std::size_t last_separator = std::string_view::npos;
+    std::size_t previous_separator = std::string_view::npos;
+    depth = 0;
+    for (std::size_t i = 0; i < function.size(); ++i) {
+        auto c = function[i];
+        if (c == '<') {
+            ++depth;
+        } else if (c == '>') {
+            --depth;
+        } else if (depth == 0 && c == ' ') {
+            begin = i + 1;
+            last_separator = previous_separator = std::string_view::npos;
+        } else if (depth == 0 && c == ':' && i + 1 < function.size() && function[i + 1] == ':') {
+            previous_separator = last_separator;
+            last_separator = i;
+            ++i;
+        }
+    }
+    if (previous_separator != std::string_view::npos) {
+        begin = previous_separator + 2;
+    }
+    return function.substr(begin);
+}
+
+std::string_view file_basename(std::string_view path) {
+    auto slash = path.find_last_of("/\\");
+    return slash == std::string_view::npos ? path : path.substr(slash + 1);
+}
+
+}  // namespace
+
+LockSite& LockSite::resolve(const char* name) {
+    auto& table = site_table();
+    std::lock_guard lock(table.mutex);
+    auto it = table.sites.find(std::string_view(name));
+    if (it == table.sites.end()) {
+        it = table.sites.emplace(name, std::make_unique<LockSite>(name)).first;
+    }
+    return *it->second;
+}
+
+LockSite& LockSite::resolve(const std::source_location& location) {
+    std::string name(short_function_name(location.function_name()));
+    if (name.empty()) {
+        name = "<global>";
+    }
+    name += '@';
+    name += file_basename(location.file_name());
+    name += ':';
+    name += std::to_string(location.line());
+    return resolve(name.c_str());
+}
+
+void LockSite::visit(void (*visitor)(LockSite&, void*), void* context) {
+    auto& table = site_table();
+    std::lock_guard lock(table.mutex);
+    for (auto& [name, site] : table.sites) {
+        visitor(*site, context);
+    }
+}
+
+}  // namespace http_framework::core
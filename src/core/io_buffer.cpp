@@ -0,0 +1,495 @@
+#include "core/io_buffer.hpp"
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace http_framework::core {
+
+namespace {
+
+constexpr size_type HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+constexpr std::align_val_t BLOCK_ALIGNMENT{alignof(IoBlock)};
+
+struct CentralList {
+    mutex list_mutex;
+    vector<void*> blocks;
+};
+
+struct PoolState {
+    mutex config_mutex;
+    SlabPool::Config config;
+    atomic<size_type> thread_cache_blocks{SlabPool::Config{}.thread_cache_blocks};
+    array<CentralList, SlabPool::SIZE_CLASS_COUNT> central;
+    atomic<size_type> slabs{0};
+    atomic<size_type> huge_page_slabs{0};
+    atomic<size_type> reserved_bytes{0};
+};
+
+// Leaked so blocks released from static destructors still have somewhere to go
+PoolState& pool_state() {
+    static auto* state = new PoolState();
+    return *state;
+}
+
+constinit thread_local bool thread_cache_destroyed = false;
+
+struct ThreadCache {
+    array<vector<void*>, SlabPool::SIZE_CLASS_COUNT> blocks;
+    
+    ~ThreadCache() {
+        thread_cache_destroyed = true;
+        auto& state = pool_state();
+        for (size_type i = 0; i < SlabPool::SIZE_CLASS_COUNT; ++i) {
+            if (blocks[i].empty()) {
+                continue;
+            }
+            lock_guard lock(state.central[i].list_mutex);
+            state.central[i].blocks.insert(state.central[i].blocks.end(), blocks[i].begin(), blocks[i].end());
+        }
+    }
+};
+
+// Null once the thread's cache has been torn down; callers then use the central lists
+ThreadCache* thread_cache() {
+    if (thread_cache_destroyed) {
+        return nullptr;
+    }
+    thread_local ThreadCache cache;
+    return &cache;
+}
+
+void* map_slab(size_type size, bool huge_pages, bool& used_huge_pages) {
+    used_huge_pages = false;
+#if defined(__linux__)
+    if (huge_pages) {
+#if defined(MAP_HUGETLB)
+        auto* memory = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (memory != MAP_FAILED) {
+            used_huge_pages = true;
+            return memory;
+        }
+#endif
+    }
+    auto* memory = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+#if defined(MADV_HUGEPAGE)
+    if (huge_pages) {
+        ::madvise(memory, size, MADV_HUGEPAGE);
+    }
+#endif
+    return memory;
+#else
+    return ::operator new(size, std::align_val_t{4096});
+#endif
+}
+
+// Caller holds the class's central list lock
+void carve_slab(PoolState& state, size_type size_class) {
+    SlabPool::Config config;
+    {
+        lock_guard lock(state.config_mutex);
+        config = state.config;
+    }
+    auto block_size = SlabPool::SIZE_CLASSES[size_class];
+    auto slab_size = std::max(config.slab_size, block_size);
+    if (config.huge_pages) {
+        slab_size = (slab_size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    }
+    
+    bool used_huge_pages = false;
+    auto* slab = static_cast<byte_t*>(map_slab(slab_size, config.huge_pages, used_huge_pages));
+    state.slabs.fetch_add(1, std::memory_order_relaxed);
+    state.reserved_bytes.fetch_add(slab_size, std::memory_order_relaxed);
+    if (used_huge_pages) {
+        state.huge_page_slabs.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    auto& blocks = state.central[size_class].blocks;
+    auto count = slab_size / block_size;
+    blocks.reserve(blocks.size() + count);
+    // Pushed in reverse so blocks are handed out in address order
+    for (size_type i = count; i-- > 0;) {
+        blocks.push_back(slab + i * block_size);
+    }
+}
+
+}  // namespace
+
+void SlabPool::configure(const Config& config) {
+    auto& state = pool_state();
+    lock_guard lock(state.config_mutex);
+    state.config = config;
+    state.thread_cache_blocks.store(std::max<size_type>(config.thread_cache_blocks, 2), std::memory_order_relaxed);
+}
+
+SlabPool::Config SlabPool::config() {
+    auto& state = pool_state();
+    lock_guard lock(state.config_mutex);
+    return state.config;
+}
+
+SlabPool::Stats SlabPool::stats() noexcept {
+    auto& state = pool_state();
+    return {state.slabs.load(std::memory_order_relaxed), state.huge_page_slabs.load(std::memory_order_relaxed),
+            state.reserved_bytes.load(std::memory_order_relaxed)};
+}
+
+void* SlabPool::allocate(size_type size_class) {
+    auto* cache = thread_cache();
+    if (cache && !cache->blocks[size_class].empty()) {
+        auto* block = cache->blocks[size_class].back();
+        cache->blocks[size_class].pop_back();
+        return block;
+    }
+    
+    auto& state = pool_state();
+    auto& central = state.central[size_class];
+    lock_guard lock(central.list_mutex);
+    if (central.blocks.empty()) {
+        carve_slab(state, size_class);
+    }
+    auto* block = central.blocks.back();
+    central.blocks.pop_back();
+    if (cache) {
+        auto batch = std::min(central.blocks.size(), state.thread_cache_blocks.load(std::memory_order_relaxed) / 2);
+        auto& local = cache->blocks[size_class];
+        local.insert(local.end(), central.blocks.end() - static_cast<std::ptrdiff_t>(batch), central.blocks.end());
+        central.blocks.resize(central.blocks.size() - batch);
+    }
+    return block;
+}
+
+void SlabPool::deallocate(void* block, size_type size_class) noexcept {
+    auto& state = pool_state();
+    auto* cache = thread_cache();
+    if (cache) {
+        auto& local = cache->blocks[size_class];
+        auto limit = state.thread_cache_blocks.load(std::memory_order_relaxed);
+        if (local.size() < limit) {
+            local.push_back(block);
+            return;
+        }
+        // Keep half so a thread alternating around the limit does not bounce batches
+        auto& central = state.central[size_class];
+        auto keep = limit / 2;
+        lock_guard lock(central.list_mutex);
+        central.blocks.insert(central.blocks.end(), local.begin() + static_cast<std::ptrdiff_t>(keep), local.end());
+        local.resize(keep);
+        local.push_back(block);
+        return;
+    }
+    
+    auto& central = state.central[size_class];
+    lock_guard lock(central.list_mutex);
+    central.blocks.push_back(block);
+}
+
+IoBlock* IoBlock::create(size_type min_capacity) {
+    auto size_class = SlabPool::size_class_for(min_capacity + sizeof(IoBlock));
+    void* memory = nullptr;
+    size_type capacity = min_capacity;
+    if (size_class == SlabPool::LARGE) {
+        memory = ::operator new(sizeof(IoBlock) + min_capacity, BLOCK_ALIGNMENT);
+    } else {
+        memory = SlabPool::allocate(size_class);
+        capacity = SlabPool::SIZE_CLASSES[size_class] - sizeof(IoBlock);
+    }
+    
+    auto* block = new (memory) IoBlock();
+    block->size_class = static_cast<std::uint32_t>(size_class);
+    block->capacity = capacity;
+    return block;
+}
+
+void IoBlock::release() noexcept {
+    if (refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+    }
+    auto block_class = static_cast<size_type>(size_class);
+    this->~IoBlock();
+    if (block_class == SlabPool::LARGE) {
+        ::operator delete(static_cast<void*>(this), BLOCK_ALIGNMENT);
+    } else {
+        SlabPool::deallocate(static_cast<void*>(this), block_class);
+    }
+}
+
+IoSlice IoSlice::copy_of(byte_span bytes) {
+    if (bytes.empty()) {
+        return {};
+    }
+    auto* block = IoBlock::create(bytes.size());
+    block->reserved.store(bytes.size(), std::memory_order_relaxed);
+    std::memcpy(block->data(), bytes.data(), bytes.size());
+    return IoSlice(block, 0, bytes.size());
+}
+
+IoSlice IoSlice::subslice(size_type offset, size_type length) const {
+    offset = std::min(offset, length_);
+    length = std::min(length, length_ - offset);
+    if (length == 0) {
+        return {};
+    }
+    block_->retain();
+    return IoSlice(block_, offset_ + offset, length);
+}
+
+IoSlice IoSlice::split_front(size_type length) {
+    auto front = subslice(0, length);
+    remove_prefix(front.size());
+    return front;
+}
+
+void IoSlice::remove_prefix(size_type length) noexcept {
+    length = std::min(length, length_);
+    offset_ += length;
+    length_ -= length;
+}
+
+void IoSlice::remove_suffix(size_type length) noexcept {
+    length_ -= std::min(length, length_);
+}
+
+IoBuffer& IoBuffer::operator=(const IoBuffer& other) {
+    if (this != &other) {
+        release_prepared();
+        slices_ = other.slices_;
+        size_ = other.size_;
+    }
+    return *this;
+}
+
+IoBuffer& IoBuffer::operator=(IoBuffer&& other) noexcept {
+    if (this != &other) {
+        release_prepared();
+        slices_ = std::move(other.slices_);
+        size_ = std::exchange(other.size_, 0);
+        prepared_ = std::exchange(other.prepared_, nullptr);
+        prepared_offset_ = other.prepared_offset_;
+        prepared_length_ = std::exchange(other.prepared_length_, 0);
+    }
+    return *this;
+}
+
+size_type IoBuffer::extend_tail(byte_span bytes) noexcept {
+    if (slices_.empty() || bytes.empty()) {
+        return 0;
+    }
+    auto& tail = slices_.back();
+    auto* block = tail.block_;
+    auto end = tail.offset_ + tail.length_;
+    auto length = std::min(bytes.size(), block->capacity - end);
+    if (length == 0 || !block->try_reserve(end, length)) {
+        return 0;
+    }
+    std::memcpy(block->data() + end, bytes.data(), length);
+    tail.length_ += length;
+    size_ += length;
+    return length;
+}
+
+void IoBuffer::append(byte_span bytes) {
+    release_prepared();
+    auto copied = extend_tail(bytes);
+    if (copied == bytes.size()) {
+        return;
+    }
+    
+    auto rest = bytes.subspan(copied);
+    auto* block = IoBlock::create(std::max(rest.size(), DEFAULT_BLOCK_SIZE - sizeof(IoBlock)));
+    block->reserved.store(rest.size(), std::memory_order_relaxed);
+    std::memcpy(block->data(), rest.data(), rest.size());
+    slices_.push_back(IoSlice(block, 0, rest.size()));
+    size_ += rest.size();
+}
+
+void IoBuffer::append(IoSlice slice) {
+    if (slice.empty()) {
+        return;
+    }
+    release_prepared();
+    size_ += slice.size();
+    if (!slices_.empty()) {
+        auto& tail = slices_.back();
+        if (tail.block_ == slice.block_ && tail.offset_ + tail.length_ == slice.offset_) {
+            tail.length_ += slice.length_;
+            return;
+        }
+    }
+    slices_.push_back(std::move(slice));
+}
+
+void IoBuffer::append(const IoBuffer& other) {
+    if (&other == this) {
+        auto copy = other;
+        append(std::move(copy));
+        return;
+    }
+    for (const auto& slice : other.slices_) {
+        append(slice);
+    }
+}
+
+void IoBuffer::append(IoBuffer&& other) {
+    other.release_prepared();
+    if (slices_.empty()) {
+        release_prepared();
+        slices_ = std::move(other.slices_);
+        size_ = std::exchange(other.size_, 0);
+        other.slices_.clear();
+        return;
+    }
+    for (auto& slice : other.slices_) {
+        append(std::move(slice));
+    }
+    other.clear();
+}
+
+mutable_byte_span IoBuffer::prepare(size_type min_bytes) {
+    release_prepared();
+    min_bytes = std::max<size_type>(min_bytes, 1);
+    
+    if (!slices_.empty()) {
+        auto& tail = slices_.back();
+        auto* block = tail.block_;
+        auto end = tail.offset_ + tail.length_;
+        auto room = block->capacity - end;
+        if (room >= min_bytes && block->try_reserve(end, room)) {
+            block->retain();
+            prepared_ = block;
+            prepared_offset_ = end;
+            prepared_length_ = room;
+            return {block->data() + end, room};
+        }
+    }
+    
+    auto* block = IoBlock::create(std::max(min_bytes, DEFAULT_BLOCK_SIZE - sizeof(IoBlock)));
+    block->reserved.store(block->capacity, std::memory_order_relaxed);
+    prepared_ = block;
+    prepared_offset_ = 0;
+    prepared_length_ = block->capacity;
+    return {block->data(), block->capacity};
+}
+
+void IoBuffer::commit(size_type bytes) {
+    if (!prepared_) {
+        return;
+    }
+    bytes = std::min(bytes, prepared_length_);
+    if (bytes > 0) {
+        auto* tail = slices_.empty() ? nullptr : &slices_.back();
+        if (tail && tail->block_ == prepared_ && tail->offset_ + tail->length_ == prepared_offset_) {
+            tail->length_ += bytes;
+        } else {
+            prepared_->retain();
+            slices_.push_back(IoSlice(prepared_, prepared_offset_, bytes));
+        }
+        prepared_offset_ += bytes;
+        prepared_length_ -= bytes;
+        size_ += bytes;
+    }
+    release_prepared();
+}
+
+void IoBuffer::release_prepared() noexcept {
+    if (!prepared_) {
+        return;
+    }
+    // Hand unused space back unless someone has reserved past it since
+    auto end = prepared_offset_ + prepared_length_;
+    prepared_->reserved.compare_exchange_strong(end, prepared_offset_, std::memory_order_relaxed);
+    prepared_->release();
+    prepared_ = nullptr;
+    prepared_length_ = 0;
+}
+
+void IoBuffer::consume(size_type bytes) {
+    release_prepared();
+    bytes = std::min(bytes, size_);
+    size_ -= bytes;
+    size_type dropped = 0;
+    while (bytes > 0 && bytes >= slices_[dropped].size()) {
+        bytes -= slices_[dropped].size();
+        ++dropped;
+    }
+    slices_.erase(slices_.begin(), slices_.begin() + static_cast<std::ptrdiff_t>(dropped));
+    if (bytes > 0) {
+        slices_.front().remove_prefix(bytes);
+    }
+}
+
+IoBuffer IoBuffer::split(size_type bytes) {
+    release_prepared();
+    IoBuffer front;
+    bytes = std::min(bytes, size_);
+    size_type taken = 0;
+    while (bytes > 0 && bytes >= slices_[taken].size()) {
+        bytes -= slices_[taken].size();
+        front.size_ += slices_[taken].size();
+        front.slices_.push_back(std::move(slices_[taken]));
+        ++taken;
+    }
+    slices_.erase(slices_.begin(), slices_.begin() + static_cast<std::ptrdiff_t>(taken));
+    if (bytes > 0) {
+        front.size_ += bytes;
+        front.slices_.push_back(slices_.front().split_front(bytes));
+    }
+    size_ -= front.size_;
+    return front;
+}
+
+void IoBuffer::clear() noexcept {
+    release_prepared();
+    slices_.clear();
+    size_ = 0;
+}
+
+size_type IoBuffer::copy_to(mutable_byte_span out, size_type offset) const noexcept {
+    size_type copied = 0;
+    for (const auto& slice : slices_) {
+        if (copied == out.size()) {
+            break;
+        }
+        if (offset >= slice.size()) {
+            offset -= slice.size();
+            continue;
+        }
+        auto length = std::min(slice.size() - offset, out.size() - copied);
+        std::memcpy(out.data() + copied, slice.data() + offset, length);
+        copied += length;
+        offset = 0;
+    }
+    return copied;
+}
+
+buffer_t IoBuffer::to_vector() const {
+    buffer_t result(size_);
+    copy_to(result);
+    return result;
+}
+
+string IoBuffer::to_string() const {
+    string result(size_, '\0');
+    copy_to(mutable_byte_span(reinterpret_cast<byte_t*>(result.data()), result.size()));
+    return result;
+}
+
+byte_span IoBuffer::linearize() {
+    release_prepared();
+    if (slices_.size() > 1) {
+        auto* block = IoBlock::create(size_);
+        block->reserved.store(size_, std::memory_order_relaxed);
+        copy_to(mutable_byte_span(block->data(), size_));
+        slices_.clear();
+        slices_.push_back(IoSlice(block, 0, size_));
+    }
+    return slices_.empty() ? byte_span{} : slices_.front().span();
+}
+
+}  // namespace http_framework::core
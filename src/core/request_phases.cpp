@@ -0,0 +1,75 @@
+#include "core/request_phases.hpp"
+#include <thread>
+
+namespace http_framework::core {
+
+namespace {
+
+double calibrate_tsc() noexcept {
+    using namespace std::chrono;
+    
+    auto wall_start = steady_clock::now();
+    auto ticks_start = TscClock::now();
+    std::this_thread::sleep_for(milliseconds(10));
+    auto ticks_end = TscClock::now();
+    auto wall_end = steady_clock::now();
+    
+    auto elapsed_ns = duration_cast<nanoseconds>(wall_end - wall_start).count();
+    if (ticks_end <= ticks_start || elapsed_ns <= 0) {
+        return 1.0;
+    }
+    return static_cast<double>(elapsed_ns) / static_cast<double>(ticks_end - ticks_start);
+}
+
+}  // namespace
+
+string_view to_string(Phase phase) noexcept {
+    switch (phase) {
+        case Phase::READ: return "read";
+        case Phase::PARSE: return "parse";
+        case Phase::ROUTE: return "route";
+        case Phase::MIDDLEWARE: return "middleware";
+        case Phase::HANDLER: return "handler";
+        case Phase::SERIALIZE: return "serialize";
+        case Phase::WRITE: return "write";
+    }
+    return "unknown";
+}
+
+double TscClock::nanoseconds_per_tick() noexcept {
+    static const double ratio = calibrate_tsc();
+    return ratio;
+}
+
+std::uint64_t RequestPhases::duration_ns(Phase phase) const noexcept {
+    std::uint64_t result = 0;
+    for_each([&](Phase marked, std::uint64_t duration) {
+        if (marked == phase) {
+            result = duration;
+        }
+    });
+    return result;
+}
+
+std::uint64_t RequestPhases::total_ns() const noexcept {
+    if (!is_active()) {
+        return 0;
+    }
+    
+    std::uint64_t last = start_;
+    for (auto end : ends_) {
+        last = std::max(last, end);
+    }
+    return TscClock::to_nanoseconds(last - start_);
+}
+
+timestamp_t RequestPhases::timestamp_of(Phase phase) const noexcept {
+    auto end = ends_[static_cast<size_type>(phase)];
+    if (!is_active() || end <= start_) {
+        return started_at_;
+    }
+    auto offset = std::chrono::nanoseconds(TscClock::to_nanoseconds(end - start_));
+    return started_at_ + std::chrono::duration_cast<timestamp_t::duration>(offset);
+}
+
+}  // namespace http_framework::core
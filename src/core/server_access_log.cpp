@@ -0,0 +1,31 @@
+#include "core/server.hpp"
+
+namespace http_framework::core {
+
+void Server::enable_access_logging(string_view log_file) {
+    http::AccessLog::Config config;
+    config.path = string(log_file);
+    enable_access_logging(std::move(config));
+}
+
+void Server::enable_access_logging(http::AccessLog::Config config) {
+    access_log_file_ = config.path;
+    access_log_ = std::make_unique<http::AccessLog>(std::move(config));
+    access_logging_enabled_ = true;
+}
+
+// The log stays alive so requests already in flight never see it destroyed
+void Server::disable_access_logging() {
+    access_logging_enabled_ = false;
+    if (access_log_) {
+        access_log_->flush();
+    }
+}
+
+void Server::log_access(const http::Request& request, const http::Response& response) {
+    if (access_logging_enabled_ && access_log_) {
+        access_log_->log(request, response);
+    }
+}
+
+}  // namespace http_framework::core
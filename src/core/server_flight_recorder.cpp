@@ -0,0 +1,67 @@
+#include "core/server.hpp"
+
+namespace http_framework::core {
+
+void Server::enable_flight_recorder(string_view endpoint, FlightRecorder::Config config) {
+    flight_recorder_endpoint_ = string(endpoint);
+    if (flight_recorder_) {
+        return;
+    }
+    
+    flight_recorder_ = std::make_unique<FlightRecorder>(std::move(config));
+    flight_recorder_->install_signal_handler();
+}
+
+// The recorder stays alive so in-flight requests can still record into it
+void Server::disable_flight_recorder() {
+    flight_recorder_endpoint_.reset();
+    if (flight_recorder_) {
+        flight_recorder_->remove_signal_handler();
+    }
+}
+
+void Server::handle_flight_recorder(const http::Request& request, http::Response& response) {
+    if (!flight_recorder_) {
+        response.send_error(404, "Flight recorder is disabled");
+        return;
+    }
+    
+    response.set_status_code(200);
+    if (request.get_query_param("format") == "binary") {
+        buffer_t body;
+        flight_recorder_->dump_binary(body);
+        response.set_header("Content-Type", "application/octet-stream");
+        response.set_body(std::move(body));
+        return;
+    }
+    
+    string body;
+    flight_recorder_->dump_json(body);
+    response.set_header("Content-Type", "application/json");
+    response.set_body(body);
+}
+
+void Server::record_flight(const http::Request& request, const http::Response& response, const Connection& connection,
+                           FlightRecord record) {
+    if (!flight_recorder_ || !flight_recorder_endpoint_) {
+        return;
+    }
+    
+    string_view path = request.uri();
+    record.finished_at_ns = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    record.connection_id = connection.connection_id();
+    record.status = response.status_code();
+    record.method = static_cast<std::uint8_t>(request.method());
+    record.set_route(path.substr(0, path.find_first_of("?#")));
+    record.set_phases(connection.request_phases());
+    
+    if (!flight_recorder_->is_slow(record.total_ns)) {
+        flight_recorder_->record(record);
+        return;
+    }
+    auto request_id = request.get_header("X-Request-Id");
+    flight_recorder_->record(record, request.uri(), request_id ? string_view(*request_id) : string_view{});
+}
+
+}  // namespace http_framework::core
@@ -0,0 +1,142 @@
+#include "core/server.hpp"
+#include "metrics/lock_metrics.hpp"
+#include <fstream>
+#include <unistd.h>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace http_framework::core {
+
+namespace {
+
+double allocated_bytes() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    auto info = mallinfo2();
+    return static_cast<double>(info.uordblks + info.hblkhd);
+#else
+    return 0.0;
+#endif
+}
+
+double resident_bytes() {
+    std::ifstream statm("/proc/self/statm");
+    size_type total_pages = 0;
+    size_type resident_pages = 0;
+    if (!(statm >> total_pages >> resident_pages)) {
+        return 0.0;
+    }
+    return static_cast<double>(resident_pages) * static_cast<double>(sysconf(_SC_PAGESIZE));
+}
+
+string_view route_path(const http::Request& request) noexcept {
+    string_view path = request.uri();
+    return path.substr(0, path.find_first_of("?#"));
+}
+
+}  // namespace
+
+void Server::enable_metrics(string_view endpoint) {
+    metrics_endpoint_ = string(endpoint);
+    if (http_metrics_) {
+        return;
+    }
+    
+    http_metrics_ = std::make_unique<metrics::HttpServerMetrics>(metrics_registry_);
+    
+    metrics_registry_.callback_gauge("http_server_connections_active", "Open client connections", [this] {
+        std::shared_lock lock(connections_mutex_);
+        return static_cast<double>(connections_.size());
+    });
+    metrics_registry_.callback_gauge("http_server_requests_in_flight", "HTTP requests currently being processed", [this] {
+        return static_cast<double>(active_request_count_.load(std::memory_order_relaxed));
+    });
+    metrics_registry_.callback_gauge("http_server_requests_failed", "Requests that ended in an unhandled error", [this] {
+        return static_cast<double>(failed_requests_.load(std::memory_order_relaxed));
+    });
+    
+    metrics_registry_.callback_gauge("thread_pool_threads", "Worker threads in the request pool", [this] {
+        return thread_pool_ ? static_cast<double>(thread_pool_->size()) : 0.0;
+    });
+    metrics_registry_.callback_gauge("thread_pool_threads_active", "Worker threads running a task", [this] {
+        return thread_pool_ ? static_cast<double>(thread_pool_->active_threads()) : 0.0;
+    });
+    metrics_registry_.callback_gauge("thread_pool_tasks_pending", "Tasks queued for the request pool", [this] {
+        return thread_pool_ ? static_cast<double>(thread_pool_->pending_tasks()) : 0.0;
+    });
+    metrics_registry_.callback_gauge("thread_pool_tasks_completed", "Tasks completed by the request pool", [this] {
+        return thread_pool_ ? static_cast<double>(thread_pool_->completed_tasks()) : 0.0;
+    });
+    
+    metrics_registry_.callback_gauge("process_heap_allocated_bytes", "Bytes in use by the C allocator", allocated_bytes);
+    metrics_registry_.callback_gauge("process_resident_memory_bytes", "Resident set size", resident_bytes);
+}
+
+// Series stay registered so a later enable_metrics resumes the same counters
+void Server::disable_metrics() {
+    metrics_endpoint_.reset();
+}
+
+void Server::handle_metrics(const http::Request& request, http::Response& response) {
+    string body;
+    body.reserve(32 * 1024);
+    metrics_registry_.render_prometheus(body);
+    metrics::Registry::instance().render_prometheus(body);
+    metrics::render_lock_metrics(body);
+    
+    response.set_status_code(200);
+    response.set_header("Content-Type", "text/plain; version=0.0.4; charset=utf-8");
+    response.set_body(body);
+}
+
+void Server::collect_performance_metrics(const http::Request& request, const http::Response& response,
+                                         duration_t processing_time) {
+    if (!http_metrics_ || !metrics_endpoint_) {
+        return;
+    }
+    
+    auto duration_us = std::chrono::duration_cast<std::chrono::microseconds>(processing_time).count();
+    http_metrics_->record(route_path(request), request.method(), response.status_code(),
+                          static_cast<std::uint64_t>(std::max<std::int64_t>(duration_us, 0)));
+}
+
+void Server::enable_phase_timing(bool enable) {
+    if (enable) {
+        // Calibration sleeps briefly, so do it here rather than on the first timed request
+        TscClock::nanoseconds_per_tick();
+    }
+    RequestPhases::set_enabled(enable);
+}
+
+void Server::record_request_phases(const http::Request& request, const RequestPhases& phases, tracing::RequestTrace& trace) {
+    if (!phases.is_active()) {
+        return;
+    }
+
+    if (trace.is_recording()) {
+        phases.for_each([&](Phase phase, std::uint64_t) {
+            trace.mark(to_string(phase), phases.timestamp_of(phase));
+        });
+    }
+
+    if (http_metrics_ && metrics_endpoint_) {
+        http_metrics_->record_phases(http_metrics_->route(route_path(request)), phases);
+    }
+}
+
+void Server::annotate_allocations(const http::Request& request, http::Response& response, const RequestAllocations& allocations) {
+    if (!allocations.is_active() || !request.has_header("X-Debug-Allocations")) {
+        return;
+    }
+    response.set_header("X-Allocations", allocations.to_header_value());
+}
+
+void Server::record_request_allocations(const http::Request& request, const RequestAllocations& allocations) {
+    if (!allocations.is_active() || !http_metrics_ || !metrics_endpoint_) {
+        return;
+    }
+    http_metrics_->record_allocations(http_metrics_->route(route_path(request)), allocations);
+}
+
+}  // namespace http_framework::core
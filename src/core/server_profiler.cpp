@@ -0,0 +1,111 @@
+#include "core/server.hpp"
+#include "async/completion.hpp"
+#include "async/scheduler.hpp"
+#include "utils/thread_name.hpp"
+#include <charconv>
+
+namespace http_framework::core {
+
+namespace {
+
+optional<size_type> numeric_param(const http::Request& request, string_view name) {
+    auto value = request.get_query_param(name);
+    if (!value) {
+        return std::nullopt;
+    }
+    size_type result = 0;
+    auto [end, error] = std::from_chars(value->data(), value->data() + value->size(), result);
+    if (error != std::errc{} || end != value->data() + value->size()) {
+        return std::nullopt;
+    }
+    return result;
+}
+
+using ProfileCompletion = async::Completion<utils::CpuProfiler::Profile>;
+
+// Samples and symbolizes on a thread of its own, then hands the result to a scheduler
+// worker so the awaiting handler never continues on the profiler thread
+void start_profile_thread(utils::CpuProfiler::Options options, shared_ptr<ProfileCompletion> completion) {
+    std::thread([options, completion]() {
+        utils::set_current_thread_name("profiler");
+        try {
+            auto profile = std::make_shared<utils::CpuProfiler::Profile>(utils::CpuProfiler::run(options));
+            async::Scheduler::shared().post([completion, profile]() {
+                completion->set_value(std::move(*profile));
+            });
+        } catch (...) {
+            async::Scheduler::shared().post([completion, error = std::current_exception()]() {
+                completion->set_exception(error);
+            });
+        }
+    }).detach();
+}
+
+}  // namespace
+
+void Server::enable_profiling(string_view endpoint, duration_t max_duration) {
+    profile_endpoint_ = string(endpoint);
+    max_profile_duration_ = max_duration;
+}
+
+void Server::disable_profiling() {
+    profile_endpoint_.reset();
+}
+
+async::Task<void> Server::handle_profile(const http::Request& request, http::Response& response) {
+    utils::CpuProfiler::Options options;
+    
+    if (request.has_query_param("seconds")) {
+        auto seconds = numeric_param(request, "seconds");
+        if (!seconds || *seconds == 0) {
+            response.send_error(400, "seconds must be a positive integer");
+            co_return;
+        }
+        options.duration = std::chrono::seconds(*seconds);
+    }
+    if (options.duration > max_profile_duration_) {
+        response.send_error(400, "Requested profile is longer than the configured maximum");
+        co_return;
+    }
+    
+    if (request.has_query_param("hz")) {
+        auto frequency = numeric_param(request, "hz");
+        if (!frequency || *frequency == 0 || *frequency > 10000) {
+            response.send_error(400, "hz must be between 1 and 10000");
+            co_return;
+        }
+        options.frequency_hz = *frequency;
+    }
+    
+    auto backend = request.get_query_param("backend");
+    if (backend == "perf") {
+        options.backend = utils::CpuProfiler::Backend::PERF_EVENT;
+    } else if (backend == "itimer") {
+        options.backend = utils::CpuProfiler::Backend::ITIMER;
+    } else if (backend) {
+        response.send_error(400, "backend must be perf or itimer");
+        co_return;
+    }
+    options.per_thread = request.get_query_param("per_thread") == "1";
+    
+    if (utils::CpuProfiler::is_running()) {
+        response.send_error(409, "A CPU profile is already running");
+        co_return;
+    }
+    
+    try {
+        auto completion = std::make_shared<ProfileCompletion>();
+        start_profile_thread(options, completion);
+        auto profile = co_await *completion;
+        response.set_status_code(200);
+        response.set_header("Content-Type", "text/plain; charset=utf-8");
+        response.set_header("X-Profile-Backend", utils::to_string(profile.backend));
+        response.set_header("X-Profile-Samples", std::to_string(profile.samples));
+        response.set_header("X-Profile-Lost-Samples", std::to_string(profile.lost_samples));
+        response.set_body(profile.folded);
+    } catch (const std::exception& e) {
+        response.send_error(503, e.what());
+    }
+}
+
+}  // namespace http_framework::core
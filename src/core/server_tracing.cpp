@@ -0,0 +1,30 @@
+#include "core/server.hpp"
+
+namespace http_framework::core {
+
+void Server::enable_request_tracing(bool enable) {
+    if (enable && !request_tracer_) {
+        request_tracer_ = std::make_unique<tracing::ServerRequestTracer>(tracing::TracerProvider::instance());
+    }
+    request_tracing_enabled_ = enable;
+}
+
+void Server::enable_request_tracing(tracing::TracerProvider& provider, tracing::ServerRequestTracer::Config config) {
+    request_tracer_ = std::make_unique<tracing::ServerRequestTracer>(provider, std::move(config));
+    request_tracing_enabled_ = true;
+}
+
+tracing::RequestTrace Server::begin_request_trace(const http::Request& request, timestamp_t received_at) {
+    if (!request_tracing_enabled_ || !request_tracer_) {
+        return {};
+    }
+    return request_tracer_->begin(request, received_at);
+}
+
+void Server::trace_request(const http::Request& request, string_view event) {
+    if (request_tracing_enabled_) {
+        tracing::record_request_event(event);
+    }
+}
+
+}  // namespace http_framework::core
@@ -0,0 +1,718 @@
+#include "http/access_log.hpp"
+#include "utils/thread_name.hpp"
+#include <algorithm>
+#include <charconv>
+#include <csignal>
+#include <ctime>
+#include <sstream>
+#include <utility>
+
+namespace http_framework::http {
+
+namespace {
+
+constexpr size_type MAX_SPARE_BUFFERS = 64;
+
+atomic<std::uint64_t> next_log_id{1};
+atomic<std::uint64_t> sighup_generation{0};
+
+#ifdef SIGHUP
+struct sigaction previous_sighup_action{};
+
+extern "C" void handle_sighup(int signal, siginfo_t* info, void* context) {
+    sighup_generation.fetch_add(1, std::memory_order_relaxed);
+    
+    // Chain to the handler we replaced; SIG_DFL is skipped since it would end the process
+    if (previous_sighup_action.sa_flags & SA_SIGINFO) {
+        if (previous_sighup_action.sa_sigaction) {
+            previous_sighup_action.sa_sigaction(signal, info, context);
+        }
+    } else if (previous_sighup_action.sa_handler != SIG_DFL && previous_sighup_action.sa_handler != SIG_IGN) {
+        previous_sighup_action.sa_handler(signal);
+    }
+}
+#endif
+
+constexpr string_view COMMON_PATTERN = R"($remote_addr - - [$time_local] "$request" $status $body_bytes_sent)";
+constexpr string_view COMBINED_PATTERN =
+    R"($remote_addr - - [$time_local] "$request" $status $body_bytes_sent "$http_referer" "$http_user_agent")";
+constexpr string_view JSON_PATTERN =
+    R"({"time":"$time_iso8601","remote_addr":"$remote_addr","method":"$method","uri":"$uri",)"
+    R"("protocol":"$protocol","status":$status,"bytes_sent":$body_bytes_sent,"duration_us":$request_time_us,)"
+    R"("referer":"$http_referer","user_agent":"$http_user_agent","request_id":$request_id})";
+
+constexpr char HEX_DIGITS[] = "0123456789abcdef";
+
+template<typename T>
+void append_number(string& out, T value) {
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+void append_padded(string& out, unsigned value, int width) {
+    char buffer[8];
+    for (int i = width - 1; i >= 0; --i) {
+        buffer[i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+    out.append(buffer, static_cast<size_type>(width));
+}
+
+void append_escaped(string& out, string_view value, AccessLogFormatter::Escape escape) {
+    for (auto c : value) {
+        auto byte = static_cast<unsigned char>(c);
+        if (escape == AccessLogFormatter::Escape::JSON) {
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += c;
+            } else if (byte < 0x20) {
+                out += "\\u00";
+                out += HEX_DIGITS[byte >> 4];
+                out += HEX_DIGITS[byte & 0x0f];
+            } else {
+                out += c;
+            }
+        } else if (c == '"' || c == '\\' || byte < 0x20 || byte >= 0x7f) {
+            out += "\\x";
+            out += HEX_DIGITS[byte >> 4];
+            out += HEX_DIGITS[byte & 0x0f];
+        } else {
+            out += c;
+        }
+    }
+}
+
+void append_missing(string& out, AccessLogFormatter::Escape escape) {
+    if (escape == AccessLogFormatter::Escape::DEFAULT) {
+        out += '-';
+    }
+}
+
+string_view method_name(HttpMethod method) noexcept {
+    static constexpr array<string_view, 9> names = {
+        "GET", "POST", "PUT", "DELETE", "PATCH", "HEAD", "OPTIONS", "TRACE", "CONNECT"
+    };
+    auto index = static_cast<size_type>(method);
+    return index < names.size() ? names[index] : string_view{"UNKNOWN"};
+}
+
+string_view protocol_name(HttpVersion version) noexcept {
+    switch (version) {
+        case HttpVersion::HTTP_1_0: return "HTTP/1.0";
+        case HttpVersion::HTTP_1_1: return "HTTP/1.1";
+        case HttpVersion::HTTP_2_0: return "HTTP/2.0";
+        case HttpVersion::HTTP_3_0: return "HTTP/3.0";
+    }
+    return "HTTP/1.1";
+}
+
+void append_ip(string& out, const IpAddress& address) {
+    if (const auto* v4 = std::get_if<std::array<byte_t, 4>>(&address.address)) {
+        for (size_type i = 0; i < v4->size(); ++i) {
+            if (i > 0) {
+                out += '.';
+            }
+            append_number(out, static_cast<unsigned>((*v4)[i]));
+        }
+        return;
+    }
+    
+    const auto& v6 = std::get<std::array<byte_t, 16>>(address.address);
+    for (size_type i = 0; i < v6.size(); i += 2) {
+        if (i > 0) {
+            out += ':';
+        }
+        char buffer[8];
+        auto group = static_cast<unsigned>((v6[i] << 8) | v6[i + 1]);
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), group, 16);
+        out.append(buffer, result.ptr);
+    }
+}
+
+// Local-time strings only change once per second, so each thread keeps the last rendering
+struct TimeCache {
+    std::time_t second{-1};
+    char local[40];
+    size_type local_length{0};
+    char iso[40];
+    size_type iso_length{0};
+    
+    void refresh(std::time_t now) {
+        if (now == second) {
+            return;
+        }
+        second = now;
+        
+        std::tm local_time{};
+#ifdef _WIN32
+        localtime_s(&local_time, &now);
+#else
+        localtime_r(&now, &local_time);
+#endif
+        local_length = std::strftime(local, sizeof(local), "%d/%b/%Y:%H:%M:%S %z", &local_time);
+        iso_length = std::strftime(iso, sizeof(iso), "%Y-%m-%dT%H:%M:%S%z", &local_time);
+        // RFC 3339 wants the offset as +hh:mm
+        if (iso_length >= 5 && iso_length + 1 < sizeof(iso)) {
+            iso[iso_length] = iso[iso_length - 1];
+            iso[iso_length - 1] = iso[iso_length - 2];
+            iso[iso_length - 2] = ':';
+            ++iso_length;
+        }
+    }
+};
+
+TimeCache& time_cache(std::chrono::system_clock::time_point now) {
+    thread_local TimeCache cache;
+    cache.refresh(std::chrono::system_clock::to_time_t(now));
+    return cache;
+}
+
+std::uint32_t next_random() noexcept {
+    thread_local std::uint64_t state = [] {
+        auto seed = static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+        seed ^= std::hash<std::thread::id>{}(std::this_thread::get_id());
+        return seed | 1;
+    }();
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return static_cast<std::uint32_t>(state >> 32);
+}
+
+bool is_variable_char(char c) noexcept {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+struct ThreadBuffer {
+    mutex buffer_mutex;
+    string data;
+    atomic<bool> abandoned{false};
+    atomic<bool> detached{false};
+};
+
+struct ThreadBuffers {
+    vector<std::pair<std::uint64_t, shared_ptr<ThreadBuffer>>> entries;
+    
+    ~ThreadBuffers() {
+        for (auto& entry : entries) {
+            entry.second->abandoned.store(true, std::memory_order_release);
+        }
+    }
+};
+
+thread_local ThreadBuffers thread_buffers;
+
+}  // namespace
+
+struct AccessLog::Flusher {
+    std::uint64_t id{next_log_id.fetch_add(1, std::memory_order_relaxed)};
+    
+    mutex buffers_mutex;
+    vector<shared_ptr<ThreadBuffer>> buffers;
+    
+    mutex queue_mutex;
+    condition_variable queue_condition;
+    condition_variable flush_condition;
+    vector<string> full_buffers;
+    vector<string> spare_buffers;
+    size_type flush_requested{0};
+    size_type flush_completed{0};
+    bool stop_requested{false};
+    bool reopen_requested{false};
+    
+    std::FILE* file{nullptr};
+    std::uint64_t seen_sighup_generation{0};
+    std::thread thread;
+    
+    ThreadBuffer& local_buffer(size_type capacity) {
+        for (auto& [log_id, buffer] : thread_buffers.entries) {
+            if (log_id == id) {
+                return *buffer;
+            }
+        }
+        
+        auto& entries = thread_buffers.entries;
+        entries.erase(std::remove_if(entries.begin(), entries.end(), [](const auto& entry) {
+            return entry.second->detached.load(std::memory_order_acquire);
+        }), entries.end());
+        
+        auto buffer = std::make_shared<ThreadBuffer>();
+        buffer->data.reserve(capacity);
+        {
+            lock_guard lock(buffers_mutex);
+            buffers.push_back(buffer);
+        }
+        entries.emplace_back(id, buffer);
+        return *buffer;
+    }
+    
+    // Called with the buffer's mutex held
+    void hand_off(ThreadBuffer& buffer, size_type capacity) {
+        auto replacement = take_spare(capacity);
+        {
+            lock_guard lock(queue_mutex);
+            full_buffers.push_back(std::move(buffer.data));
+        }
+        queue_condition.notify_one();
+        buffer.data = std::move(replacement);
+    }
+    
+    string take_spare(size_type capacity) {
+        string spare;
+        {
+            lock_guard lock(queue_mutex);
+            if (!spare_buffers.empty()) {
+                spare = std::move(spare_buffers.back());
+                spare_buffers.pop_back();
+            }
+        }
+        spare.clear();
+        spare.reserve(capacity);
+        return spare;
+    }
+};
+
+AccessLogFormatter AccessLogFormatter::compile(AccessLogFormat format) {
+    switch (format) {
+        case AccessLogFormat::COMMON: return compile(COMMON_PATTERN);
+        case AccessLogFormat::COMBINED: return compile(COMBINED_PATTERN);
+        case AccessLogFormat::JSON: return compile(JSON_PATTERN, Escape::JSON);
+        case AccessLogFormat::CUSTOM: break;
+    }
+    return compile(COMBINED_PATTERN);
+}
+
+string_view AccessLogFormatter::common_pattern() noexcept {
+    return COMMON_PATTERN;
+}
+
+string_view AccessLogFormatter::combined_pattern() noexcept {
+    return COMBINED_PATTERN;
+}
+
+string_view AccessLogFormatter::json_pattern() noexcept {
+    return JSON_PATTERN;
+}
+
+AccessLogFormatter AccessLogFormatter::compile(string_view pattern, Escape escape) {
+    static const hash_map<string_view, FieldWriter> writers = {
+        {"remote_addr", [](string& out, const AccessLogRecord& record, const Field&) {
+            append_ip(out, record.request.remote_endpoint().address);
+        }},
+        {"remote_port", [](string& out, const AccessLogRecord& record, const Field&) {
+            append_number(out, record.request.remote_endpoint().port);
+        }},
+        {"time_local", [](string& out, const AccessLogRecord& record, const Field&) {
+            auto& cache = time_cache(record.completed_at);
+            out.append(cache.local, cache.local_length);
+        }},
+        {"time_iso8601", [](string& out, const AccessLogRecord& record, const Field&) {
+            auto& cache = time_cache(record.completed_at);
+            out.append(cache.iso, cache.iso_length);
+        }},
+        {"msec", [](string& out, const AccessLogRecord& record, const Field&) {
+            auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(
+                record.completed_at.time_since_epoch()).count();
+            append_number(out, millis / 1000);
+            out += '.';
+            append_padded(out, static_cast<unsigned>(millis % 1000), 3);
+        }},
+        {"request", [](string& out, const AccessLogRecord& record, const Field& field) {
+            out += method_name(record.request.method());
+            out += ' ';
+            append_escaped(out, record.request.uri(), field.escape);
+            out += ' ';
+            out += protocol_name(record.request.version());
+        }},
+        {"method", [](string& out, const AccessLogRecord& record, const Field&) {
+            out += method_name(record.request.method());
+        }},
+        {"uri", [](string& out, const AccessLogRecord& record, const Field& field) {
+            append_escaped(out, record.request.uri(), field.escape);
+        }},
+        {"path", [](string& out, const AccessLogRecord& record, const Field& field) {
+            string_view uri = record.request.uri();
+            append_escaped(out, uri.substr(0, uri.find('?')), field.escape);
+        }},
+        {"query", [](string& out, const AccessLogRecord& record, const Field& field) {
+            string_view uri = record.request.uri();
+            auto question = uri.find('?');
+            if (question != string_view::npos) {
+                append_escaped(out, uri.substr(question + 1), field.escape);
+            }
+        }},
+        {"protocol", [](string& out, const AccessLogRecord& record, const Field&) {
+            out += protocol_name(record.request.version());
+        }},
+        {"status", [](string& out, const AccessLogRecord& record, const Field&) {
+            append_number(out, record.response.status_code());
+        }},
+        {"body_bytes_sent", [](string& out, const AccessLogRecord& record, const Field&) {
+            append_number(out, record.response.body_size());
+        }},
+        {"request_time", [](string& out, const AccessLogRecord& record, const Field&) {
+            auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(record.duration).count();
+            append_number(out, millis / 1000);
+            out += '.';
+            append_padded(out, static_cast<unsigned>(millis % 1000), 3);
+        }},
+        {"request_time_us", [](string& out, const AccessLogRecord& record, const Field&) {
+            append_number(out, record.duration.count());
+        }},
+        {"request_id", [](string& out, const AccessLogRecord& record, const Field&) {
+            append_number(out, record.request.request_id());
+        }}
+    };
+    
+    FieldWriter write_literal = [](string& out, const AccessLogRecord&, const Field& field) {
+        out += field.argument;
+    };
+    FieldWriter write_request_header = [](string& out, const AccessLogRecord& record, const Field& field) {
+        if (auto value = record.request.header_view(field.argument)) {
+            append_escaped(out, *value, field.escape);
+        } else {
+            append_missing(out, field.escape);
+        }
+    };
+    FieldWriter write_response_header = [](string& out, const AccessLogRecord& record, const Field& field) {
+        if (auto value = record.response.header_view(field.argument)) {
+            append_escaped(out, *value, field.escape);
+        } else {
+            append_missing(out, field.escape);
+        }
+    };
+    
+    AccessLogFormatter formatter;
+    auto add_literal = [&](string_view text) {
+        if (text.empty()) {
+            return;
+        }
+        if (!formatter.fields_.empty() && formatter.fields_.back().writer == write_literal) {
+            formatter.fields_.back().argument.append(text);
+        } else {
+            formatter.fields_.push_back(Field{write_literal, string(text), escape});
+        }
+    };
+    
+    auto header_name = [](string_view variable) {
+        string name(variable);
+        std::replace(name.begin(), name.end(), '_', '-');
+        std::transform(name.begin(), name.end(), name.begin(),
+            [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return name;
+    };
+    
+    size_type position = 0;
+    while (position < pattern.size()) {
+        auto dollar = pattern.find('$', position);
+        if (dollar == string_view::npos) {
+            add_literal(pattern.substr(position));
+            break;
+        }
+        add_literal(pattern.substr(position, dollar - position));
+        
+        string_view name;
+        size_type next = dollar + 1;
+        if (next < pattern.size() && pattern[next] == '{') {
+            auto close = pattern.find('}', next);
+            if (close == string_view::npos) {
+                add_literal(pattern.substr(dollar));
+                break;
+            }
+            name = pattern.substr(next + 1, close - next - 1);
+            next = close + 1;
+        } else {
+            auto end = next;
+            while (end < pattern.size() && is_variable_char(pattern[end])) {
+                ++end;
+            }
+            name = pattern.substr(next, end - next);
+            next = end;
+        }
+        
+        if (auto it = writers.find(name); it != writers.end()) {
+            formatter.fields_.push_back(Field{it->second, {}, escape});
+        } else if (name.starts_with("http_") && name.size() > 5) {
+            formatter.fields_.push_back(Field{write_request_header, header_name(name.substr(5)), escape});
+        } else if (name.starts_with("sent_http_") && name.size() > 10) {
+            formatter.fields_.push_back(Field{write_response_header, header_name(name.substr(10)), escape});
+        } else {
+            add_literal(pattern.substr(dollar, next - dollar));
+        }
+        position = next;
+    }
+    
+    add_literal("\n");
+    return formatter;
+}
+
+void AccessLogFormatter::append(string& out, const AccessLogRecord& record) const {
+    for (const auto& field : fields_) {
+        field.writer(out, record, field);
+    }
+}
+
+string AccessLogMetrics::to_json() const {
+    std::ostringstream oss;
+    oss << "{\"records_logged\":" << records_logged
+        << ",\"records_sampled_out\":" << records_sampled_out
+        << ",\"bytes_written\":" << bytes_written
+        << ",\"batches_written\":" << batches_written
+        << ",\"write_failures\":" << write_failures
+        << ",\"reopens\":" << reopens << "}";
+    return oss.str();
+}
+
+AccessLog::AccessLog() : AccessLog(Config{}) {}
+
+AccessLog::AccessLog(Config config)
+    : config_(std::move(config)),
+      formatter_(config_.format == AccessLogFormat::CUSTOM
+                     ? AccessLogFormatter::compile(config_.pattern, config_.escape)
+                     : AccessLogFormatter::compile(config_.format)),
+      sample_threshold_(static_cast<std::uint32_t>(
+          std::clamp(config_.sample_rate, 0.0, 1.0) * static_cast<double>(UINT32_MAX))),
+      flusher_(std::make_unique<Flusher>()) {
+    if (config_.reopen_on_sighup) {
+        install_sighup_handler();
+    }
+    flusher_->seen_sighup_generation = sighup_generation.load(std::memory_order_relaxed);
+    open_file();
+    flusher_->thread = std::thread([this] { flusher_loop(); });
+}
+
+AccessLog::~AccessLog() {
+    close();
+}
+
+void AccessLog::install_sighup_handler() {
+#ifdef SIGHUP
+    static std::once_flag installed;
+    std::call_once(installed, [] {
+        struct sigaction action{};
+        action.sa_sigaction = handle_sighup;
+        sigemptyset(&action.sa_mask);
+        action.sa_flags = SA_RESTART | SA_SIGINFO;
+        ::sigaction(SIGHUP, &action, &previous_sighup_action);
+    });
+#endif
+}
+
+bool AccessLog::should_sample(const Response& response) noexcept {
+    if (config_.sample_rate >= 1.0 ||
+        (config_.always_log_status != 0 && response.status_code() >= config_.always_log_status) ||
+        next_random() < sample_threshold_) {
+        return true;
+    }
+    records_sampled_out_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void AccessLog::log(const Request& request, const Response& response) {
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - request.timestamp());
+    log(request, response, duration);
+}
+
+void AccessLog::log(const Request& request, const Response& response, std::chrono::microseconds duration) {
+    if (!flusher_ || !should_sample(response)) {
+        return;
+    }
+    
+    AccessLogRecord record{request, response, std::chrono::system_clock::now(), duration};
+    auto& buffer = flusher_->local_buffer(buffer_capacity());
+    {
+        lock_guard lock(buffer.buffer_mutex);
+        formatter_.append(buffer.data, record);
+        if (buffer.data.size() >= config_.buffer_size) {
+            flusher_->hand_off(buffer, buffer_capacity());
+        }
+    }
+    records_logged_.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Headroom so the record that crosses buffer_size does not reallocate
+size_type AccessLog::buffer_capacity() const noexcept {
+    return config_.buffer_size + config_.buffer_size / 8;
+}
+
+void AccessLog::flush() {
+    if (!flusher_) {
+        return;
+    }
+    
+    auto& flusher = *flusher_;
+    unique_lock lock(flusher.queue_mutex);
+    auto ticket = ++flusher.flush_requested;
+    flusher.queue_condition.notify_one();
+    flusher.flush_condition.wait(lock, [&] { return flusher.flush_completed >= ticket || flusher.stop_requested; });
+}
+
+void AccessLog::reopen() {
+    if (!flusher_) {
+        return;
+    }
+    
+    {
+        lock_guard lock(flusher_->queue_mutex);
+        flusher_->reopen_requested = true;
+    }
+    flusher_->queue_condition.notify_one();
+}
+
+void AccessLog::close() {
+    if (!flusher_) {
+        return;
+    }
+    
+    {
+        lock_guard lock(flusher_->queue_mutex);
+        flusher_->stop_requested = true;
+    }
+    flusher_->queue_condition.notify_one();
+    if (flusher_->thread.joinable()) {
+        flusher_->thread.join();
+    }
+    
+    {
+        lock_guard lock(flusher_->buffers_mutex);
+        for (auto& buffer : flusher_->buffers) {
+            buffer->detached.store(true, std::memory_order_release);
+        }
+    }
+    
+    {
+        lock_guard lock(flusher_->queue_mutex);
+        flusher_->flush_condition.notify_all();
+    }
+    
+    if (flusher_->file) {
+        std::fclose(flusher_->file);
+    }
+    flusher_.reset();
+}
+
+bool AccessLog::is_open() const {
+    return flusher_ && flusher_->file != nullptr;
+}
+
+AccessLogMetrics AccessLog::metrics() const {
+    AccessLogMetrics metrics;
+    metrics.records_logged = records_logged_.load();
+    metrics.records_sampled_out = records_sampled_out_.load();
+    metrics.bytes_written = bytes_written_.load();
+    metrics.batches_written = batches_written_.load();
+    metrics.write_failures = write_failures_.load();
+    metrics.reopens = reopens_.load();
+    return metrics;
+}
+
+bool AccessLog::open_file() {
+    auto& flusher = *flusher_;
+    if (flusher.file) {
+        std::fclose(flusher.file);
+    }
+    
+    flusher.file = std::fopen(config_.path.c_str(), "ab");
+    if (!flusher.file) {
+        return false;
+    }
+    // Batches are already large, so stdio buffering would only add a copy
+    std::setvbuf(flusher.file, nullptr, _IONBF, 0);
+    return true;
+}
+
+void AccessLog::write_batch(vector<string>& batch) {
+    auto& flusher = *flusher_;
+    size_type written = 0;
+    for (auto& chunk : batch) {
+        if (chunk.empty()) {
+            continue;
+        }
+        if (flusher.file && std::fwrite(chunk.data(), 1, chunk.size(), flusher.file) == chunk.size()) {
+            written += chunk.size();
+        } else {
+            write_failures_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    
+    if (written > 0) {
+        bytes_written_.fetch_add(written, std::memory_order_relaxed);
+        batches_written_.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    lock_guard lock(flusher.queue_mutex);
+    for (auto& chunk : batch) {
+        if (flusher.spare_buffers.size() < MAX_SPARE_BUFFERS) {
+            chunk.clear();
+            flusher.spare_buffers.push_back(std::move(chunk));
+        }
+    }
+    batch.clear();
+}
+
+void AccessLog::flusher_loop() {
+    utils::set_current_thread_name("access-log");
+    auto& flusher = *flusher_;
+    vector<string> batch;
+    vector<shared_ptr<ThreadBuffer>> snapshot;
+    
+    while (true) {
+        size_type flush_target = 0;
+        bool stopping = false;
+        bool reopen = false;
+        {
+            unique_lock lock(flusher.queue_mutex);
+            flusher.queue_condition.wait_for(lock, config_.flush_interval, [&] {
+                return !flusher.full_buffers.empty() || flusher.stop_requested || flusher.reopen_requested ||
+                       flusher.flush_requested != flusher.flush_completed;
+            });
+            batch.swap(flusher.full_buffers);
+            flush_target = flusher.flush_requested;
+            stopping = flusher.stop_requested;
+            reopen = std::exchange(flusher.reopen_requested, false);
+        }
+        
+        // Partially filled buffers are collected on every pass so quiet threads still flush
+        {
+            lock_guard lock(flusher.buffers_mutex);
+            snapshot = flusher.buffers;
+            flusher.buffers.erase(std::remove_if(flusher.buffers.begin(), flusher.buffers.end(),
+                [](const shared_ptr<ThreadBuffer>& buffer) {
+                    return buffer->abandoned.load(std::memory_order_acquire);
+                }), flusher.buffers.end());
+        }
+        for (auto& buffer : snapshot) {
+            auto replacement = flusher.take_spare(buffer_capacity());
+            lock_guard lock(buffer->buffer_mutex);
+            if (!buffer->data.empty()) {
+                batch.push_back(std::move(buffer->data));
+                buffer->data = std::move(replacement);
+            }
+        }
+        snapshot.clear();
+        
+        write_batch(batch);
+        
+        auto generation = sighup_generation.load(std::memory_order_relaxed);
+        if (reopen || generation != flusher.seen_sighup_generation) {
+            flusher.seen_sighup_generation = generation;
+            if (open_file()) {
+                reopens_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        
+        {
+            lock_guard lock(flusher.queue_mutex);
+            flusher.flush_completed = flush_target;
+            flusher.flush_condition.notify_all();
+        }
+        
+        if (stopping) {
+            break;
+        }
+    }
+}
+
+}  // namespace http_framework::http
@@ -56,6 +56,21 @@ optional<string> Request::get_header(string_view name) const {
     return std::nullopt;
 }
 
+optional<string_view> Request::header_view(string_view name) const noexcept {
+    auto it = std::find_if(headers_.begin(), headers_.end(),
+        [name](const HttpHeader& header) {
+            return std::equal(header.name.begin(), header.name.end(), name.begin(), name.end(),
+                [](char stored, char wanted) {
+                    return stored == std::tolower(static_cast<unsigned char>(wanted));
+                });
+        });
+    
+    if (it != headers_.end()) {
+        return string_view(it->value);
+    }
+    return std::nullopt;
+}
+
 void Request::add_cookie(const HttpCookie& cookie) {
     cookies_.push_back(cookie);
 }
@@ -102,19 +117,19 @@ optional<string> Request::get_cookie(string_view name) const {
 }
 
 void Request::set_query_param(string_view name, string_view value) {
-    query_params_[string(name)] = string(value);
+    query_params_[name] = value;
 }
 
 void Request::remove_query_param(string_view name) {
-    query_params_.erase(string(name));
+    query_params_.erase(name);
 }
 
 bool Request::has_query_param(string_view name) const {
-    return query_params_.find(string(name)) != query_params_.end();
+    return query_params_.find(name) != query_params_.end();
 }
 
 optional<string> Request::get_query_param(string_view name) const {
-    auto it = query_params_.find(string(name));
+    auto it = query_params_.find(name);
     if (it != query_params_.end()) {
         return it->second;
     }
@@ -122,15 +137,15 @@ optional<string> Request::get_query_param(string_view name) const {
 }
 
 void Request::set_path_param(string_view name, string_view value) {
-    path_params_[string(name)] = string(value);
+    path_params_[name] = value;
 }
 
 bool Request::has_path_param(string_view name) const {
-    return path_params_.find(string(name)) != path_params_.end();
+    return path_params_.find(name) != path_params_.end();
 }
 
 optional<string> Request::get_path_param(string_view name) const {
-    auto it = path_params_.find(string(name));
+    auto it = path_params_.find(name);
     if (it != path_params_.end()) {
         return it->second;
     }
@@ -262,8 +277,9 @@ bool Request::matches_path(const std::regex& pattern) const {
 hash_map<string, string> Request::extract_path_variables(const std::regex& pattern, const vector<string>& var_names) const {
     hash_map<string, string> variables;
     std::smatch matches;
+    auto path = get_path();
     
-    if (std::regex_match(get_path(), matches, pattern)) {
+    if (std::regex_match(path, matches, pattern)) {
         for (size_type i = 1; i < matches.size() && i - 1 < var_names.size(); ++i) {
             variables[var_names[i - 1]] = matches[i].str();
         }
@@ -322,11 +338,11 @@ void Request::parse_multipart_data() {
 }
 
 bool Request::has_attribute(string_view name) const {
-    return attributes_.find(string(name)) != attributes_.end();
+    return attributes_.find(name) != attributes_.end();
 }
 
 void Request::remove_attribute(string_view name) {
-    attributes_.erase(string(name));
+    attributes_.erase(name);
 }
 
 string Request::to_string() const {
@@ -363,7 +379,7 @@ Request Request::from_string(string_view data) {
     Request request;
     
     auto lines = vector<string>();
-    std::istringstream stream(string(data));
+    std::istringstream stream{string(data)};
     string line;
     
     while (std::getline(stream, line)) {
@@ -458,6 +474,7 @@ void Request::reset() {
     query_params_.clear();
     path_params_.clear();
     attributes_.clear();
+    context_.clear();
     timestamp_ = std::chrono::steady_clock::now();
     request_id_ = 0;
     
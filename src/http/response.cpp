@@ -10,6 +10,7 @@ namespace http_framework::http {
 
 void Response::set_body(string_view body) {
     body_.assign(body.begin(), body.end());
+    body_chain_.clear();
     chunked_ = false;
     update_content_length();
 }
@@ -63,6 +64,22 @@ optional<string> Response::get_header(string_view name) const {
     return std::nullopt;
 }
 
+optional<string_view> Response::header_view(string_view name) const noexcept {
+    auto it = std::find_if(headers_.begin(), headers_.end(),
+        [name](const HttpHeader& header) {
+            return std::equal(header.name.begin(), header.name.end(), name.begin(), name.end(),
+                [](char stored, char wanted) {
+                    return std::tolower(static_cast<unsigned char>(stored)) ==
+                           std::tolower(static_cast<unsigned char>(wanted));
+                });
+        });
+    
+    if (it != headers_.end()) {
+        return string_view(it->value);
+    }
+    return std::nullopt;
+}
+
 void Response::add_cookie(const HttpCookie& cookie) {
     cookies_.push_back(cookie);
 }
@@ -193,11 +210,22 @@ void Response::disable_chunked_encoding() {
     update_content_length();
 }
 
+void Response::set_body(core::IoBuffer body) {
+    body_.clear();
+    body_chain_ = std::move(body);
+    chunked_ = false;
+    update_content_length();
+}
+
 void Response::append_body_chunk(string_view chunk) {
     if (!chunked_) {
         enable_chunked_encoding();
     }
     
+    if (!body_chain_.empty()) {
+        body_chain_.append(chunk);
+        return;
+    }
     body_.insert(body_.end(), chunk.begin(), chunk.end());
 }
 
@@ -206,16 +234,43 @@ void Response::append_body_chunk(const buffer_t& chunk) {
         enable_chunked_encoding();
     }
     
+    if (!body_chain_.empty()) {
+        body_chain_.append(byte_span(chunk));
+        return;
+    }
     body_.insert(body_.end(), chunk.begin(), chunk.end());
 }
 
+void Response::append_body_chunk(core::IoBuffer chunk) {
+    if (!chunked_) {
+        enable_chunked_encoding();
+    }
+    
+    if (body_chain_.empty() && !body_.empty()) {
+        body_chain_.append(byte_span(body_));
+        body_.clear();
+    }
+    body_chain_.append(std::move(chunk));
+}
+
 void Response::finish_chunked_body() {
     if (chunked_) {
         // Add final chunk marker (would be handled in serialization)
     }
 }
 
+const buffer_t& Response::flatten_body() {
+    if (!body_chain_.empty()) {
+        body_ = body_chain_.to_vector();
+        body_chain_.clear();
+    }
+    return body_;
+}
+
 string Response::body_as_string() const {
+    if (!body_chain_.empty()) {
+        return body_chain_.to_string();
+    }
     return string(body_.begin(), body_.end());
 }
 
@@ -254,6 +309,7 @@ bool Response::send_file(string_view file_path) {
     auto file_size = file.tellg();
     file.seekg(0, std::ios::beg);
     
+    body_chain_.clear();
     body_.resize(file_size);
     file.read(reinterpret_cast<char*>(body_.data()), file_size);
     file.close();
@@ -308,6 +364,7 @@ bool Response::send_file_range(string_view file_path, size_type start, size_type
     file.seekg(start, std::ios::beg);
     auto range_size = end - start + 1;
     
+    body_chain_.clear();
     body_.resize(range_size);
     file.read(reinterpret_cast<char*>(body_.data()), range_size);
     file.close();
@@ -370,6 +427,14 @@ void Response::set_cors_preflight_headers() {
 }
 
 string Response::to_string() const {
+    auto result = format_head();
+    if (!body_.empty() || !body_chain_.empty()) {
+        result += body_as_string();
+    }
+    return result;
+}
+
+string Response::format_head() const {
     std::ostringstream oss;
     
     // Status line
@@ -416,11 +481,6 @@ string Response::to_string() const {
     
     oss << "\r\n";
     
-    // Body
-    if (!body_.empty()) {
-        oss << body_as_string();
-    }
-    
     return oss.str();
 }
 
@@ -429,11 +489,21 @@ buffer_t Response::to_buffer() const {
     return buffer_t(response_str.begin(), response_str.end());
 }
 
+core::IoBuffer Response::to_io_buffer() const {
+    core::IoBuffer buffer(format_head());
+    if (!body_chain_.empty()) {
+        buffer.append(body_chain_);
+    } else {
+        buffer.append(byte_span(body_));
+    }
+    return buffer;
+}
+
 Response Response::from_string(string_view data) {
     Response response;
     
     auto lines = vector<string>();
-    std::istringstream stream(string(data));
+    std::istringstream stream{string(data)};
     string line;
     
     while (std::getline(stream, line)) {
@@ -514,6 +584,7 @@ void Response::reset() {
     headers_.clear();
     cookies_.clear();
     body_.clear();
+    body_chain_.clear();
     compression_type_ = CompressionType::NONE;
     chunked_ = false;
     headers_sent_ = false;
@@ -526,7 +597,7 @@ bool Response::is_valid() const {
 }
 
 bool Response::is_complete() const {
-    return !body_.empty() || status_code_ == 204 || status_code_ == 304;
+    return body_size() > 0 || status_code_ == 204 || status_code_ == 304;
 }
 
 Response Response::ok(string_view body) {
@@ -666,8 +737,8 @@ string Response::format_timestamp(timestamp_t ts) const {
 }
 
 void Response::update_content_length() {
-    if (!chunked_ && !body_.empty()) {
-        set_content_length(body_.size());
+    if (!chunked_ && body_size() > 0) {
+        set_content_length(body_size());
     }
 }
 
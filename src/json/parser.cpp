@@ -0,0 +1,810 @@
+#include "json/parser.hpp"
+#include <bit>
+#include <charconv>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define HTTP_FRAMEWORK_JSON_KERNEL_AVX2 1
+#define HTTP_FRAMEWORK_JSON_KERNEL_SSE2 0
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define HTTP_FRAMEWORK_JSON_KERNEL_AVX2 0
+#define HTTP_FRAMEWORK_JSON_KERNEL_SSE2 1
+#else
+#define HTTP_FRAMEWORK_JSON_KERNEL_AVX2 0
+#define HTTP_FRAMEWORK_JSON_KERNEL_SSE2 0
+#endif
+
+#if defined(__PCLMUL__)
+#include <wmmintrin.h>
+#endif
+
+namespace http_framework::json {
+
+namespace {
+
+constexpr size_type BLOCK_SIZE = 64;
+
+enum CharClass : std::uint8_t {
+    QUOTE = 1,
+    BACKSLASH = 2,
+    OPERATOR = 4,
+    WHITESPACE = 8,
+    CONTROL = 16
+};
+
+constexpr array<std::uint8_t, 256> make_char_classes() {
+    array<std::uint8_t, 256> classes{};
+    for (int c = 0; c < 0x20; ++c) {
+        classes[c] = CONTROL;
+    }
+    classes['"'] = QUOTE;
+    classes['\\'] = BACKSLASH;
+    for (char c : {'{', '}', '[', ']', ':', ','}) {
+        classes[static_cast<unsigned char>(c)] = OPERATOR;
+    }
+    for (char c : {' ', '\t', '\n', '\r'}) {
+        classes[static_cast<unsigned char>(c)] |= WHITESPACE;
+    }
+    return classes;
+}
+
+constexpr auto CHAR_CLASSES = make_char_classes();
+
+bool is_delimiter(char c) noexcept {
+    return (CHAR_CLASSES[static_cast<unsigned char>(c)] & (QUOTE | OPERATOR | WHITESPACE)) != 0;
+}
+
+// One bit per byte of a 64-byte block
+struct BlockMasks {
+    std::uint64_t quote{0};
+    std::uint64_t backslash{0};
+    std::uint64_t op{0};
+    std::uint64_t whitespace{0};
+    std::uint64_t control{0};
+    std::uint64_t non_ascii{0};
+};
+
+#if HTTP_FRAMEWORK_JSON_KERNEL_AVX2
+
+BlockMasks classify(const char* block) noexcept {
+    BlockMasks masks;
+    for (size_type half = 0; half < 2; ++half) {
+        auto bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + half * 32));
+        auto bits = [](__m256i match) {
+            return static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(match)));
+        };
+        auto equals = [&](char c) { return _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(c)); };
+        // '[' and ']' are '{' and '}' with bit 5 cleared
+        auto folded = _mm256_or_si256(bytes, _mm256_set1_epi8(0x20));
+        auto brackets = _mm256_or_si256(_mm256_cmpeq_epi8(folded, _mm256_set1_epi8('{')),
+                                        _mm256_cmpeq_epi8(folded, _mm256_set1_epi8('}')));
+        auto op = _mm256_or_si256(brackets, _mm256_or_si256(equals(':'), equals(',')));
+        auto whitespace = _mm256_or_si256(_mm256_or_si256(equals(' '), equals('\t')),
+                                          _mm256_or_si256(equals('\n'), equals('\r')));
+        auto control = _mm256_cmpeq_epi8(_mm256_max_epu8(bytes, _mm256_set1_epi8(0x1f)), _mm256_set1_epi8(0x1f));
+        
+        auto shift = half * 32;
+        masks.quote |= bits(equals('"')) << shift;
+        masks.backslash |= bits(equals('\\')) << shift;
+        masks.op |= bits(op) << shift;
+        masks.whitespace |= bits(whitespace) << shift;
+        masks.control |= bits(control) << shift;
+        masks.non_ascii |= bits(bytes) << shift;
+    }
+    return masks;
+}
+
+#elif HTTP_FRAMEWORK_JSON_KERNEL_SSE2
+
+BlockMasks classify(const char* block) noexcept {
+    BlockMasks masks;
+    for (size_type quarter = 0; quarter < 4; ++quarter) {
+        auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + quarter * 16));
+        auto bits = [](__m128i match) {
+            return static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm_movemask_epi8(match)));
+        };
+        auto equals = [&](char c) { return _mm_cmpeq_epi8(bytes, _mm_set1_epi8(c)); };
+        // '[' and ']' are '{' and '}' with bit 5 cleared
+        auto folded = _mm_or_si128(bytes, _mm_set1_epi8(0x20));
+        auto brackets = _mm_or_si128(_mm_cmpeq_epi8(folded, _mm_set1_epi8('{')),
+                                     _mm_cmpeq_epi8(folded, _mm_set1_epi8('}')));
+        auto op = _mm_or_si128(brackets, _mm_or_si128(equals(':'), equals(',')));
+        auto whitespace = _mm_or_si128(_mm_or_si128(equals(' '), equals('\t')),
+                                       _mm_or_si128(equals('\n'), equals('\r')));
+        auto control = _mm_cmpeq_epi8(_mm_max_epu8(bytes, _mm_set1_epi8(0x1f)), _mm_set1_epi8(0x1f));
+        
+        auto shift = quarter * 16;
+        masks.quote |= bits(equals('"')) << shift;
+        masks.backslash |= bits(equals('\\')) << shift;
+        masks.op |= bits(op) << shift;
+        masks.whitespace |= bits(whitespace) << shift;
+        masks.control |= bits(control) << shift;
+        masks.non_ascii |= bits(bytes) << shift;
+    }
+    return masks;
+}
+
+#else
+
+BlockMasks classify(const char* block) noexcept {
+    BlockMasks masks;
+    for (size_type i = 0; i < BLOCK_SIZE; ++i) {
+        auto byte = static_cast<unsigned char>(block[i]);
+        auto classes = CHAR_CLASSES[byte];
+        auto bit = std::uint64_t{1} << i;
+        masks.quote |= (classes & QUOTE) ? bit : 0;
+        masks.backslash |= (classes & BACKSLASH) ? bit : 0;
+        masks.op |= (classes & OPERATOR) ? bit : 0;
+        masks.whitespace |= (classes & WHITESPACE) ? bit : 0;
+        masks.control |= (classes & CONTROL) ? bit : 0;
+        masks.non_ascii |= byte >= 0x80 ? bit : 0;
+    }
+    return masks;
+}
+
+#endif
+
+// Bit i of the result is the XOR of bits 0..i, which turns quote positions into a
+// mask of the bytes inside strings
+std::uint64_t prefix_xor(std::uint64_t bits) noexcept {
+#if defined(__PCLMUL__)
+    auto all_ones = _mm_set1_epi8(static_cast<char>(0xff));
+    auto product = _mm_clmulepi64_si128(_mm_set_epi64x(0, static_cast<long long>(bits)), all_ones, 0);
+    return static_cast<std::uint64_t>(_mm_cvtsi128_si64(product));
+#else
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+    return bits;
+#endif
+}
+
+// Marks the bytes escaped by an odd-length run of backslashes. Runs are found by
+// adding their start bits so the carry ripples to the end; a run that ends on the
+// other parity from where it started has odd length. ends_odd carries a run that
+// reaches the end of the block into the next one.
+std::uint64_t find_escaped(std::uint64_t backslash, std::uint64_t& ends_odd) noexcept {
+    constexpr std::uint64_t EVEN_BITS = 0x5555555555555555ULL;
+    constexpr std::uint64_t ODD_BITS = ~EVEN_BITS;
+    
+    auto start_edges = backslash & ~(backslash << 1);
+    auto even_start_mask = EVEN_BITS ^ ends_odd;
+    auto even_starts = start_edges & even_start_mask;
+    auto odd_starts = start_edges & ~even_start_mask;
+    auto even_carries = backslash + even_starts;
+    auto odd_carries = backslash + odd_starts;
+    bool overflow = odd_carries < backslash;
+    odd_carries |= ends_odd;
+    ends_odd = overflow ? 1 : 0;
+    
+    auto even_carry_ends = even_carries & ~backslash;
+    auto odd_carry_ends = odd_carries & ~backslash;
+    return (even_carry_ends & ODD_BITS) | (odd_carry_ends & EVEN_BITS);
+}
+
+bool validate_utf8(const unsigned char* data, size_type size) noexcept {
+    size_type i = 0;
+    while (i < size) {
+        auto byte = data[i];
+        if (byte < 0x80) {
+            ++i;
+            continue;
+        }
+        
+        size_type length = 0;
+        std::uint32_t code_point = 0;
+        if ((byte & 0xe0) == 0xc0) {
+            length = 2;
+            code_point = byte & 0x1f;
+        } else if ((byte & 0xf0) == 0xe0) {
+            length = 3;
+            code_point = byte & 0x0f;
+        } else if ((byte & 0xf8) == 0xf0) {
+            length = 4;
+            code_point = byte & 0x07;
+        } else {
+            return false;
+        }
+        if (size - i < length) {
+            return false;
+        }
+        for (size_type k = 1; k < length; ++k) {
+            if ((data[i + k] & 0xc0) != 0x80) {
+                return false;
+            }
+            code_point = (code_point << 6) | (data[i + k] & 0x3f);
+        }
+        
+        // Overlong forms, surrogates and values past U+10FFFF
+        constexpr std::uint32_t MIN_FOR_LENGTH[] = {0, 0, 0x80, 0x800, 0x10000};
+        if (code_point < MIN_FOR_LENGTH[length] || code_point > 0x10ffff ||
+            (code_point >= 0xd800 && code_point <= 0xdfff)) {
+            return false;
+        }
+        i += length;
+    }
+    return true;
+}
+
+void append_utf8(string& out, std::uint32_t code_point) {
+    if (code_point < 0x80) {
+        out.push_back(static_cast<char>(code_point));
+    } else if (code_point < 0x800) {
+        out.push_back(static_cast<char>(0xc0 | (code_point >> 6)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3f)));
+    } else if (code_point < 0x10000) {
+        out.push_back(static_cast<char>(0xe0 | (code_point >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3f)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3f)));
+    } else {
+        out.push_back(static_cast<char>(0xf0 | (code_point >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3f)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3f)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3f)));
+    }
+}
+
+bool parse_hex4(const char* digits, std::uint32_t& out) noexcept {
+    out = 0;
+    for (int i = 0; i < 4; ++i) {
+        auto c = digits[i];
+        std::uint32_t value;
+        if (c >= '0' && c <= '9') {
+            value = static_cast<std::uint32_t>(c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            value = static_cast<std::uint32_t>(c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'F') {
+            value = static_cast<std::uint32_t>(c - 'A' + 10);
+        } else {
+            return false;
+        }
+        out = (out << 4) | value;
+    }
+    return true;
+}
+
+// Walks the escapes in raw, which stage one has already checked for unescaped control
+// characters and bad UTF-8: literal(run) gets the text between escapes and
+// code_point(cp) each decoded escape. Returns false at the first malformed escape.
+template<typename Literal, typename CodePoint>
+bool decode_escapes(string_view raw, Literal&& literal, CodePoint&& code_point) {
+    size_type i = 0;
+    while (i < raw.size()) {
+        auto backslash = raw.find('\\', i);
+        if (backslash == string_view::npos) {
+            literal(raw.substr(i));
+            break;
+        }
+        literal(raw.substr(i, backslash - i));
+        if (backslash + 1 >= raw.size()) {
+            return false;
+        }
+        
+        auto c = raw[backslash + 1];
+        i = backslash + 2;
+        switch (c) {
+            case '"': code_point('"'); break;
+            case '\\': code_point('\\'); break;
+            case '/': code_point('/'); break;
+            case 'b': code_point('\b'); break;
+            case 'f': code_point('\f'); break;
+            case 'n': code_point('\n'); break;
+            case 'r': code_point('\r'); break;
+            case 't': code_point('\t'); break;
+            case 'u': {
+                std::uint32_t value = 0;
+                if (raw.size() - i < 4 || !parse_hex4(raw.data() + i, value)) {
+                    return false;
+                }
+                i += 4;
+                if (value >= 0xd800 && value <= 0xdbff) {
+                    std::uint32_t low = 0;
+                    if (raw.size() - i < 6 || raw[i] != '\\' || raw[i + 1] != 'u' ||
+                        !parse_hex4(raw.data() + i + 2, low) || low < 0xdc00 || low > 0xdfff) {
+                        return false;
+                    }
+                    i += 6;
+                    value = 0x10000 + ((value - 0xd800) << 10) + (low - 0xdc00);
+                } else if (value >= 0xdc00 && value <= 0xdfff) {
+                    return false;
+                }
+                code_point(value);
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+bool unescape(string_view raw, string& out) {
+    out.clear();
+    out.reserve(raw.size());
+    return decode_escapes(raw, [&](string_view run) { out.append(run); },
+                          [&](std::uint32_t code_point) { append_utf8(out, code_point); });
+}
+
+// The same checks as unescape, for strings that are skipped rather than read
+bool escapes_valid(string_view raw) noexcept {
+    return raw.find('\\') == string_view::npos ||
+           decode_escapes(raw, [](string_view) {}, [](std::uint32_t) {});
+}
+
+enum class NumberKind {
+    INVALID,
+    INTEGER,
+    REAL
+};
+
+// The JSON number grammar: -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+NumberKind classify_number(string_view token) noexcept {
+    size_type i = 0;
+    auto size = token.size();
+    auto digit = [&](size_type at) { return at < size && token[at] >= '0' && token[at] <= '9'; };
+    
+    if (i < size && token[i] == '-') {
+        ++i;
+    }
+    if (!digit(i)) {
+        return NumberKind::INVALID;
+    }
+    if (token[i] == '0') {
+        ++i;
+    } else {
+        while (digit(i)) {
+            ++i;
+        }
+    }
+    
+    auto kind = NumberKind::INTEGER;
+    if (i < size && token[i] == '.') {
+        ++i;
+        if (!digit(i)) {
+            return NumberKind::INVALID;
+        }
+        while (digit(i)) {
+            ++i;
+        }
+        kind = NumberKind::REAL;
+    }
+    if (i < size && (token[i] == 'e' || token[i] == 'E')) {
+        ++i;
+        if (i < size && (token[i] == '+' || token[i] == '-')) {
+            ++i;
+        }
+        if (!digit(i)) {
+            return NumberKind::INVALID;
+        }
+        while (digit(i)) {
+            ++i;
+        }
+        kind = NumberKind::REAL;
+    }
+    return i == size ? kind : NumberKind::INVALID;
+}
+
+// Accumulates the digits of an integer token without its sign; false on overflow or
+// anything that is not a plain run of digits
+bool parse_digits(string_view digits, std::uint64_t& out) noexcept {
+    if (digits.empty() || (digits.size() > 1 && digits[0] == '0')) {
+        return false;
+    }
+    std::uint64_t value = 0;
+    for (auto c : digits) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        auto d = static_cast<std::uint64_t>(c - '0');
+        if (value > (std::numeric_limits<std::uint64_t>::max() - d) / 10) {
+            return false;
+        }
+        value = value * 10 + d;
+    }
+    out = value;
+    return true;
+}
+
+}  // namespace
+
+string_view to_string(Error error) noexcept {
+    switch (error) {
+        case Error::NONE: return "no error";
+        case Error::EMPTY: return "empty document";
+        case Error::CAPACITY: return "document too large";
+        case Error::UNCLOSED_STRING: return "unclosed string";
+        case Error::INVALID_UTF8: return "invalid UTF-8";
+        case Error::CONTROL_CHARACTER: return "unescaped control character in string";
+        case Error::UNEXPECTED_CHARACTER: return "unexpected character";
+        case Error::INVALID_ESCAPE: return "invalid escape sequence";
+        case Error::INVALID_NUMBER: return "invalid number";
+        case Error::INVALID_LITERAL: return "invalid literal";
+        case Error::INCORRECT_TYPE: return "value has a different type";
+        case Error::NUMBER_OUT_OF_RANGE: return "number out of range";
+        case Error::DEPTH_EXCEEDED: return "nesting too deep";
+        case Error::TRAILING_CONTENT: return "content after the document";
+    }
+    return "unknown error";
+}
+
+string_view StructuralIndex::kernel() noexcept {
+#if HTTP_FRAMEWORK_JSON_KERNEL_AVX2
+    return "avx2";
+#elif HTTP_FRAMEWORK_JSON_KERNEL_SSE2
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+Error StructuralIndex::build(string_view input) {
+    positions_.clear();
+    if (input.size() > MAX_DOCUMENT_SIZE) {
+        return Error::CAPACITY;
+    }
+    positions_.reserve(input.size() / 4 + 2);
+    
+    std::uint64_t escape_carry = 0;
+    std::uint64_t in_string_carry = 0;
+    std::uint64_t scalar_carry = 0;
+    std::uint64_t non_ascii = 0;
+    size_type first_non_ascii_block = input.size();
+    
+    char tail[BLOCK_SIZE];
+    for (size_type offset = 0; offset < input.size(); offset += BLOCK_SIZE) {
+        const char* block = input.data() + offset;
+        if (input.size() - offset < BLOCK_SIZE) {
+            // Spaces are inert, so padding the last block changes nothing
+            std::memset(tail, ' ', BLOCK_SIZE);
+            std::memcpy(tail, block, input.size() - offset);
+            block = tail;
+        }
+        
+        auto masks = classify(block);
+        auto escaped = find_escaped(masks.backslash, escape_carry);
+        auto quotes = masks.quote & ~escaped;
+        // Set from an opening quote up to, but not including, its closing quote
+        auto in_string = prefix_xor(quotes) ^ in_string_carry;
+        in_string_carry = static_cast<std::uint64_t>(static_cast<std::int64_t>(in_string) >> 63);
+        
+        if (masks.control & in_string) {
+            return Error::CONTROL_CHARACTER;
+        }
+        if (masks.non_ascii && first_non_ascii_block == input.size()) {
+            first_non_ascii_block = offset;
+        }
+        non_ascii |= masks.non_ascii;
+        
+        auto scalar = ~(masks.op | masks.whitespace | masks.quote | in_string);
+        auto scalar_starts = scalar & ~((scalar << 1) | scalar_carry);
+        scalar_carry = scalar >> 63;
+        auto structurals = (masks.op & ~in_string) | quotes | scalar_starts;
+        
+        while (structurals) {
+            positions_.push_back(static_cast<std::uint32_t>(offset + static_cast<size_type>(std::countr_zero(structurals))));
+            structurals &= structurals - 1;
+        }
+    }
+    
+    if (in_string_carry) {
+        return Error::UNCLOSED_STRING;
+    }
+    if (non_ascii && !validate_utf8(reinterpret_cast<const unsigned char*>(input.data()) + first_non_ascii_block,
+                                    input.size() - first_non_ascii_block)) {
+        return Error::INVALID_UTF8;
+    }
+    if (positions_.empty()) {
+        return Error::EMPTY;
+    }
+    positions_.push_back(static_cast<std::uint32_t>(input.size()));
+    return Error::NONE;
+}
+
+StructuralIndex& thread_index() {
+    thread_local StructuralIndex index;
+    return index;
+}
+
+bool Cursor::fail(Error error) noexcept {
+    if (error_ == Error::NONE) {
+        error_ = error;
+    }
+    return false;
+}
+
+string_view Cursor::scalar_token() const noexcept {
+    auto start = static_cast<size_type>(*current_);
+    auto end = start;
+    while (end < size_ && !is_delimiter(data_[end])) {
+        ++end;
+    }
+    return {data_ + start, end - start};
+}
+
+string_view Cursor::take_raw_string() noexcept {
+    // Stage one records both quotes of every string, so the closing one is next
+    auto open = static_cast<size_type>(current_[0]);
+    auto close = static_cast<size_type>(current_[1]);
+    current_ += 2;
+    return {data_ + open + 1, close - open - 1};
+}
+
+bool Cursor::type_mismatch() noexcept {
+    switch (peek()) {
+        case '\0':
+        case ',':
+        case ':':
+        case '}':
+        case ']':
+            return fail(Error::UNEXPECTED_CHARACTER);
+        default:
+            return fail(Error::INCORRECT_TYPE);
+    }
+}
+
+bool Cursor::enter() noexcept {
+    if (!ok()) {
+        return false;
+    }
+    if (depth_ >= MAX_DEPTH) {
+        return fail(Error::DEPTH_EXCEEDED);
+    }
+    ++depth_;
+    ++current_;
+    return true;
+}
+
+bool Cursor::close_or_next(char close, bool& done) noexcept {
+    auto c = peek();
+    if (c == ',') {
+        ++current_;
+        return true;
+    }
+    if (c == close) {
+        ++current_;
+        --depth_;
+        done = true;
+        return true;
+    }
+    return fail(Error::UNEXPECTED_CHARACTER);
+}
+
+bool Cursor::read_key(string_view& key, string& scratch) {
+    if (peek() != '"') {
+        return fail(Error::UNEXPECTED_CHARACTER);
+    }
+    auto raw = take_raw_string();
+    if (raw.find('\\') == string_view::npos) {
+        key = raw;
+    } else {
+        if (!unescape(raw, scratch)) {
+            return fail(Error::INVALID_ESCAPE);
+        }
+        key = scratch;
+    }
+    if (peek() != ':') {
+        return fail(Error::UNEXPECTED_CHARACTER);
+    }
+    ++current_;
+    return true;
+}
+
+bool Cursor::read_bool(bool& out) {
+    if (!ok()) {
+        return false;
+    }
+    auto c = peek();
+    if (c != 't' && c != 'f') {
+        return type_mismatch();
+    }
+    auto token = scalar_token();
+    if (token == "true") {
+        out = true;
+    } else if (token == "false") {
+        out = false;
+    } else {
+        return fail(Error::INVALID_LITERAL);
+    }
+    ++current_;
+    return true;
+}
+
+bool Cursor::read_int64(std::int64_t& out) {
+    if (!ok()) {
+        return false;
+    }
+    auto c = peek();
+    if (c != '-' && (c < '0' || c > '9')) {
+        return type_mismatch();
+    }
+    
+    auto token = scalar_token();
+    bool negative = token[0] == '-';
+    std::uint64_t magnitude = 0;
+    if (!parse_digits(token.substr(negative ? 1 : 0), magnitude)) {
+        switch (classify_number(token)) {
+            case NumberKind::INVALID: return fail(Error::INVALID_NUMBER);
+            case NumberKind::REAL: return fail(Error::INCORRECT_TYPE);
+            case NumberKind::INTEGER: return fail(Error::NUMBER_OUT_OF_RANGE);
+        }
+    }
+    
+    constexpr auto MAX = static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max());
+    if (negative) {
+        if (magnitude > MAX + 1) {
+            return fail(Error::NUMBER_OUT_OF_RANGE);
+        }
+        out = magnitude == MAX + 1 ? std::numeric_limits<std::int64_t>::min()
+                                   : -static_cast<std::int64_t>(magnitude);
+    } else {
+        if (magnitude > MAX) {
+            return fail(Error::NUMBER_OUT_OF_RANGE);
+        }
+        out = static_cast<std::int64_t>(magnitude);
+    }
+    ++current_;
+    return true;
+}
+
+bool Cursor::read_uint64(std::uint64_t& out) {
+    if (!ok()) {
+        return false;
+    }
+    auto c = peek();
+    if (c != '-' && (c < '0' || c > '9')) {
+        return type_mismatch();
+    }
+    
+    auto token = scalar_token();
+    if (!parse_digits(token, out)) {
+        switch (classify_number(token)) {
+            case NumberKind::INVALID: return fail(Error::INVALID_NUMBER);
+            case NumberKind::REAL: return fail(Error::INCORRECT_TYPE);
+            case NumberKind::INTEGER: return fail(Error::NUMBER_OUT_OF_RANGE);
+        }
+    }
+    ++current_;
+    return true;
+}
+
+bool Cursor::read_double(double& out) {
+    if (!ok()) {
+        return false;
+    }
+    auto c = peek();
+    if (c != '-' && (c < '0' || c > '9')) {
+        return type_mismatch();
+    }
+    
+    auto token = scalar_token();
+    if (classify_number(token) == NumberKind::INVALID) {
+        return fail(Error::INVALID_NUMBER);
+    }
+    auto [end, ec] = std::from_chars(token.data(), token.data() + token.size(), out);
+    if (ec == std::errc::result_out_of_range) {
+        return fail(Error::NUMBER_OUT_OF_RANGE);
+    }
+    if (ec != std::errc() || end != token.data() + token.size()) {
+        return fail(Error::INVALID_NUMBER);
+    }
+    ++current_;
+    return true;
+}
+
+bool Cursor::read_string(string& out) {
+    if (!ok()) {
+        return false;
+    }
+    if (peek() != '"') {
+        return type_mismatch();
+    }
+    auto raw = take_raw_string();
+    if (raw.find('\\') == string_view::npos) {
+        out.assign(raw);
+        return true;
+    }
+    return unescape(raw, out) || fail(Error::INVALID_ESCAPE);
+}
+
+bool Cursor::consume_null() noexcept {
+    if (!ok() || peek() != 'n' || scalar_token() != "null") {
+        return false;
+    }
+    ++current_;
+    return true;
+}
+
+bool Cursor::skip_key() noexcept {
+    if (peek() != '"') {
+        return fail(Error::UNEXPECTED_CHARACTER);
+    }
+    if (!escapes_valid(take_raw_string())) {
+        return fail(Error::INVALID_ESCAPE);
+    }
+    if (peek() != ':') {
+        return fail(Error::UNEXPECTED_CHARACTER);
+    }
+    ++current_;
+    return true;
+}
+    
+bool Cursor::skip_scalar() noexcept {
+    auto c = peek();
+    if (c == '"') {
+        return escapes_valid(take_raw_string()) || fail(Error::INVALID_ESCAPE);
+    }
+    
+    auto token = scalar_token();
+    if (token.empty()) {
+        return fail(Error::UNEXPECTED_CHARACTER);
+    }
+    if (c == 't' || c == 'f' || c == 'n') {
+        if (token != "true" && token != "false" && token != "null") {
+            return fail(Error::INVALID_LITERAL);
+        }
+    } else if (classify_number(token) == NumberKind::INVALID) {
+        return fail(Error::INVALID_NUMBER);
+    }
+    ++current_;
+    return true;
+}
+
+bool Cursor::skip_value() {
+    if (!ok()) {
+        return false;
+    }
+    auto c = peek();
+    if (c != '{' && c != '[') {
+        return skip_scalar();
+    }
+    
+    // Skipped containers get the same grammar checks as read ones, but are walked with
+    // an explicit stack so deep nesting cannot exhaust the native one
+    array<char, MAX_DEPTH> closers;
+    size_type depth = 0;
+    for (;;) {
+        auto token = peek();
+        if (token == '{' || token == '[') {
+            auto close = token == '{' ? '}' : ']';
+            if (!enter()) {
+                return false;
+            }
+            if (peek() != close) {
+                closers[depth++] = close;
+                if (close == '}' && !skip_key()) {
+                    return false;
+                }
+                continue;
+            }
+            ++current_;
+            --depth_;
+        } else if (!skip_scalar()) {
+            return false;
+        }
+        
+        // A value just ended: close finished containers until a comma starts the next member
+        bool done = true;
+        while (depth > 0 && done) {
+            done = false;
+            if (!close_or_next(closers[depth - 1], done)) {
+                return false;
+            }
+            if (done) {
+                --depth;
+            }
+        }
+        if (depth == 0) {
+            return true;
+        }
+        if (closers[depth - 1] == '}' && !skip_key()) {
+            return false;
+        }
+    }
+}
+
+}  // namespace http_framework::json
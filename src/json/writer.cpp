@@ -0,0 +1,153 @@
+#include "json/writer.hpp"
+#include <cmath>
+
+namespace http_framework::json {
+
+namespace {
+
+constexpr array<char, 16> HEX_DIGITS = {
+    '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'
+};
+
+constexpr array<bool, 256> make_escape_table() {
+    array<bool, 256> table{};
+    for (int c = 0; c < 0x20; ++c) {
+        table[c] = true;
+    }
+    table['"'] = true;
+    table['\\'] = true;
+    return table;
+}
+
+constexpr auto NEEDS_ESCAPE = make_escape_table();
+
+bool needs_escape(char c) noexcept {
+    return NEEDS_ESCAPE[static_cast<unsigned char>(c)];
+}
+
+// Room claimed from an IoBuffer whenever the current span runs out
+constexpr size_type CHAIN_CLAIM = 16 * 1024;
+
+}  // namespace
+
+Writer::Writer(buffer_t& out, size_type size_hint) : target_(Target::VECTOR), out_(&out), base_(out.size()) {
+    out.resize(base_ + size_hint);
+    begin_ = reinterpret_cast<char*>(out.data()) + base_;
+    cursor_ = begin_;
+    limit_ = reinterpret_cast<char*>(out.data()) + out.size();
+}
+
+Writer::Writer(string& out, size_type size_hint) : target_(Target::STRING), out_(&out), base_(out.size()) {
+    out.resize(base_ + size_hint);
+    begin_ = out.data() + base_;
+    cursor_ = begin_;
+    limit_ = out.data() + out.size();
+}
+
+Writer::Writer(core::IoBuffer& out) : target_(Target::CHAIN), out_(&out) {}
+
+void Writer::number(double value) {
+    if (!std::isfinite(value)) {
+        null();
+        return;
+    }
+    ensure(32);
+    cursor_ = std::to_chars(cursor_, cursor_ + 32, value).ptr;
+}
+
+void Writer::string_value(string_view value) {
+    size_type clean = 0;
+    while (clean < value.size() && !needs_escape(value[clean])) {
+        ++clean;
+    }
+    
+    // Worst case after the first escape is six bytes per input byte (\u00XX)
+    ensure(clean == value.size() ? value.size() + 2 : clean + (value.size() - clean) * 6 + 2);
+    *cursor_++ = '"';
+    std::memcpy(cursor_, value.data(), clean);
+    cursor_ += clean;
+    
+    for (auto i = clean; i < value.size(); ++i) {
+        auto c = value[i];
+        if (!needs_escape(c)) {
+            *cursor_++ = c;
+            continue;
+        }
+        *cursor_++ = '\\';
+        switch (c) {
+            case '"': *cursor_++ = '"'; break;
+            case '\\': *cursor_++ = '\\'; break;
+            case '\b': *cursor_++ = 'b'; break;
+            case '\f': *cursor_++ = 'f'; break;
+            case '\n': *cursor_++ = 'n'; break;
+            case '\r': *cursor_++ = 'r'; break;
+            case '\t': *cursor_++ = 't'; break;
+            default: {
+                auto byte = static_cast<unsigned char>(c);
+                *cursor_++ = 'u';
+                *cursor_++ = '0';
+                *cursor_++ = '0';
+                *cursor_++ = HEX_DIGITS[byte >> 4];
+                *cursor_++ = HEX_DIGITS[byte & 0x0f];
+                break;
+            }
+        }
+    }
+    *cursor_++ = '"';
+}
+
+void Writer::grow(size_type bytes) {
+    auto written = static_cast<size_type>(cursor_ - begin_);
+    switch (target_) {
+        case Target::VECTOR: {
+            auto& out = *static_cast<buffer_t*>(out_);
+            out.resize(std::max(out.size() * 2, base_ + written + bytes));
+            begin_ = reinterpret_cast<char*>(out.data()) + base_;
+            limit_ = reinterpret_cast<char*>(out.data()) + out.size();
+            break;
+        }
+        case Target::STRING: {
+            auto& out = *static_cast<string*>(out_);
+            out.resize(std::max(out.size() * 2, base_ + written + bytes));
+            begin_ = out.data() + base_;
+            limit_ = out.data() + out.size();
+            break;
+        }
+        case Target::CHAIN: {
+            auto& out = *static_cast<core::IoBuffer*>(out_);
+            if (begin_) {
+                out.commit(written);
+            }
+            auto span = out.prepare(std::max(bytes, CHAIN_CLAIM));
+            begin_ = reinterpret_cast<char*>(span.data());
+            limit_ = begin_ + span.size();
+            written = 0;
+            break;
+        }
+    }
+    cursor_ = begin_ + written;
+}
+
+void Writer::finish() {
+    if (finished_) {
+        return;
+    }
+    finished_ = true;
+    
+    auto written = static_cast<size_type>(cursor_ - begin_);
+    switch (target_) {
+        case Target::VECTOR:
+            static_cast<buffer_t*>(out_)->resize(base_ + written);
+            break;
+        case Target::STRING:
+            static_cast<string*>(out_)->resize(base_ + written);
+            break;
+        case Target::CHAIN:
+            if (begin_) {
+                static_cast<core::IoBuffer*>(out_)->commit(written);
+            }
+            break;
+    }
+}
+
+}  // namespace http_framework::json
@@ -1,35 +1,153 @@
 #include "http_framework.hpp"
+#include <charconv>
 #include <iostream>
 #include <signal.h>
 
 using namespace http_framework;
 
+struct UserInput {
+    string name;
+    optional<string> email;
+};
+
+struct UserView {
+    std::int64_t id{0};
+    string name;
+};
+
+struct UserList {
+    vector<UserView> users;
+};
+
+struct UserMessage {
+    string message;
+    optional<UserInput> data;
+};
+
+struct Product {
+    std::int64_t id{0};
+    string name;
+    optional<string> category;
+};
+
+struct ProductList {
+    vector<Product> products;
+};
+
+struct StatusMessage {
+    string message;
+    std::int64_t timestamp{0};
+};
+
+struct HealthStatus {
+    string status;
+    std::int64_t timestamp{0};
+};
+
+template<>
+struct json::Fields<UserInput> {
+    static constexpr auto value = std::make_tuple(
+        json::field("name", &UserInput::name),
+        json::field("email", &UserInput::email));
+};
+
+template<>
+struct json::Fields<UserView> {
+    static constexpr auto value = std::make_tuple(
+        json::field("id", &UserView::id),
+        json::field("name", &UserView::name));
+};
+
+template<>
+struct json::Fields<UserList> {
+    static constexpr auto value = std::make_tuple(json::field("users", &UserList::users));
+};
+
+template<>
+struct json::Fields<UserMessage> {
+    static constexpr auto value = std::make_tuple(
+        json::field("message", &UserMessage::message),
+        json::field("data", &UserMessage::data));
+};
+
+template<>
+struct json::Fields<Product> {
+    static constexpr auto value = std::make_tuple(
+        json::field("id", &Product::id),
+        json::field("name", &Product::name),
+        json::field("category", &Product::category));
+};
+
+template<>
+struct json::Fields<ProductList> {
+    static constexpr auto value = std::make_tuple(json::field("products", &ProductList::products));
+};
+
+template<>
+struct json::Fields<StatusMessage> {
+    static constexpr auto value = std::make_tuple(
+        json::field("message", &StatusMessage::message),
+        json::field("timestamp", &StatusMessage::timestamp));
+};
+
+template<>
+struct json::Fields<HealthStatus> {
+    static constexpr auto value = std::make_tuple(
+        json::field("status", &HealthStatus::status),
+        json::field("timestamp", &HealthStatus::timestamp));
+};
+
+optional<std::int64_t> parse_id(const optional<string>& text) {
+    if (!text) {
+        return std::nullopt;
+    }
+    std::int64_t id = 0;
+    auto [end, ec] = std::from_chars(text->data(), text->data() + text->size(), id);
+    if (ec != std::errc() || end != text->data() + text->size()) {
+        return std::nullopt;
+    }
+    return id;
+}
+
+std::int64_t now_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
 class UserController {
 public:
     void index(const Request& req, Response& res) {
-        res.set_json_body(R"({"users": [{"id": 1, "name": "John"}, {"id": 2, "name": "Jane"}]})");
+        res.set_json_body(UserList{{{1, "John"}, {2, "Jane"}}});
     }
     
     void show(const Request& req, Response& res) {
-        auto id = req.get_path_param("id");
+        auto id = parse_id(req.get_path_param("id"));
         if (id) {
-            res.set_json_body("{\"id\": " + *id + ", \"name\": \"User " + *id + "\"}");
+            res.set_json_body(UserView{*id, "User " + std::to_string(*id)});
         } else {
             res.send_error(400, "Invalid user ID");
         }
     }
     
     void create(const Request& req, Response& res) {
-        auto body = req.body_as_string();
+        auto input = req.body_as_json<UserInput>();
+        if (!input) {
+            res.send_error(400, "Expected a JSON user object");
+            return;
+        }
         res.set_status_code(201);
-        res.set_json_body("{\"message\": \"User created\", \"data\": " + body + "}");
+        res.set_json_body(UserMessage{"User created", std::move(input)});
     }
     
     void update(const Request& req, Response& res) {
         auto id = req.get_path_param("id");
-        auto body = req.body_as_string();
+        auto input = req.body_as_json<UserInput>();
+        if (!input) {
+            res.send_error(400, "Expected a JSON user object");
+            return;
+        }
         if (id) {
-            res.set_json_body("{\"message\": \"User " + *id + " updated\", \"data\": " + body + "}");
+            res.set_json_body(UserMessage{"User " + *id + " updated", std::move(input)});
         } else {
             res.send_error(400, "Invalid user ID");
         }
@@ -51,18 +169,13 @@ public:
         auto category = req.get_query_param("category");
         auto limit = req.get_query_param("limit");
         
-        string response = R"({"products": [)";
-        response += R"({"id": 1, "name": "Laptop", "category": "electronics"},)";
-        response += R"({"id": 2, "name": "Book", "category": "education"})";
-        response += "]}";
-        
-        res.set_json_body(response);
+        res.set_json_body(ProductList{{{1, "Laptop", "electronics"}, {2, "Book", "education"}}});
     }
     
     void get_product(const Request& req, Response& res) {
-        auto id = req.get_path_param("id");
+        auto id = parse_id(req.get_path_param("id"));
         if (id) {
-            res.set_json_body("{\"id\": " + *id + ", \"name\": \"Product " + *id + "\"}");
+            res.set_json_body(Product{*id, "Product " + std::to_string(*id), std::nullopt});
         } else {
             res.send_error(404, "Product not found");
         }
@@ -71,9 +184,7 @@ public:
 
 async::Task<void> async_handler(const Request& req, Response& res) {
     co_await async::sleep_for(std::chrono::milliseconds(100));
-    res.set_json_body(R"({"message": "Async response", "timestamp": ")" + 
-                     std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(
-                         std::chrono::system_clock::now().time_since_epoch()).count()) + "\"}");
+    res.set_json_body(StatusMessage{"Async response", now_ms()});
 }
 
 void websocket_handler(const Request& req, Response& res) {
@@ -114,22 +225,20 @@ void auth_middleware(const Request& req, Response& res, function<void()> next) {
 }
 
 void logging_middleware(const Request& req, Response& res, function<void()> next) {
-    auto start_time = std::chrono::steady_clock::now();
+    static const auto formatter = http::AccessLogFormatter::compile(
+        "[$time_iso8601] $method $uri -> $status ($request_time_us us)");
+    thread_local string line;
     
-    std::cout << "[" << std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now().time_since_epoch()).count() 
-              << "] " << "Request: " << static_cast<int>(req.method()) 
-              << " " << req.uri() << std::endl;
+    auto start_time = std::chrono::steady_clock::now();
     
     next();
     
-    auto end_time = std::chrono::steady_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start_time);
     
-    std::cout << "[" << std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now().time_since_epoch()).count() 
-              << "] " << "Response: " << res.status_code() 
-              << " (" << duration.count() << "ms)" << std::endl;
+    line.clear();
+    formatter.append(line, {req, res, std::chrono::system_clock::now(), duration});
+    std::fwrite(line.data(), 1, line.size(), stdout);
 }
 
 void rate_limit_middleware(const Request& req, Response& res, function<void()> next) {
@@ -301,30 +410,12 @@ int main() {
             });
             
             api_router.get("/stats", [&](const Request& req, Response& res) {
-                auto stats = server.get_stats();
-                string json = "{";
-                bool first = true;
-                for (const auto& [key, value] : stats) {
-                    if (!first) json += ",";
-                    json += "\"" + key + "\":";
-                    std::visit([&](const auto& v) {
-                        if constexpr (std::is_same_v<std::decay_t<decltype(v)>, string>) {
-                            json += "\"" + v + "\"";
-                        } else {
-                            json += std::to_string(v);
-                        }
-                    }, value);
-                    first = false;
-                }
-                json += "}";
-                res.set_json_body(json);
+                res.set_json_body(server.get_stats());
             });
         });
         
         router->get("/health", [](const Request& req, Response& res) {
-            res.set_json_body(R"({"status": "healthy", "timestamp": ")" + 
-                             std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(
-                                 std::chrono::system_clock::now().time_since_epoch()).count()) + "\"}");
+            res.set_json_body(HealthStatus{"healthy", now_ms()});
         });
         
         router->fallback([](const Request& req, Response& res) {
@@ -0,0 +1,172 @@
+#include "metrics/http_metrics.hpp"
+#include <algorithm>
+#include <functional>
+
+namespace http_framework::metrics {
+
+namespace {
+
+string_view method_name(size_type index) noexcept {
+    static constexpr array<string_view, HttpServerMetrics::METHOD_COUNT> names = {
+        "GET", "POST", "PUT", "DELETE", "PATCH", "HEAD", "OPTIONS", "TRACE", "CONNECT"
+    };
+    return names[index];
+}
+
+string_view status_class_name(size_type index) noexcept {
+    static constexpr array<string_view, HttpServerMetrics::STATUS_CLASS_COUNT> names = {
+        "1xx", "2xx", "3xx", "4xx", "5xx"
+    };
+    return names[index];
+}
+
+size_type status_class(status_code_t status) noexcept {
+    auto hundreds = static_cast<size_type>(status / 100);
+    return std::clamp<size_type>(hundreds, 1, HttpServerMetrics::STATUS_CLASS_COUNT) - 1;
+}
+
+size_type method_index(HttpMethod method) noexcept {
+    return std::min(static_cast<size_type>(method), HttpServerMetrics::METHOD_COUNT - 1);
+}
+
+}  // namespace
+
+HttpServerMetrics::HttpServerMetrics(Registry& registry) : HttpServerMetrics(registry, Config{}) {}
+
+HttpServerMetrics::HttpServerMetrics(Registry& registry, Config config)
+    : config_(std::move(config)),
+      requests_(&registry.counter_family(config_.prefix + "_requests_total",
+                                         "HTTP requests completed, by route, method and status class",
+                                         {"route", "method", "status"})),
+      latency_(&registry.histogram_family(config_.prefix + "_request_duration_seconds",
+                                          "HTTP request latency, by route and method",
+                                          {"route", "method"}, config_.latency)),
+      phases_(&registry.histogram_family(config_.prefix + "_request_phase_seconds",
+                                         "Time spent in each phase of an HTTP request, by route",
+                                         {"route", "phase"}, config_.phase_latency)),
+      table_(std::make_unique<atomic<RouteMetrics*>[]>(std::bit_ceil(std::max<size_type>(config_.max_routes, 1) * 2))),
+      table_mask_(std::bit_ceil(std::max<size_type>(config_.max_routes, 1) * 2) - 1),
+      other_(config_.other_route_label) {
+    if constexpr (core::RequestAllocations::compiled_in()) {
+        allocations_ = &registry.histogram_family(config_.prefix + "_request_allocations",
+                                                  "Heap allocations made while serving one HTTP request, by route",
+                                                  {"route"}, config_.allocations);
+        allocated_bytes_ = &registry.histogram_family(config_.prefix + "_request_allocated_bytes",
+                                                      "Bytes allocated while serving one HTTP request, by route",
+                                                      {"route"}, config_.allocated_bytes);
+        phase_allocations_ = &registry.counter_family(config_.prefix + "_request_phase_allocations_total",
+                                                      "Heap allocations made in each phase of HTTP requests, by route",
+                                                      {"route", "phase"});
+    }
+}
+
+HttpServerMetrics::RouteMetrics& HttpServerMetrics::register_route(string_view route) {
+    lock_guard lock(routes_mutex_);
+    auto slot = std::hash<string_view>{}(route) & table_mask_;
+    while (auto* existing = table_[slot].load(std::memory_order_acquire)) {
+        if (existing->route == route) {
+            return *existing;
+        }
+        slot = (slot + 1) & table_mask_;
+    }
+    
+    if (routes_.size() >= config_.max_routes) {
+        return other_;
+    }
+    
+    routes_.push_back(std::make_unique<RouteMetrics>(route));
+    table_[slot].store(routes_.back().get(), std::memory_order_release);
+    return *routes_.back();
+}
+
+// The table is never more than half full, so every probe sequence reaches an empty slot
+HttpServerMetrics::RouteMetrics& HttpServerMetrics::route(string_view route) noexcept {
+    auto slot = std::hash<string_view>{}(route) & table_mask_;
+    while (auto* existing = table_[slot].load(std::memory_order_acquire)) {
+        if (existing->route == route) {
+            return *existing;
+        }
+        slot = (slot + 1) & table_mask_;
+    }
+    return other_;
+}
+
+void HttpServerMetrics::record(RouteMetrics& route, HttpMethod method, status_code_t status, std::uint64_t duration_us) {
+    auto method_slot = method_index(method);
+    auto status_slot = status_class(status);
+    
+    auto* counter = route.requests[method_slot * STATUS_CLASS_COUNT + status_slot].load(std::memory_order_acquire);
+    if (!counter) {
+        counter = &resolve_counter(route, method_slot, status_slot);
+    }
+    counter->increment();
+    
+    auto* histogram = route.latency[method_slot].load(std::memory_order_acquire);
+    if (!histogram) {
+        histogram = &resolve_histogram(route, method_slot);
+    }
+    histogram->record(duration_us);
+}
+
+void HttpServerMetrics::record_phases(RouteMetrics& route, const core::RequestPhases& phases) {
+    phases.for_each([&](core::Phase phase, std::uint64_t duration_ns) {
+        auto* histogram = route.phases[static_cast<size_type>(phase)].load(std::memory_order_acquire);
+        if (!histogram) {
+            histogram = &resolve_phase(route, phase);
+        }
+        histogram->record(duration_ns);
+    });
+}
+
+void HttpServerMetrics::record_allocations(RouteMetrics& route, const core::RequestAllocations& allocations) {
+    if (!allocations_ || !allocations.is_active()) {
+        return;
+    }
+    
+    auto* count = route.allocations.load(std::memory_order_acquire);
+    auto* bytes = route.allocated_bytes.load(std::memory_order_acquire);
+    if (!count || !bytes) {
+        count = &allocations_->with({route.route});
+        bytes = &allocated_bytes_->with({route.route});
+        route.allocations.store(count, std::memory_order_release);
+        route.allocated_bytes.store(bytes, std::memory_order_release);
+    }
+    auto total = allocations.total();
+    count->record(total.allocations);
+    bytes->record(total.bytes);
+    
+    allocations.for_each([&](core::Phase phase, const core::AllocationCounters& counters) {
+        auto* counter = route.phase_allocations[static_cast<size_type>(phase)].load(std::memory_order_acquire);
+        if (!counter) {
+            counter = &resolve_phase_allocations(route, phase);
+        }
+        counter->increment(counters.allocations);
+    });
+}
+
+// Racing threads resolve to the same series, so either store is correct
+Counter& HttpServerMetrics::resolve_counter(RouteMetrics& route, size_type method, size_type status_class) {
+    auto& counter = requests_->with({route.route, method_name(method), status_class_name(status_class)});
+    route.requests[method * STATUS_CLASS_COUNT + status_class].store(&counter, std::memory_order_release);
+    return counter;
+}
+
+Histogram& HttpServerMetrics::resolve_histogram(RouteMetrics& route, size_type method) {
+    auto& histogram = latency_->with({route.route, method_name(method)});
+    route.latency[method].store(&histogram, std::memory_order_release);
+    return histogram;
+}
+
+Histogram& HttpServerMetrics::resolve_phase(RouteMetrics& route, core::Phase phase) {
+    auto& histogram = phases_->with({route.route, core::to_string(phase)});
+    route.phases[static_cast<size_type>(phase)].store(&histogram, std::memory_order_release);
+    return histogram;
+}
+
+Counter& HttpServerMetrics::resolve_phase_allocations(RouteMetrics& route, core::Phase phase) {
+    auto& counter = phase_allocations_->with({route.route, core::to_string(phase)});
+    route.phase_allocations[static_cast<size_type>(phase)].store(&counter, std::memory_order_release);
+    return counter;
+}
+
+}  // namespace http_framework::metrics
@@ -0,0 +1,122 @@
+#include "metrics/lock_metrics.hpp"
+#include "metrics/registry.hpp"
+#include <charconv>
+
+namespace http_framework::metrics {
+
+#if HTTP_FRAMEWORK_LOCK_PROFILING
+
+namespace {
+
+constexpr double SECONDS_PER_NANOSECOND = 1e-9;
+
+void append_double(string& out, double value) {
+    char buffer[32];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+void append_uint(string& out, std::uint64_t value) {
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+void append_header(string& out, string_view name, string_view help, string_view type) {
+    out += "# HELP ";
+    out += name;
+    out += ' ';
+    out += help;
+    out += "\n# TYPE ";
+    out += name;
+    out += ' ';
+    out += type;
+    out += '\n';
+}
+
+void append_sample(string& out, string_view name, const core::LockSite& site, string_view extra_label = {}) {
+    out += name;
+    out += "{site=\"";
+    append_label_value(out, site.name);
+    out += '"';
+    if (!extra_label.empty()) {
+        out += ',';
+        out += extra_label;
+    }
+    out += "} ";
+}
+
+}  // namespace
+
+void render_lock_metrics(string& out, string_view prefix) {
+    string base(prefix);
+    base += "_lock";
+    auto name = [&](string_view suffix) { return base + string(suffix); };
+    
+    auto acquisitions = name("_acquisitions_total");
+    append_header(out, acquisitions, "Lock acquisitions, shared and exclusive", "counter");
+    core::LockSite::for_each([&](const core::LockSite& site) {
+        append_sample(out, acquisitions, site);
+        append_uint(out, site.acquisitions.load(std::memory_order_relaxed));
+        out += '\n';
+    });
+    
+    auto contended = name("_contended_acquisitions_total");
+    append_header(out, contended, "Lock acquisitions that had to wait", "counter");
+    core::LockSite::for_each([&](const core::LockSite& site) {
+        append_sample(out, contended, site);
+        append_uint(out, site.contended.load(std::memory_order_relaxed));
+        out += '\n';
+    });
+    
+    auto wait = name("_wait_seconds");
+    auto wait_bucket = wait + "_bucket";
+    append_header(out, wait, "Time spent waiting to acquire the lock", "histogram");
+    core::LockSite::for_each([&](const core::LockSite& site) {
+        std::uint64_t cumulative = 0;
+        string le;
+        for (size_type i = 0; i + 1 < core::LockSite::WAIT_BUCKETS; ++i) {
+            cumulative += site.wait_buckets[i].load(std::memory_order_relaxed);
+            le = "le=\"";
+            append_double(le, static_cast<double>(std::uint64_t{1} << i) * SECONDS_PER_NANOSECOND);
+            le += '"';
+            append_sample(out, wait_bucket, site, le);
+            append_uint(out, cumulative);
+            out += '\n';
+        }
+        cumulative += site.wait_buckets[core::LockSite::WAIT_BUCKETS - 1].load(std::memory_order_relaxed);
+        append_sample(out, wait_bucket, site, "le=\"+Inf\"");
+        append_uint(out, cumulative);
+        out += '\n';
+        append_sample(out, wait + "_sum", site);
+        append_double(out, static_cast<double>(site.wait_ns.load(std::memory_order_relaxed)) * SECONDS_PER_NANOSECOND);
+        out += '\n';
+        append_sample(out, wait + "_count", site);
+        append_uint(out, cumulative);
+        out += '\n';
+    });
+    
+    auto hold_total = name("_hold_seconds_total");
+    append_header(out, hold_total, "Time the lock was held exclusively", "counter");
+    core::LockSite::for_each([&](const core::LockSite& site) {
+        append_sample(out, hold_total, site);
+        append_double(out, static_cast<double>(site.hold_ns.load(std::memory_order_relaxed)) * SECONDS_PER_NANOSECOND);
+        out += '\n';
+    });
+    
+    auto hold_max = name("_hold_seconds_max");
+    append_header(out, hold_max, "Longest exclusive hold since start", "gauge");
+    core::LockSite::for_each([&](const core::LockSite& site) {
+        append_sample(out, hold_max, site);
+        append_double(out, static_cast<double>(site.max_hold_ns.load(std::memory_order_relaxed)) * SECONDS_PER_NANOSECOND);
+        out += '\n';
+    });
+}
+
+#else
+
+void render_lock_metrics(string&, string_view) {}
+
+#endif
+
+}  // namespace http_framework::metrics
@@ -0,0 +1,265 @@
+#include "metrics/registry.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+
+namespace http_framework::metrics {
+
+namespace {
+
+atomic<size_type> next_shard{0};
+
+void append_double(string& out, double value) {
+    if (std::isnan(value)) {
+        out += "NaN";
+        return;
+    }
+    if (std::isinf(value)) {
+        out += value > 0 ? "+Inf" : "-Inf";
+        return;
+    }
+    
+    char buffer[32];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+void append_uint(string& out, std::uint64_t value) {
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+void append_help(string& out, string_view name, string_view help, string_view type) {
+    out += "# HELP ";
+    out += name;
+    out += ' ';
+    for (auto c : help) {
+        if (c == '\\') {
+            out += "\\\\";
+        } else if (c == '\n') {
+            out += "\\n";
+        } else {
+            out += c;
+        }
+    }
+    out += "\n# TYPE ";
+    out += name;
+    out += ' ';
+    out += type;
+    out += '\n';
+}
+
+void append_series(string& out, string_view name, string_view suffix, string_view labels, string_view extra_label = {}) {
+    out += name;
+    out += suffix;
+    if (!labels.empty() || !extra_label.empty()) {
+        out += '{';
+        out += labels;
+        if (!labels.empty() && !extra_label.empty()) {
+            out += ',';
+        }
+        out += extra_label;
+        out += '}';
+    }
+    out += ' ';
+}
+
+}  // namespace
+
+size_type assign_shard() noexcept {
+    return next_shard.fetch_add(1, std::memory_order_relaxed);
+}
+
+void append_label_value(string& out, string_view value) {
+    for (auto c : value) {
+        switch (c) {
+            case '\\': out += "\\\\"; break;
+            case '"': out += "\\\""; break;
+            case '\n': out += "\\n"; break;
+            default: out += c; break;
+        }
+    }
+}
+
+std::uint64_t Counter::value() const noexcept {
+    std::uint64_t total = 0;
+    for (const auto& shard : shards_) {
+        total += shard.value.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+Histogram::Histogram() : shards_(std::make_unique<Shard[]>(HISTOGRAM_SHARDS)) {}
+
+Histogram::Snapshot Histogram::snapshot() const {
+    Snapshot snapshot;
+    for (size_type s = 0; s < HISTOGRAM_SHARDS; ++s) {
+        const auto& shard = shards_[s];
+        for (size_type i = 0; i < BUCKET_COUNT; ++i) {
+            snapshot.counts[i] += shard.counts[i].load(std::memory_order_relaxed);
+        }
+        snapshot.sum += shard.sum.load(std::memory_order_relaxed);
+    }
+    for (auto count : snapshot.counts) {
+        snapshot.count += count;
+    }
+    return snapshot;
+}
+
+std::uint64_t Histogram::Snapshot::count_at_or_below(std::uint64_t bound) const noexcept {
+    std::uint64_t total = 0;
+    for (size_type i = 0; i < BUCKET_COUNT && bucket_upper_bound(i) <= bound; ++i) {
+        total += counts[i];
+    }
+    return total;
+}
+
+std::uint64_t Histogram::Snapshot::quantile(double q) const noexcept {
+    if (count == 0) {
+        return 0;
+    }
+    
+    auto rank = static_cast<std::uint64_t>(std::ceil(std::clamp(q, 0.0, 1.0) * static_cast<double>(count)));
+    rank = std::max<std::uint64_t>(rank, 1);
+    std::uint64_t seen = 0;
+    for (size_type i = 0; i < BUCKET_COUNT; ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return bucket_upper_bound(i);
+        }
+    }
+    return bucket_upper_bound(BUCKET_COUNT - 1);
+}
+
+Registry& Registry::instance() {
+    static Registry registry;
+    return registry;
+}
+
+Registry::Entry& Registry::find_or_create(string_view name, MetricType type) {
+    auto it = entries_.find(name);
+    if (it != entries_.end()) {
+        if (it->second.type != type) {
+            throw std::invalid_argument("metric " + string(name) + " is already registered with another type");
+        }
+        return it->second;
+    }
+    
+    Entry entry;
+    entry.type = type;
+    return entries_.emplace(string(name), std::move(entry)).first->second;
+}
+
+CounterFamily& Registry::counter_family(string_view name, string_view help, vector<string> label_names) {
+    lock_guard lock(registry_mutex_);
+    auto& entry = find_or_create(name, MetricType::COUNTER);
+    if (!entry.counters) {
+        entry.counters = std::make_unique<CounterFamily>(name, help, std::move(label_names));
+    }
+    return *entry.counters;
+}
+
+GaugeFamily& Registry::gauge_family(string_view name, string_view help, vector<string> label_names) {
+    lock_guard lock(registry_mutex_);
+    auto& entry = find_or_create(name, MetricType::GAUGE);
+    if (entry.callback) {
+        throw std::invalid_argument("metric " + string(name) + " is already registered as a callback gauge");
+    }
+    if (!entry.gauges) {
+        entry.gauges = std::make_unique<GaugeFamily>(name, help, std::move(label_names));
+    }
+    return *entry.gauges;
+}
+
+HistogramFamily& Registry::histogram_family(string_view name, string_view help, vector<string> label_names,
+                                            HistogramOptions options) {
+    lock_guard lock(registry_mutex_);
+    auto& entry = find_or_create(name, MetricType::HISTOGRAM);
+    if (!entry.histograms) {
+        entry.histograms = std::make_unique<HistogramFamily>(name, help, std::move(label_names));
+        std::sort(options.bounds.begin(), options.bounds.end());
+        entry.histogram_options = std::move(options);
+    }
+    return *entry.histograms;
+}
+
+void Registry::callback_gauge(string_view name, string_view help, function<double()> callback) {
+    lock_guard lock(registry_mutex_);
+    auto& entry = find_or_create(name, MetricType::GAUGE);
+    if (entry.gauges) {
+        throw std::invalid_argument("metric " + string(name) + " is already registered as a gauge");
+    }
+    entry.help = string(help);
+    entry.callback = std::move(callback);
+}
+
+string Registry::render_prometheus() const {
+    string out;
+    out.reserve(16 * 1024);
+    render_prometheus(out);
+    return out;
+}
+
+void Registry::render_prometheus(string& out) const {
+    lock_guard lock(registry_mutex_);
+    for (const auto& [name, entry] : entries_) {
+        switch (entry.type) {
+            case MetricType::COUNTER:
+                append_help(out, name, entry.counters->help(), "counter");
+                entry.counters->for_each([&](string_view labels, const Counter& counter) {
+                    append_series(out, name, "", labels);
+                    append_uint(out, counter.value());
+                    out += '\n';
+                });
+                break;
+                
+            case MetricType::GAUGE:
+                if (entry.callback) {
+                    append_help(out, name, entry.help, "gauge");
+                    append_series(out, name, "", {});
+                    append_double(out, entry.callback());
+                    out += '\n';
+                    break;
+                }
+                append_help(out, name, entry.gauges->help(), "gauge");
+                entry.gauges->for_each([&](string_view labels, const Gauge& gauge) {
+                    append_series(out, name, "", labels);
+                    append_double(out, gauge.value());
+                    out += '\n';
+                });
+                break;
+                
+            case MetricType::HISTOGRAM: {
+                const auto& options = entry.histogram_options;
+                append_help(out, name, entry.histograms->help(), "histogram");
+                entry.histograms->for_each([&](string_view labels, const Histogram& histogram) {
+                    auto snapshot = histogram.snapshot();
+                    string le;
+                    for (auto bound : options.bounds) {
+                        // A fine bucket counts toward a boundary only when all of it lies below
+                        auto raw_bound = static_cast<std::uint64_t>(std::floor(bound / options.scale + 1e-9));
+                        le = "le=\"";
+                        append_double(le, bound);
+                        le += '"';
+                        append_series(out, name, "_bucket", labels, le);
+                        append_uint(out, snapshot.count_at_or_below(raw_bound));
+                        out += '\n';
+                    }
+                    append_series(out, name, "_bucket", labels, "le=\"+Inf\"");
+                    append_uint(out, snapshot.count);
+                    out += '\n';
+                    append_series(out, name, "_sum", labels);
+                    append_double(out, static_cast<double>(snapshot.sum) * options.scale);
+                    out += '\n';
+                    append_series(out, name, "_count", labels);
+                    append_uint(out, snapshot.count);
+                    out += '\n';
+                });
+                break;
+            }
+        }
+    }
+}
+
+}  // namespace http_framework::metrics
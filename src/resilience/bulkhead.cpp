@@ -0,0 +1,544 @@
+#include "resilience/bulkhead.hpp"
+#include <algorithm>
+#include <bit>
+#include <sstream>
+
+namespace http_framework::resilience {
+
+string BulkheadMetrics::to_json() const {
+    std::ostringstream oss;
+    oss << "{\"max_concurrent_calls\":" << max_concurrent_calls
+        << ",\"available_permits\":" << available_permits
+        << ",\"queued_waiters\":" << queued_waiters
+        << ",\"acquired_immediately\":" << acquired_immediately
+        << ",\"acquired_after_wait\":" << acquired_after_wait
+        << ",\"rejected_queue_full\":" << rejected_queue_full
+        << ",\"timed_out\":" << timed_out
+        << ",\"abandoned_entries\":" << abandoned_entries
+        << ",\"total_wait_us\":" << total_wait_time.count()
+        << ",\"average_wait_us\":" << average_wait_time().count()
+        << ",\"max_wait_us\":" << max_wait_time.count()
+        << ",\"wait_time_buckets\":[";
+        
+    for (size_type i = 0; i < wait_time_buckets.size(); ++i) {
+        if (i > 0) {
+            oss << ",";
+        }
+        oss << "{\"le_us\":";
+        if (i < WAIT_BUCKET_BOUNDS_US.size()) {
+            oss << WAIT_BUCKET_BOUNDS_US[i];
+        } else {
+            oss << "\"+Inf\"";
+        }
+        oss << ",\"count\":" << wait_time_buckets[i] << "}";
+    }
+    
+    oss << "]}";
+    return oss.str();
+}
+
+void AsyncBulkhead::Permit::release() noexcept {
+    if (auto* bulkhead = std::exchange(bulkhead_, nullptr)) {
+        bulkhead->release_permit();
+    }
+}
+
+bool AsyncBulkhead::AcquireAwaiter::await_ready() {
+    if (bulkhead_.try_take_permit()) {
+        bulkhead_.acquired_immediately_.fetch_add(1, std::memory_order_relaxed);
+        immediate_status_ = PermitStatus::ACQUIRED;
+        return true;
+    }
+    
+    if (bulkhead_.config_.max_queue_size == 0 || deadline_ <= std::chrono::steady_clock::now()) {
+        bulkhead_.rejected_queue_full_.fetch_add(1, std::memory_order_relaxed);
+        immediate_status_ = PermitStatus::REJECTED;
+        return true;
+    }
+    
+    node_ = std::make_shared<WaitNode>();
+    return false;
+}
+
+bool AsyncBulkhead::AcquireAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    // Once the node is visible in the queue another thread may resume (and destroy)
+    // the awaiting coroutine, so only locals are touched past this point.
+    auto& bulkhead = bulkhead_;
+    auto node = node_;
+    node->handle = handle;
+    node->enqueued_at = std::chrono::steady_clock::now();
+    node->deadline = deadline_;
+    
+    if (!bulkhead.enqueue_waiter(node)) {
+        node_.reset();
+        immediate_status_ = PermitStatus::REJECTED;
+        return false;
+    }
+    
+    if (bulkhead.try_take_permit()) {
+        if (bulkhead.transition(*node, WaitState::GRANTED)) {
+            return false;
+        }
+        bulkhead.release_permit();
+        return true;
+    }
+    
+    bulkhead.schedule_deadline(node);
+    return true;
+}
+
+AsyncBulkhead::Permit AsyncBulkhead::AcquireAwaiter::await_resume() {
+    if (!node_) {
+        if (immediate_status_ == PermitStatus::ACQUIRED) {
+            return Permit{&bulkhead_, PermitStatus::ACQUIRED, std::chrono::microseconds::zero()};
+        }
+        return Permit{nullptr, immediate_status_, std::chrono::microseconds::zero()};
+    }
+    
+    auto wait_time = elapsed_since(node_->enqueued_at);
+    auto state = node_->state.load(std::memory_order_acquire);
+    if (state == WaitState::CANCELLED) {
+        // Only the destructor cancels, and it may already have returned
+        return Permit{nullptr, PermitStatus::SHUTDOWN, wait_time};
+    }
+    
+    bulkhead_.record_wait(wait_time);
+    if (state == WaitState::GRANTED) {
+        bulkhead_.disarm_deadline(*node_);
+        bulkhead_.acquired_after_wait_.fetch_add(1, std::memory_order_relaxed);
+        return Permit{&bulkhead_, PermitStatus::ACQUIRED, wait_time};
+    }
+    bulkhead_.timed_out_.fetch_add(1, std::memory_order_relaxed);
+    return Permit{nullptr, PermitStatus::TIMED_OUT, wait_time};
+}
+
+AsyncBulkhead::WaitQueue::WaitQueue(size_type capacity, QueueDiscipline discipline)
+    : discipline_(discipline), capacity_(std::max<size_type>(capacity, 1)) {
+    if (discipline_ == QueueDiscipline::FIFO) {
+        auto ring_size = std::bit_ceil(capacity_);
+        ring_mask_ = ring_size - 1;
+        ring_ = std::make_unique<RingCell[]>(ring_size);
+        for (size_type i = 0; i < ring_size; ++i) {
+            ring_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    } else {
+        stack_ = std::make_unique<StackCell[]>(capacity_);
+        for (size_type i = 0; i < capacity_; ++i) {
+            stack_[i].next.store(i + 1 < capacity_ ? static_cast<std::uint32_t>(i + 2) : 0, std::memory_order_relaxed);
+        }
+        free_head_.store(1, std::memory_order_relaxed);
+    }
+}
+
+bool AsyncBulkhead::WaitQueue::try_push(shared_ptr<WaitNode> node) {
+    if (size_.fetch_add(1, std::memory_order_acq_rel) >= static_cast<ssize_type>(capacity_)) {
+        size_.fetch_sub(1, std::memory_order_acq_rel);
+        return false;
+    }
+    
+    if (discipline_ == QueueDiscipline::FIFO) {
+        if (!ring_push(node)) {
+            size_.fetch_sub(1, std::memory_order_acq_rel);
+            return false;
+        }
+        return true;
+    }
+    
+    auto index = pop_index(free_head_);
+    if (index == 0) {
+        size_.fetch_sub(1, std::memory_order_acq_rel);
+        return false;
+    }
+    stack_[index - 1].node = std::move(node);
+    push_index(stack_head_, index);
+    return true;
+}
+
+shared_ptr<AsyncBulkhead::WaitNode> AsyncBulkhead::WaitQueue::try_pop() {
+    shared_ptr<WaitNode> node;
+    
+    if (discipline_ == QueueDiscipline::FIFO) {
+        node = ring_pop();
+    } else if (auto index = pop_index(stack_head_); index != 0) {
+        node = std::move(stack_[index - 1].node);
+        push_index(free_head_, index);
+    }
+    
+    if (node) {
+        size_.fetch_sub(1, std::memory_order_acq_rel);
+    }
+    return node;
+}
+
+size_type AsyncBulkhead::WaitQueue::size() const noexcept {
+    return static_cast<size_type>(std::max<ssize_type>(size_.load(std::memory_order_acquire), 0));
+}
+
+bool AsyncBulkhead::WaitQueue::ring_push(shared_ptr<WaitNode>& node) {
+    auto position = enqueue_pos_.load(std::memory_order_relaxed);
+    RingCell* cell = nullptr;
+    
+    for (;;) {
+        cell = &ring_[position & ring_mask_];
+        auto sequence = cell->sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<ssize_type>(sequence) - static_cast<ssize_type>(position);
+        
+        if (diff == 0) {
+            if (enqueue_pos_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            position = enqueue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+    
+    cell->node = std::move(node);
+    cell->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+shared_ptr<AsyncBulkhead::WaitNode> AsyncBulkhead::WaitQueue::ring_pop() {
+    auto position = dequeue_pos_.load(std::memory_order_relaxed);
+    RingCell* cell = nullptr;
+    
+    for (;;) {
+        cell = &ring_[position & ring_mask_];
+        auto sequence = cell->sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<ssize_type>(sequence) - static_cast<ssize_type>(position + 1);
+        
+        if (diff == 0) {
+            if (dequeue_pos_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return nullptr;
+        } else {
+            position = dequeue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+    
+    auto node = std::move(cell->node);
+    cell->sequence.store(position + ring_mask_ + 1, std::memory_order_release);
+    return node;
+}
+
+std::uint32_t AsyncBulkhead::WaitQueue::pop_index(atomic<std::uint64_t>& head) {
+    auto current = head.load(std::memory_order_acquire);
+    
+    for (;;) {
+        auto index = tagged_index(current);
+        if (index == 0) {
+            return 0;
+        }
+        
+        auto next = stack_[index - 1].next.load(std::memory_order_acquire);
+        if (head.compare_exchange_weak(current, make_tagged(current, next),
+                                       std::memory_order_acq_rel, std::memory_order_acquire)) {
+            return index;
+        }
+    }
+}
+
+void AsyncBulkhead::WaitQueue::push_index(atomic<std::uint64_t>& head, std::uint32_t index) {
+    auto current = head.load(std::memory_order_relaxed);
+    
+    for (;;) {
+        stack_[index - 1].next.store(tagged_index(current), std::memory_order_relaxed);
+        if (head.compare_exchange_weak(current, make_tagged(current, index),
+                                       std::memory_order_release, std::memory_order_relaxed)) {
+            return;
+        }
+    }
+}
+
+AsyncBulkhead::AsyncBulkhead(string_view name) : AsyncBulkhead(name, Config{}) {}
+
+AsyncBulkhead::AsyncBulkhead(string_view name, Config config)
+    : name_(name), config_(std::move(config)),
+      available_(static_cast<ssize_type>(config_.max_concurrent_calls)),
+      wait_queue_(config_.max_queue_size * 2, config_.discipline),
+      scheduler_(config_.scheduler ? *config_.scheduler : async::Scheduler::shared()),
+      lifetime_(std::make_shared<Lifetime>()) {
+    lifetime_->owner = this;
+}
+
+AsyncBulkhead::~AsyncBulkhead() {
+    {
+        lock_guard lock(lifetime_->guard);
+        lifetime_->owner = nullptr;
+    }
+    cancel_all_waiters();
+}
+
+AsyncBulkhead::AcquireAwaiter AsyncBulkhead::acquire() {
+    return acquire_until(std::chrono::steady_clock::now() + config_.max_wait_duration);
+}
+
+AsyncBulkhead::AcquireAwaiter AsyncBulkhead::acquire(duration_t max_wait) {
+    return acquire_until(std::chrono::steady_clock::now() + max_wait);
+}
+
+AsyncBulkhead::AcquireAwaiter AsyncBulkhead::acquire_until(timestamp_t deadline) {
+    return AcquireAwaiter{*this, deadline};
+}
+
+AsyncBulkhead::Permit AsyncBulkhead::try_acquire() {
+    if (try_take_permit()) {
+        acquired_immediately_.fetch_add(1, std::memory_order_relaxed);
+        return Permit{this, PermitStatus::ACQUIRED, std::chrono::microseconds::zero()};
+    }
+    return Permit{nullptr, PermitStatus::REJECTED, std::chrono::microseconds::zero()};
+}
+
+size_type AsyncBulkhead::available_permits() const noexcept {
+    return static_cast<size_type>(std::max<ssize_type>(available_.load(std::memory_order_relaxed), 0));
+}
+
+BulkheadMetrics AsyncBulkhead::metrics() const {
+    BulkheadMetrics snapshot;
+    snapshot.max_concurrent_calls = config_.max_concurrent_calls;
+    snapshot.available_permits = available_permits();
+    snapshot.queued_waiters = queued_calls();
+    snapshot.acquired_immediately = acquired_immediately_.load(std::memory_order_relaxed);
+    snapshot.acquired_after_wait = acquired_after_wait_.load(std::memory_order_relaxed);
+    snapshot.rejected_queue_full = rejected_queue_full_.load(std::memory_order_relaxed);
+    snapshot.timed_out = timed_out_.load(std::memory_order_relaxed);
+    snapshot.abandoned_entries = abandoned_entries_.load(std::memory_order_relaxed);
+    snapshot.total_wait_time = std::chrono::microseconds(total_wait_us_.load(std::memory_order_relaxed));
+    snapshot.max_wait_time = std::chrono::microseconds(max_wait_us_.load(std::memory_order_relaxed));
+    
+    for (size_type i = 0; i < wait_buckets_.size(); ++i) {
+        snapshot.wait_time_buckets[i] = wait_buckets_[i].load(std::memory_order_relaxed);
+    }
+    
+    return snapshot;
+}
+
+void AsyncBulkhead::reset_metrics() {
+    acquired_immediately_.store(0, std::memory_order_relaxed);
+    acquired_after_wait_.store(0, std::memory_order_relaxed);
+    rejected_queue_full_.store(0, std::memory_order_relaxed);
+    timed_out_.store(0, std::memory_order_relaxed);
+    abandoned_entries_.store(0, std::memory_order_relaxed);
+    total_wait_us_.store(0, std::memory_order_relaxed);
+    max_wait_us_.store(0, std::memory_order_relaxed);
+    
+    for (auto& bucket : wait_buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+bool AsyncBulkhead::try_take_permit() noexcept {
+    auto current = available_.load(std::memory_order_acquire);
+    while (current > 0) {
+        if (available_.compare_exchange_weak(current, current - 1, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void AsyncBulkhead::release_permit() noexcept {
+    available_.fetch_add(1, std::memory_order_seq_cst);
+    dispatch_waiters();
+}
+
+void AsyncBulkhead::dispatch_waiters() noexcept {
+    // A waiter enqueues before re-checking available_, and a releaser publishes its permit
+    // before checking waiting_, so at least one side always observes the other.
+    while (waiting_.load(std::memory_order_seq_cst) > 0) {
+        if (!try_take_permit()) {
+            return;
+        }
+        
+        bool handed_off = false;
+        while (auto node = pop_waiter()) {
+            if (grant(node, WaitState::GRANTED)) {
+                handed_off = true;
+                break;
+            }
+            abandoned_entries_.fetch_add(1, std::memory_order_relaxed);
+        }
+        
+        if (!handed_off) {
+            available_.fetch_add(1, std::memory_order_seq_cst);
+            return;
+        }
+    }
+}
+
+bool AsyncBulkhead::transition(WaitNode& node, WaitState target) noexcept {
+    auto expected = WaitState::WAITING;
+    if (!node.state.compare_exchange_strong(expected, target, std::memory_order_acq_rel, std::memory_order_acquire)) {
+        return false;
+    }
+    waiting_.fetch_sub(1, std::memory_order_seq_cst);
+    return true;
+}
+
+bool AsyncBulkhead::grant(const shared_ptr<WaitNode>& node, WaitState target) noexcept {
+    if (!transition(*node, target)) {
+        return false;
+    }
+    // Never resume inline: the caller may be a Permit destructor inside another
+    // waiter's coroutine, or a deadline timer
+    scheduler_.resume(node->handle);
+    return true;
+}
+
+bool AsyncBulkhead::enqueue_waiter(const shared_ptr<WaitNode>& node) {
+    if (waiting_.fetch_add(1, std::memory_order_seq_cst) >= config_.max_queue_size) {
+        waiting_.fetch_sub(1, std::memory_order_seq_cst);
+        rejected_queue_full_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    
+    if (wait_queue_.try_push(node)) {
+        return true;
+    }
+    
+    // The physical queue also holds entries whose waiters already timed out; drop
+    // those and retry once before turning the caller away.
+    compact_wait_queue();
+    if (wait_queue_.try_push(node)) {
+        return true;
+    }
+    
+    waiting_.fetch_sub(1, std::memory_order_seq_cst);
+    rejected_queue_full_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+shared_ptr<AsyncBulkhead::WaitNode> AsyncBulkhead::pop_waiter() {
+    // Overflow holds entries that were queued before compaction, so FIFO serves them
+    // first and LIFO serves them last
+    if (config_.discipline == QueueDiscipline::FIFO) {
+        if (auto node = pop_overflow()) {
+            return node;
+        }
+        return wait_queue_.try_pop();
+    }
+    if (auto node = wait_queue_.try_pop()) {
+        return node;
+    }
+    return pop_overflow();
+}
+
+shared_ptr<AsyncBulkhead::WaitNode> AsyncBulkhead::pop_overflow() {
+    if (overflow_size_.load(std::memory_order_acquire) == 0) {
+        return nullptr;
+    }
+    
+    lock_guard lock(overflow_mutex_);
+    if (overflow_.empty()) {
+        return nullptr;
+    }
+    
+    shared_ptr<WaitNode> node;
+    if (config_.discipline == QueueDiscipline::FIFO) {
+        node = std::move(overflow_.front());
+        overflow_.pop_front();
+    } else {
+        node = std::move(overflow_.back());
+        overflow_.pop_back();
+    }
+    overflow_size_.store(overflow_.size(), std::memory_order_release);
+    return node;
+}
+
+void AsyncBulkhead::compact_wait_queue() {
+    vector<shared_ptr<WaitNode>> live;
+    auto budget = wait_queue_.size();
+    
+    while (budget-- > 0) {
+        auto node = wait_queue_.try_pop();
+        if (!node) {
+            break;
+        }
+        if (node->state.load(std::memory_order_acquire) == WaitState::WAITING) {
+            live.push_back(std::move(node));
+        } else {
+            abandoned_entries_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    
+    if (config_.discipline == QueueDiscipline::LIFO) {
+        std::reverse(live.begin(), live.end());
+    }
+    
+    // Concurrent enqueues can refill the ring while live entries are out of it; those
+    // entries still hold a place in line, so they wait in overflow instead
+    vector<shared_ptr<WaitNode>> displaced;
+    for (auto& node : live) {
+        if (!wait_queue_.try_push(node)) {
+            displaced.push_back(std::move(node));
+        }
+    }
+    
+    if (!displaced.empty()) {
+        lock_guard lock(overflow_mutex_);
+        for (auto& node : displaced) {
+            overflow_.push_back(std::move(node));
+        }
+        overflow_size_.store(overflow_.size(), std::memory_order_release);
+    }
+}
+
+void AsyncBulkhead::schedule_deadline(const shared_ptr<WaitNode>& node) {
+    auto id = scheduler_.post_at(node->deadline, [lifetime = lifetime_, weak = weak_ptr<WaitNode>(node)]() {
+        auto waiter = weak.lock();
+        if (!waiter) {
+            return;
+        }
+        lock_guard lock(lifetime->guard);
+        if (lifetime->owner) {
+            lifetime->owner->expire(waiter);
+        }
+    });
+        
+    // The waiter may already have been granted and resumed; if so it disarmed first
+    // and the timer is cancelled here instead
+    std::uint64_t expected = 0;
+    if (!node->timer_sequence.compare_exchange_strong(expected, id.sequence, std::memory_order_acq_rel)) {
+        scheduler_.cancel(id);
+    }
+}
+
+void AsyncBulkhead::disarm_deadline(WaitNode& node) noexcept {
+    auto sequence = node.timer_sequence.exchange(WaitNode::TIMER_DISARMED, std::memory_order_acq_rel);
+    if (sequence != 0 && sequence != WaitNode::TIMER_DISARMED) {
+        scheduler_.cancel(async::Scheduler::TimerId{node.deadline, sequence});
+    }
+}
+
+void AsyncBulkhead::expire(const shared_ptr<WaitNode>& node) noexcept {
+    grant(node, WaitState::TIMED_OUT);
+}
+
+void AsyncBulkhead::cancel_all_waiters() {
+    while (auto node = pop_waiter()) {
+        disarm_deadline(*node);
+        grant(node, WaitState::CANCELLED);
+    }
+}
+
+void AsyncBulkhead::record_wait(std::chrono::microseconds wait_time) noexcept {
+    auto micros = static_cast<std::uint64_t>(std::max<std::int64_t>(wait_time.count(), 0));
+    total_wait_us_.fetch_add(micros, std::memory_order_relaxed);
+    
+    auto current_max = max_wait_us_.load(std::memory_order_relaxed);
+    while (micros > current_max && !max_wait_us_.compare_exchange_weak(current_max, micros, std::memory_order_relaxed)) {
+    }
+    
+    const auto& bounds = BulkheadMetrics::WAIT_BUCKET_BOUNDS_US;
+    auto bucket = static_cast<size_type>(std::lower_bound(bounds.begin(), bounds.end(), micros) - bounds.begin());
+    wait_buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+std::chrono::microseconds AsyncBulkhead::elapsed_since(timestamp_t start) noexcept {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+}
+
+}  // namespace http_framework::resilience
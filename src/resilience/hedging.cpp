@@ -0,0 +1,193 @@
+#include "resilience/hedging.hpp"
+#include <bit>
+
+namespace http_framework::resilience {
+
+void CancellationToken::on_cancel(function<void()> callback) const {
+    if (!state_) {
+        return;
+    }
+    
+    {
+        lock_guard lock(state_->callbacks_mutex);
+        if (!state_->cancelled.load(std::memory_order_acquire)) {
+            state_->callbacks.push_back(std::move(callback));
+            return;
+        }
+    }
+    
+    callback();
+}
+
+void CancellationSource::cancel() {
+    vector<function<void()>> callbacks;
+    
+    {
+        lock_guard lock(state_->callbacks_mutex);
+        if (state_->cancelled.exchange(true, std::memory_order_acq_rel)) {
+            return;
+        }
+        callbacks.swap(state_->callbacks);
+    }
+    
+    for (auto& callback : callbacks) {
+        try {
+            callback();
+        } catch (...) {
+            // Cancellation callbacks are best effort
+        }
+    }
+}
+
+RetryBudget::RetryBudget() : RetryBudget(Config{}) {}
+
+RetryBudget::RetryBudget(Config config)
+    : config_(std::move(config)),
+      max_scaled_(static_cast<std::int64_t>(config_.max_tokens * SCALE)),
+      scaled_tokens_(static_cast<std::int64_t>(std::min(config_.min_tokens_per_second, config_.max_tokens) * SCALE)),
+      last_refill_ns_(now_ns()) {}
+
+void RetryBudget::record_request() noexcept {
+    requests_.fetch_add(1, std::memory_order_relaxed);
+    deposit(static_cast<std::int64_t>(config_.deposit_per_request * SCALE));
+}
+
+bool RetryBudget::try_withdraw() noexcept {
+    refill();
+    
+    auto current = scaled_tokens_.load(std::memory_order_relaxed);
+    while (current >= SCALE) {
+        if (scaled_tokens_.compare_exchange_weak(current, current - SCALE, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+            retries_permitted_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    
+    retries_throttled_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+double RetryBudget::available_tokens() const noexcept {
+    return static_cast<double>(scaled_tokens_.load(std::memory_order_relaxed)) / SCALE;
+}
+
+void RetryBudget::deposit(std::int64_t scaled) noexcept {
+    if (scaled <= 0) {
+        return;
+    }
+    
+    auto current = scaled_tokens_.load(std::memory_order_relaxed);
+    while (current < max_scaled_) {
+        auto next = std::min(current + scaled, max_scaled_);
+        if (scaled_tokens_.compare_exchange_weak(current, next, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+            return;
+        }
+    }
+}
+
+void RetryBudget::refill() noexcept {
+    auto now = now_ns();
+    auto last = last_refill_ns_.load(std::memory_order_relaxed);
+    if (now <= last || !last_refill_ns_.compare_exchange_strong(last, now, std::memory_order_acq_rel)) {
+        return;
+    }
+    
+    auto elapsed_seconds = static_cast<double>(now - last) / 1e9;
+    deposit(static_cast<std::int64_t>(elapsed_seconds * config_.min_tokens_per_second * SCALE));
+}
+
+std::int64_t RetryBudget::now_ns() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+LatencyTracker::LatencyTracker(duration_t window)
+    : window_ns_(std::max<std::int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(window).count(), 1)) {}
+
+void LatencyTracker::record(std::chrono::microseconds latency) noexcept {
+    auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    auto epoch = now / window_ns_;
+    auto& window = windows_[static_cast<size_type>(epoch) & 1];
+    
+    auto window_epoch = window.epoch.load(std::memory_order_acquire);
+    if (window_epoch != epoch && window.epoch.compare_exchange_strong(window_epoch, epoch, std::memory_order_acq_rel)) {
+        for (auto& bucket : window.buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        window.count.store(0, std::memory_order_relaxed);
+    }
+    
+    auto micros = static_cast<std::uint64_t>(std::max<std::int64_t>(latency.count(), 0));
+    window.buckets[bucket_for(micros)].fetch_add(1, std::memory_order_relaxed);
+    window.count.fetch_add(1, std::memory_order_relaxed);
+}
+
+optional<std::chrono::microseconds> LatencyTracker::percentile(double quantile, size_type min_samples) const noexcept {
+    auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    auto epoch = now / window_ns_;
+    
+    array<std::uint64_t, BUCKET_COUNT> merged{};
+    std::uint64_t total = 0;
+    
+    for (const auto& window : windows_) {
+        auto window_epoch = window.epoch.load(std::memory_order_acquire);
+        if (window_epoch != epoch && window_epoch != epoch - 1) {
+            continue;
+        }
+        for (size_type i = 0; i < BUCKET_COUNT; ++i) {
+            auto count = window.buckets[i].load(std::memory_order_relaxed);
+            merged[i] += count;
+            total += count;
+        }
+    }
+    
+    if (total == 0 || total < min_samples) {
+        return std::nullopt;
+    }
+    
+    auto rank = static_cast<std::uint64_t>(std::ceil(std::clamp(quantile, 0.0, 1.0) * static_cast<double>(total)));
+    rank = std::max<std::uint64_t>(rank, 1);
+    
+    std::uint64_t seen = 0;
+    for (size_type i = 0; i < BUCKET_COUNT; ++i) {
+        seen += merged[i];
+        if (seen >= rank) {
+            return std::chrono::microseconds(bucket_upper_bound(i));
+        }
+    }
+    
+    return std::chrono::microseconds(bucket_upper_bound(BUCKET_COUNT - 1));
+}
+
+size_type LatencyTracker::sample_count() const noexcept {
+    size_type total = 0;
+    for (const auto& window : windows_) {
+        total += window.count.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+size_type LatencyTracker::bucket_for(std::uint64_t micros) noexcept {
+    if (micros < SUB_BUCKETS) {
+        return static_cast<size_type>(micros);
+    }
+    
+    auto shift = static_cast<size_type>(std::bit_width(micros)) - 1 - SUB_BUCKET_BITS;
+    auto sub_bucket = static_cast<size_type>(micros >> shift) & (SUB_BUCKETS - 1);
+    return std::min((shift + 1) * SUB_BUCKETS + sub_bucket, BUCKET_COUNT - 1);
+}
+
+std::uint64_t LatencyTracker::bucket_upper_bound(size_type bucket) noexcept {
+    if (bucket < SUB_BUCKETS) {
+        return bucket;
+    }
+    
+    auto shift = bucket / SUB_BUCKETS - 1;
+    auto sub_bucket = bucket % SUB_BUCKETS;
+    auto lower = static_cast<std::uint64_t>(SUB_BUCKETS + sub_bucket) << shift;
+    return lower + (std::uint64_t{1} << shift) - 1;
+}
+
+}  // namespace http_framework::resilience
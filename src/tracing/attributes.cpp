@@ -0,0 +1,193 @@
+#include "tracing/attributes.hpp"
+#include <sstream>
+#include <stdexcept>
+
+namespace http_framework::tracing {
+
+namespace {
+
+template<typename Elements>
+string join_elements(const Elements& elements) {
+    std::ostringstream oss;
+    oss << "[";
+    bool first = true;
+    for (const auto& element : elements) {
+        if (!first) {
+            oss << ",";
+        }
+        oss << element;
+        first = false;
+    }
+    oss << "]";
+    return oss.str();
+}
+
+}  // namespace
+
+string Attribute::to_string() const {
+    return std::visit([](const auto& held) -> string {
+        using Held = std::decay_t<decltype(held)>;
+        if constexpr (std::is_same_v<Held, string>) {
+            return held;
+        } else if constexpr (std::is_same_v<Held, bool>) {
+            return held ? "true" : "false";
+        } else if constexpr (std::is_arithmetic_v<Held>) {
+            std::ostringstream oss;
+            oss << held;
+            return oss.str();
+        } else if constexpr (std::is_same_v<Held, vector<bool>>) {
+            std::ostringstream oss;
+            oss << std::boolalpha;
+            oss << "[";
+            for (size_type i = 0; i < held.size(); ++i) {
+                oss << (i > 0 ? "," : "") << static_cast<bool>(held[i]);
+            }
+            oss << "]";
+            return oss.str();
+        } else {
+            return join_elements(held);
+        }
+    }, value);
+}
+
+string_view AttributeKey::name() const {
+    return AttributeKeyRegistry::instance().name(*this);
+}
+
+AttributeKey AttributeKey::intern(string_view name) {
+    return AttributeKeyRegistry::instance().intern(name);
+}
+
+optional<AttributeKey> AttributeKey::find(string_view name) {
+    return AttributeKeyRegistry::instance().find(name);
+}
+
+AttributeKeyRegistry& AttributeKeyRegistry::instance() {
+    static AttributeKeyRegistry registry;
+    return registry;
+}
+
+AttributeKeyRegistry::AttributeKeyRegistry() {
+    for (auto name : WELL_KNOWN_ATTRIBUTE_NAMES) {
+        intern(name);
+    }
+}
+
+AttributeKey AttributeKeyRegistry::intern(string_view name) {
+    if (auto existing = find(name)) {
+        return *existing;
+    }
+    
+    std::unique_lock lock(mutex_);
+    auto it = ids_.find(name);
+    if (it != ids_.end()) {
+        return AttributeKey{it->second};
+    }
+    
+    if (names_.size() >= MAX_KEYS) {
+        throw std::length_error("Attribute key registry is full");
+    }
+    
+    const auto& stored = names_.emplace_back(name);
+    auto id = static_cast<std::uint16_t>(names_.size());
+    ids_.emplace(stored, id);
+    return AttributeKey{id};
+}
+
+optional<AttributeKey> AttributeKeyRegistry::find(string_view name) const {
+    shared_lock lock(mutex_);
+    auto it = ids_.find(name);
+    if (it == ids_.end()) {
+        return std::nullopt;
+    }
+    return AttributeKey{it->second};
+}
+
+string_view AttributeKeyRegistry::name(AttributeKey key) const {
+    shared_lock lock(mutex_);
+    if (!key.is_valid() || key.id > names_.size()) {
+        return {};
+    }
+    return names_[key.id - 1];
+}
+
+size_type AttributeKeyRegistry::size() const {
+    shared_lock lock(mutex_);
+    return names_.size();
+}
+
+vector<string_view> AttributeView::as_string_array() const {
+    vector<string_view> result;
+    result.reserve(count);
+    
+    size_type position = 0;
+    for (std::uint32_t i = 0; i < count; ++i) {
+        std::uint32_t length = 0;
+        std::memcpy(&length, bytes.data() + position, sizeof(length));
+        position += sizeof(length);
+        result.emplace_back(reinterpret_cast<const char*>(bytes.data() + position), length);
+        position += length;
+    }
+    
+    return result;
+}
+
+Attribute AttributeView::to_attribute() const {
+    Attribute result;
+    result.type = type;
+    
+    switch (type) {
+        case AttributeType::STRING:
+            result.value = string(as_string());
+            break;
+        case AttributeType::BOOL:
+            result.value = boolean;
+            break;
+        case AttributeType::INT64:
+            result.value = static_cast<int64_t>(integer);
+            break;
+        case AttributeType::DOUBLE:
+            result.value = real;
+            break;
+        case AttributeType::STRING_ARRAY: {
+            vector<string> elements;
+            for (auto element : as_string_array()) {
+                elements.emplace_back(element);
+            }
+            result.value = std::move(elements);
+            break;
+        }
+        case AttributeType::BOOL_ARRAY: {
+            auto elements = as_bool_array();
+            result.value = vector<bool>(elements.begin(), elements.end());
+            break;
+        }
+        case AttributeType::INT64_ARRAY: {
+            auto elements = as_int64_array();
+            result.value = vector<int64_t>(elements.begin(), elements.end());
+            break;
+        }
+        case AttributeType::DOUBLE_ARRAY: {
+            auto elements = as_double_array();
+            result.value = vector<double>(elements.begin(), elements.end());
+            break;
+        }
+    }
+    
+    return result;
+}
+
+string AttributeView::to_string() const {
+    switch (type) {
+        case AttributeType::STRING:
+            return string(as_string());
+        case AttributeType::BOOL:
+            return boolean ? "true" : "false";
+        case AttributeType::INT64:
+            return std::to_string(integer);
+        default:
+            return to_attribute().to_string();
+    }
+}
+
+}  // namespace http_framework::tracing
@@ -0,0 +1,381 @@
+#include "tracing/tracer.hpp"
+#include <algorithm>
+
+namespace http_framework::tracing {
+
+namespace {
+
+constexpr char HEX_DIGITS[] = "0123456789abcdef";
+
+std::mt19937_64& id_generator() {
+    thread_local std::mt19937_64 generator{[] {
+        std::random_device device;
+        return (static_cast<std::uint64_t>(device()) << 32) ^ device();
+    }()};
+    return generator;
+}
+
+void fill_random(byte_t* data, size_type size) {
+    auto& generator = id_generator();
+    for (size_type offset = 0; offset < size; offset += 8) {
+        auto value = generator();
+        for (size_type i = 0; i < 8 && offset + i < size; ++i) {
+            data[offset + i] = static_cast<byte_t>(value >> (8 * i));
+        }
+    }
+}
+
+int hex_value(char c) noexcept {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+int lower_hex_value(char c) noexcept {
+    return c >= 'A' && c <= 'F' ? -1 : hex_value(c);
+}
+
+template<size_type N>
+bool parse_hex_bytes(string_view hex, array<byte_t, N>& out) noexcept {
+    if (hex.size() != N * 2) {
+        return false;
+    }
+    
+    for (size_type i = 0; i < N; ++i) {
+        auto high = hex_value(hex[2 * i]);
+        auto low = hex_value(hex[2 * i + 1]);
+        if (high < 0 || low < 0) {
+            return false;
+        }
+        out[i] = static_cast<byte_t>((high << 4) | low);
+    }
+    return true;
+}
+
+template<size_type N>
+void write_hex_bytes(const array<byte_t, N>& data, char* out) noexcept {
+    for (size_type i = 0; i < N; ++i) {
+        out[2 * i] = HEX_DIGITS[data[i] >> 4];
+        out[2 * i + 1] = HEX_DIGITS[data[i] & 0x0f];
+    }
+}
+
+// traceparent forbids uppercase hex, so it is checked before the shared parser runs
+bool is_lower_hex(string_view hex) noexcept {
+    return std::all_of(hex.begin(), hex.end(), [](char c) { return lower_hex_value(c) >= 0; });
+}
+
+template<size_type N>
+bool is_zero(const array<byte_t, N>& data) noexcept {
+    return std::all_of(data.begin(), data.end(), [](byte_t b) { return b == 0; });
+}
+
+string_view trim_whitespace(string_view value) noexcept {
+    while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) {
+        value.remove_prefix(1);
+    }
+    while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) {
+        value.remove_suffix(1);
+    }
+    return value;
+}
+
+bool is_valid_key(string_view key) noexcept {
+    if (key.empty() || key.size() > 256) {
+        return false;
+    }
+    
+    auto first = key.front();
+    if (!((first >= 'a' && first <= 'z') || (first >= '0' && first <= '9'))) {
+        return false;
+    }
+    
+    size_type tenant_separators = 0;
+    for (auto c : key) {
+        if (c == '@') {
+            ++tenant_separators;
+            continue;
+        }
+        bool allowed = (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') ||
+                       c == '_' || c == '-' || c == '*' || c == '/';
+        if (!allowed) {
+            return false;
+        }
+    }
+    return tenant_separators <= 1 && key.back() != '@';
+}
+
+bool is_valid_value(string_view value) noexcept {
+    if (value.empty() || value.size() > 256 || value.back() == ' ') {
+        return false;
+    }
+    return std::all_of(value.begin(), value.end(), [](char c) {
+        return c >= 0x20 && c <= 0x7e && c != ',' && c != '=';
+    });
+}
+
+}  // namespace
+
+TraceId::TraceId() : data{} {}
+
+TraceId::TraceId(string_view hex_string) : data{} {
+    if (!parse_hex_bytes(hex_string, data)) {
+        data.fill(0);
+    }
+}
+
+string TraceId::to_string() const {
+    string result(HEX_LENGTH, '\0');
+    write_hex(result.data());
+    return result;
+}
+
+bool TraceId::is_valid() const noexcept {
+    return !is_zero(data);
+}
+
+void TraceId::write_hex(char* out) const noexcept {
+    write_hex_bytes(data, out);
+}
+
+TraceId TraceId::generate() {
+    TraceId trace_id;
+    do {
+        fill_random(trace_id.data.data(), trace_id.data.size());
+    } while (!trace_id.is_valid());
+    return trace_id;
+}
+
+TraceId TraceId::invalid() {
+    return TraceId{};
+}
+
+optional<TraceId> TraceId::from_hex(string_view hex_string) noexcept {
+    TraceId trace_id;
+    if (!parse_hex_bytes(hex_string, trace_id.data)) {
+        return std::nullopt;
+    }
+    return trace_id;
+}
+
+SpanId::SpanId() : data{} {}
+
+SpanId::SpanId(string_view hex_string) : data{} {
+    if (!parse_hex_bytes(hex_string, data)) {
+        data.fill(0);
+    }
+}
+
+string SpanId::to_string() const {
+    string result(HEX_LENGTH, '\0');
+    write_hex(result.data());
+    return result;
+}
+
+bool SpanId::is_valid() const noexcept {
+    return !is_zero(data);
+}
+
+void SpanId::write_hex(char* out) const noexcept {
+    write_hex_bytes(data, out);
+}
+
+SpanId SpanId::generate() {
+    SpanId span_id;
+    do {
+        fill_random(span_id.data.data(), span_id.data.size());
+    } while (!span_id.is_valid());
+    return span_id;
+}
+
+SpanId SpanId::invalid() {
+    return SpanId{};
+}
+
+optional<SpanId> SpanId::from_hex(string_view hex_string) noexcept {
+    SpanId span_id;
+    if (!parse_hex_bytes(hex_string, span_id.data)) {
+        return std::nullopt;
+    }
+    return span_id;
+}
+
+size_type TraceState::size() const noexcept {
+    size_type count = 0;
+    for_each([&count](string_view, string_view) { ++count; });
+    return count;
+}
+
+optional<string_view> TraceState::get(string_view key) const noexcept {
+    optional<string_view> result;
+    for_each([&](string_view member_key, string_view member_value) {
+        if (!result && member_key == key) {
+            result = member_value;
+        }
+    });
+    return result;
+}
+
+bool TraceState::set(string_view key, string_view value) {
+    if (!is_valid_key(key) || !is_valid_value(value)) {
+        return false;
+    }
+    
+    string updated;
+    updated.reserve(header_.size() + key.size() + value.size() + 2);
+    updated.append(key).append("=").append(value);
+    
+    size_type members = 1;
+    for_each([&](string_view member_key, string_view member_value) {
+        if (member_key == key || members >= MAX_MEMBERS) {
+            return;
+        }
+        if (updated.size() + member_key.size() + member_value.size() + 2 > MAX_LENGTH) {
+            return;
+        }
+        updated.append(",").append(member_key).append("=").append(member_value);
+        ++members;
+    });
+    
+    header_ = std::move(updated);
+    return true;
+}
+
+void TraceState::erase(string_view key) {
+    string updated;
+    updated.reserve(header_.size());
+    for_each([&](string_view member_key, string_view member_value) {
+        if (member_key == key) {
+            return;
+        }
+        if (!updated.empty()) {
+            updated.append(",");
+        }
+        updated.append(member_key).append("=").append(member_value);
+    });
+    header_ = std::move(updated);
+}
+
+optional<TraceState> TraceState::parse(string_view header) {
+    header = trim_whitespace(header);
+    if (!is_valid(header)) {
+        return std::nullopt;
+    }
+    
+    TraceState state;
+    state.header_.assign(header);
+    return state;
+}
+
+bool TraceState::is_valid(string_view header) noexcept {
+    if (header.size() > MAX_LENGTH) {
+        return false;
+    }
+    
+    size_type members = 0;
+    while (!header.empty()) {
+        auto comma = header.find(',');
+        auto member = trim_whitespace(header.substr(0, comma));
+        header = comma == string_view::npos ? string_view{} : header.substr(comma + 1);
+        
+        if (member.empty()) {
+            continue;
+        }
+        
+        auto equals = member.find('=');
+        if (equals == string_view::npos ||
+            !is_valid_key(member.substr(0, equals)) ||
+            !is_valid_value(member.substr(equals + 1)) ||
+            ++members > MAX_MEMBERS) {
+            return false;
+        }
+    }
+    return true;
+}
+
+SpanContext::SpanContext(TraceId tid, SpanId sid, bool sampled)
+    : trace_id(tid), span_id(sid), is_sampled(sampled) {}
+
+bool SpanContext::is_valid() const noexcept {
+    return trace_id.is_valid() && span_id.is_valid();
+}
+
+string SpanContext::to_trace_parent() const {
+    string result(TRACE_PARENT_LENGTH, '\0');
+    write_trace_parent(result.data());
+    return result;
+}
+
+void SpanContext::write_trace_parent(char* out) const noexcept {
+    out[0] = '0';
+    out[1] = '0';
+    out[2] = '-';
+    trace_id.write_hex(out + 3);
+    out[35] = '-';
+    span_id.write_hex(out + 36);
+    out[52] = '-';
+    out[53] = '0';
+    out[54] = is_sampled ? '1' : '0';
+}
+
+optional<SpanContext> SpanContext::from_trace_parent(string_view trace_parent) noexcept {
+    trace_parent = trim_whitespace(trace_parent);
+    if (trace_parent.size() < TRACE_PARENT_LENGTH) {
+        return std::nullopt;
+    }
+    
+    if (trace_parent[2] != '-' || trace_parent[35] != '-' || trace_parent[52] != '-') {
+        return std::nullopt;
+    }
+    
+    auto version_high = lower_hex_value(trace_parent[0]);
+    auto version_low = lower_hex_value(trace_parent[1]);
+    if (version_high < 0 || version_low < 0 || (version_high == 0xf && version_low == 0xf)) {
+        return std::nullopt;
+    }
+    
+    // Version 00 is exact; later versions may append fields after another dash
+    bool version_zero = version_high == 0 && version_low == 0;
+    if (trace_parent.size() > TRACE_PARENT_LENGTH &&
+        (version_zero || trace_parent[TRACE_PARENT_LENGTH] != '-')) {
+        return std::nullopt;
+    }
+    
+    auto trace_hex = trace_parent.substr(3, TraceId::HEX_LENGTH);
+    auto span_hex = trace_parent.substr(36, SpanId::HEX_LENGTH);
+    auto flags_hex = trace_parent.substr(53, 2);
+    if (!is_lower_hex(trace_hex) || !is_lower_hex(span_hex) || !is_lower_hex(flags_hex)) {
+        return std::nullopt;
+    }
+    
+    SpanContext context;
+    if (!parse_hex_bytes(trace_hex, context.trace_id.data) ||
+        !parse_hex_bytes(span_hex, context.span_id.data) ||
+        !context.is_valid()) {
+        return std::nullopt;
+    }
+    
+    auto flags = (lower_hex_value(flags_hex[0]) << 4) | lower_hex_value(flags_hex[1]);
+    context.is_sampled = (flags & 0x01) != 0;
+    context.is_remote = true;
+    return context;
+}
+
+optional<SpanContext> SpanContext::from_headers(string_view trace_parent, string_view trace_state) {
+    auto context = from_trace_parent(trace_parent);
+    if (context && !trace_state.empty()) {
+        if (auto state = TraceState::parse(trace_state)) {
+            context->trace_state = std::move(*state);
+        }
+    }
+    return context;
+}
+
+}  // namespace http_framework::tracing
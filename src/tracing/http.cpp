@@ -0,0 +1,368 @@
+#include "tracing/server_tracing.hpp"
+#include "http/request.hpp"
+#include "http/response.hpp"
+#include <charconv>
+#include <utility>
+#include <sstream>
+
+namespace http_framework::tracing {
+
+namespace {
+
+thread_local Span* active_server_span = nullptr;
+
+constexpr string_view TRACE_PARENT_HEADER = "traceparent";
+constexpr string_view TRACE_STATE_HEADER = "tracestate";
+
+string_view method_name(HttpMethod method) noexcept {
+    switch (method) {
+        case HttpMethod::GET: return "GET";
+        case HttpMethod::POST: return "POST";
+        case HttpMethod::PUT: return "PUT";
+        case HttpMethod::DELETE: return "DELETE";
+        case HttpMethod::PATCH: return "PATCH";
+        case HttpMethod::HEAD: return "HEAD";
+        case HttpMethod::OPTIONS: return "OPTIONS";
+        case HttpMethod::TRACE: return "TRACE";
+        case HttpMethod::CONNECT: return "CONNECT";
+    }
+    return "_OTHER";
+}
+
+string_view protocol_version(HttpVersion version) noexcept {
+    switch (version) {
+        case HttpVersion::HTTP_1_0: return "1.0";
+        case HttpVersion::HTTP_1_1: return "1.1";
+        case HttpVersion::HTTP_2_0: return "2";
+        case HttpVersion::HTTP_3_0: return "3";
+    }
+    return "1.1";
+}
+
+void record_request_attributes(Span& span, const http_framework::http::Request& request) {
+    const auto& uri = request.uri();
+    string_view target(uri);
+    auto query_start = target.find('?');
+    auto path = target.substr(0, std::min(query_start, target.find('#')));
+    
+    span.set_attribute(semconv::HTTP_REQUEST_METHOD, method_name(request.method()));
+    span.set_attribute(semconv::URL_PATH, path);
+    if (query_start != string_view::npos) {
+        auto query = target.substr(query_start + 1);
+        span.set_attribute(semconv::URL_QUERY, query.substr(0, query.find('#')));
+    }
+    span.set_attribute(semconv::URL_SCHEME, string_view("http"));
+    span.set_attribute(semconv::NETWORK_PROTOCOL_NAME, string_view("http"));
+    span.set_attribute(semconv::NETWORK_PROTOCOL_VERSION, protocol_version(request.version()));
+    
+    if (auto host = request.header_view("host")) {
+        span.set_attribute(semconv::SERVER_ADDRESS, *host);
+    }
+    if (auto user_agent = request.header_view("user-agent")) {
+        span.set_attribute(semconv::USER_AGENT_ORIGINAL, *user_agent);
+    }
+    if (!request.body().empty()) {
+        span.set_attribute(semconv::HTTP_REQUEST_BODY_SIZE, static_cast<int64_t>(request.body().size()));
+    }
+}
+
+void record_status(Span& span, status_code_t status_code, status_code_t first_error_code) {
+    span.set_attribute(semconv::HTTP_RESPONSE_STATUS_CODE, static_cast<int64_t>(status_code));
+    if (status_code < first_error_code) {
+        return;
+    }
+    
+    char digits[8];
+    auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), status_code);
+    span.set_attribute(semconv::ERROR_TYPE, string_view(digits, static_cast<size_type>(end - digits)));
+    span.set_status(false);
+}
+
+}  // namespace
+
+string_view to_string(RequestPhase phase) noexcept {
+    switch (phase) {
+        case RequestPhase::PARSE: return "parse";
+        case RequestPhase::ROUTE: return "route";
+        case RequestPhase::HANDLER: return "handler";
+        case RequestPhase::WRITE: return "write";
+    }
+    return "unknown";
+}
+
+RequestTrace::RequestTrace(RequestTrace&& other) noexcept
+    : context_(std::move(other.context_)),
+      span_(std::move(other.span_)),
+      previous_context_(std::move(other.previous_context_)),
+      previous_span_(other.previous_span_),
+      record_phases_(other.record_phases_),
+      active_(std::exchange(other.active_, false)) {}
+
+RequestTrace& RequestTrace::operator=(RequestTrace&& other) noexcept {
+    if (this != &other) {
+        if (span_) {
+            span_->end();
+            span_.reset();
+        }
+        release();
+        
+        context_ = std::move(other.context_);
+        span_ = std::move(other.span_);
+        previous_context_ = std::move(other.previous_context_);
+        previous_span_ = other.previous_span_;
+        record_phases_ = other.record_phases_;
+        active_ = std::exchange(other.active_, false);
+    }
+    return *this;
+}
+
+RequestTrace::~RequestTrace() {
+    if (span_) {
+        span_->end();
+        span_.reset();
+    }
+    release();
+}
+
+void RequestTrace::mark(RequestPhase phase) {
+    if (span_ && record_phases_) {
+        span_->add_event(to_string(phase));
+    }
+}
+
+void RequestTrace::mark(RequestPhase phase, timestamp_t timestamp) {
+    if (span_ && record_phases_) {
+        span_->add_event(to_string(phase), timestamp);
+    }
+}
+
+void RequestTrace::mark(string_view phase, timestamp_t timestamp) {
+    if (span_ && record_phases_) {
+        span_->add_event(phase, timestamp);
+    }
+}
+
+void RequestTrace::set_route(string_view route) {
+    if (!span_) {
+        return;
+    }
+    
+    string_view method = span_->name();
+    method = method.substr(0, method.find(' '));
+    
+    string name;
+    name.reserve(method.size() + 1 + route.size());
+    name.append(method).append(" ").append(route);
+    
+    span_->set_attribute(semconv::HTTP_ROUTE, route);
+    span_->update_name(name);
+}
+
+void RequestTrace::record_exception(const std::exception& exception) {
+    if (span_) {
+        span_->record_exception(exception);
+        span_->set_status(false, exception.what());
+    }
+}
+
+void RequestTrace::finish(const http_framework::http::Response& response) {
+    if (span_) {
+        record_status(*span_, response.status_code(), 500);
+        if (response.body_size() > 0) {
+            span_->set_attribute(semconv::HTTP_RESPONSE_BODY_SIZE, static_cast<int64_t>(response.body_size()));
+        }
+        span_->end();
+        span_.reset();
+    }
+    release();
+}
+
+void RequestTrace::release() noexcept {
+    if (!active_) {
+        return;
+    }
+    
+    active_ = false;
+    active_server_span = previous_span_;
+    current_span_context = std::move(previous_context_);
+    previous_context_.reset();
+}
+
+void record_request_event(string_view name) {
+    if (active_server_span) {
+        active_server_span->add_event(name);
+    }
+}
+
+string ServerTracingMetrics::to_json() const {
+    std::ostringstream oss;
+    oss << "{\"requests_traced\":" << requests_traced
+        << ",\"requests_recorded\":" << requests_recorded
+        << ",\"remote_parents\":" << remote_parents
+        << ",\"rejected_trace_parents\":" << rejected_trace_parents
+        << "}";
+    return oss.str();
+}
+
+ServerRequestTracer::ServerRequestTracer(TracerProvider& provider)
+    : ServerRequestTracer(provider, Config{}) {}
+
+ServerRequestTracer::ServerRequestTracer(TracerProvider& provider, Config config)
+    : config_(std::move(config)), tracer_(provider.get_tracer(config_.tracer_name)) {}
+
+RequestTrace ServerRequestTracer::begin(const http_framework::http::Request& request) {
+    return begin(request, std::chrono::steady_clock::now());
+}
+
+RequestTrace ServerRequestTracer::begin(const http_framework::http::Request& request, timestamp_t received_at) {
+    requests_traced_.fetch_add(1, std::memory_order_relaxed);
+    
+    optional<SpanContext> parent;
+    if (config_.trust_remote_context) {
+        if (auto trace_parent = request.header_view(TRACE_PARENT_HEADER)) {
+            parent = SpanContext::from_trace_parent(*trace_parent);
+            if (parent) {
+                remote_parents_.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                rejected_trace_parents_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        if (auto trace_state = request.header_view(TRACE_STATE_HEADER); parent && trace_state) {
+            if (auto state = TraceState::parse(*trace_state)) {
+                parent->trace_state = std::move(*state);
+            }
+        }
+    }
+    
+    const SpanContext* parent_context = parent ? &*parent : nullptr;
+    auto trace_id = parent ? parent->trace_id : TraceId::generate();
+    auto method = method_name(request.method());
+    auto decision = tracer_->should_sample(parent_context, trace_id, method, SpanKind::SERVER);
+    
+    RequestTrace trace;
+    trace.previous_context_ = current_span_context;
+    trace.previous_span_ = active_server_span;
+    
+    if (decision == SamplingDecision::DROP) {
+        trace.context_ = SpanContext(trace_id, SpanId::generate(), false);
+        if (parent) {
+            trace.context_.trace_state = std::move(parent->trace_state);
+        }
+        active_server_span = nullptr;
+    } else {
+        auto span = tracer_->start_span(method, parent_context, trace_id, SpanKind::SERVER, decision, received_at);
+        record_request_attributes(*span, request);
+        
+        trace.context_ = span->context();
+        trace.span_ = std::move(span);
+        trace.record_phases_ = config_.record_phase_events;
+        active_server_span = trace.span_.get();
+        requests_recorded_.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    current_span_context = trace.context_;
+    trace.active_ = true;
+    return trace;
+}
+
+ServerTracingMetrics ServerRequestTracer::metrics() const {
+    ServerTracingMetrics result;
+    result.requests_traced = requests_traced_.load(std::memory_order_relaxed);
+    result.requests_recorded = requests_recorded_.load(std::memory_order_relaxed);
+    result.remote_parents = remote_parents_.load(std::memory_order_relaxed);
+    result.rejected_trace_parents = rejected_trace_parents_.load(std::memory_order_relaxed);
+    return result;
+}
+
+namespace http {
+
+hash_map<string, string> extract_trace_headers(const http_framework::http::Request& request) {
+    hash_map<string, string> headers;
+    if (auto trace_parent = request.header_view(TRACE_PARENT_HEADER)) {
+        headers.emplace(string(TRACE_PARENT_HEADER), string(*trace_parent));
+    }
+    if (auto trace_state = request.header_view(TRACE_STATE_HEADER)) {
+        headers.emplace(string(TRACE_STATE_HEADER), string(*trace_state));
+    }
+    return headers;
+}
+
+optional<SpanContext> extract_context(const http_framework::http::Request& request) {
+    auto trace_parent = request.header_view(TRACE_PARENT_HEADER);
+    if (!trace_parent) {
+        return std::nullopt;
+    }
+    return SpanContext::from_headers(*trace_parent, request.header_view(TRACE_STATE_HEADER).value_or(string_view{}));
+}
+
+void inject_trace_headers(http_framework::http::Response& response, const SpanContext& context) {
+    if (!context.is_valid()) {
+        return;
+    }
+    
+    char trace_parent[SpanContext::TRACE_PARENT_LENGTH];
+    context.write_trace_parent(trace_parent);
+    response.set_header(TRACE_PARENT_HEADER, string_view(trace_parent, sizeof(trace_parent)));
+    if (!context.trace_state.empty()) {
+        response.set_header(TRACE_STATE_HEADER, context.trace_state.header());
+    }
+}
+
+void inject_trace_headers(hash_map<string, string>& headers, const SpanContext& context) {
+    if (!context.is_valid()) {
+        return;
+    }
+    
+    char trace_parent[SpanContext::TRACE_PARENT_LENGTH];
+    context.write_trace_parent(trace_parent);
+    headers[TRACE_PARENT_HEADER].assign(trace_parent, sizeof(trace_parent));
+    if (!context.trace_state.empty()) {
+        headers[TRACE_STATE_HEADER] = context.trace_state.header();
+    }
+}
+
+bool inject_current_context(hash_map<string, string>& headers) {
+    if (!current_span_context || !current_span_context->is_valid()) {
+        return false;
+    }
+    inject_trace_headers(headers, *current_span_context);
+    return true;
+}
+
+SpanScope start_server_span(const http_framework::http::Request& request) {
+    auto tracer = TracerProvider::instance().get_tracer("http_framework.server");
+    auto method = method_name(request.method());
+    auto parent = extract_context(request);
+    
+    auto span = parent ? tracer->start_span(method, *parent, SpanKind::SERVER)
+                       : tracer->start_span(method, SpanContext{}, SpanKind::SERVER);
+    if (span->is_recording()) {
+        record_request_attributes(*span, request);
+    }
+    return SpanScope(std::move(span));
+}
+
+void end_server_span(Span& span, const http_framework::http::Response& response) {
+    if (span.is_recording() && !span.is_ended()) {
+        record_status(span, response.status_code(), 500);
+    }
+    span.end();
+}
+
+unique_ptr<Span> start_client_span(string_view method, string_view url) {
+    auto span = TracerProvider::instance().get_tracer("http_framework.client")->start_span(method, SpanKind::CLIENT);
+    span->set_attribute(semconv::HTTP_REQUEST_METHOD, method);
+    span->set_attribute(semconv::URL_FULL, url);
+    return span;
+}
+
+void end_client_span(Span& span, status_code_t status_code) {
+    if (span.is_recording() && !span.is_ended()) {
+        record_status(span, status_code, 400);
+    }
+    span.end();
+}
+
+}  // namespace http
+
+}  // namespace http_framework::tracing
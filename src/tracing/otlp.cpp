@@ -0,0 +1,531 @@
+#include "tracing/otlp.hpp"
+#include <bit>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef HTTP_FRAMEWORK_HAS_ZLIB
+#include <zlib.h>
+#endif
+
+namespace http_framework::tracing {
+
+namespace {
+
+constexpr std::uint32_t WIRE_VARINT = 0;
+constexpr std::uint32_t WIRE_FIXED64 = 1;
+constexpr std::uint32_t WIRE_LENGTH = 2;
+constexpr std::uint32_t WIRE_FIXED32 = 5;
+
+// Nested lengths are reserved as padded four-byte varints and patched in place,
+// which decoders accept and which avoids sizing every message twice
+constexpr size_type LENGTH_PLACEHOLDER_BYTES = 4;
+constexpr size_type MAX_MESSAGE_LENGTH = (size_type{1} << 28) - 1;
+
+namespace field {
+    constexpr std::uint32_t REQUEST_RESOURCE_SPANS = 1;
+    
+    constexpr std::uint32_t RESOURCE_SPANS_RESOURCE = 1;
+    constexpr std::uint32_t RESOURCE_SPANS_SCOPE_SPANS = 2;
+    constexpr std::uint32_t RESOURCE_ATTRIBUTES = 1;
+    
+    constexpr std::uint32_t SCOPE_SPANS_SCOPE = 1;
+    constexpr std::uint32_t SCOPE_SPANS_SPANS = 2;
+    constexpr std::uint32_t SCOPE_NAME = 1;
+    constexpr std::uint32_t SCOPE_VERSION = 2;
+    
+    constexpr std::uint32_t SPAN_TRACE_ID = 1;
+    constexpr std::uint32_t SPAN_SPAN_ID = 2;
+    constexpr std::uint32_t SPAN_TRACE_STATE = 3;
+    constexpr std::uint32_t SPAN_PARENT_SPAN_ID = 4;
+    constexpr std::uint32_t SPAN_NAME = 5;
+    constexpr std::uint32_t SPAN_KIND = 6;
+    constexpr std::uint32_t SPAN_START_TIME = 7;
+    constexpr std::uint32_t SPAN_END_TIME = 8;
+    constexpr std::uint32_t SPAN_ATTRIBUTES = 9;
+    constexpr std::uint32_t SPAN_EVENTS = 11;
+    constexpr std::uint32_t SPAN_STATUS = 15;
+    constexpr std::uint32_t SPAN_FLAGS = 16;
+    
+    constexpr std::uint32_t EVENT_TIME = 1;
+    constexpr std::uint32_t EVENT_NAME = 2;
+    constexpr std::uint32_t EVENT_ATTRIBUTES = 3;
+    
+    constexpr std::uint32_t STATUS_MESSAGE = 2;
+    constexpr std::uint32_t STATUS_CODE = 3;
+    
+    constexpr std::uint32_t KEY_VALUE_KEY = 1;
+    constexpr std::uint32_t KEY_VALUE_VALUE = 2;
+    
+    constexpr std::uint32_t ANY_STRING = 1;
+    constexpr std::uint32_t ANY_BOOL = 2;
+    constexpr std::uint32_t ANY_INT = 3;
+    constexpr std::uint32_t ANY_DOUBLE = 4;
+    constexpr std::uint32_t ANY_ARRAY = 5;
+    constexpr std::uint32_t ARRAY_VALUES = 1;
+}  // namespace field
+
+constexpr std::uint64_t STATUS_CODE_ERROR = 2;
+constexpr std::uint32_t FLAG_SAMPLED = 0x01;
+constexpr std::uint32_t FLAG_HAS_IS_REMOTE = 0x100;
+constexpr std::uint32_t FLAG_IS_REMOTE = 0x200;
+
+std::int64_t steady_to_unix_offset() {
+    auto system_now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    auto steady_now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    return system_now - steady_now;
+}
+
+}  // namespace
+
+OtlpProtobufEncoder::OtlpProtobufEncoder() : OtlpProtobufEncoder(Config{}) {}
+
+OtlpProtobufEncoder::OtlpProtobufEncoder(Config config)
+    : config_(std::move(config)), steady_to_unix_ns_(steady_to_unix_offset()) {
+    encode_resource();
+    encode_scope();
+}
+
+byte_span OtlpProtobufEncoder::encode(const vector<Span>& spans) {
+    buffer_.clear();
+    
+    auto resource_spans = open_message(field::REQUEST_RESOURCE_SPANS);
+    put_raw(resource_message_);
+    
+    auto scope_spans = open_message(field::RESOURCE_SPANS_SCOPE_SPANS);
+    put_raw(scope_message_);
+    for (const auto& span : spans) {
+        encode_span(span);
+    }
+    close_message(scope_spans);
+    
+    close_message(resource_spans);
+    return byte_span(buffer_.data(), buffer_.size());
+}
+
+void OtlpProtobufEncoder::put_varint(std::uint64_t value) {
+    byte_t scratch[10];
+    size_type length = 0;
+    while (value >= 0x80) {
+        scratch[length++] = static_cast<byte_t>(value | 0x80);
+        value >>= 7;
+    }
+    scratch[length++] = static_cast<byte_t>(value);
+    buffer_.insert(buffer_.end(), scratch, scratch + length);
+}
+
+void OtlpProtobufEncoder::put_tag(std::uint32_t field, std::uint32_t wire_type) {
+    put_varint((static_cast<std::uint64_t>(field) << 3) | wire_type);
+}
+
+void OtlpProtobufEncoder::put_fixed32(std::uint32_t value) {
+    byte_t scratch[4];
+    for (size_type i = 0; i < 4; ++i) {
+        scratch[i] = static_cast<byte_t>(value >> (8 * i));
+    }
+    buffer_.insert(buffer_.end(), scratch, scratch + 4);
+}
+
+void OtlpProtobufEncoder::put_fixed64(std::uint64_t value) {
+    byte_t scratch[8];
+    for (size_type i = 0; i < 8; ++i) {
+        scratch[i] = static_cast<byte_t>(value >> (8 * i));
+    }
+    buffer_.insert(buffer_.end(), scratch, scratch + 8);
+}
+
+void OtlpProtobufEncoder::put_bytes(std::uint32_t field, const void* data, size_type size) {
+    put_tag(field, WIRE_LENGTH);
+    put_varint(size);
+    auto bytes = static_cast<const byte_t*>(data);
+    buffer_.insert(buffer_.end(), bytes, bytes + size);
+}
+
+void OtlpProtobufEncoder::put_string(std::uint32_t field, string_view value) {
+    put_bytes(field, value.data(), value.size());
+}
+
+size_type OtlpProtobufEncoder::open_message(std::uint32_t field) {
+    put_tag(field, WIRE_LENGTH);
+    auto mark = buffer_.size();
+    buffer_.resize(mark + LENGTH_PLACEHOLDER_BYTES);
+    return mark;
+}
+
+void OtlpProtobufEncoder::close_message(size_type mark) {
+    auto length = buffer_.size() - mark - LENGTH_PLACEHOLDER_BYTES;
+    if (length > MAX_MESSAGE_LENGTH) {
+        throw std::length_error("OTLP message exceeds 256 MiB");
+    }
+    
+    for (size_type i = 0; i < LENGTH_PLACEHOLDER_BYTES; ++i) {
+        auto group = static_cast<byte_t>((length >> (7 * i)) & 0x7f);
+        buffer_[mark + i] = i + 1 < LENGTH_PLACEHOLDER_BYTES ? static_cast<byte_t>(group | 0x80) : group;
+    }
+}
+
+void OtlpProtobufEncoder::encode_span(const Span& span) {
+    const auto& context = span.context();
+    auto mark = open_message(field::SCOPE_SPANS_SPANS);
+    
+    put_bytes(field::SPAN_TRACE_ID, context.trace_id.data.data(), context.trace_id.data.size());
+    put_bytes(field::SPAN_SPAN_ID, context.span_id.data.data(), context.span_id.data.size());
+    
+    if (!context.trace_state.empty()) {
+        put_string(field::SPAN_TRACE_STATE, context.trace_state.header());
+    }
+    
+    if (span.parent_span_id().is_valid()) {
+        const auto& parent = span.parent_span_id();
+        put_bytes(field::SPAN_PARENT_SPAN_ID, parent.data.data(), parent.data.size());
+    }
+    
+    put_string(field::SPAN_NAME, span.name());
+    put_tag(field::SPAN_KIND, WIRE_VARINT);
+    put_varint(static_cast<std::uint64_t>(span.kind()) + 1);
+    
+    put_tag(field::SPAN_START_TIME, WIRE_FIXED64);
+    put_fixed64(unix_nanos(span.start_time()));
+    put_tag(field::SPAN_END_TIME, WIRE_FIXED64);
+    put_fixed64(unix_nanos(span.end_time().value_or(span.start_time())));
+    
+    span.attributes().for_each([this](const AttributeView& attribute) {
+        encode_attribute(field::SPAN_ATTRIBUTES, attribute);
+    });
+    
+    for (const auto& event : span.events()) {
+        encode_event(event);
+    }
+    
+    if (!span.status().ok) {
+        auto status = open_message(field::SPAN_STATUS);
+        if (!span.status().description.empty()) {
+            put_string(field::STATUS_MESSAGE, span.status().description);
+        }
+        put_tag(field::STATUS_CODE, WIRE_VARINT);
+        put_varint(STATUS_CODE_ERROR);
+        close_message(status);
+    }
+    
+    std::uint32_t flags = context.is_sampled ? FLAG_SAMPLED : 0;
+    flags |= FLAG_HAS_IS_REMOTE | (span.has_remote_parent() ? FLAG_IS_REMOTE : 0);
+    put_tag(field::SPAN_FLAGS, WIRE_FIXED32);
+    put_fixed32(flags);
+    
+    close_message(mark);
+}
+
+void OtlpProtobufEncoder::encode_event(const Span::Event& event) {
+    auto mark = open_message(field::SPAN_EVENTS);
+    put_tag(field::EVENT_TIME, WIRE_FIXED64);
+    put_fixed64(unix_nanos(event.timestamp));
+    put_string(field::EVENT_NAME, event.name);
+    event.attributes.for_each([this](const AttributeView& attribute) {
+        encode_attribute(field::EVENT_ATTRIBUTES, attribute);
+    });
+    close_message(mark);
+}
+
+void OtlpProtobufEncoder::encode_attribute(std::uint32_t field, const AttributeView& attribute) {
+    auto key_value = open_message(field);
+    put_string(field::KEY_VALUE_KEY, key_name(attribute.key));
+    auto value = open_message(field::KEY_VALUE_VALUE);
+    
+    switch (attribute.type) {
+        case AttributeType::STRING:
+            put_string(field::ANY_STRING, attribute.as_string());
+            break;
+        case AttributeType::BOOL:
+            put_tag(field::ANY_BOOL, WIRE_VARINT);
+            put_varint(attribute.boolean ? 1 : 0);
+            break;
+        case AttributeType::INT64:
+            put_tag(field::ANY_INT, WIRE_VARINT);
+            put_varint(static_cast<std::uint64_t>(attribute.integer));
+            break;
+        case AttributeType::DOUBLE:
+            put_tag(field::ANY_DOUBLE, WIRE_FIXED64);
+            put_fixed64(std::bit_cast<std::uint64_t>(attribute.real));
+            break;
+        case AttributeType::STRING_ARRAY: {
+            auto array = open_message(field::ANY_ARRAY);
+            size_type position = 0;
+            for (std::uint32_t i = 0; i < attribute.count; ++i) {
+                std::uint32_t length = 0;
+                std::memcpy(&length, attribute.bytes.data() + position, sizeof(length));
+                position += sizeof(length);
+                auto element = open_message(field::ARRAY_VALUES);
+                put_bytes(field::ANY_STRING, attribute.bytes.data() + position, length);
+                close_message(element);
+                position += length;
+            }
+            close_message(array);
+            break;
+        }
+        case AttributeType::BOOL_ARRAY: {
+            auto array = open_message(field::ANY_ARRAY);
+            for (bool element : attribute.as_bool_array()) {
+                auto entry = open_message(field::ARRAY_VALUES);
+                put_tag(field::ANY_BOOL, WIRE_VARINT);
+                put_varint(element ? 1 : 0);
+                close_message(entry);
+            }
+            close_message(array);
+            break;
+        }
+        case AttributeType::INT64_ARRAY: {
+            auto array = open_message(field::ANY_ARRAY);
+            for (auto element : attribute.as_int64_array()) {
+                auto entry = open_message(field::ARRAY_VALUES);
+                put_tag(field::ANY_INT, WIRE_VARINT);
+                put_varint(static_cast<std::uint64_t>(element));
+                close_message(entry);
+            }
+            close_message(array);
+            break;
+        }
+        case AttributeType::DOUBLE_ARRAY: {
+            auto array = open_message(field::ANY_ARRAY);
+            for (auto element : attribute.as_double_array()) {
+                auto entry = open_message(field::ARRAY_VALUES);
+                put_tag(field::ANY_DOUBLE, WIRE_FIXED64);
+                put_fixed64(std::bit_cast<std::uint64_t>(element));
+                close_message(entry);
+            }
+            close_message(array);
+            break;
+        }
+    }
+    
+    close_message(value);
+    close_message(key_value);
+}
+
+void OtlpProtobufEncoder::encode_attribute(std::uint32_t field, string_view key, const Attribute& attribute) {
+    SpanAttributes staging;
+    auto staged_key = AttributeKey::intern(key);
+    std::visit([&](const auto& held) { staging.set(staged_key, held); }, attribute.value);
+    staging.for_each([&](const AttributeView& view) { encode_attribute(field, view); });
+}
+
+void OtlpProtobufEncoder::set_resource(const Resource& resource) {
+    if (config_.service_name.empty()) {
+        config_.service_name = resource.service_name;
+    }
+    if (config_.service_version.empty()) {
+        config_.service_version = resource.service_version;
+    }
+    for (const auto& [key, attribute] : resource.attributes) {
+        config_.resource_attributes.try_emplace(key, attribute);
+    }
+    encode_resource();
+}
+
+void OtlpProtobufEncoder::encode_resource() {
+    buffer_.clear();
+    auto resource = open_message(field::RESOURCE_SPANS_RESOURCE);
+    auto service_name = config_.service_name.empty() ? string("unknown_service") : config_.service_name;
+    encode_attribute(field::RESOURCE_ATTRIBUTES, "service.name", Attribute{service_name});
+    if (!config_.service_version.empty()) {
+        encode_attribute(field::RESOURCE_ATTRIBUTES, "service.version", Attribute{config_.service_version});
+    }
+    for (const auto& [key, attribute] : config_.resource_attributes) {
+        encode_attribute(field::RESOURCE_ATTRIBUTES, key, attribute);
+    }
+    close_message(resource);
+    resource_message_.assign(buffer_.begin(), buffer_.end());
+}
+
+void OtlpProtobufEncoder::encode_scope() {
+    buffer_.clear();
+    auto scope = open_message(field::SCOPE_SPANS_SCOPE);
+    put_string(field::SCOPE_NAME, config_.scope_name);
+    if (!config_.scope_version.empty()) {
+        put_string(field::SCOPE_VERSION, config_.scope_version);
+    }
+    close_message(scope);
+    scope_message_.assign(buffer_.begin(), buffer_.end());
+}
+
+string_view OtlpProtobufEncoder::key_name(AttributeKey key) {
+    if (key.id >= key_names_.size()) {
+        key_names_.resize(key.id + 1);
+    }
+    
+    auto& name = key_names_[key.id];
+    if (name.empty()) {
+        name = key.name();
+    }
+    return name;
+}
+
+std::uint64_t OtlpProtobufEncoder::unix_nanos(timestamp_t timestamp) const noexcept {
+    auto steady = std::chrono::duration_cast<std::chrono::nanoseconds>(timestamp.time_since_epoch()).count();
+    return static_cast<std::uint64_t>(steady + steady_to_unix_ns_);
+}
+
+bool gzip_available() noexcept {
+#ifdef HTTP_FRAMEWORK_HAS_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool gzip_compress(byte_span input, buffer_t& output, int level) {
+    output.clear();
+#ifdef HTTP_FRAMEWORK_HAS_ZLIB
+    z_stream stream{};
+    if (deflateInit2(&stream, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return false;
+    }
+    
+    output.resize(deflateBound(&stream, static_cast<uLong>(input.size())));
+    stream.next_in = const_cast<Bytef*>(input.data());
+    stream.avail_in = static_cast<uInt>(input.size());
+    stream.next_out = output.data();
+    stream.avail_out = static_cast<uInt>(output.size());
+    
+    auto result = deflate(&stream, Z_FINISH);
+    auto written = static_cast<size_type>(stream.total_out);
+    deflateEnd(&stream);
+    
+    if (result != Z_STREAM_END) {
+        output.clear();
+        return false;
+    }
+    
+    output.resize(written);
+    return true;
+#else
+    return false;
+#endif
+}
+
+byte_span OtlpSpanExporter::serialize_spans(const vector<Span>& spans) {
+    if (!encoder_) {
+        encoder_ = std::make_unique<OtlpProtobufEncoder>();
+    }
+    
+    auto payload = encoder_->encode(spans);
+    if (config_.gzip && gzip_compress(payload, compressed_)) {
+        return byte_span(compressed_.data(), compressed_.size());
+    }
+    return payload;
+}
+
+string FileSpanExporterMetrics::to_json() const {
+    std::ostringstream oss;
+    oss << "{\"batches_written\":" << batches_written
+        << ",\"spans_written\":" << spans_written
+        << ",\"bytes_written\":" << bytes_written
+        << ",\"write_failures\":" << write_failures
+        << "}";
+    return oss.str();
+}
+
+FileSpanExporter::FileSpanExporter() : FileSpanExporter(Config{}) {}
+
+FileSpanExporter::FileSpanExporter(Config config)
+    : config_(std::move(config)), encoder_(config_.encoder) {
+    if (config_.gzip && !gzip_available()) {
+        config_.gzip = false;
+    }
+    file_ = std::fopen(config_.path.c_str(), config_.truncate ? "wb" : "ab");
+}
+
+FileSpanExporter::~FileSpanExporter() {
+    shutdown();
+}
+
+void FileSpanExporter::set_resource(const Resource& resource) {
+    lock_guard lock(file_mutex_);
+    encoder_.set_resource(resource);
+}
+
+SpanExporter::ExportResult FileSpanExporter::export_spans(const vector<Span>& spans) {
+    if (spans.empty()) {
+        return ExportResult::SUCCESS;
+    }
+    
+    lock_guard lock(file_mutex_);
+    if (shut_down_) {
+        return ExportResult::FAILURE;
+    }
+    
+    // A sidecar may create the pipe after startup, so keep retrying the open
+    if (!file_) {
+        file_ = std::fopen(config_.path.c_str(), "ab");
+        if (!file_) {
+            write_failures_.fetch_add(1, std::memory_order_relaxed);
+            return ExportResult::FAILURE;
+        }
+    }
+    
+    auto payload = encoder_.encode(spans);
+    if (config_.gzip && gzip_compress(payload, compressed_, config_.gzip_level)) {
+        payload = byte_span(compressed_.data(), compressed_.size());
+    }
+    
+    if (!write_record(payload)) {
+        write_failures_.fetch_add(1, std::memory_order_relaxed);
+        std::fclose(file_);
+        file_ = nullptr;
+        return ExportResult::FAILURE;
+    }
+    
+    batches_written_.fetch_add(1, std::memory_order_relaxed);
+    spans_written_.fetch_add(spans.size(), std::memory_order_relaxed);
+    return ExportResult::SUCCESS;
+}
+
+void FileSpanExporter::shutdown(duration_t timeout) {
+    lock_guard lock(file_mutex_);
+    shut_down_ = true;
+    if (file_) {
+        std::fflush(file_);
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+}
+
+bool FileSpanExporter::is_open() const {
+    lock_guard lock(file_mutex_);
+    return file_ != nullptr;
+}
+
+FileSpanExporterMetrics FileSpanExporter::metrics() const {
+    FileSpanExporterMetrics result;
+    result.batches_written = batches_written_.load(std::memory_order_relaxed);
+    result.spans_written = spans_written_.load(std::memory_order_relaxed);
+    result.bytes_written = bytes_written_.load(std::memory_order_relaxed);
+    result.write_failures = write_failures_.load(std::memory_order_relaxed);
+    return result;
+}
+
+bool FileSpanExporter::write_record(byte_span payload) {
+    byte_t prefix[10];
+    size_type prefix_length = 0;
+    auto length = static_cast<std::uint64_t>(payload.size());
+    while (length >= 0x80) {
+        prefix[prefix_length++] = static_cast<byte_t>(length | 0x80);
+        length >>= 7;
+    }
+    prefix[prefix_length++] = static_cast<byte_t>(length);
+    
+    if (std::fwrite(prefix, 1, prefix_length, file_) != prefix_length ||
+        std::fwrite(payload.data(), 1, payload.size(), file_) != payload.size()) {
+        return false;
+    }
+    
+    if (config_.flush_each_batch && std::fflush(file_) != 0) {
+        return false;
+    }
+    
+    bytes_written_.fetch_add(prefix_length + payload.size(), std::memory_order_relaxed);
+    return true;
+}
+
+}  // namespace http_framework::tracing
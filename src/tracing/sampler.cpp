@@ -0,0 +1,339 @@
+#include "tracing/sampler.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <sstream>
+
+namespace http_framework::tracing {
+
+namespace {
+
+std::int64_t steady_now_ns() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+std::uint64_t trace_id_random_part(const TraceId& trace_id) noexcept {
+    std::uint64_t value = 0;
+    for (size_type i = 8; i < trace_id.data.size(); ++i) {
+        value = (value << 8) | trace_id.data[i];
+    }
+    return value >> 1;
+}
+
+}  // namespace
+
+TraceIdRatioSampler::TraceIdRatioSampler(double ratio, SamplingDecision unsampled)
+    : ratio_(std::clamp(ratio, 0.0, 1.0)),
+      threshold_(static_cast<std::uint64_t>(ratio_ * 9223372036854775808.0)),
+      unsampled_(unsampled) {}
+
+SamplingDecision TraceIdRatioSampler::should_sample(const SamplingParameters& parameters) {
+    return trace_id_random_part(parameters.trace_id) < threshold_ ? SamplingDecision::RECORD_AND_SAMPLE : unsampled_;
+}
+
+string TraceIdRatioSampler::description() const {
+    std::ostringstream oss;
+    oss << "TraceIdRatioBased{" << ratio_ << "}";
+    return oss.str();
+}
+
+RateLimitingSampler::RateLimitingSampler(double traces_per_second, SamplingDecision unsampled)
+    : traces_per_second_(std::max(traces_per_second, 0.0)),
+      max_scaled_(static_cast<std::int64_t>(std::max(traces_per_second_, 1.0) * SCALE)),
+      unsampled_(unsampled),
+      scaled_tokens_(max_scaled_),
+      last_refill_ns_(steady_now_ns()) {}
+
+SamplingDecision RateLimitingSampler::should_sample(const SamplingParameters& parameters) {
+    auto now = steady_now_ns();
+    auto last = last_refill_ns_.load(std::memory_order_relaxed);
+    if (now > last && last_refill_ns_.compare_exchange_strong(last, now, std::memory_order_acq_rel)) {
+        auto refill = static_cast<std::int64_t>(static_cast<double>(now - last) / 1e9 * traces_per_second_ * SCALE);
+        auto current = scaled_tokens_.load(std::memory_order_relaxed);
+        while (refill > 0 && current < max_scaled_ &&
+               !scaled_tokens_.compare_exchange_weak(current, std::min(current + refill, max_scaled_), std::memory_order_acq_rel)) {
+        }
+    }
+    
+    auto current = scaled_tokens_.load(std::memory_order_relaxed);
+    while (current >= SCALE) {
+        if (scaled_tokens_.compare_exchange_weak(current, current - SCALE, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+            sampled_.fetch_add(1, std::memory_order_relaxed);
+            return SamplingDecision::RECORD_AND_SAMPLE;
+        }
+    }
+    
+    throttled_.fetch_add(1, std::memory_order_relaxed);
+    return unsampled_;
+}
+
+string RateLimitingSampler::description() const {
+    std::ostringstream oss;
+    oss << "RateLimitingSampler{" << traces_per_second_ << "}";
+    return oss.str();
+}
+
+ParentBasedSampler::ParentBasedSampler(shared_ptr<Sampler> root) : ParentBasedSampler(std::move(root), Config{}) {}
+
+ParentBasedSampler::ParentBasedSampler(shared_ptr<Sampler> root, Config config)
+    : root_(std::move(root)), config_(std::move(config)) {}
+
+SamplingDecision ParentBasedSampler::should_sample(const SamplingParameters& parameters) {
+    const auto* parent = parameters.parent_context;
+    if (parent == nullptr || !parent->is_valid()) {
+        return root_->should_sample(parameters);
+    }
+    
+    if (parent->is_remote) {
+        return parent->is_sampled
+            ? config_.remote_parent_sampled->should_sample(parameters)
+            : config_.remote_parent_not_sampled->should_sample(parameters);
+    }
+    
+    if (parent->is_sampled) {
+        return config_.local_parent_sampled->should_sample(parameters);
+    }
+    if (parent->is_recorded) {
+        return SamplingDecision::RECORD_ONLY;
+    }
+    return config_.local_parent_not_sampled->should_sample(parameters);
+}
+
+string ParentBasedSampler::description() const {
+    return "ParentBased{root:" + root_->description() + "}";
+}
+
+string TailSamplingMetrics::to_json() const {
+    std::ostringstream oss;
+    oss << "{\"traces_kept\":" << traces_kept
+        << ",\"traces_dropped\":" << traces_dropped
+        << ",\"traces_kept_slow\":" << traces_kept_slow
+        << ",\"traces_kept_error\":" << traces_kept_error
+        << ",\"spans_buffered\":" << spans_buffered
+        << ",\"spans_forwarded\":" << spans_forwarded
+        << ",\"spans_evicted\":" << spans_evicted
+        << ",\"late_spans\":" << late_spans
+        << "}";
+    return oss.str();
+}
+
+TailSamplingProcessor::TailSamplingProcessor(unique_ptr<SpanProcessor> downstream)
+    : TailSamplingProcessor(std::move(downstream), Config{}) {}
+
+TailSamplingProcessor::TailSamplingProcessor(unique_ptr<SpanProcessor> downstream, Config config)
+    : downstream_(std::move(downstream)),
+      config_(std::move(config)),
+      shard_mask_(std::bit_ceil(std::max<size_type>(config_.shard_count, 1)) - 1),
+      shards_(std::make_unique<Shard[]>(shard_mask_ + 1)) {
+    sweeper_thread_ = std::make_unique<std::thread>(&TailSamplingProcessor::sweeper_loop, this);
+}
+
+TailSamplingProcessor::~TailSamplingProcessor() {
+    shutdown();
+}
+
+void TailSamplingProcessor::on_start(const Span& span) {
+    downstream_->on_start(span);
+}
+
+void TailSamplingProcessor::on_end(const Span& span) {
+    // Without ownership the span cannot be buffered, so only head-sampled spans pass through
+    if (span.context().is_sampled) {
+        downstream_->on_end(span);
+    }
+}
+
+void TailSamplingProcessor::on_end(Span&& span) {
+    if (span.context().is_sampled) {
+        forward(std::move(span));
+        return;
+    }
+    
+    auto now = std::chrono::steady_clock::now();
+    auto trace_id = span.context().trace_id;
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(span.end_time().value_or(now) - span.start_time());
+    auto slow = duration >= config_.latency_threshold;
+    auto failed = !span.status().ok;
+    auto local_root = !span.parent_span_id().is_valid() || span.has_remote_parent();
+    
+    optional<PendingTrace> completed;
+    auto verdict = Verdict::DROP;
+    auto& shard = shard_for(trace_id);
+    
+    {
+        lock_guard lock(shard.traces_mutex);
+        
+        auto decided = shard.decided.find(trace_id);
+        if (decided != shard.decided.end()) {
+            late_spans_.fetch_add(1, std::memory_order_relaxed);
+            if (!decided->second.first) {
+                return;
+            }
+        } else {
+            auto it = shard.pending.find(trace_id);
+            if (it == shard.pending.end()) {
+                if (shard.pending.size() >= std::max<size_type>(config_.max_buffered_traces / (shard_mask_ + 1), 1)) {
+                    spans_evicted_.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                it = shard.pending.emplace(trace_id, PendingTrace{{}, now}).first;
+            }
+            
+            auto& trace = it->second;
+            trace.slow = trace.slow || slow;
+            trace.failed = trace.failed || failed;
+            
+            if (trace.spans.size() < config_.max_spans_per_trace) {
+                trace.spans.push_back(std::move(span));
+                spans_buffered_.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                spans_evicted_.fetch_add(1, std::memory_order_relaxed);
+            }
+            
+            if (!local_root) {
+                return;
+            }
+            
+            completed = std::move(trace);
+            shard.pending.erase(it);
+            verdict = judge(*completed);
+            shard.decided[trace_id] = {verdict != Verdict::DROP, now};
+        }
+    }
+    
+    if (completed) {
+        settle(std::move(*completed), verdict);
+        return;
+    }
+    
+    span.apply_sampling(SamplingDecision::RECORD_AND_SAMPLE);
+    forward(std::move(span));
+}
+
+void TailSamplingProcessor::set_resource(const Resource& resource) {
+    downstream_->set_resource(resource);
+}
+
+void TailSamplingProcessor::force_flush(duration_t timeout) {
+    sweep(true);
+    downstream_->force_flush(timeout);
+}
+
+void TailSamplingProcessor::shutdown(duration_t timeout) {
+    {
+        lock_guard lock(sweeper_mutex_);
+        if (shutdown_requested_.exchange(true, std::memory_order_acq_rel)) {
+            return;
+        }
+    }
+    
+    sweeper_condition_.notify_all();
+    if (sweeper_thread_ && sweeper_thread_->joinable()) {
+        sweeper_thread_->join();
+    }
+    
+    sweep(true);
+    downstream_->shutdown(timeout);
+}
+
+TailSamplingMetrics TailSamplingProcessor::metrics() const {
+    TailSamplingMetrics result;
+    result.traces_kept = traces_kept_.load(std::memory_order_relaxed);
+    result.traces_dropped = traces_dropped_.load(std::memory_order_relaxed);
+    result.traces_kept_slow = traces_kept_slow_.load(std::memory_order_relaxed);
+    result.traces_kept_error = traces_kept_error_.load(std::memory_order_relaxed);
+    result.spans_buffered = spans_buffered_.load(std::memory_order_relaxed);
+    result.spans_forwarded = spans_forwarded_.load(std::memory_order_relaxed);
+    result.spans_evicted = spans_evicted_.load(std::memory_order_relaxed);
+    result.late_spans = late_spans_.load(std::memory_order_relaxed);
+    return result;
+}
+
+size_type TailSamplingProcessor::TraceIdHash::operator()(const TraceId& trace_id) const noexcept {
+    std::uint64_t value = 0;
+    std::memcpy(&value, trace_id.data.data() + 8, sizeof(value));
+    return static_cast<size_type>(value);
+}
+
+TailSamplingProcessor::Shard& TailSamplingProcessor::shard_for(const TraceId& trace_id) const noexcept {
+    auto hash = static_cast<std::uint64_t>(TraceIdHash{}(trace_id)) * 0x9E3779B97F4A7C15ULL;
+    return shards_[static_cast<size_type>(hash >> 32) & shard_mask_];
+}
+
+TailSamplingProcessor::Verdict TailSamplingProcessor::judge(const PendingTrace& trace) const noexcept {
+    if (config_.keep_errors && trace.failed) {
+        return Verdict::KEEP_ERROR;
+    }
+    return trace.slow ? Verdict::KEEP_SLOW : Verdict::DROP;
+}
+
+void TailSamplingProcessor::settle(PendingTrace trace, Verdict verdict) {
+    switch (verdict) {
+        case Verdict::DROP:
+            traces_dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        case Verdict::KEEP_SLOW:
+            traces_kept_slow_.fetch_add(1, std::memory_order_relaxed);
+            break;
+        case Verdict::KEEP_ERROR:
+            traces_kept_error_.fetch_add(1, std::memory_order_relaxed);
+            break;
+    }
+    
+    traces_kept_.fetch_add(1, std::memory_order_relaxed);
+    for (auto& span : trace.spans) {
+        span.apply_sampling(SamplingDecision::RECORD_AND_SAMPLE);
+        forward(std::move(span));
+    }
+}
+
+void TailSamplingProcessor::forward(Span&& span) {
+    spans_forwarded_.fetch_add(1, std::memory_order_relaxed);
+    downstream_->on_end(std::move(span));
+}
+
+void TailSamplingProcessor::sweep(bool flush_all) {
+    auto now = std::chrono::steady_clock::now();
+    vector<std::pair<PendingTrace, Verdict>> expired;
+    
+    for (size_type i = 0; i <= shard_mask_; ++i) {
+        auto& shard = shards_[i];
+        lock_guard lock(shard.traces_mutex);
+        
+        for (auto it = shard.pending.begin(); it != shard.pending.end();) {
+            if (flush_all || now - it->second.first_seen >= config_.decision_wait) {
+                auto verdict = judge(it->second);
+                shard.decided[it->first] = {verdict != Verdict::DROP, now};
+                expired.emplace_back(std::move(it->second), verdict);
+                it = shard.pending.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        
+        std::erase_if(shard.decided, [&](const auto& entry) {
+            return now - entry.second.second >= config_.decision_wait;
+        });
+    }
+    
+    for (auto& [trace, verdict] : expired) {
+        settle(std::move(trace), verdict);
+    }
+}
+
+void TailSamplingProcessor::sweeper_loop() {
+    auto interval = std::max<duration_t>(config_.decision_wait / 4, std::chrono::milliseconds(10));
+    
+    while (!shutdown_requested_.load(std::memory_order_acquire)) {
+        {
+            unique_lock lock(sweeper_mutex_);
+            sweeper_condition_.wait_for(lock, interval, [this] {
+                return shutdown_requested_.load(std::memory_order_acquire);
+            });
+        }
+        sweep(false);
+    }
+}
+
+}  // namespace http_framework::tracing
@@ -0,0 +1,154 @@
+#include "tracing/tracer.hpp"
+#include <typeinfo>
+
+namespace http_framework::tracing {
+
+namespace {
+
+void copy_attribute(EventAttributes& target, AttributeKey key, const Attribute& attribute) {
+    std::visit([&](const auto& held) { target.set(key, held); }, attribute.value);
+}
+
+EventAttributes to_event_attributes(const hash_map<string, Attribute>& attributes) {
+    EventAttributes result;
+    for (const auto& [name, attribute] : attributes) {
+        copy_attribute(result, AttributeKey::intern(name), attribute);
+    }
+    return result;
+}
+
+}  // namespace
+
+Span::Span(string_view name, SpanKind kind)
+    : context_(TraceId::generate(), SpanId::generate()),
+      name_(name),
+      kind_(kind),
+      start_time_(std::chrono::steady_clock::now()) {}
+
+Span::Span(string_view name, const SpanContext& parent_context, SpanKind kind)
+    : name_(name), kind_(kind), start_time_(std::chrono::steady_clock::now()) {
+    if (!parent_context.is_valid()) {
+        context_ = SpanContext(TraceId::generate(), SpanId::generate());
+        return;
+    }
+    
+    context_ = SpanContext(parent_context.trace_id, SpanId::generate(), parent_context.is_sampled);
+    context_.trace_state = parent_context.trace_state;
+    parent_span_id_ = parent_context.span_id;
+    remote_parent_ = parent_context.is_remote;
+}
+
+Span::~Span() = default;
+
+Span& Span::update_name(string_view name) {
+    if (recording_) {
+        name_.assign(name);
+    }
+    return *this;
+}
+
+Span& Span::set_attribute(string_view key, string_view value) {
+    if (recording_) {
+        attributes_.set(AttributeKey::intern(key), value);
+    }
+    return *this;
+}
+
+Span& Span::set_attribute(string_view key, bool value) {
+    if (recording_) {
+        attributes_.set(AttributeKey::intern(key), value);
+    }
+    return *this;
+}
+
+Span& Span::set_attribute(string_view key, int64_t value) {
+    if (recording_) {
+        attributes_.set(AttributeKey::intern(key), value);
+    }
+    return *this;
+}
+
+Span& Span::set_attribute(string_view key, double value) {
+    if (recording_) {
+        attributes_.set(AttributeKey::intern(key), value);
+    }
+    return *this;
+}
+
+Span& Span::set_attribute(string_view key, const vector<string>& value) {
+    if (recording_) {
+        attributes_.set(AttributeKey::intern(key), value);
+    }
+    return *this;
+}
+
+Span& Span::add_event(string_view name) {
+    return add_event(name, std::chrono::steady_clock::now(), EventAttributes{});
+}
+
+Span& Span::add_event(string_view name, const hash_map<string, Attribute>& attributes) {
+    return add_event(name, std::chrono::steady_clock::now(), to_event_attributes(attributes));
+}
+
+Span& Span::add_event(string_view name, EventAttributes attributes) {
+    return add_event(name, std::chrono::steady_clock::now(), std::move(attributes));
+}
+
+Span& Span::add_event(string_view name, timestamp_t timestamp) {
+    return add_event(name, timestamp, EventAttributes{});
+}
+
+Span& Span::add_event(string_view name, timestamp_t timestamp, const hash_map<string, Attribute>& attributes) {
+    return add_event(name, timestamp, to_event_attributes(attributes));
+}
+
+Span& Span::add_event(string_view name, timestamp_t timestamp, EventAttributes attributes) {
+    if (recording_) {
+        events_.push_back(Event{string(name), timestamp, std::move(attributes)});
+    }
+    return *this;
+}
+
+Span& Span::set_status(bool ok, string_view description) {
+    if (recording_) {
+        status_.ok = ok;
+        status_.description = ok ? string{} : string(description);
+    }
+    return *this;
+}
+
+Span& Span::record_exception(const std::exception& exception) {
+    if (!recording_) {
+        return *this;
+    }
+    
+    EventAttributes attributes;
+    attributes.set(semconv::EXCEPTION_TYPE, string_view(typeid(exception).name()));
+    attributes.set(semconv::EXCEPTION_MESSAGE, string_view(exception.what()));
+    return add_event("exception", std::move(attributes));
+}
+
+void Span::end() {
+    end(std::chrono::steady_clock::now());
+}
+
+void Span::end(timestamp_t end_timestamp) {
+    if (end_time_) {
+        return;
+    }
+    
+    end_time_ = end_timestamp;
+    if (recording_ && provider_) {
+        auto context = context_;
+        auto* provider = std::exchange(provider_, nullptr);
+        provider->process_span_end(std::move(*this));
+        
+        // The processors own the recorded data now; the shell keeps what the caller
+        // may still ask for and records nothing further
+        context_ = std::move(context);
+        end_time_ = end_timestamp;
+        recording_ = false;
+    }
+}
+
+}  // namespace http_framework::tracing
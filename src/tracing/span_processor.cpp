@@ -0,0 +1,348 @@
+#include "tracing/tracer.hpp"
+#include <algorithm>
+#include <bit>
+#include <sstream>
+
+namespace http_framework::tracing {
+
+namespace {
+
+atomic<std::uint64_t> next_processor_id{1};
+
+}  // namespace
+
+struct BatchSpanProcessor::ThreadBuffers {
+    struct Entry {
+        std::uint64_t processor_id;
+        shared_ptr<SpanRing> ring;
+    };
+    
+    vector<Entry> entries;
+    
+    ~ThreadBuffers() {
+        for (auto& entry : entries) {
+            entry.ring->abandon();
+        }
+    }
+};
+
+string BatchSpanProcessorMetrics::to_json() const {
+    std::ostringstream oss;
+    oss << "{\"spans_enqueued\":" << spans_enqueued
+        << ",\"spans_exported\":" << spans_exported
+        << ",\"spans_dropped\":" << spans_dropped
+        << ",\"backpressure_waits\":" << backpressure_waits
+        << ",\"batches_exported\":" << batches_exported
+        << ",\"export_failures\":" << export_failures
+        << ",\"queued_spans\":" << queued_spans
+        << ",\"thread_buffers\":" << thread_buffers
+        << "}";
+    return oss.str();
+}
+
+BatchSpanProcessor::SpanRing::SpanRing(size_type capacity)
+    : mask_(capacity - 1), slots_(std::make_unique<optional<Span>[]>(capacity)) {}
+
+bool BatchSpanProcessor::SpanRing::try_push(Span&& span) {
+    auto tail = tail_.load(std::memory_order_relaxed);
+    if (tail - cached_head_ > mask_) {
+        cached_head_ = head_.load(std::memory_order_acquire);
+        if (tail - cached_head_ > mask_) {
+            return false;
+        }
+    }
+    
+    slots_[tail & mask_].emplace(std::move(span));
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+size_type BatchSpanProcessor::SpanRing::drain(vector<Span>& out, size_type max_spans) {
+    auto head = head_.load(std::memory_order_relaxed);
+    auto tail = tail_.load(std::memory_order_acquire);
+    auto count = std::min(tail - head, max_spans);
+    
+    for (size_type i = 0; i < count; ++i) {
+        auto& slot = slots_[(head + i) & mask_];
+        out.push_back(std::move(*slot));
+        slot.reset();
+    }
+    
+    head_.store(head + count, std::memory_order_release);
+    return count;
+}
+
+size_type BatchSpanProcessor::SpanRing::size() const noexcept {
+    auto tail = tail_.load(std::memory_order_acquire);
+    return tail - head_.load(std::memory_order_acquire);
+}
+
+BatchSpanProcessor::BatchSpanProcessor(shared_ptr<SpanExporter> exporter)
+    : BatchSpanProcessor(std::move(exporter), Config{}) {}
+
+BatchSpanProcessor::BatchSpanProcessor(shared_ptr<SpanExporter> exporter, Config config)
+    : exporter_(std::move(exporter)),
+      config_(std::move(config)),
+      id_(next_processor_id.fetch_add(1, std::memory_order_relaxed)),
+      ring_capacity_(std::bit_ceil(std::max<size_type>(config_.max_queue_size, 2))) {
+    config_.max_export_batch_size = std::max<size_type>(config_.max_export_batch_size, 1);
+    worker_thread_ = std::make_unique<std::thread>(&BatchSpanProcessor::worker_loop, this);
+}
+
+BatchSpanProcessor::~BatchSpanProcessor() {
+    shutdown(config_.export_timeout);
+    
+    lock_guard lock(buffers_mutex_);
+    for (auto& ring : buffers_) {
+        ring->detach();
+    }
+}
+
+void BatchSpanProcessor::on_start(const Span& span) {}
+
+void BatchSpanProcessor::set_resource(const Resource& resource) {
+    exporter_->set_resource(resource);
+}
+
+void BatchSpanProcessor::on_end(const Span& span) {
+    // Only reachable by calling the processor directly: the provider moves spans into its owner
+    if (span.context().is_sampled) {
+        spans_dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void BatchSpanProcessor::on_end(Span&& span) {
+    if (!span.context().is_sampled) {
+        return;
+    }
+    
+    // Counted before closed_ is checked, so shutdown either sees this push or we see closed_
+    producers_in_flight_.fetch_add(1);
+    struct InFlight {
+        atomic<size_type>& count;
+        ~InFlight() { count.fetch_sub(1); }
+    } in_flight{producers_in_flight_};
+    
+    if (closed_.load()) {
+        spans_dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    
+    auto& ring = local_ring();
+    if (ring.try_push(std::move(span))) {
+        spans_enqueued_.fetch_add(1, std::memory_order_relaxed);
+        if (ring.producer_backlog() >= config_.max_export_batch_size || ring.producer_backlog() > ring_capacity_ / 2) {
+            wake_worker();
+        }
+        return;
+    }
+    
+    if (config_.overflow_policy == OverflowPolicy::BLOCK) {
+        backpressure_waits_.fetch_add(1, std::memory_order_relaxed);
+        auto deadline = std::chrono::steady_clock::now() + config_.max_block_duration;
+        
+        do {
+            wake_worker();
+            std::this_thread::yield();
+            if (ring.try_push(std::move(span))) {
+                spans_enqueued_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        } while (std::chrono::steady_clock::now() < deadline && !closed_.load(std::memory_order_relaxed));
+    }
+    
+    spans_dropped_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void BatchSpanProcessor::force_flush(duration_t timeout) {
+    unique_lock lock(worker_mutex_);
+    if (!worker_thread_) {
+        return;
+    }
+    
+    auto target = ++flush_requested_;
+    worker_condition_.notify_one();
+    flush_condition_.wait_for(lock, timeout, [this, target] {
+        return flush_completed_ >= target;
+    });
+}
+
+void BatchSpanProcessor::shutdown(duration_t timeout) {
+    if (closed_.exchange(true)) {
+        return;
+    }
+    // Producers that got past closed_ finish their push before the worker's final drain
+    while (producers_in_flight_.load() != 0) {
+        std::this_thread::yield();
+    }
+    
+    {
+        lock_guard lock(worker_mutex_);
+        shutdown_requested_.store(true, std::memory_order_release);
+    }
+    worker_condition_.notify_all();
+    if (worker_thread_ && worker_thread_->joinable()) {
+        worker_thread_->join();
+    }
+    
+    {
+        lock_guard lock(worker_mutex_);
+        worker_thread_.reset();
+    }
+    flush_condition_.notify_all();
+    
+    if (exporter_) {
+        exporter_->shutdown(timeout);
+    }
+}
+
+BatchSpanProcessorMetrics BatchSpanProcessor::metrics() const {
+    BatchSpanProcessorMetrics result;
+    result.spans_enqueued = spans_enqueued_.load(std::memory_order_relaxed);
+    result.spans_exported = spans_exported_.load(std::memory_order_relaxed);
+    result.spans_dropped = spans_dropped_.load(std::memory_order_relaxed);
+    result.backpressure_waits = backpressure_waits_.load(std::memory_order_relaxed);
+    result.batches_exported = batches_exported_.load(std::memory_order_relaxed);
+    result.export_failures = export_failures_.load(std::memory_order_relaxed);
+    
+    lock_guard lock(buffers_mutex_);
+    result.thread_buffers = buffers_.size();
+    for (const auto& ring : buffers_) {
+        result.queued_spans += ring->size();
+    }
+    
+    return result;
+}
+
+BatchSpanProcessor::SpanRing& BatchSpanProcessor::local_ring() {
+    auto& buffers = thread_buffers();
+    for (auto& entry : buffers.entries) {
+        if (entry.processor_id == id_) {
+            return *entry.ring;
+        }
+    }
+    
+    std::erase_if(buffers.entries, [](const ThreadBuffers::Entry& entry) {
+        return entry.ring->detached();
+    });
+    
+    auto ring = std::make_shared<SpanRing>(ring_capacity_);
+    {
+        lock_guard lock(buffers_mutex_);
+        buffers_.push_back(ring);
+    }
+    buffers.entries.push_back({id_, ring});
+    return *ring;
+}
+
+void BatchSpanProcessor::wake_worker() noexcept {
+    // A missed notification only delays the export until the next schedule_delay tick
+    if (!wake_pending_.exchange(true, std::memory_order_acq_rel)) {
+        worker_condition_.notify_one();
+    }
+}
+
+void BatchSpanProcessor::worker_loop() {
+    vector<Span> batch;
+    batch.reserve(config_.max_export_batch_size);
+    
+    while (true) {
+        size_type flush_target = 0;
+        {
+            unique_lock lock(worker_mutex_);
+            worker_condition_.wait_for(lock, config_.schedule_delay, [this] {
+                return shutdown_requested_.load(std::memory_order_acquire) ||
+                       wake_pending_.load(std::memory_order_acquire) ||
+                       flush_requested_ != flush_completed_;
+            });
+            wake_pending_.store(false, std::memory_order_release);
+            flush_target = flush_requested_;
+        }
+        
+        auto stopping = shutdown_requested_.load(std::memory_order_acquire);
+        drain_buffers(batch);
+        
+        {
+            lock_guard lock(worker_mutex_);
+            flush_completed_ = flush_target;
+        }
+        flush_condition_.notify_all();
+        
+        if (stopping) {
+            break;
+        }
+    }
+}
+
+void BatchSpanProcessor::drain_buffers(vector<Span>& batch) {
+    vector<shared_ptr<SpanRing>> rings;
+    {
+        lock_guard lock(buffers_mutex_);
+        rings = buffers_;
+    }
+    
+    for (auto& ring : rings) {
+        while (ring->drain(batch, config_.max_export_batch_size - batch.size()) > 0 || batch.size() >= config_.max_export_batch_size) {
+            if (batch.size() >= config_.max_export_batch_size) {
+                export_batch(batch);
+            }
+        }
+    }
+    
+    export_batch(batch);
+    
+    lock_guard lock(buffers_mutex_);
+    std::erase_if(buffers_, [](const shared_ptr<SpanRing>& ring) {
+        return ring->abandoned() && ring->size() == 0;
+    });
+}
+
+void BatchSpanProcessor::export_batch(vector<Span>& spans) {
+    if (spans.empty()) {
+        return;
+    }
+    
+    auto result = SpanExporter::ExportResult::FAILURE;
+    if (exporter_) {
+        try {
+            result = exporter_->export_spans(spans);
+        } catch (...) {
+            result = SpanExporter::ExportResult::FAILURE;
+        }
+    }
+    
+    if (result == SpanExporter::ExportResult::SUCCESS) {
+        spans_exported_.fetch_add(spans.size(), std::memory_order_relaxed);
+        batches_exported_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        spans_dropped_.fetch_add(spans.size(), std::memory_order_relaxed);
+        export_failures_.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    spans.clear();
+}
+
+BatchSpanProcessor::ThreadBuffers& BatchSpanProcessor::thread_buffers() {
+    thread_local ThreadBuffers buffers;
+    return buffers;
+}
+
+void TracerProvider::process_span_start(const Span& span) {
+    for (auto& processor : processors_) {
+        processor->on_start(span);
+    }
+}
+
+void TracerProvider::process_span_end(Span&& span) {
+    if (processors_.empty() || !span.is_recording()) {
+        return;
+    }
+    
+    // add_span_processor keeps the owner, if any, last
+    for (size_type i = 0; i + 1 < processors_.size(); ++i) {
+        processors_[i]->on_end(static_cast<const Span&>(span));
+    }
+    processors_.back()->on_end(std::move(span));
+}
+
+}  // namespace http_framework::tracing
@@ -0,0 +1,166 @@
+#include "tracing/tracer.hpp"
+#include "tracing/sampler.hpp"
+
+namespace http_framework::tracing {
+
+thread_local optional<SpanContext> current_span_context;
+
+namespace {
+
+unique_ptr<TracerProvider>& global_provider() {
+    static unique_ptr<TracerProvider> provider = std::make_unique<TracerProvider>();
+    return provider;
+}
+
+}  // namespace
+
+TracerProvider::TracerProvider() : TracerProvider(Config{}) {}
+
+TracerProvider::TracerProvider(Config config) : config_(std::move(config)) {
+    if (!config_.sampler) {
+        config_.sampler = std::make_shared<ParentBasedSampler>(
+            std::make_shared<TraceIdRatioSampler>(config_.sampling_ratio));
+    }
+}
+
+TracerProvider::~TracerProvider() {
+    shutdown();
+}
+
+shared_ptr<Tracer> TracerProvider::get_tracer(string_view name, string_view version) {
+    lock_guard lock(tracers_mutex_);
+    
+    string key(name);
+    key.append("@").append(version);
+    
+    auto it = tracers_.find(key);
+    if (it != tracers_.end()) {
+        return it->second;
+    }
+    
+    auto tracer = std::make_shared<Tracer>(name, version, *this);
+    tracers_.emplace(std::move(key), tracer);
+    return tracer;
+}
+
+void TracerProvider::add_span_processor(unique_ptr<SpanProcessor> processor) {
+    if (!processor) {
+        return;
+    }
+    
+    auto has_owner = !processors_.empty() && processors_.back()->takes_ownership();
+    if (processor->takes_ownership() && has_owner) {
+        throw std::invalid_argument("A TracerProvider has at most one span processor that takes ownership of ended spans");
+    }
+    
+    processor->set_resource(Resource{config_.service_name, config_.service_version, config_.resource_attributes});
+    if (has_owner) {
+        processors_.insert(processors_.end() - 1, std::move(processor));
+    } else {
+        processors_.push_back(std::move(processor));
+    }
+}
+
+void TracerProvider::force_flush(duration_t timeout) {
+    for (auto& processor : processors_) {
+        processor->force_flush(timeout);
+    }
+}
+
+void TracerProvider::shutdown(duration_t timeout) {
+    for (auto& processor : processors_) {
+        processor->shutdown(timeout);
+    }
+}
+
+TracerProvider& TracerProvider::instance() {
+    return *global_provider();
+}
+
+void TracerProvider::set_global_provider(unique_ptr<TracerProvider> provider) {
+    if (provider) {
+        global_provider() = std::move(provider);
+    }
+}
+
+Tracer::Tracer(string_view name, string_view version, TracerProvider& provider)
+    : name_(name), version_(version), provider_(provider) {}
+
+unique_ptr<Span> Tracer::start_span(string_view name, SpanKind kind) {
+    if (auto parent = get_current_span_context()) {
+        return start_span(name, *parent, kind);
+    }
+    
+    auto trace_id = TraceId::generate();
+    auto decision = should_sample(nullptr, trace_id, name, kind);
+    return start_span(name, nullptr, trace_id, kind, decision, std::chrono::steady_clock::now());
+}
+
+unique_ptr<Span> Tracer::start_span(string_view name, const SpanContext& parent_context, SpanKind kind) {
+    const SpanContext* parent = parent_context.is_valid() ? &parent_context : nullptr;
+    auto trace_id = parent ? parent_context.trace_id : TraceId::generate();
+    auto decision = should_sample(parent, trace_id, name, kind);
+    return start_span(name, parent, trace_id, kind, decision, std::chrono::steady_clock::now());
+}
+
+SamplingDecision Tracer::should_sample(const SpanContext* parent_context, const TraceId& trace_id,
+                                       string_view name, SpanKind kind) const {
+    return provider_.config_.sampler->should_sample(SamplingParameters{parent_context, trace_id, name, kind});
+}
+
+unique_ptr<Span> Tracer::start_span(string_view name, const SpanContext* parent_context, const TraceId& trace_id,
+                                    SpanKind kind, SamplingDecision decision, timestamp_t start_time) {
+    auto span = parent_context ? std::make_unique<Span>(name, *parent_context, kind)
+                               : std::make_unique<Span>(name, kind);
+    span->context_.trace_id = trace_id;
+    span->start_time_ = start_time;
+    span->provider_ = &provider_;
+    span->apply_sampling(decision);
+    
+    if (span->is_recording()) {
+        provider_.process_span_start(*span);
+    }
+    return span;
+}
+
+SpanScope::SpanScope(unique_ptr<Span> span)
+    : span_(std::move(span)), previous_context_(current_span_context) {
+    if (span_) {
+        current_span_context = span_->context();
+    }
+}
+
+SpanScope::~SpanScope() {
+    if (!span_) {
+        return;
+    }
+    
+    span_->end();
+    if (previous_context_) {
+        current_span_context = std::move(previous_context_);
+    } else {
+        current_span_context.reset();
+    }
+}
+
+SpanScope start_active_span(string_view name, SpanKind kind) {
+    return SpanScope(TracerProvider::instance().get_tracer("http_framework")->start_span(name, kind));
+}
+
+SpanScope start_active_span(string_view name, const SpanContext& parent_context, SpanKind kind) {
+    return SpanScope(TracerProvider::instance().get_tracer("http_framework")->start_span(name, parent_context, kind));
+}
+
+optional<SpanContext> get_current_span_context() {
+    return current_span_context;
+}
+
+void set_current_span_context(const SpanContext& context) {
+    current_span_context = context;
+}
+
+void clear_current_span_context() {
+    current_span_context.reset();
+}
+
+}  // namespace http_framework::tracing
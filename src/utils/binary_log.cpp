@@ -0,0 +1,370 @@
+#include "utils/binary_log.hpp"
+#include "utils/log_ring.hpp"
+#include "utils/thread_name.hpp"
+#include <algorithm>
+#include <cstdio>
+
+namespace http_framework::utils::blog {
+
+unique_ptr<BinaryLogger> BinaryLogger::global_logger_;
+atomic<BinaryLogger*> BinaryLogger::global_logger_instance_{nullptr};
+mutex BinaryLogger::global_logger_mutex_;
+
+namespace {
+
+constexpr size_type FILE_BUFFER_BYTES = 64 * 1024;
+
+atomic<std::uint64_t> next_writer_id{1};
+atomic<std::uint32_t> next_thread_number{1};
+
+struct SiteRegistry {
+    mutex registry_mutex;
+    deque<SiteInfo> sites;
+};
+
+SiteRegistry& site_registry() {
+    static SiteRegistry registry;
+    return registry;
+}
+
+std::uint32_t thread_number() noexcept {
+    thread_local std::uint32_t number = next_thread_number.fetch_add(1, std::memory_order_relaxed);
+    return number;
+}
+
+std::uint64_t unix_nanos() noexcept {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+template<typename T>
+void put(buffer_t& out, T value) {
+    auto offset = out.size();
+    out.resize(offset + sizeof(T));
+    std::memcpy(out.data() + offset, &value, sizeof(T));
+}
+
+void put_text(buffer_t& out, const char* text) {
+    auto length = static_cast<std::uint16_t>(std::min<size_type>(text ? std::strlen(text) : 0, 0xffff));
+    put(out, length);
+    out.insert(out.end(), text, text + length);
+}
+
+void encode_site(buffer_t& out, std::uint32_t site_id, const SiteInfo& info) {
+    out.push_back(static_cast<byte_t>(RecordKind::SITE));
+    put(out, site_id);
+    out.push_back(static_cast<byte_t>(info.location.level));
+    put(out, info.location.line);
+    out.push_back(static_cast<byte_t>(info.arg_types.size()));
+    for (auto type : info.arg_types) {
+        out.push_back(static_cast<byte_t>(type));
+    }
+    put_text(out, info.location.format);
+    put_text(out, info.location.file);
+    put_text(out, info.location.function);
+}
+
+struct ThreadRings {
+    vector<std::pair<std::uint64_t, shared_ptr<LogRing>>> entries;
+    
+    ~ThreadRings() {
+        for (auto& entry : entries) {
+            entry.second->abandon();
+        }
+    }
+};
+
+thread_local ThreadRings thread_rings;
+thread_local buffer_t event_scratch;
+
+}  // namespace
+
+struct BinaryLogger::Writer {
+    std::uint64_t id{next_writer_id.fetch_add(1, std::memory_order_relaxed)};
+    size_type ring_capacity{0};
+    
+    mutex rings_mutex;
+    vector<shared_ptr<LogRing>> rings;
+    
+    mutex wake_mutex;
+    condition_variable wake_condition;
+    condition_variable flush_condition;
+    size_type flush_requested{0};
+    size_type flush_completed{0};
+    atomic<bool> wake_pending{false};
+    atomic<bool> stop_requested{false};
+    
+    std::FILE* file{nullptr};
+    vector<bool> sites_written;
+    buffer_t site_scratch;
+    std::thread thread;
+    
+    LogRing& local_ring() {
+        for (auto& [writer_id, ring] : thread_rings.entries) {
+            if (writer_id == id) {
+                return *ring;
+            }
+        }
+        
+        auto& entries = thread_rings.entries;
+        entries.erase(std::remove_if(entries.begin(), entries.end(),
+            [](const auto& entry) { return entry.second->detached(); }), entries.end());
+            
+        auto ring = std::make_shared<LogRing>(ring_capacity);
+        {
+            lock_guard lock(rings_mutex);
+            rings.push_back(ring);
+        }
+        entries.emplace_back(id, ring);
+        return *ring;
+    }
+    
+    void wake() noexcept {
+        if (!wake_pending.exchange(true, std::memory_order_acq_rel)) {
+            lock_guard lock(wake_mutex);
+            wake_condition.notify_one();
+        }
+    }
+};
+
+BinaryLogger::BinaryLogger() : BinaryLogger(Config{}) {}
+
+BinaryLogger::BinaryLogger(Config config)
+    : config_(std::move(config)), level_(config_.level), writer_(std::make_unique<Writer>()) {
+    writer_->ring_capacity = LogRing::round_capacity(config_.buffer_size);
+    writer_->file = std::fopen(config_.path.c_str(), config_.truncate ? "wb" : "ab");
+    if (writer_->file) {
+        std::setvbuf(writer_->file, nullptr, _IOFBF, FILE_BUFFER_BYTES);
+        // Appended sessions repeat the magic so the decoder can resynchronize on site ids
+        std::fwrite(FILE_MAGIC, 1, sizeof(FILE_MAGIC), writer_->file);
+    }
+    writer_->thread = std::thread([this] { writer_loop(); });
+}
+
+BinaryLogger::~BinaryLogger() {
+    close();
+}
+
+bool BinaryLogger::is_open() const noexcept {
+    return writer_ && writer_->file != nullptr;
+}
+
+std::uint32_t BinaryLogger::register_site(const SiteLocation& location, std::span<const ArgType> arg_types) {
+    auto& registry = site_registry();
+    lock_guard lock(registry.registry_mutex);
+    registry.sites.push_back(SiteInfo{location, arg_types});
+    return static_cast<std::uint32_t>(registry.sites.size() - 1);
+}
+
+optional<SiteInfo> BinaryLogger::site(std::uint32_t site_id) {
+    auto& registry = site_registry();
+    lock_guard lock(registry.registry_mutex);
+    if (site_id >= registry.sites.size()) {
+        return std::nullopt;
+    }
+    return registry.sites[site_id];
+}
+
+byte_t* BinaryLogger::begin_event(std::uint32_t site_id, size_type args_size) {
+    event_scratch.resize(EVENT_HEADER_BYTES + args_size);
+    auto* out = event_scratch.data();
+    auto thread = thread_number();
+    auto timestamp = unix_nanos();
+    auto length = static_cast<std::uint32_t>(args_size);
+    
+    out[0] = static_cast<byte_t>(RecordKind::EVENT);
+    std::memcpy(out + 1, &site_id, sizeof(site_id));
+    std::memcpy(out + 5, &thread, sizeof(thread));
+    std::memcpy(out + 9, &timestamp, sizeof(timestamp));
+    std::memcpy(out + 17, &length, sizeof(length));
+    return out + EVENT_HEADER_BYTES;
+}
+
+void BinaryLogger::commit_event(std::uint32_t site_id, size_type record_size) {
+    if (!writer_) {
+        dropped_count_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    
+    auto& writer = *writer_;
+    auto& ring = writer.local_ring();
+    if (record_size > ring.max_payload()) {
+        dropped_count_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    
+    if (ring.try_push(site_id, event_scratch.data(), record_size)) {
+        if (ring.producer_backlog() * 2 >= ring.capacity()) {
+            writer.wake();
+        }
+        return;
+    }
+    
+    if (config_.overflow_policy == OverflowPolicy::BLOCK) {
+        writer.wake();
+        for (size_type attempt = 0; !writer.stop_requested.load(std::memory_order_acquire); ++attempt) {
+            if (ring.try_push(site_id, event_scratch.data(), record_size)) {
+                return;
+            }
+            if (attempt < 64) {
+                std::this_thread::yield();
+            } else {
+                writer.wake();
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+        }
+    }
+    
+    dropped_count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void BinaryLogger::flush() {
+    if (!writer_) {
+        return;
+    }
+    
+    auto& writer = *writer_;
+    unique_lock lock(writer.wake_mutex);
+    auto ticket = ++writer.flush_requested;
+    writer.wake_pending.store(true, std::memory_order_release);
+    writer.wake_condition.notify_one();
+    writer.flush_condition.wait(lock, [&] {
+        return writer.flush_completed >= ticket || writer.stop_requested.load(std::memory_order_acquire);
+    });
+}
+
+void BinaryLogger::close() {
+    if (!writer_) {
+        return;
+    }
+    
+    {
+        lock_guard lock(writer_->wake_mutex);
+        writer_->stop_requested.store(true, std::memory_order_release);
+        writer_->wake_condition.notify_one();
+        writer_->flush_condition.notify_all();
+    }
+    if (writer_->thread.joinable()) {
+        writer_->thread.join();
+    }
+    
+    {
+        lock_guard lock(writer_->rings_mutex);
+        for (auto& ring : writer_->rings) {
+            ring->detach();
+        }
+    }
+    
+    if (writer_->file) {
+        std::fclose(writer_->file);
+    }
+    writer_.reset();
+}
+
+void BinaryLogger::writer_loop() {
+    set_current_thread_name("binlog-writer");
+    auto& writer = *writer_;
+    vector<shared_ptr<LogRing>> snapshot;
+    
+    auto write_bytes = [&](const void* data, size_type size) {
+        if (writer.file && size > 0 && std::fwrite(data, 1, size, writer.file) == size) {
+            bytes_written_.fetch_add(size, std::memory_order_relaxed);
+        }
+    };
+    
+    auto write_site_once = [&](std::uint32_t site_id) {
+        if (site_id < writer.sites_written.size() && writer.sites_written[site_id]) {
+            return;
+        }
+        auto info = site(site_id);
+        if (!info) {
+            return;
+        }
+        if (site_id >= writer.sites_written.size()) {
+            writer.sites_written.resize(site_id + 1, false);
+        }
+        writer.sites_written[site_id] = true;
+        
+        writer.site_scratch.clear();
+        encode_site(writer.site_scratch, site_id, *info);
+        write_bytes(writer.site_scratch.data(), writer.site_scratch.size());
+    };
+    
+    auto drain = [&](LogRing& ring) {
+        auto position = ring.head();
+        auto end = ring.published_tail();
+        while (position < end) {
+            auto record = ring.peek(position);
+            write_site_once(record.tag);
+            write_bytes(record.first.data, record.first.size);
+            write_bytes(record.second.data, record.second.size);
+            records_written_.fetch_add(1, std::memory_order_relaxed);
+            position = record.next;
+        }
+        ring.release(position);
+    };
+    
+    while (true) {
+        size_type flush_target = 0;
+        {
+            unique_lock lock(writer.wake_mutex);
+            writer.wake_condition.wait_for(lock, config_.flush_interval, [&] {
+                return writer.wake_pending.load(std::memory_order_acquire) ||
+                       writer.stop_requested.load(std::memory_order_acquire);
+            });
+            writer.wake_pending.store(false, std::memory_order_release);
+            flush_target = writer.flush_requested;
+        }
+        auto stopping = writer.stop_requested.load(std::memory_order_acquire);
+        
+        {
+            lock_guard lock(writer.rings_mutex);
+            snapshot = writer.rings;
+        }
+        
+        for (auto& ring : snapshot) {
+            drain(*ring);
+        }
+        snapshot.clear();
+        
+        {
+            lock_guard lock(writer.rings_mutex);
+            writer.rings.erase(std::remove_if(writer.rings.begin(), writer.rings.end(),
+                [](const shared_ptr<LogRing>& ring) { return ring->abandoned() && ring->empty(); }),
+                writer.rings.end());
+        }
+        
+        if (writer.file) {
+            std::fflush(writer.file);
+        }
+        
+        {
+            lock_guard lock(writer.wake_mutex);
+            writer.flush_completed = flush_target;
+            writer.flush_condition.notify_all();
+        }
+        
+        if (stopping) {
+            break;
+        }
+    }
+}
+
+BinaryLogger& BinaryLogger::create_global_logger() {
+    lock_guard lock(global_logger_mutex_);
+    if (!global_logger_) {
+        global_logger_ = std::make_unique<BinaryLogger>();
+        global_logger_instance_.store(global_logger_.get(), std::memory_order_release);
+    }
+    return *global_logger_;
+}
+
+void BinaryLogger::set_global_logger(unique_ptr<BinaryLogger> logger) {
+    lock_guard lock(global_logger_mutex_);
+    if (logger) {
+        global_logger_instance_.store(logger.get(), std::memory_order_release);
+        global_logger_ = std::move(logger);
+    }
+}
+
+}  // namespace http_framework::utils::blog
@@ -0,0 +1,848 @@
+#include "utils/logger.hpp"
+#include "utils/log_ring.hpp"
+#include "utils/thread_name.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <iostream>
+#include <thread>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace http_framework::utils {
+
+unique_ptr<Logger> Logger::global_logger_;
+mutex Logger::global_logger_mutex_;
+
+namespace {
+
+#ifdef _WIN32
+struct iovec {
+    void* iov_base;
+    size_t iov_len;
+};
+#endif
+
+constexpr size_type MAX_BATCH_SEGMENTS = 256;
+constexpr int STDOUT_FD = 1;
+constexpr int STDERR_FD = 2;
+
+atomic<std::uint64_t> next_writer_id{1};
+
+string_view level_name(LogLevel level) noexcept {
+    switch (level) {
+        case LogLevel::TRACE: return "TRACE";
+        case LogLevel::DEBUG: return "DEBUG";
+        case LogLevel::INFO: return "INFO";
+        case LogLevel::WARN: return "WARN";
+        case LogLevel::ERROR: return "ERROR";
+        case LogLevel::FATAL: return "FATAL";
+    }
+    return "UNKNOWN";
+}
+
+string_view level_color(LogLevel level) noexcept {
+    switch (level) {
+        case LogLevel::TRACE: return "\033[90m";
+        case LogLevel::DEBUG: return "\033[36m";
+        case LogLevel::INFO: return "\033[32m";
+        case LogLevel::WARN: return "\033[33m";
+        case LogLevel::ERROR: return "\033[31m";
+        case LogLevel::FATAL: return "\033[35;1m";
+    }
+    return "";
+}
+
+constexpr string_view RESET_COLOR = "\033[0m";
+constexpr string_view NEWLINE = "\n";
+
+int console_fd(LogLevel level) noexcept {
+    return level >= LogLevel::ERROR ? STDERR_FD : STDOUT_FD;
+}
+
+// Writes every segment, resuming after partial writes and EINTR
+bool write_segments(int fd, iovec* segments, size_type count) {
+    while (count > 0) {
+#ifdef _WIN32
+        auto written = static_cast<std::ptrdiff_t>(_write(fd, segments->iov_base, static_cast<unsigned>(segments->iov_len)));
+#else
+        auto written = ::writev(fd, segments, static_cast<int>(std::min<size_type>(count, IOV_MAX)));
+#endif
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        
+        auto remaining = static_cast<size_type>(written);
+        while (count > 0 && remaining >= segments->iov_len) {
+            remaining -= segments->iov_len;
+            ++segments;
+            --count;
+        }
+        if (count > 0 && remaining > 0) {
+            segments->iov_base = static_cast<char*>(segments->iov_base) + remaining;
+            segments->iov_len -= remaining;
+        }
+    }
+    return true;
+}
+
+struct ThreadRings {
+    vector<std::pair<std::uint64_t, shared_ptr<LogRing>>> entries;
+    
+    ~ThreadRings() {
+        for (auto& entry : entries) {
+            entry.second->abandon();
+        }
+    }
+};
+
+thread_local ThreadRings thread_rings;
+
+// Gathers segments per file descriptor so each drain issues a few large writev calls
+struct SegmentBatch {
+    int fd{-1};
+    vector<iovec> segments;
+    size_type bytes{0};
+    
+    void add(const void* data, size_type size) {
+        if (size > 0) {
+            segments.push_back(iovec{const_cast<void*>(data), size});
+            bytes += size;
+        }
+    }
+    
+    bool full() const noexcept { return segments.size() + 6 > MAX_BATCH_SEGMENTS; }
+    
+    size_type flush() {
+        auto written = bytes;
+        if (fd >= 0 && !segments.empty() && !write_segments(fd, segments.data(), segments.size())) {
+            written = 0;
+        }
+        segments.clear();
+        bytes = 0;
+        return written;
+    }
+};
+
+}  // namespace
+
+struct Logger::AsyncWriter {
+    std::uint64_t id{next_writer_id.fetch_add(1, std::memory_order_relaxed)};
+    size_type ring_capacity{0};
+    
+    mutex rings_mutex;
+    vector<shared_ptr<LogRing>> rings;
+    
+    mutex wake_mutex;
+    condition_variable wake_condition;
+    condition_variable flush_condition;
+    size_type flush_requested{0};
+    size_type flush_completed{0};
+    atomic<bool> wake_pending{false};
+    atomic<bool> stop_requested{false};
+    atomic<bool> rotate_requested{false};
+    atomic<size_type> sample_counter{0};
+    
+    int file_fd{-1};
+    std::thread thread;
+    
+    LogRing& local_ring() {
+        for (auto& [writer_id, ring] : thread_rings.entries) {
+            if (writer_id == id) {
+                return *ring;
+            }
+        }
+        
+        auto& entries = thread_rings.entries;
+        entries.erase(std::remove_if(entries.begin(), entries.end(),
+            [](const auto& entry) { return entry.second->detached(); }), entries.end());
+            
+        auto ring = std::make_shared<LogRing>(ring_capacity);
+        {
+            lock_guard lock(rings_mutex);
+            rings.push_back(ring);
+        }
+        entries.emplace_back(id, ring);
+        return *ring;
+    }
+    
+    void wake() noexcept {
+        if (!wake_pending.exchange(true, std::memory_order_acq_rel)) {
+            lock_guard lock(wake_mutex);
+            wake_condition.notify_one();
+        }
+    }
+};
+
+Logger::Logger() : Logger(Config{}) {}
+
+Logger::Logger(const Config& config) {
+    configure(config);
+}
+
+Logger::~Logger() {
+    close();
+}
+
+void Logger::configure(const Config& config) {
+    stop_async_writer();
+    {
+        lock_guard lock(logger_mutex_);
+        close_file_stream();
+        config_ = config;
+    }
+    
+    if (config_.async) {
+        start_async_writer();
+    } else if (config_.file_output) {
+        lock_guard lock(logger_mutex_);
+        open_file_stream();
+    }
+}
+
+void Logger::trace(string_view message) {
+    log(LogLevel::TRACE, message);
+}
+
+void Logger::debug(string_view message) {
+    log(LogLevel::DEBUG, message);
+}
+
+void Logger::info(string_view message) {
+    log(LogLevel::INFO, message);
+}
+
+void Logger::warn(string_view message) {
+    log(LogLevel::WARN, message);
+}
+
+void Logger::error(string_view message) {
+    log(LogLevel::ERROR, message);
+}
+
+void Logger::fatal(string_view message) {
+    log(LogLevel::FATAL, message);
+}
+
+void Logger::log(LogLevel level, string_view message) {
+    if (should_log(level)) {
+        write_log_entry(level, message);
+    }
+}
+
+void Logger::log(LogLevel level, string_view message, const hash_map<string, string>& context) {
+    if (should_log(level)) {
+        write_log_entry(level, message, context);
+    }
+}
+
+void Logger::log_with_location(LogLevel level, string_view message, string_view file, int line, string_view function) {
+    if (!should_log(level)) {
+        return;
+    }
+    
+    if (!config_.include_location) {
+        write_log_entry(level, message);
+        return;
+    }
+    
+    hash_map<string, string> location_context = {
+        {"file", string(file)},
+        {"line", std::to_string(line)},
+        {"function", string(function)}
+    };
+    write_log_entry(level, message, location_context);
+}
+
+void Logger::flush() {
+    if (async_writer_) {
+        auto& writer = *async_writer_;
+        unique_lock lock(writer.wake_mutex);
+        auto ticket = ++writer.flush_requested;
+        writer.wake_pending.store(true, std::memory_order_release);
+        writer.wake_condition.notify_one();
+        writer.flush_condition.wait(lock, [&] {
+            return writer.flush_completed >= ticket || writer.stop_requested.load(std::memory_order_acquire);
+        });
+        return;
+    }
+    
+    lock_guard lock(logger_mutex_);
+    if (config_.console_output) {
+        std::cout.flush();
+        std::cerr.flush();
+    }
+    if (file_stream_) {
+        file_stream_->flush();
+    }
+}
+
+void Logger::close() {
+    stop_async_writer();
+    lock_guard lock(logger_mutex_);
+    close_file_stream();
+}
+
+void Logger::set_file_path(string_view path) {
+    auto config = config_;
+    config.file_path = string(path);
+    configure(config);
+}
+
+void Logger::add_context(string_view key, string_view value) {
+    lock_guard lock(logger_mutex_);
+    context_[key] = value;
+    rebuild_context_suffix();
+}
+
+void Logger::remove_context(string_view key) {
+    lock_guard lock(logger_mutex_);
+    context_.erase(key);
+    rebuild_context_suffix();
+}
+
+void Logger::clear_context() {
+    lock_guard lock(logger_mutex_);
+    context_.clear();
+    rebuild_context_suffix();
+}
+
+void Logger::rotate_log_file() {
+    if (async_writer_) {
+        async_writer_->rotate_requested.store(true, std::memory_order_release);
+        async_writer_->wake();
+        return;
+    }
+    
+    lock_guard lock(logger_mutex_);
+    perform_file_rotation();
+}
+
+hash_map<string, variant<string, int64_t, double, bool>> Logger::get_statistics() const {
+    hash_map<string, variant<string, int64_t, double, bool>> stats;
+    stats["message_count"] = static_cast<int64_t>(message_count_.load());
+    stats["error_count"] = static_cast<int64_t>(error_count_.load());
+    stats["bytes_written"] = static_cast<int64_t>(bytes_written_.load());
+    stats["current_file_size"] = static_cast<int64_t>(current_file_size_.load());
+    stats["dropped_count"] = static_cast<int64_t>(dropped_count_.load());
+    stats["sampled_out_count"] = static_cast<int64_t>(sampled_out_count_.load());
+    stats["level"] = level_to_string(config_.level);
+    stats["async"] = async_writer_ != nullptr;
+    return stats;
+}
+
+Logger& Logger::get_global_logger() {
+    lock_guard lock(global_logger_mutex_);
+    if (!global_logger_) {
+        global_logger_ = std::make_unique<Logger>();
+    }
+    return *global_logger_;
+}
+
+void Logger::set_global_logger(unique_ptr<Logger> logger) {
+    lock_guard lock(global_logger_mutex_);
+    if (logger) {
+        global_logger_ = std::move(logger);
+    }
+}
+
+string Logger::level_to_string(LogLevel level) {
+    return string(level_name(level));
+}
+
+LogLevel Logger::string_to_level(string_view level_str) {
+    string upper(level_str);
+    std::transform(upper.begin(), upper.end(), upper.begin(),
+        [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+        
+    if (upper == "TRACE") return LogLevel::TRACE;
+    if (upper == "DEBUG") return LogLevel::DEBUG;
+    if (upper == "WARN" || upper == "WARNING") return LogLevel::WARN;
+    if (upper == "ERROR") return LogLevel::ERROR;
+    if (upper == "FATAL") return LogLevel::FATAL;
+    return LogLevel::INFO;
+}
+
+void Logger::write_log_entry(LogLevel level, string_view message, const optional<hash_map<string, string>>& extra_context) {
+    try {
+        if (async_writer_) {
+            thread_local string scratch;
+            scratch.clear();
+            append_formatted_message(scratch, level, message, extra_context);
+            enqueue_async(level, scratch);
+            update_statistics(level, scratch.size());
+            return;
+        }
+        
+        auto formatted = format_message(level, message, extra_context);
+        
+        unique_lock lock(logger_mutex_, std::defer_lock);
+        if (config_.thread_safe) {
+            lock.lock();
+        }
+        
+        if (config_.console_output) {
+            write_to_console(level, formatted);
+        }
+        if (config_.file_output) {
+            write_to_file(formatted);
+        }
+        update_statistics(level, formatted.size());
+    } catch (const std::exception& e) {
+        handle_logging_error(e);
+    }
+}
+
+void Logger::write_to_console(LogLevel level, const string& formatted_message) {
+    auto& stream = level >= LogLevel::ERROR ? std::cerr : std::cout;
+    if (config_.colored_output) {
+        string_view line(formatted_message);
+        line.remove_suffix(1);
+        stream << get_color_code(level) << line << get_reset_color_code() << '\n';
+    } else {
+        stream << formatted_message;
+    }
+    
+    if (config_.auto_flush) {
+        stream.flush();
+    }
+    bytes_written_.fetch_add(formatted_message.size(), std::memory_order_relaxed);
+}
+
+void Logger::write_to_file(const string& formatted_message) {
+    if (!file_stream_ && !open_file_stream()) {
+        return;
+    }
+    
+    *file_stream_ << formatted_message;
+    if (config_.auto_flush) {
+        file_stream_->flush();
+    }
+    
+    current_file_size_.fetch_add(formatted_message.size(), std::memory_order_relaxed);
+    bytes_written_.fetch_add(formatted_message.size(), std::memory_order_relaxed);
+    check_file_rotation();
+}
+
+string Logger::format_message(LogLevel level, string_view message, const optional<hash_map<string, string>>& extra_context) const {
+    string formatted;
+    formatted.reserve(message.size() + 64);
+    append_formatted_message(formatted, level, message, extra_context);
+    return formatted;
+}
+
+void Logger::append_formatted_message(string& out, LogLevel level, string_view message,
+                                      const optional<hash_map<string, string>>& extra_context) const {
+    if (config_.include_timestamp) {
+        out += '[';
+        out += format_timestamp();
+        out += "] ";
+    }
+    
+    out += '[';
+    out += level_name(level);
+    out += "] ";
+    
+    if (config_.include_thread_id) {
+        out += '[';
+        out += format_thread_id();
+        out += "] ";
+    }
+    
+    out += message;
+    
+    if (auto suffix = context_suffix_.load(std::memory_order_acquire)) {
+        out += *suffix;
+    }
+    
+    if (extra_context && !extra_context->empty()) {
+        out += " {";
+        bool first = true;
+        for (const auto& [key, value] : *extra_context) {
+            if (!first) {
+                out += ", ";
+            }
+            out.append(key).append("=").append(value);
+            first = false;
+        }
+        out += '}';
+    }
+    
+    out += '\n';
+}
+
+// strftime runs at most once per second per thread and format; only the milliseconds
+// change in between. Loggers with different formats on one thread share the slot.
+string Logger::format_timestamp() const {
+    struct CachedSecond {
+        std::time_t second{-1};
+        string format;
+        string text;
+    };
+    thread_local CachedSecond cache;
+    
+    auto now = std::chrono::system_clock::now();
+    auto seconds = std::chrono::system_clock::to_time_t(now);
+    if (seconds != cache.second || cache.format != config_.timestamp_format) {
+        std::tm local_time{};
+#ifdef _WIN32
+        localtime_s(&local_time, &seconds);
+#else
+        localtime_r(&seconds, &local_time);
+#endif
+        char buffer[64];
+        auto length = std::strftime(buffer, sizeof(buffer), config_.timestamp_format.c_str(), &local_time);
+        cache.text.assign(buffer, length);
+        cache.format = config_.timestamp_format;
+        cache.second = seconds;
+    }
+    
+    auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count() % 1000;
+    char fraction[5] = {'.', static_cast<char>('0' + millis / 100), static_cast<char>('0' + millis / 10 % 10),
+                        static_cast<char>('0' + millis % 10), '\0'};
+                        
+    string result;
+    result.reserve(cache.text.size() + 4);
+    result.append(cache.text).append(fraction, 4);
+    return result;
+}
+
+string Logger::format_thread_id() const {
+    thread_local string cached = [] {
+        std::ostringstream oss;
+        oss << std::this_thread::get_id();
+        return oss.str();
+    }();
+    return cached;
+}
+
+string Logger::get_color_code(LogLevel level) const {
+    return string(level_color(level));
+}
+
+string Logger::get_reset_color_code() const {
+    return string(RESET_COLOR);
+}
+
+void Logger::check_file_rotation() {
+    if (config_.max_file_size > 0 && current_file_size_.load(std::memory_order_relaxed) >= config_.max_file_size) {
+        perform_file_rotation();
+    }
+}
+
+void Logger::perform_file_rotation() {
+    if (!config_.file_path) {
+        return;
+    }
+    
+    close_file_stream();
+    
+    std::error_code ec;
+    const auto& path = *config_.file_path;
+    if (config_.max_backup_files == 0) {
+        std::filesystem::remove(path, ec);
+    } else {
+        string source;
+        string target;
+        create_backup_filename(config_.max_backup_files, target);
+        std::filesystem::remove(target, ec);
+        
+        for (auto number = config_.max_backup_files - 1; number >= 1; --number) {
+            create_backup_filename(number, source);
+            create_backup_filename(number + 1, target);
+            if (std::filesystem::exists(source, ec)) {
+                std::filesystem::rename(source, target, ec);
+            }
+        }
+        
+        create_backup_filename(1, target);
+        std::filesystem::rename(path, target, ec);
+    }
+    
+    open_file_stream();
+}
+
+void Logger::create_backup_filename(size_type backup_number, string& backup_path) const {
+    backup_path = config_.file_path.value_or("");
+    backup_path.append(".").append(std::to_string(backup_number));
+}
+
+bool Logger::open_file_stream() {
+    if (!config_.file_path) {
+        return false;
+    }
+    
+    std::error_code ec;
+    auto existing_size = std::filesystem::file_size(*config_.file_path, ec);
+    current_file_size_.store(ec ? 0 : static_cast<size_type>(existing_size), std::memory_order_relaxed);
+    
+    if (async_writer_) {
+#ifdef _WIN32
+        async_writer_->file_fd = _open(config_.file_path->c_str(), _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY, 0644);
+#else
+        async_writer_->file_fd = ::open(config_.file_path->c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+#endif
+        return async_writer_->file_fd >= 0;
+    }
+    
+    file_stream_ = std::make_unique<std::ofstream>(*config_.file_path, std::ios::out | std::ios::app | std::ios::binary);
+    if (!file_stream_->is_open()) {
+        file_stream_.reset();
+        return false;
+    }
+    return true;
+}
+
+void Logger::close_file_stream() {
+    if (file_stream_) {
+        file_stream_->flush();
+        file_stream_->close();
+        file_stream_.reset();
+    }
+    
+    if (async_writer_ && async_writer_->file_fd >= 0) {
+#ifdef _WIN32
+        _close(async_writer_->file_fd);
+#else
+        ::close(async_writer_->file_fd);
+#endif
+        async_writer_->file_fd = -1;
+    }
+}
+
+void Logger::start_async_writer() {
+    async_writer_ = std::make_unique<AsyncWriter>();
+    async_writer_->ring_capacity = LogRing::round_capacity(config_.async_buffer_size);
+    if (config_.file_output) {
+        open_file_stream();
+    }
+    async_writer_->thread = std::thread([this] { async_writer_loop(); });
+}
+
+void Logger::stop_async_writer() {
+    if (!async_writer_) {
+        return;
+    }
+    
+    {
+        lock_guard lock(async_writer_->wake_mutex);
+        async_writer_->stop_requested.store(true, std::memory_order_release);
+        async_writer_->wake_condition.notify_one();
+        async_writer_->flush_condition.notify_all();
+    }
+    if (async_writer_->thread.joinable()) {
+        async_writer_->thread.join();
+    }
+    
+    {
+        lock_guard lock(async_writer_->rings_mutex);
+        for (auto& ring : async_writer_->rings) {
+            ring->detach();
+        }
+    }
+    
+    close_file_stream();
+    async_writer_.reset();
+}
+
+void Logger::enqueue_async(LogLevel level, string_view formatted_message) {
+    auto& writer = *async_writer_;
+    auto& ring = writer.local_ring();
+    
+    // Oversized records are cut so they can never wedge a BLOCK producer, keeping the
+    // newline so the next record still starts on its own line
+    string truncated;
+    if (formatted_message.size() > ring.max_payload()) {
+        truncated.reserve(ring.max_payload());
+        truncated.append(formatted_message.substr(0, ring.max_payload() - 1)).push_back('\n');
+        formatted_message = truncated;
+    }
+    
+    if (config_.overflow_policy == OverflowPolicy::SAMPLE && level < LogLevel::WARN &&
+        ring.producer_backlog() * 4 >= ring.capacity() * 3) {
+        auto rate = std::max<size_type>(config_.sample_rate, 1);
+        if (writer.sample_counter.fetch_add(1, std::memory_order_relaxed) % rate != 0) {
+            sampled_out_count_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+    
+    if (ring.try_push(static_cast<std::uint32_t>(level), formatted_message.data(), formatted_message.size())) {
+        if (level >= LogLevel::ERROR || ring.producer_backlog() * 2 >= ring.capacity()) {
+            writer.wake();
+        }
+        return;
+    }
+    
+    if (config_.overflow_policy == OverflowPolicy::BLOCK) {
+        writer.wake();
+        for (size_type attempt = 0; !writer.stop_requested.load(std::memory_order_acquire); ++attempt) {
+            if (ring.try_push(static_cast<std::uint32_t>(level), formatted_message.data(), formatted_message.size())) {
+                return;
+            }
+            if (attempt < 64) {
+                std::this_thread::yield();
+            } else {
+                writer.wake();
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+        }
+    }
+    
+    dropped_count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Logger::async_writer_loop() {
+    set_current_thread_name("log-writer");
+    auto& writer = *async_writer_;
+    vector<shared_ptr<LogRing>> snapshot;
+    SegmentBatch stdout_batch;
+    SegmentBatch stderr_batch;
+    SegmentBatch file_batch;
+    stdout_batch.fd = STDOUT_FD;
+    stderr_batch.fd = STDERR_FD;
+    
+    auto flush_batches = [&] {
+        bytes_written_.fetch_add(stdout_batch.flush() + stderr_batch.flush(), std::memory_order_relaxed);
+        file_batch.fd = writer.file_fd;
+        auto file_bytes = file_batch.flush();
+        bytes_written_.fetch_add(file_bytes, std::memory_order_relaxed);
+        current_file_size_.fetch_add(file_bytes, std::memory_order_relaxed);
+    };
+    
+    auto drain = [&](LogRing& ring) {
+        auto position = ring.head();
+        auto end = ring.published_tail();
+        while (position < end) {
+            auto record = ring.peek(position);
+            auto level = static_cast<LogLevel>(record.tag);
+            
+            if (config_.console_output) {
+                auto& batch = console_fd(level) == STDERR_FD ? stderr_batch : stdout_batch;
+                if (config_.colored_output) {
+                    // The reset code goes before the record's trailing newline
+                    auto color = level_color(level);
+                    auto first = record.first;
+                    auto second = record.second;
+                    (second.size > 0 ? second : first).size -= 1;
+                    batch.add(color.data(), color.size());
+                    batch.add(first.data, first.size);
+                    batch.add(second.data, second.size);
+                    batch.add(RESET_COLOR.data(), RESET_COLOR.size());
+                    batch.add(NEWLINE.data(), NEWLINE.size());
+                } else {
+                    batch.add(record.first.data, record.first.size);
+                    batch.add(record.second.data, record.second.size);
+                }
+            }
+            if (config_.file_output) {
+                file_batch.add(record.first.data, record.first.size);
+                file_batch.add(record.second.data, record.second.size);
+            }
+            
+            position = record.next;
+            if (stdout_batch.full() || stderr_batch.full() || file_batch.full()) {
+                flush_batches();
+                ring.release(position);
+            }
+        }
+        
+        flush_batches();
+        ring.release(position);
+    };
+    
+    while (true) {
+        size_type flush_target = 0;
+        {
+            unique_lock lock(writer.wake_mutex);
+            writer.wake_condition.wait_for(lock, config_.async_flush_interval, [&] {
+                return writer.wake_pending.load(std::memory_order_acquire) ||
+                       writer.stop_requested.load(std::memory_order_acquire);
+            });
+            writer.wake_pending.store(false, std::memory_order_release);
+            flush_target = writer.flush_requested;
+        }
+        auto stopping = writer.stop_requested.load(std::memory_order_acquire);
+        
+        {
+            lock_guard lock(writer.rings_mutex);
+            snapshot = writer.rings;
+        }
+        
+        for (auto& ring : snapshot) {
+            drain(*ring);
+        }
+        
+        {
+            lock_guard lock(writer.rings_mutex);
+            writer.rings.erase(std::remove_if(writer.rings.begin(), writer.rings.end(),
+                [](const shared_ptr<LogRing>& ring) {
+                    return ring->abandoned() && ring->empty();
+                }), writer.rings.end());
+        }
+        snapshot.clear();
+        
+        if (writer.rotate_requested.exchange(false, std::memory_order_acq_rel) ||
+            (config_.file_output && config_.max_file_size > 0 &&
+             current_file_size_.load(std::memory_order_relaxed) >= config_.max_file_size)) {
+            perform_file_rotation();
+        }
+        
+        {
+            lock_guard lock(writer.wake_mutex);
+            writer.flush_completed = flush_target;
+            writer.flush_condition.notify_all();
+        }
+        
+        if (stopping) {
+            break;
+        }
+    }
+}
+
+void Logger::rebuild_context_suffix() {
+    if (context_.empty()) {
+        context_suffix_.store(nullptr, std::memory_order_release);
+        return;
+    }
+    
+    string suffix = " {";
+    bool first = true;
+    for (const auto& [key, value] : context_) {
+        if (!first) {
+            suffix += ", ";
+        }
+        suffix.append(key).append("=").append(value);
+        first = false;
+    }
+    suffix += '}';
+    context_suffix_.store(std::make_shared<const string>(std::move(suffix)), std::memory_order_release);
+}
+
+void Logger::handle_logging_error(const std::exception& e) {
+    std::fprintf(stderr, "Logger error: %s\n", e.what());
+}
+
+void Logger::update_statistics(LogLevel level, size_type message_size) {
+    message_count_.fetch_add(1, std::memory_order_relaxed);
+    if (level >= LogLevel::ERROR) {
+        error_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+}  // namespace http_framework::utils
@@ -0,0 +1,520 @@
+#include "utils/profiler.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <thread>
+
+#if defined(__linux__)
+#include <cxxabi.h>
+#include <dirent.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <linux/perf_event.h>
+#include <signal.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+namespace http_framework::utils {
+
+namespace {
+
+atomic<bool> profiler_running{false};
+
+#if defined(__linux__)
+
+constexpr size_type MAX_STACK_DEPTH = 128;
+constexpr auto DRAIN_INTERVAL = std::chrono::milliseconds(50);
+
+constexpr char HEX_DIGITS[] = "0123456789abcdef";
+
+string hex_address(std::uintptr_t value) {
+    string out = "0x";
+    bool leading = true;
+    for (int shift = static_cast<int>(sizeof(value) * 8) - 4; shift >= 0; shift -= 4) {
+        auto digit = (value >> shift) & 0x0f;
+        if (digit == 0 && leading && shift != 0) {
+            continue;
+        }
+        leading = false;
+        out += HEX_DIGITS[digit];
+    }
+    return out;
+}
+
+vector<pid_t> list_threads() {
+    vector<pid_t> threads;
+    if (auto* dir = ::opendir("/proc/self/task")) {
+        while (auto* entry = ::readdir(dir)) {
+            if (entry->d_name[0] >= '0' && entry->d_name[0] <= '9') {
+                threads.push_back(static_cast<pid_t>(std::atoi(entry->d_name)));
+            }
+        }
+        ::closedir(dir);
+    }
+    return threads;
+}
+
+void read_thread_names(hash_map<pid_t, string>& names) {
+    for (auto tid : list_threads()) {
+        std::ifstream comm("/proc/self/task/" + std::to_string(tid) + "/comm");
+        string name;
+        if (std::getline(comm, name) && !name.empty()) {
+            names[tid] = std::move(name);
+        }
+    }
+}
+
+// "worker-12" -> "worker"; names without a numeric suffix are kept whole
+string_view thread_role(string_view name) noexcept {
+    auto dash = name.rfind('-');
+    if (dash == string_view::npos || dash == 0 || dash + 1 == name.size()) {
+        return name;
+    }
+    auto suffix = name.substr(dash + 1);
+    bool numeric = std::all_of(suffix.begin(), suffix.end(), [](char c) { return c >= '0' && c <= '9'; });
+    return numeric ? name.substr(0, dash) : name;
+}
+
+// Resolves return addresses to demangled names, caching each address once
+class Symbolizer {
+public:
+    const string& name(std::uintptr_t address) {
+        auto it = cache_.find(address);
+        if (it != cache_.end()) {
+            return it->second;
+        }
+        return cache_.emplace(address, resolve(address)).first->second;
+    }
+
+private:
+    hash_map<std::uintptr_t, string> cache_;
+    
+    static string resolve(std::uintptr_t address) {
+        Dl_info info{};
+        if (!::dladdr(reinterpret_cast<void*>(address), &info)) {
+            return hex_address(address);
+        }
+        
+        string result;
+        if (info.dli_sname) {
+            int status = 0;
+            char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+            result = status == 0 && demangled ? demangled : info.dli_sname;
+            std::free(demangled);
+        } else if (info.dli_fname) {
+            string_view module = info.dli_fname;
+            module = module.substr(module.rfind('/') + 1);
+            result = string(module) + "+" + hex_address(address - reinterpret_cast<std::uintptr_t>(info.dli_fbase));
+        } else {
+            result = hex_address(address);
+        }
+        // ';' separates frames in the folded format
+        std::replace(result.begin(), result.end(), ';', ':');
+        return result;
+    }
+};
+
+// Counts identical raw stacks; symbolization and folding happen once, at the end
+class StackAggregator {
+public:
+    // frames are leaf first; the leaf is an exact PC, the rest are return addresses
+    void add(pid_t tid, const std::uintptr_t* frames, size_type depth) {
+        if (depth == 0) {
+            return;
+        }
+        key_.assign(reinterpret_cast<const char*>(&tid), sizeof(tid));
+        key_.append(reinterpret_cast<const char*>(frames), depth * sizeof(std::uintptr_t));
+        ++counts_[key_];
+    }
+    
+    string fold(const hash_map<pid_t, string>& names, bool per_thread) {
+        Symbolizer symbolizer;
+        std::map<string, size_type> lines;
+        string line;
+        
+        for (const auto& [key, count] : counts_) {
+            pid_t tid;
+            std::memcpy(&tid, key.data(), sizeof(tid));
+            auto depth = (key.size() - sizeof(tid)) / sizeof(std::uintptr_t);
+            vector<std::uintptr_t> frames(depth);
+            std::memcpy(frames.data(), key.data() + sizeof(tid), depth * sizeof(std::uintptr_t));
+            
+            auto name = names.find(tid);
+            if (name == names.end()) {
+                line = "thread-" + std::to_string(tid);
+            } else {
+                line = per_thread ? name->second : string(thread_role(name->second));
+            }
+            
+            for (auto i = depth; i-- > 0;) {
+                line += ';';
+                // Step back into the call instruction so inlined-frame boundaries resolve correctly
+                line += symbolizer.name(i == 0 ? frames[i] : frames[i] - 1);
+            }
+            lines[line] += count;
+        }
+        
+        string out;
+        for (const auto& [stack, count] : lines) {
+            out += stack;
+            out += ' ';
+            out += std::to_string(count);
+            out += '\n';
+        }
+        return out;
+    }
+
+private:
+    hash_map<string, size_type> counts_;
+    string key_;
+};
+
+// One task-clock sampling event per thread, each with its own mmap ring
+class PerfSampler {
+public:
+    ~PerfSampler() { stop(); }
+    
+    bool start(const CpuProfiler::Options& options, int& error) {
+        page_size_ = static_cast<size_type>(::sysconf(_SC_PAGESIZE));
+        map_size_ = page_size_ * (1 + DATA_PAGES);
+        
+        for (auto tid : list_threads()) {
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_SOFTWARE;
+            attr.config = PERF_COUNT_SW_TASK_CLOCK;
+            attr.freq = 1;
+            attr.sample_freq = options.frequency_hz;
+            attr.sample_type = PERF_SAMPLE_TID | PERF_SAMPLE_CALLCHAIN;
+            attr.sample_max_stack = static_cast<std::uint16_t>(std::min(options.max_stack_depth, MAX_STACK_DEPTH));
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.exclude_callchain_kernel = 1;
+            
+            auto fd = static_cast<int>(::syscall(SYS_perf_event_open, &attr, tid, -1, -1, PERF_FLAG_FD_CLOEXEC));
+            if (fd < 0) {
+                // A thread that exited since the listing is not a backend failure
+                if (errno == ESRCH) {
+                    continue;
+                }
+                error = errno;
+                stop();
+                return false;
+            }
+            
+            auto* map = ::mmap(nullptr, map_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (map == MAP_FAILED) {
+                error = errno;
+                ::close(fd);
+                stop();
+                return false;
+            }
+            streams_.push_back({fd, map});
+        }
+        
+        for (auto& stream : streams_) {
+            ::ioctl(stream.fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+        return !streams_.empty();
+    }
+    
+    void drain(StackAggregator& aggregator, size_type max_depth, size_type& samples, size_type& lost) {
+        for (auto& stream : streams_) {
+            drain_stream(stream, aggregator, max_depth, samples, lost);
+        }
+    }
+    
+    void stop() {
+        for (auto& stream : streams_) {
+            ::ioctl(stream.fd, PERF_EVENT_IOC_DISABLE, 0);
+            ::munmap(stream.map, map_size_);
+            ::close(stream.fd);
+        }
+        streams_.clear();
+    }
+
+private:
+    static constexpr size_type DATA_PAGES = 32;
+    
+    struct Stream {
+        int fd;
+        void* map;
+    };
+    
+    vector<Stream> streams_;
+    size_type page_size_{0};
+    size_type map_size_{0};
+    vector<byte_t> record_;
+    array<std::uintptr_t, MAX_STACK_DEPTH> frames_{};
+    
+    void drain_stream(Stream& stream, StackAggregator& aggregator, size_type max_depth, size_type& samples, size_type& lost) {
+        auto* meta = static_cast<perf_event_mmap_page*>(stream.map);
+        auto* data = static_cast<const byte_t*>(stream.map) + page_size_;
+        auto data_size = page_size_ * DATA_PAGES;
+        
+        auto head = std::atomic_ref<__u64>(meta->data_head).load(std::memory_order_acquire);
+        auto tail = meta->data_tail;
+        
+        while (tail + sizeof(perf_event_header) <= head) {
+            perf_event_header header;
+            copy_from_ring(data, data_size, tail, &header, sizeof(header));
+            if (header.size < sizeof(header) || tail + header.size > head) {
+                break;
+            }
+            record_.resize(header.size);
+            copy_from_ring(data, data_size, tail, record_.data(), header.size);
+            tail += header.size;
+            
+            if (header.type == PERF_RECORD_SAMPLE) {
+                // Body: u32 pid, u32 tid, u64 nr, u64 ips[nr]
+                std::uint32_t tid;
+                std::uint64_t count;
+                std::memcpy(&tid, record_.data() + sizeof(header) + 4, sizeof(tid));
+                std::memcpy(&count, record_.data() + sizeof(header) + 8, sizeof(count));
+                auto* ips = record_.data() + sizeof(header) + 16;
+                count = std::min<std::uint64_t>(count, (header.size - sizeof(header) - 16) / sizeof(std::uint64_t));
+                
+                size_type depth = 0;
+                for (std::uint64_t i = 0; i < count && depth < max_depth; ++i) {
+                    std::uint64_t ip;
+                    std::memcpy(&ip, ips + i * sizeof(ip), sizeof(ip));
+                    // PERF_CONTEXT_* markers separate kernel and user chains
+                    if (ip >= static_cast<std::uint64_t>(PERF_CONTEXT_MAX)) {
+                        continue;
+                    }
+                    frames_[depth++] = static_cast<std::uintptr_t>(ip);
+                }
+                aggregator.add(static_cast<pid_t>(tid), frames_.data(), depth);
+                ++samples;
+            } else if (header.type == PERF_RECORD_LOST) {
+                std::uint64_t dropped;
+                std::memcpy(&dropped, record_.data() + sizeof(header) + 8, sizeof(dropped));
+                lost += static_cast<size_type>(dropped);
+            }
+        }
+        
+        std::atomic_ref<__u64>(meta->data_tail).store(tail, std::memory_order_release);
+    }
+    
+    static void copy_from_ring(const byte_t* data, size_type size, std::uint64_t position, void* out, size_type length) {
+        auto offset = static_cast<size_type>(position % size);
+        auto first = std::min(length, size - offset);
+        std::memcpy(out, data + offset, first);
+        std::memcpy(static_cast<byte_t*>(out) + first, data, length - first);
+    }
+};
+
+// SIGPROF fallback. The handler claims a slot with one fetch_add and unwinds into it;
+// nothing else in it allocates, locks or touches state the collector is reading.
+struct ItimerSamples {
+    size_type capacity{0};
+    size_type depth{0};
+    unique_ptr<void*[]> frames;
+    unique_ptr<atomic<std::uint32_t>[]> depths;
+    unique_ptr<pid_t[]> tids;
+    atomic<size_type> next{0};
+    atomic<size_type> lost{0};
+    atomic<bool> active{false};
+};
+
+atomic<ItimerSamples*> itimer_samples{nullptr};
+// Handlers between entry and return. Kept outside ItimerSamples, which lives on the
+// collector's stack: a handler must be counted before it can see the pointer at all.
+atomic<int> itimer_in_flight{0};
+
+// backtrace() starts at the handler, then the kernel's signal trampoline
+constexpr size_type SIGNAL_FRAMES = 2;
+
+extern "C" void profiler_sigprof_handler(int) {
+    auto saved_errno = errno;
+    // Counted before the pointer is loaded, so once the collector has cleared the pointer
+    // and seen zero, no handler still holds it
+    itimer_in_flight.fetch_add(1);
+    if (auto* samples = itimer_samples.load()) {
+        if (samples->active.load()) {
+            auto index = samples->next.fetch_add(1, std::memory_order_relaxed);
+            if (index < samples->capacity) {
+                auto* frames = &samples->frames[index * samples->depth];
+                auto depth = ::backtrace(frames, static_cast<int>(samples->depth));
+                samples->tids[index] = static_cast<pid_t>(::syscall(SYS_gettid));
+                samples->depths[index].store(static_cast<std::uint32_t>(std::max(depth, 0)), std::memory_order_release);
+            } else {
+                samples->lost.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+    itimer_in_flight.fetch_sub(1);
+    errno = saved_errno;
+}
+
+// Clears the handler's pointer, then waits out any handler that loaded it before that
+void detach_itimer_samples() {
+    itimer_samples.store(nullptr);
+    while (itimer_in_flight.load() != 0) {
+        std::this_thread::yield();
+    }
+}
+
+bool run_itimer(const CpuProfiler::Options& options, StackAggregator& aggregator, CpuProfiler::Profile& profile) {
+    ItimerSamples samples;
+    auto seconds = std::max<std::int64_t>(std::chrono::duration_cast<std::chrono::seconds>(options.duration).count(), 1);
+    auto expected = static_cast<size_type>(seconds) * options.frequency_hz *
+                    std::max<size_type>(std::thread::hardware_concurrency(), 1);
+    // Bounded at 16Ki samples so a long profile of a busy process cannot balloon memory
+    samples.capacity = std::clamp<size_type>(expected, 1024, 16384);
+    samples.depth = std::min(options.max_stack_depth, MAX_STACK_DEPTH) + SIGNAL_FRAMES;
+    samples.frames = std::make_unique<void*[]>(samples.capacity * samples.depth);
+    samples.depths = std::make_unique<atomic<std::uint32_t>[]>(samples.capacity);
+    samples.tids = std::make_unique<pid_t[]>(samples.capacity);
+    
+    // The first backtrace() loads libgcc_s, which must not happen inside the handler
+    void* warm_up[4];
+    ::backtrace(warm_up, 4);
+    
+    struct sigaction action{};
+    struct sigaction previous{};
+    action.sa_handler = profiler_sigprof_handler;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    
+    itimer_samples.store(&samples, std::memory_order_release);
+    samples.active.store(true);
+    if (::sigaction(SIGPROF, &action, &previous) != 0) {
+        itimer_samples.store(nullptr);
+        return false;
+    }
+    
+    auto interval_us = static_cast<long>(std::max<size_type>(1000000 / std::max<size_type>(options.frequency_hz, 1), 1));
+    itimerval timer{};
+    // tv_usec must stay below one second, which 1 Hz would otherwise hit
+    timer.it_interval.tv_sec = interval_us / 1000000;
+    timer.it_interval.tv_usec = interval_us % 1000000;
+    // The first tick lands half an interval in, so a profile as short as one interval still samples
+    auto first_us = std::max<long>(interval_us / 2, 1);
+    timer.it_value.tv_sec = first_us / 1000000;
+    timer.it_value.tv_usec = first_us % 1000000;
+    itimerval previous_timer{};
+    if (::setitimer(ITIMER_PROF, &timer, &previous_timer) != 0) {
+        ::sigaction(SIGPROF, &previous, nullptr);
+        detach_itimer_samples();
+        return false;
+    }
+    
+    std::this_thread::sleep_for(options.duration);
+    
+    itimerval stopped{};
+    ::setitimer(ITIMER_PROF, &stopped, nullptr);
+    samples.active.store(false);
+    // A tick can still be pending once the timer is stopped. Ignoring SIGPROF discards it,
+    // where restoring a SIG_DFL action straight away would let it terminate the process.
+    struct sigaction ignore{};
+    ignore.sa_handler = SIG_IGN;
+    sigemptyset(&ignore.sa_mask);
+    ::sigaction(SIGPROF, &ignore, nullptr);
+    detach_itimer_samples();
+    ::sigaction(SIGPROF, &previous, nullptr);
+    ::setitimer(ITIMER_PROF, &previous_timer, nullptr);
+    
+    auto recorded = std::min(samples.next.load(), samples.capacity);
+    array<std::uintptr_t, MAX_STACK_DEPTH> frames{};
+    for (size_type i = 0; i < recorded; ++i) {
+        auto depth = static_cast<size_type>(samples.depths[i].load(std::memory_order_acquire));
+        if (depth <= SIGNAL_FRAMES) {
+            continue;
+        }
+        auto* raw = &samples.frames[i * samples.depth];
+        for (size_type j = SIGNAL_FRAMES; j < depth; ++j) {
+            frames[j - SIGNAL_FRAMES] = reinterpret_cast<std::uintptr_t>(raw[j]);
+        }
+        aggregator.add(samples.tids[i], frames.data(), depth - SIGNAL_FRAMES);
+        ++profile.samples;
+    }
+    profile.lost_samples += samples.lost.load();
+    return true;
+}
+
+#endif
+
+}  // namespace
+
+string_view to_string(CpuProfiler::Backend backend) noexcept {
+    switch (backend) {
+        case CpuProfiler::Backend::AUTO: return "auto";
+        case CpuProfiler::Backend::PERF_EVENT: return "perf_event";
+        case CpuProfiler::Backend::ITIMER: return "itimer";
+    }
+    return "unknown";
+}
+
+bool CpuProfiler::is_running() noexcept {
+    return profiler_running.load(std::memory_order_relaxed);
+}
+
+CpuProfiler::Profile CpuProfiler::run(const Options& options) {
+#if defined(__linux__)
+    bool expected = false;
+    if (!profiler_running.compare_exchange_strong(expected, true)) {
+        throw std::runtime_error("A CPU profile is already running");
+    }
+    struct RunningGuard {
+        ~RunningGuard() { profiler_running.store(false); }
+    } guard;
+    
+    if (options.frequency_hz == 0) {
+        throw std::invalid_argument("Profiling frequency must be positive");
+    }
+    
+    Profile profile;
+    StackAggregator aggregator;
+    hash_map<pid_t, string> names;
+    read_thread_names(names);
+    auto started_at = std::chrono::steady_clock::now();
+    auto max_depth = std::min(options.max_stack_depth, MAX_STACK_DEPTH);
+    
+    bool sampled = false;
+    if (options.backend != Backend::ITIMER) {
+        PerfSampler sampler;
+        int error = 0;
+        if (sampler.start(options, error)) {
+            auto deadline = started_at + options.duration;
+            while (std::chrono::steady_clock::now() < deadline) {
+                std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(
+                    DRAIN_INTERVAL, deadline - std::chrono::steady_clock::now()));
+                sampler.drain(aggregator, max_depth, profile.samples, profile.lost_samples);
+            }
+            sampler.stop();
+            profile.backend = Backend::PERF_EVENT;
+            sampled = true;
+        } else if (options.backend == Backend::PERF_EVENT) {
+            throw std::runtime_error("perf_event_open failed: " + string(std::strerror(error)));
+        }
+    }
+    
+    if (!sampled) {
+        if (!run_itimer(options, aggregator, profile)) {
+            throw std::runtime_error("Could not start the SIGPROF timer: " + string(std::strerror(errno)));
+        }
+        profile.backend = Backend::ITIMER;
+    }
+    
+    profile.duration = std::chrono::duration_cast<duration_t>(std::chrono::steady_clock::now() - started_at);
+    // Pick up threads started during the profile; names seen at the start win
+    hash_map<pid_t, string> late_names;
+    read_thread_names(late_names);
+    names.merge(late_names);
+    profile.folded = aggregator.fold(names, options.per_thread);
+    return profile;
+#else
+    throw std::runtime_error("CPU profiling is only supported on Linux");
+#endif
+}
+
+}  // namespace http_framework::utils
@@ -0,0 +1,941 @@
+#include "core/types.hpp"
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace http_framework;
+
+namespace {
+
+std::uint64_t monotonic_ns() noexcept {
+    timespec now{};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<std::uint64_t>(now.tv_sec) * 1'000'000'000ULL + static_cast<std::uint64_t>(now.tv_nsec);
+}
+
+atomic<bool> interrupted{false};
+
+void handle_interrupt(int) {
+    interrupted.store(true, std::memory_order_relaxed);
+}
+
+struct Options {
+    string host{"127.0.0.1"};
+    string port{"8080"};
+    vector<string> paths;
+    string method{"GET"};
+    string body;
+    vector<string> headers;
+    size_type threads{2};
+    size_type connections{64};
+    size_type pipeline{1};
+    double duration_s{10.0};
+    double warmup_s{1.0};
+    // Total requests per second across all connections; 0 runs closed loop
+    double rate{0.0};
+    // Closed loop only: back-fills samples a stalled connection never sent
+    std::uint64_t expected_interval_us{0};
+    std::uint64_t timeout_ms{5000};
+    bool keep_alive{true};
+    string hdr_output;
+};
+
+// HdrHistogram layout: values below 2^SUB_BUCKET_BITS are exact, above that each power of
+// two is split into 2^SUB_BUCKET_BITS linear buckets, bounding the recording error to 0.1%
+class LatencyHistogram {
+public:
+    static constexpr std::uint32_t SUB_BUCKET_BITS = 10;
+    static constexpr std::uint32_t MAX_VALUE_BITS = 40;
+    static constexpr size_type SUB_BUCKET_COUNT = size_type{1} << SUB_BUCKET_BITS;
+    static constexpr size_type BUCKET_COUNT = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) << SUB_BUCKET_BITS;
+    
+    LatencyHistogram() : counts_(BUCKET_COUNT, 0) {}
+    
+    void record(std::uint64_t value) noexcept {
+        ++counts_[index_of(value)];
+        ++total_;
+        max_ = std::max(max_, value);
+        sum_ += static_cast<double>(value);
+        sum_squares_ += static_cast<double>(value) * static_cast<double>(value);
+    }
+    
+    // HdrHistogram's recordValueWithExpectedInterval: a response that took value instead of
+    // expected_interval hid the requests a non-blocked client would have sent meanwhile
+    void record_corrected(std::uint64_t value, std::uint64_t expected_interval) noexcept {
+        record(value);
+        if (expected_interval == 0 || value <= expected_interval) {
+            return;
+        }
+        for (auto missing = value - expected_interval; missing >= expected_interval; missing -= expected_interval) {
+            record(missing);
+        }
+    }
+    
+    void merge(const LatencyHistogram& other) noexcept {
+        for (size_type i = 0; i < BUCKET_COUNT; ++i) {
+            counts_[i] += other.counts_[i];
+        }
+        total_ += other.total_;
+        max_ = std::max(max_, other.max_);
+        sum_ += other.sum_;
+        sum_squares_ += other.sum_squares_;
+    }
+    
+    std::uint64_t total() const noexcept { return total_; }
+    std::uint64_t max() const noexcept { return max_; }
+    double mean() const noexcept { return total_ ? sum_ / static_cast<double>(total_) : 0.0; }
+    
+    double stddev() const noexcept {
+        if (total_ == 0) {
+            return 0.0;
+        }
+        auto m = mean();
+        return std::sqrt(std::max(0.0, sum_squares_ / static_cast<double>(total_) - m * m));
+    }
+    
+    std::uint64_t value_at_percentile(double percentile) const noexcept {
+        if (total_ == 0) {
+            return 0;
+        }
+        auto rank = static_cast<std::uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(total_)));
+        rank = std::clamp<std::uint64_t>(rank, 1, total_);
+        std::uint64_t seen = 0;
+        for (size_type i = 0; i < BUCKET_COUNT; ++i) {
+            seen += counts_[i];
+            if (seen >= rank) {
+                return std::min(highest_equivalent(i), max_);
+            }
+        }
+        return max_;
+    }
+    
+    std::uint64_t count_at_or_below(std::uint64_t value) const noexcept {
+        std::uint64_t count = 0;
+        auto last = index_of(value);
+        for (size_type i = 0; i <= last; ++i) {
+            count += counts_[i];
+        }
+        return count;
+    }
+    
+    // The .hgrm text format understood by HdrHistogram's plotting tools
+    void write_percentile_distribution(std::FILE* out, double unit_divisor) const {
+        constexpr int TICKS_PER_HALF_DISTANCE = 5;
+        
+        std::fprintf(out, "%12s %14s %10s %14s\n\n", "Value", "Percentile", "TotalCount", "1/(1-Percentile)");
+        double percentile = 0.0;
+        while (total_ > 0) {
+            auto value = value_at_percentile(percentile);
+            auto count = count_at_or_below(value);
+            if (count >= total_) {
+                std::fprintf(out, "%12.3f %1.12f %10llu\n", static_cast<double>(max_) / unit_divisor, 1.0,
+                             static_cast<unsigned long long>(total_));
+                break;
+            }
+            std::fprintf(out, "%12.3f %1.12f %10llu %14.2f\n", static_cast<double>(value) / unit_divisor,
+                         percentile / 100.0, static_cast<unsigned long long>(count), 1.0 / (1.0 - percentile / 100.0));
+                         
+            auto level = std::floor(std::log2(100.0 / (100.0 - percentile)));
+            percentile += 100.0 / (std::pow(2.0, level + 1) * TICKS_PER_HALF_DISTANCE);
+        }
+        
+        std::fprintf(out, "#[Mean    = %12.3f, StdDeviation   = %12.3f]\n", mean() / unit_divisor, stddev() / unit_divisor);
+        std::fprintf(out, "#[Max     = %12.3f, Total count    = %12llu]\n", static_cast<double>(max_) / unit_divisor,
+                     static_cast<unsigned long long>(total_));
+        std::fprintf(out, "#[Buckets = %12u, SubBuckets     = %12zu]\n", MAX_VALUE_BITS - SUB_BUCKET_BITS + 1,
+                     SUB_BUCKET_COUNT);
+    }
+
+private:
+    vector<std::uint64_t> counts_;
+    std::uint64_t total_{0};
+    std::uint64_t max_{0};
+    double sum_{0.0};
+    double sum_squares_{0.0};
+    
+    static size_type index_of(std::uint64_t value) noexcept {
+        if (value < SUB_BUCKET_COUNT) {
+            return static_cast<size_type>(value);
+        }
+        auto msb = static_cast<std::uint32_t>(std::bit_width(value)) - 1;
+        if (msb >= MAX_VALUE_BITS) {
+            return BUCKET_COUNT - 1;
+        }
+        auto shift = msb - SUB_BUCKET_BITS;
+        auto sub_bucket = static_cast<size_type>((value >> shift) & (SUB_BUCKET_COUNT - 1));
+        return ((static_cast<size_type>(shift) + 1) << SUB_BUCKET_BITS) + sub_bucket;
+    }
+    
+    static std::uint64_t highest_equivalent(size_type index) noexcept {
+        if (index < SUB_BUCKET_COUNT) {
+            return index;
+        }
+        auto shift = (index >> SUB_BUCKET_BITS) - 1;
+        auto lower = static_cast<std::uint64_t>(SUB_BUCKET_COUNT + (index & (SUB_BUCKET_COUNT - 1))) << shift;
+        return lower + (std::uint64_t{1} << shift) - 1;
+    }
+};
+
+struct Stats {
+    std::uint64_t requests{0};
+    std::uint64_t bytes_read{0};
+    array<std::uint64_t, 6> status_classes{};
+    std::uint64_t connect_errors{0};
+    std::uint64_t read_errors{0};
+    std::uint64_t write_errors{0};
+    std::uint64_t parse_errors{0};
+    std::uint64_t timeouts{0};
+    // Measured from when each request should have been sent
+    LatencyHistogram latency;
+    // Measured from when it was actually written, i.e. what a naive client reports
+    LatencyHistogram service_time;
+    
+    void merge(const Stats& other) {
+        requests += other.requests;
+        bytes_read += other.bytes_read;
+        for (size_type i = 0; i < status_classes.size(); ++i) {
+            status_classes[i] += other.status_classes[i];
+        }
+        connect_errors += other.connect_errors;
+        read_errors += other.read_errors;
+        write_errors += other.write_errors;
+        parse_errors += other.parse_errors;
+        timeouts += other.timeouts;
+        latency.merge(other.latency);
+        service_time.merge(other.service_time);
+    }
+};
+
+struct Target {
+    sockaddr_storage address{};
+    socklen_t address_length{0};
+    vector<string> requests;
+};
+
+class ResponseParser {
+public:
+    enum class Result { INCOMPLETE, COMPLETE, ERROR };
+    
+    static constexpr size_type MAX_HEADER_BYTES = 64 * 1024;
+    
+    // Consumes at most one response from data starting at offset
+    Result parse(const string& data, size_type& offset) {
+        if (!headers_done_) {
+            auto result = parse_headers(data, offset);
+            if (result != Result::COMPLETE) {
+                return result;
+            }
+        }
+        
+        if (!chunked_) {
+            if (data.size() - cursor_ < content_length_) {
+                return Result::INCOMPLETE;
+            }
+            offset = cursor_ + content_length_;
+            headers_done_ = false;
+            return Result::COMPLETE;
+        }
+        
+        while (true) {
+            auto line_end = data.find("\r\n", cursor_);
+            if (line_end == string::npos) {
+                return Result::INCOMPLETE;
+            }
+            auto size = std::strtoull(data.c_str() + cursor_, nullptr, 16);
+            if (size == 0) {
+                // The last chunk is followed by optional trailers and an empty line
+                if (data.size() < line_end + 4) {
+                    return Result::INCOMPLETE;
+                }
+                auto end = data.compare(line_end + 2, 2, "\r\n") == 0 ? line_end + 4 : data.find("\r\n\r\n", line_end + 2);
+                if (end == string::npos) {
+                    return Result::INCOMPLETE;
+                }
+                offset = end == line_end + 4 ? end : end + 4;
+                headers_done_ = false;
+                return Result::COMPLETE;
+            }
+            if (data.size() < line_end + 2 + size + 2) {
+                return Result::INCOMPLETE;
+            }
+            cursor_ = line_end + 2 + size + 2;
+        }
+    }
+    
+    status_code_t status() const noexcept { return status_; }
+    bool closes_connection() const noexcept { return close_; }
+    void reset() noexcept { headers_done_ = false; }
+
+private:
+    bool headers_done_{false};
+    bool chunked_{false};
+    bool close_{false};
+    status_code_t status_{0};
+    size_type content_length_{0};
+    size_type cursor_{0};
+    
+    Result parse_headers(const string& data, size_type offset) {
+        auto end = data.find("\r\n\r\n", offset);
+        if (end == string::npos) {
+            return data.size() - offset > MAX_HEADER_BYTES ? Result::ERROR : Result::INCOMPLETE;
+        }
+        
+        string_view head(data.data() + offset, end - offset);
+        if (head.size() < 12 || head.substr(0, 5) != "HTTP/") {
+            return Result::ERROR;
+        }
+        status_ = static_cast<status_code_t>(std::atoi(data.c_str() + offset + 9));
+        chunked_ = false;
+        close_ = false;
+        content_length_ = 0;
+        
+        size_type position = head.find("\r\n");
+        while (position != string_view::npos && position < head.size()) {
+            auto line_start = position + 2;
+            auto line_end = head.find("\r\n", line_start);
+            auto line = head.substr(line_start, line_end == string_view::npos ? string_view::npos : line_end - line_start);
+            auto colon = line.find(':');
+            if (colon != string_view::npos) {
+                auto name = line.substr(0, colon);
+                auto value = line.substr(colon + 1);
+                while (!value.empty() && value.front() == ' ') {
+                    value.remove_prefix(1);
+                }
+                if (equals_ignore_case(name, "content-length")) {
+                    content_length_ = std::strtoull(string(value).c_str(), nullptr, 10);
+                } else if (equals_ignore_case(name, "transfer-encoding")) {
+                    chunked_ = contains_ignore_case(value, "chunked");
+                } else if (equals_ignore_case(name, "connection")) {
+                    close_ = contains_ignore_case(value, "close");
+                }
+            }
+            position = line_end;
+        }
+        
+        cursor_ = end + 4;
+        headers_done_ = true;
+        return Result::COMPLETE;
+    }
+    
+    static bool equals_ignore_case(string_view a, string_view b) noexcept {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+            return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+        });
+    }
+    
+    static bool contains_ignore_case(string_view haystack, string_view needle) noexcept {
+        for (size_type i = 0; i + needle.size() <= haystack.size(); ++i) {
+            if (equals_ignore_case(haystack.substr(i, needle.size()), needle)) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+// One epoll loop driving a share of the connections. In open-loop mode each connection
+// follows a fixed send schedule and latency is measured from the scheduled time, so a
+// stalled server is charged for every request it delayed.
+class Worker {
+public:
+    Worker(const Options& options, const Target& target, size_type connections, double rate,
+           std::uint64_t start_ns, std::uint64_t warmup_end_ns, std::uint64_t end_ns)
+        : options_(options), target_(target), start_ns_(start_ns), warmup_end_ns_(warmup_end_ns), end_ns_(end_ns),
+          connections_(connections) {
+        if (rate > 0.0) {
+            interval_ns_ = static_cast<std::uint64_t>(1e9 * static_cast<double>(connections) / rate);
+            for (size_type i = 0; i < connections_.size(); ++i) {
+                connections_[i].next_due = start_ns_ + interval_ns_ * i / connections_.size();
+            }
+        }
+        for (size_type i = 0; i < connections_.size(); ++i) {
+            connections_[i].request_index = i;
+        }
+    }
+    
+    Worker(const Worker&) = delete;
+    Worker& operator=(const Worker&) = delete;
+    
+    ~Worker() {
+        for (auto& connection : connections_) {
+            close_connection(connection);
+        }
+        if (timer_fd_ >= 0) {
+            ::close(timer_fd_);
+        }
+        if (epoll_fd_ >= 0) {
+            ::close(epoll_fd_);
+        }
+    }
+    
+    void run() {
+        epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+        timer_fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (epoll_fd_ < 0 || timer_fd_ < 0) {
+            std::perror("http_bench: epoll");
+            return;
+        }
+        epoll_event timer_event{};
+        timer_event.events = EPOLLIN;
+        timer_event.data.ptr = nullptr;
+        epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, timer_fd_, &timer_event);
+        
+        for (auto& connection : connections_) {
+            open_connection(connection);
+        }
+        
+        array<epoll_event, 256> events{};
+        while (!interrupted.load(std::memory_order_relaxed)) {
+            auto now = monotonic_ns();
+            if (now >= end_ns_) {
+                break;
+            }
+            
+            for (auto& connection : connections_) {
+                expire(connection, now);
+                if (connection.fd < 0) {
+                    open_connection(connection);
+                }
+                fill_pipeline(connection, now);
+            }
+            arm_timer(now);
+            
+            auto ready = epoll_wait(epoll_fd_, events.data(), static_cast<int>(events.size()), 100);
+            for (int i = 0; i < ready; ++i) {
+                auto* connection = static_cast<Connection*>(events[i].data.ptr);
+                if (!connection) {
+                    std::uint64_t expirations = 0;
+                    [[maybe_unused]] auto ignored = ::read(timer_fd_, &expirations, sizeof(expirations));
+                    continue;
+                }
+                handle_event(*connection, events[i].events);
+            }
+        }
+    }
+    
+    const Stats& stats() const noexcept { return stats_; }
+
+private:
+    struct Pending {
+        std::uint64_t intended_ns;
+        std::uint64_t sent_ns;
+    };
+    
+    struct Connection {
+        int fd{-1};
+        bool connecting{false};
+        bool want_write{false};
+        string out;
+        size_type out_offset{0};
+        string in;
+        size_type in_offset{0};
+        deque<Pending> in_flight;
+        ResponseParser parser;
+        std::uint64_t next_due{0};
+        size_type request_index{0};
+    };
+    
+    const Options& options_;
+    const Target& target_;
+    std::uint64_t start_ns_;
+    std::uint64_t warmup_end_ns_;
+    std::uint64_t end_ns_;
+    std::uint64_t interval_ns_{0};
+    vector<Connection> connections_;
+    int epoll_fd_{-1};
+    int timer_fd_{-1};
+    Stats stats_;
+    
+    bool open_loop() const noexcept { return interval_ns_ != 0; }
+    
+    void open_connection(Connection& connection) {
+        auto fd = ::socket(target_.address.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            ++stats_.connect_errors;
+            return;
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        
+        auto result = ::connect(fd, reinterpret_cast<const sockaddr*>(&target_.address), target_.address_length);
+        if (result < 0 && errno != EINPROGRESS) {
+            ::close(fd);
+            ++stats_.connect_errors;
+            return;
+        }
+        
+        connection.fd = fd;
+        connection.connecting = result < 0;
+        connection.want_write = connection.connecting;
+        connection.out.clear();
+        connection.out_offset = 0;
+        connection.in.clear();
+        connection.in_offset = 0;
+        connection.parser.reset();
+        
+        epoll_event event{};
+        event.events = EPOLLIN | (connection.want_write ? EPOLLOUT : 0u);
+        event.data.ptr = &connection;
+        epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event);
+    }
+    
+    void close_connection(Connection& connection) {
+        if (connection.fd >= 0) {
+            epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, connection.fd, nullptr);
+            ::close(connection.fd);
+            connection.fd = -1;
+        }
+        connection.in_flight.clear();
+    }
+    
+    void fail(Connection& connection, std::uint64_t& counter) {
+        counter += std::max<size_type>(connection.in_flight.size(), 1);
+        close_connection(connection);
+    }
+    
+    void expire(Connection& connection, std::uint64_t now) {
+        if (!connection.in_flight.empty() &&
+            now - connection.in_flight.front().sent_ns > options_.timeout_ms * 1'000'000ULL) {
+            fail(connection, stats_.timeouts);
+        }
+    }
+    
+    void fill_pipeline(Connection& connection, std::uint64_t now) {
+        if (connection.fd < 0 || connection.connecting) {
+            return;
+        }
+        
+        auto depth = options_.keep_alive ? options_.pipeline : 1;
+        while (connection.in_flight.size() < depth) {
+            std::uint64_t intended = now;
+            if (open_loop()) {
+                if (connection.next_due > now) {
+                    break;
+                }
+                intended = connection.next_due;
+                connection.next_due += interval_ns_;
+            }
+            
+            const auto& request = target_.requests[connection.request_index++ % target_.requests.size()];
+            connection.out.append(request);
+            connection.in_flight.push_back({intended, now});
+        }
+        flush(connection);
+    }
+    
+    void flush(Connection& connection) {
+        while (connection.out_offset < connection.out.size()) {
+            auto written = ::send(connection.fd, connection.out.data() + connection.out_offset,
+                                  connection.out.size() - connection.out_offset, MSG_NOSIGNAL);
+            if (written < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    break;
+                }
+                fail(connection, stats_.write_errors);
+                return;
+            }
+            connection.out_offset += static_cast<size_type>(written);
+        }
+        
+        if (connection.out_offset == connection.out.size()) {
+            connection.out.clear();
+            connection.out_offset = 0;
+        }
+        set_want_write(connection, connection.out_offset < connection.out.size());
+    }
+    
+    void set_want_write(Connection& connection, bool want_write) {
+        if (connection.want_write == want_write) {
+            return;
+        }
+        connection.want_write = want_write;
+        epoll_event event{};
+        event.events = EPOLLIN | (want_write ? EPOLLOUT : 0u);
+        event.data.ptr = &connection;
+        epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, connection.fd, &event);
+    }
+    
+    void handle_event(Connection& connection, std::uint32_t events) {
+        if (connection.fd < 0) {
+            return;
+        }
+        
+        if (connection.connecting && (events & (EPOLLOUT | EPOLLERR | EPOLLHUP))) {
+            int error = 0;
+            socklen_t length = sizeof(error);
+            getsockopt(connection.fd, SOL_SOCKET, SO_ERROR, &error, &length);
+            if (error != 0) {
+                fail(connection, stats_.connect_errors);
+                return;
+            }
+            connection.connecting = false;
+            set_want_write(connection, false);
+            fill_pipeline(connection, monotonic_ns());
+            return;
+        }
+        
+        if (events & EPOLLOUT) {
+            flush(connection);
+            if (connection.fd < 0) {
+                return;
+            }
+        }
+        if (events & (EPOLLIN | EPOLLERR | EPOLLHUP)) {
+            receive(connection);
+        }
+    }
+    
+    void receive(Connection& connection) {
+        char buffer[64 * 1024];
+        while (true) {
+            auto received = ::recv(connection.fd, buffer, sizeof(buffer), 0);
+            if (received > 0) {
+                stats_.bytes_read += static_cast<std::uint64_t>(received);
+                connection.in.append(buffer, static_cast<size_type>(received));
+                if (static_cast<size_type>(received) < sizeof(buffer)) {
+                    break;
+                }
+                continue;
+            }
+            if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                break;
+            }
+            // Peer closed or errored; anything still expected is lost
+            if (!connection.in_flight.empty()) {
+                fail(connection, stats_.read_errors);
+            } else {
+                close_connection(connection);
+            }
+            return;
+        }
+        
+        auto now = monotonic_ns();
+        while (!connection.in_flight.empty()) {
+            auto result = connection.parser.parse(connection.in, connection.in_offset);
+            if (result == ResponseParser::Result::INCOMPLETE) {
+                break;
+            }
+            if (result == ResponseParser::Result::ERROR) {
+                fail(connection, stats_.parse_errors);
+                return;
+            }
+            complete(connection, now);
+            if (connection.fd < 0) {
+                return;
+            }
+        }
+        
+        if (connection.in_offset > 0 && connection.in_offset * 2 >= connection.in.size()) {
+            connection.in.erase(0, connection.in_offset);
+            connection.in_offset = 0;
+        }
+        fill_pipeline(connection, now);
+    }
+    
+    void complete(Connection& connection, std::uint64_t now) {
+        auto pending = connection.in_flight.front();
+        connection.in_flight.pop_front();
+        
+        if (now >= warmup_end_ns_) {
+            ++stats_.requests;
+            auto status_class = std::min<size_type>(connection.parser.status() / 100, 5);
+            ++stats_.status_classes[status_class];
+            
+            auto latency_us = (now - pending.intended_ns) / 1000;
+            auto service_us = (now - pending.sent_ns) / 1000;
+            if (open_loop()) {
+                stats_.latency.record(latency_us);
+            } else {
+                stats_.latency.record_corrected(latency_us, options_.expected_interval_us);
+            }
+            stats_.service_time.record(service_us);
+        }
+        
+        if (!options_.keep_alive || connection.parser.closes_connection()) {
+            close_connection(connection);
+        }
+    }
+    
+    void arm_timer(std::uint64_t now) {
+        if (!open_loop()) {
+            return;
+        }
+        
+        auto next = end_ns_;
+        for (const auto& connection : connections_) {
+            if (connection.fd >= 0 && !connection.connecting &&
+                connection.in_flight.size() < (options_.keep_alive ? options_.pipeline : 1)) {
+                next = std::min(next, connection.next_due);
+            }
+        }
+        next = std::max(next, now + 1);
+        
+        itimerspec spec{};
+        spec.it_value.tv_sec = static_cast<time_t>(next / 1'000'000'000ULL);
+        spec.it_value.tv_nsec = static_cast<long>(next % 1'000'000'000ULL);
+        timerfd_settime(timer_fd_, TFD_TIMER_ABSTIME, &spec, nullptr);
+    }
+};
+
+bool parse_url(string_view url, Options& options) {
+    constexpr string_view scheme = "http://";
+    if (url.substr(0, scheme.size()) != scheme) {
+        return false;
+    }
+    url.remove_prefix(scheme.size());
+    
+    auto slash = url.find('/');
+    auto authority = url.substr(0, slash);
+    auto path = slash == string_view::npos ? string_view{"/"} : url.substr(slash);
+    
+    auto colon = authority.rfind(':');
+    if (colon != string_view::npos && authority.find(']') == string_view::npos) {
+        options.host = string(authority.substr(0, colon));
+        options.port = string(authority.substr(colon + 1));
+    } else if (!authority.empty() && authority.front() == '[') {
+        auto close = authority.find(']');
+        options.host = string(authority.substr(1, close - 1));
+        if (close + 1 < authority.size() && authority[close + 1] == ':') {
+            options.port = string(authority.substr(close + 2));
+        }
+    } else {
+        options.host = string(authority);
+        options.port = "80";
+    }
+    options.paths.emplace_back(path);
+    return !options.host.empty();
+}
+
+bool resolve_target(const Options& options, Target& target) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* results = nullptr;
+    if (getaddrinfo(options.host.c_str(), options.port.c_str(), &hints, &results) != 0 || !results) {
+        return false;
+    }
+    std::memcpy(&target.address, results->ai_addr, results->ai_addrlen);
+    target.address_length = results->ai_addrlen;
+    freeaddrinfo(results);
+    
+    for (const auto& path : options.paths) {
+        string request;
+        request.reserve(256 + options.body.size());
+        request.append(options.method).append(" ").append(path).append(" HTTP/1.1\r\n");
+        request.append("Host: ").append(options.host).append(":").append(options.port).append("\r\n");
+        for (const auto& header : options.headers) {
+            request.append(header).append("\r\n");
+        }
+        if (!options.body.empty()) {
+            request.append("Content-Length: ").append(std::to_string(options.body.size())).append("\r\n");
+        }
+        if (!options.keep_alive) {
+            request.append("Connection: close\r\n");
+        }
+        request.append("\r\n").append(options.body);
+        target.requests.push_back(std::move(request));
+    }
+    return true;
+}
+
+void print_latency(const char* label, const LatencyHistogram& histogram) {
+    std::printf("  %-22s", label);
+    for (auto percentile : {50.0, 90.0, 99.0, 99.9, 99.99}) {
+        std::printf(" p%-6g%9.3fms", percentile, static_cast<double>(histogram.value_at_percentile(percentile)) / 1000.0);
+    }
+    std::printf("  max %9.3fms\n", static_cast<double>(histogram.max()) / 1000.0);
+}
+
+void print_report(const Options& options, const Stats& stats, double measured_s) {
+    std::printf("  %llu requests in %.2fs, %.2f MB read\n", static_cast<unsigned long long>(stats.requests), measured_s,
+                static_cast<double>(stats.bytes_read) / (1024.0 * 1024.0));
+    std::printf("  Requests/sec: %.2f\n", static_cast<double>(stats.requests) / measured_s);
+    if (options.rate > 0.0) {
+        std::printf("  Target rate:  %.2f\n", options.rate);
+    }
+    std::printf("  Latency mean %.3fms, stddev %.3fms\n", stats.latency.mean() / 1000.0, stats.latency.stddev() / 1000.0);
+    print_latency(options.rate > 0.0 || options.expected_interval_us ? "Latency (corrected):" : "Latency:", stats.latency);
+    if (options.rate > 0.0 || options.expected_interval_us) {
+        print_latency("Service time:", stats.service_time);
+    }
+    std::printf("  Status: 1xx=%llu 2xx=%llu 3xx=%llu 4xx=%llu 5xx=%llu other=%llu\n",
+                static_cast<unsigned long long>(stats.status_classes[1]),
+                static_cast<unsigned long long>(stats.status_classes[2]),
+                static_cast<unsigned long long>(stats.status_classes[3]),
+                static_cast<unsigned long long>(stats.status_classes[4]),
+                static_cast<unsigned long long>(stats.status_classes[5]),
+                static_cast<unsigned long long>(stats.status_classes[0]));
+    std::printf("  Errors: connect=%llu read=%llu write=%llu parse=%llu timeout=%llu\n",
+                static_cast<unsigned long long>(stats.connect_errors), static_cast<unsigned long long>(stats.read_errors),
+                static_cast<unsigned long long>(stats.write_errors), static_cast<unsigned long long>(stats.parse_errors),
+                static_cast<unsigned long long>(stats.timeouts));
+}
+
+void print_usage() {
+    std::fprintf(stderr,
+        "usage: http_bench [options] http://host:port/path [path ...]\n"
+        "  -t, --threads N          event-loop threads (default 2)\n"
+        "  -c, --connections N      open connections (default 64)\n"
+        "  -d, --duration SECONDS   measured duration (default 10)\n"
+        "  -w, --warmup SECONDS     unrecorded warm-up before measuring (default 1)\n"
+        "  -R, --rate N             open loop at N requests/s in total; closed loop when omitted\n"
+        "  -p, --pipeline N         requests in flight per connection (default 1)\n"
+        "  -H, --header 'K: V'      extra request header, repeatable\n"
+        "  -m, --method METHOD      request method (default GET)\n"
+        "  -b, --body TEXT          request body\n"
+        "      --expected-interval US   closed loop: correct for coordinated omission\n"
+        "      --timeout MS         per-request timeout (default 5000)\n"
+        "      --no-keepalive       one request per connection\n"
+        "      --hdr FILE           write the corrected latency distribution in .hgrm format\n"
+        "Extra paths are requested round-robin on the same host.\n");
+}
+
+bool parse_options(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        string_view arg = argv[i];
+        auto value = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+        auto need = [&](const char* text) {
+            if (!text) {
+                std::fprintf(stderr, "http_bench: %s needs a value\n", argv[i]);
+            }
+            return text != nullptr;
+        };
+        
+        const char* text = nullptr;
+        if (arg == "-t" || arg == "--threads") {
+            if (!need(text = value())) return false;
+            options.threads = std::max<size_type>(1, std::strtoull(text, nullptr, 10));
+        } else if (arg == "-c" || arg == "--connections") {
+            if (!need(text = value())) return false;
+            options.connections = std::max<size_type>(1, std::strtoull(text, nullptr, 10));
+        } else if (arg == "-d" || arg == "--duration") {
+            if (!need(text = value())) return false;
+            options.duration_s = std::strtod(text, nullptr);
+        } else if (arg == "-w" || arg == "--warmup") {
+            if (!need(text = value())) return false;
+            options.warmup_s = std::strtod(text, nullptr);
+        } else if (arg == "-R" || arg == "--rate") {
+            if (!need(text = value())) return false;
+            options.rate = std::strtod(text, nullptr);
+        } else if (arg == "-p" || arg == "--pipeline") {
+            if (!need(text = value())) return false;
+            options.pipeline = std::max<size_type>(1, std::strtoull(text, nullptr, 10));
+        } else if (arg == "-H" || arg == "--header") {
+            if (!need(text = value())) return false;
+            options.headers.emplace_back(text);
+        } else if (arg == "-m" || arg == "--method") {
+            if (!need(text = value())) return false;
+            options.method = text;
+        } else if (arg == "-b" || arg == "--body") {
+            if (!need(text = value())) return false;
+            options.body = text;
+        } else if (arg == "--expected-interval") {
+            if (!need(text = value())) return false;
+            options.expected_interval_us = std::strtoull(text, nullptr, 10);
+        } else if (arg == "--timeout") {
+            if (!need(text = value())) return false;
+            options.timeout_ms = std::strtoull(text, nullptr, 10);
+        } else if (arg == "--no-keepalive") {
+            options.keep_alive = false;
+        } else if (arg == "--hdr") {
+            if (!need(text = value())) return false;
+            options.hdr_output = text;
+        } else if (arg == "-h" || arg == "--help") {
+            return false;
+        } else if (arg.substr(0, 7) == "http://") {
+            if (!parse_url(arg, options)) {
+                std::fprintf(stderr, "http_bench: invalid url %s\n", argv[i]);
+                return false;
+            }
+        } else if (!arg.empty() && arg.front() == '/') {
+            options.paths.emplace_back(arg);
+        } else {
+            std::fprintf(stderr, "http_bench: unknown argument %s\n", argv[i]);
+            return false;
+        }
+    }
+    
+    options.threads = std::min(options.threads, options.connections);
+    return !options.paths.empty() && options.duration_s > 0.0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        print_usage();
+        return 2;
+    }
+    
+    Target target;
+    if (!resolve_target(options, target)) {
+        std::fprintf(stderr, "http_bench: cannot resolve %s:%s\n", options.host.c_str(), options.port.c_str());
+        return 1;
+    }
+    
+    std::signal(SIGINT, handle_interrupt);
+    std::signal(SIGPIPE, SIG_IGN);
+    
+    std::printf("Running %.1fs test @ http://%s:%s%s\n", options.duration_s, options.host.c_str(),
+                options.port.c_str(), options.paths.front().c_str());
+    std::printf("  %zu threads, %zu connections, pipeline %zu, %s\n", options.threads, options.connections,
+                options.keep_alive ? options.pipeline : size_type{1},
+                options.rate > 0.0 ? "open loop" : "closed loop");
+                
+    auto start = monotonic_ns();
+    auto warmup_end = start + static_cast<std::uint64_t>(options.warmup_s * 1e9);
+    auto end = warmup_end + static_cast<std::uint64_t>(options.duration_s * 1e9);
+    
+    vector<unique_ptr<Worker>> workers;
+    for (size_type i = 0; i < options.threads; ++i) {
+        auto connections = options.connections / options.threads + (i < options.connections % options.threads ? 1 : 0);
+        auto rate = options.rate * static_cast<double>(connections) / static_cast<double>(options.connections);
+        workers.push_back(std::make_unique<Worker>(options, target, connections, rate, start, warmup_end, end));
+    }
+    
+    vector<std::thread> threads;
+    for (auto& worker : workers) {
+        threads.emplace_back([&worker] { worker->run(); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    auto finished = std::min(monotonic_ns(), end);
+    auto measured_s = finished > warmup_end ? static_cast<double>(finished - warmup_end) / 1e9 : 0.0;
+    
+    Stats total;
+    for (const auto& worker : workers) {
+        total.merge(worker->stats());
+    }
+    print_report(options, total, std::max(measured_s, 1e-9));
+    
+    if (!options.hdr_output.empty()) {
+        auto* file = options.hdr_output == "-" ? stdout : std::fopen(options.hdr_output.c_str(), "w");
+        if (!file) {
+            std::fprintf(stderr, "http_bench: cannot write %s\n", options.hdr_output.c_str());
+            return 1;
+        }
+        total.latency.write_percentile_distribution(file, 1000.0);
+        if (file != stdout) {
+            std::fclose(file);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,336 @@
+#include "utils/binary_log.hpp"
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+using namespace http_framework;
+using namespace http_framework::utils::blog;
+
+namespace {
+
+struct Options {
+    LogLevel min_level{LogLevel::TRACE};
+    bool show_location{false};
+    bool show_thread{true};
+    vector<string> inputs;
+};
+
+struct DecodedSite {
+    LogLevel level{LogLevel::INFO};
+    std::uint32_t line{0};
+    vector<ArgType> arg_types;
+    string format;
+    string file;
+    string function;
+};
+
+class Reader {
+public:
+    explicit Reader(const buffer_t& data) : data_(data) {}
+    
+    bool at_end() const noexcept { return position_ >= data_.size(); }
+    size_type position() const noexcept { return position_; }
+    size_type remaining() const noexcept { return data_.size() - position_; }
+    
+    bool starts_with_magic() const noexcept {
+        return remaining() >= sizeof(FILE_MAGIC) &&
+               std::memcmp(data_.data() + position_, FILE_MAGIC, sizeof(FILE_MAGIC)) == 0;
+    }
+    
+    void skip(size_type count) noexcept { position_ += std::min(count, remaining()); }
+    
+    template<typename T>
+    bool read(T& value) noexcept {
+        if (remaining() < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, data_.data() + position_, sizeof(T));
+        position_ += sizeof(T);
+        return true;
+    }
+    
+    bool read_bytes(string& out, size_type count) {
+        if (remaining() < count) {
+            return false;
+        }
+        out.assign(reinterpret_cast<const char*>(data_.data() + position_), count);
+        position_ += count;
+        return true;
+    }
+    
+    bool read_text(string& out) {
+        std::uint16_t length = 0;
+        return read(length) && read_bytes(out, length);
+    }
+
+private:
+    const buffer_t& data_;
+    size_type position_{0};
+};
+
+string_view level_name(LogLevel level) noexcept {
+    switch (level) {
+        case LogLevel::TRACE: return "TRACE";
+        case LogLevel::DEBUG: return "DEBUG";
+        case LogLevel::INFO: return "INFO";
+        case LogLevel::WARN: return "WARN";
+        case LogLevel::ERROR: return "ERROR";
+        case LogLevel::FATAL: return "FATAL";
+    }
+    return "UNKNOWN";
+}
+
+optional<LogLevel> parse_level(string_view name) {
+    for (auto level : {LogLevel::TRACE, LogLevel::DEBUG, LogLevel::INFO,
+                       LogLevel::WARN, LogLevel::ERROR, LogLevel::FATAL}) {
+        if (name == level_name(level)) {
+            return level;
+        }
+    }
+    return std::nullopt;
+}
+
+void append_timestamp(string& out, std::uint64_t unix_nanos) {
+    auto seconds = static_cast<std::time_t>(unix_nanos / 1'000'000'000ULL);
+    auto millis = (unix_nanos / 1'000'000ULL) % 1000;
+    std::tm local_time{};
+    localtime_r(&seconds, &local_time);
+    
+    char buffer[48];
+    auto length = std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &local_time);
+    length += static_cast<size_type>(std::snprintf(buffer + length, sizeof(buffer) - length, ".%03u",
+                                                   static_cast<unsigned>(millis)));
+    out.append(buffer, length);
+}
+
+bool append_arg(string& out, Reader& reader, ArgType type) {
+    switch (type) {
+        case ArgType::BOOL: {
+            std::uint8_t value = 0;
+            if (!reader.read(value)) return false;
+            out += value ? "true" : "false";
+            return true;
+        }
+        case ArgType::CHAR: {
+            std::uint8_t value = 0;
+            if (!reader.read(value)) return false;
+            out += static_cast<char>(value);
+            return true;
+        }
+        case ArgType::INT64: {
+            std::int64_t value = 0;
+            if (!reader.read(value)) return false;
+            out += std::to_string(value);
+            return true;
+        }
+        case ArgType::UINT64: {
+            std::uint64_t value = 0;
+            if (!reader.read(value)) return false;
+            out += std::to_string(value);
+            return true;
+        }
+        case ArgType::DOUBLE: {
+            double value = 0;
+            if (!reader.read(value)) return false;
+            char buffer[32];
+            auto length = std::snprintf(buffer, sizeof(buffer), "%g", value);
+            out.append(buffer, static_cast<size_type>(length));
+            return true;
+        }
+        case ArgType::STRING: {
+            std::uint32_t length = 0;
+            string text;
+            if (!reader.read(length) || !reader.read_bytes(text, length)) return false;
+            out += text;
+            return true;
+        }
+        case ArgType::POINTER: {
+            std::uint64_t value = 0;
+            if (!reader.read(value)) return false;
+            char buffer[24];
+            auto length = std::snprintf(buffer, sizeof(buffer), "0x%llx", static_cast<unsigned long long>(value));
+            out.append(buffer, static_cast<size_type>(length));
+            return true;
+        }
+    }
+    return false;
+}
+
+// Same substitution rules as Logger::format_string: each "{}" takes the next argument
+bool append_message(string& out, Reader& reader, const DecodedSite& site) {
+    string_view format = site.format;
+    size_type argument = 0;
+    size_type position = 0;
+    while (position < format.size()) {
+        auto brace = format.find("{}", position);
+        if (brace == string_view::npos) {
+            out += format.substr(position);
+            break;
+        }
+        out += format.substr(position, brace - position);
+        if (argument < site.arg_types.size() && !append_arg(out, reader, site.arg_types[argument++])) {
+            return false;
+        }
+        position = brace + 2;
+    }
+    
+    while (argument < site.arg_types.size()) {
+        out += ' ';
+        if (!append_arg(out, reader, site.arg_types[argument++])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool read_site(Reader& reader, hash_map<std::uint32_t, DecodedSite>& sites) {
+    std::uint32_t site_id = 0;
+    std::uint8_t level = 0;
+    std::uint8_t arg_count = 0;
+    DecodedSite site;
+    if (!reader.read(site_id) || !reader.read(level) || !reader.read(site.line) || !reader.read(arg_count)) {
+        return false;
+    }
+    
+    site.level = static_cast<LogLevel>(level);
+    for (std::uint8_t i = 0; i < arg_count; ++i) {
+        std::uint8_t type = 0;
+        if (!reader.read(type)) {
+            return false;
+        }
+        site.arg_types.push_back(static_cast<ArgType>(type));
+    }
+    
+    if (!reader.read_text(site.format) || !reader.read_text(site.file) || !reader.read_text(site.function)) {
+        return false;
+    }
+    sites[site_id] = std::move(site);
+    return true;
+}
+
+bool read_event(Reader& reader, const hash_map<std::uint32_t, DecodedSite>& sites,
+                const Options& options, string& line) {
+    std::uint32_t site_id = 0;
+    std::uint32_t thread = 0;
+    std::uint64_t timestamp = 0;
+    std::uint32_t args_size = 0;
+    if (!reader.read(site_id) || !reader.read(thread) || !reader.read(timestamp) || !reader.read(args_size)) {
+        return false;
+    }
+    if (reader.remaining() < args_size) {
+        return false;
+    }
+    
+    auto args_end = reader.position() + args_size;
+    auto it = sites.find(site_id);
+    if (it == sites.end() || it->second.level < options.min_level) {
+        reader.skip(args_size);
+        return true;
+    }
+    
+    const auto& site = it->second;
+    line.clear();
+    line += '[';
+    append_timestamp(line, timestamp);
+    line += "] [";
+    line += level_name(site.level);
+    line += "] ";
+    if (options.show_thread) {
+        line += "[T" + std::to_string(thread) + "] ";
+    }
+    
+    if (!append_message(line, reader, site) || reader.position() != args_end) {
+        return false;
+    }
+    
+    if (options.show_location) {
+        line += " (" + site.file + ":" + std::to_string(site.line) + " " + site.function + ")";
+    }
+    line += '\n';
+    std::fwrite(line.data(), 1, line.size(), stdout);
+    return true;
+}
+
+int decode(const buffer_t& data, const Options& options, const string& name) {
+    Reader reader(data);
+    hash_map<std::uint32_t, DecodedSite> sites;
+    string line;
+    
+    while (!reader.at_end()) {
+        if (reader.starts_with_magic()) {
+            // Each writer session restarts site numbering
+            sites.clear();
+            reader.skip(sizeof(FILE_MAGIC));
+            continue;
+        }
+        
+        std::uint8_t kind = 0;
+        auto record_start = reader.position();
+        reader.read(kind);
+        
+        bool ok = false;
+        if (kind == static_cast<std::uint8_t>(RecordKind::SITE)) {
+            ok = read_site(reader, sites);
+        } else if (kind == static_cast<std::uint8_t>(RecordKind::EVENT)) {
+            ok = read_event(reader, sites, options, line);
+        }
+        
+        if (!ok) {
+            std::fprintf(stderr, "logdecode: %s: malformed record at offset %zu\n", name.c_str(), record_start);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void print_usage() {
+    std::fprintf(stderr,
+        "usage: logdecode [--level LEVEL] [--location] [--no-thread] [file ...]\n"
+        "Decodes binary logs written by BinaryLogger; reads stdin when no file is given.\n");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        string_view arg = argv[i];
+        if (arg == "--level" && i + 1 < argc) {
+            auto level = parse_level(argv[++i]);
+            if (!level) {
+                print_usage();
+                return 2;
+            }
+            options.min_level = *level;
+        } else if (arg == "--location") {
+            options.show_location = true;
+        } else if (arg == "--no-thread") {
+            options.show_thread = false;
+        } else if (arg == "-h" || arg == "--help") {
+            print_usage();
+            return 0;
+        } else {
+            options.inputs.emplace_back(arg);
+        }
+    }
+    
+    int status = 0;
+    if (options.inputs.empty()) {
+        buffer_t data{std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>()};
+        return decode(data, options, "<stdin>");
+    }
+    
+    for (const auto& input : options.inputs) {
+        std::ifstream file(input, std::ios::binary);
+        if (!file) {
+            std::fprintf(stderr, "logdecode: cannot open %s\n", input.c_str());
+            status = 1;
+            continue;
+        }
+        buffer_t data{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+        status |= decode(data, options, input);
+    }
+    return status;
+}
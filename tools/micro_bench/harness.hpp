@@ -0,0 +1,375 @@
+#pragma once
+
+// Fallback for builds without Google Benchmark. It implements the subset of its API the
+// suite uses and writes the same JSON schema, so results compare across both backends.
+
+#include "core/types.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+namespace benchmark {
+    using http_framework::function;
+    using http_framework::optional;
+    using http_framework::size_type;
+    using http_framework::string;
+    using http_framework::string_view;
+    using http_framework::vector;
+    
+    template<typename T>
+    inline void DoNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static volatile const void* sink;
+        sink = &value;
+#endif
+    }
+    
+    template<typename T>
+    inline void DoNotOptimize(T& value) {
+#if defined(__clang__)
+        asm volatile("" : "+r,m"(value) : : "memory");
+#elif defined(__GNUC__)
+        asm volatile("" : "+m,r"(value) : : "memory");
+#else
+        static volatile const void* sink;
+        sink = &value;
+#endif
+    }
+    
+    inline void ClobberMemory() {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : : "memory");
+#endif
+    }
+    
+    class State {
+    public:
+        State(std::int64_t iterations, vector<std::int64_t> args) : max_iterations_(iterations), args_(std::move(args)) {}
+        
+        struct [[maybe_unused]] Value {};
+        
+        class Iterator {
+        public:
+            Iterator(State* state, std::int64_t remaining) : state_(state), remaining_(remaining) {}
+            
+            Value operator*() const noexcept { return {}; }
+            Iterator& operator++() noexcept {
+                --remaining_;
+                return *this;
+            }
+            bool operator!=(const Iterator&) noexcept {
+                if (remaining_ > 0) {
+                    return true;
+                }
+                state_->finish();
+                return false;
+            }
+            
+        private:
+            State* state_;
+            std::int64_t remaining_;
+        };
+        
+        Iterator begin() {
+            start();
+            return {this, max_iterations_};
+        }
+        Iterator end() { return {this, 0}; }
+        
+        std::int64_t range(size_type index = 0) const { return index < args_.size() ? args_[index] : 0; }
+        std::int64_t iterations() const noexcept { return max_iterations_; }
+        
+        void PauseTiming() { accumulate(); }
+        void ResumeTiming() { start(); }
+        
+        void SetItemsProcessed(std::int64_t items) noexcept { items_processed_ = items; }
+        void SetBytesProcessed(std::int64_t bytes) noexcept { bytes_processed_ = bytes; }
+        void SetLabel(string_view label) { label_ = string(label); }
+        
+        double real_ns() const noexcept { return real_ns_; }
+        double cpu_ns() const noexcept { return cpu_ns_; }
+        std::int64_t items_processed() const noexcept { return items_processed_; }
+        std::int64_t bytes_processed() const noexcept { return bytes_processed_; }
+        const string& label() const noexcept { return label_; }
+        
+    private:
+        std::int64_t max_iterations_;
+        vector<std::int64_t> args_;
+        double real_ns_{0.0};
+        double cpu_ns_{0.0};
+        double real_start_{0.0};
+        double cpu_start_{0.0};
+        std::int64_t items_processed_{0};
+        std::int64_t bytes_processed_{0};
+        string label_;
+        bool finished_{false};
+        
+        static double now_ns(clockid_t clock) noexcept {
+            timespec time{};
+            clock_gettime(clock, &time);
+            return static_cast<double>(time.tv_sec) * 1e9 + static_cast<double>(time.tv_nsec);
+        }
+        
+        void start() noexcept {
+            real_start_ = now_ns(CLOCK_MONOTONIC);
+            cpu_start_ = now_ns(CLOCK_THREAD_CPUTIME_ID);
+        }
+        
+        void accumulate() noexcept {
+            real_ns_ += now_ns(CLOCK_MONOTONIC) - real_start_;
+            cpu_ns_ += now_ns(CLOCK_THREAD_CPUTIME_ID) - cpu_start_;
+        }
+        
+        void finish() noexcept {
+            if (!finished_) {
+                accumulate();
+                finished_ = true;
+            }
+        }
+    };
+    
+    class Benchmark {
+    public:
+        using Function = void (*)(State&);
+        
+        Benchmark(string_view name, Function function) : name_(name), function_(function) {}
+        
+        Benchmark* Arg(std::int64_t arg) {
+            arg_sets_.push_back({arg});
+            return this;
+        }
+        
+        Benchmark* Args(const vector<std::int64_t>& args) {
+            arg_sets_.push_back(args);
+            return this;
+        }
+        
+        const string& name() const noexcept { return name_; }
+        Function function() const noexcept { return function_; }
+        const vector<vector<std::int64_t>>& arg_sets() const noexcept { return arg_sets_; }
+        
+    private:
+        string name_;
+        Function function_;
+        vector<vector<std::int64_t>> arg_sets_;
+    };
+    
+    namespace internal {
+        struct Options {
+            string filter;
+            string format{"console"};
+            string out_path;
+            string out_format{"json"};
+            double min_time_s{0.5};
+        };
+        
+        inline Options& options() {
+            static Options instance;
+            return instance;
+        }
+        
+        inline vector<http_framework::unique_ptr<Benchmark>>& registry() {
+            static vector<http_framework::unique_ptr<Benchmark>> instance;
+            return instance;
+        }
+        
+        struct Result {
+            string name;
+            std::int64_t iterations;
+            double real_ns;
+            double cpu_ns;
+            double items_per_second;
+            double bytes_per_second;
+            string label;
+        };
+        
+        inline string run_name(const Benchmark& benchmark, const vector<std::int64_t>& args) {
+            auto name = benchmark.name();
+            for (auto arg : args) {
+                name += '/';
+                name += std::to_string(arg);
+            }
+            return name;
+        }
+        
+        // Grows the iteration count until one run lasts min_time_s, as Google Benchmark does
+        inline Result run(const Benchmark& benchmark, const vector<std::int64_t>& args) {
+            std::int64_t iterations = 1;
+            while (true) {
+                State state(iterations, args);
+                benchmark.function()(state);
+                
+                auto seconds = state.real_ns() / 1e9;
+                if (seconds >= options().min_time_s || iterations >= 1'000'000'000) {
+                    auto per_second = [&](std::int64_t count) {
+                        return seconds > 0 ? static_cast<double>(count) / seconds : 0.0;
+                    };
+                    return {run_name(benchmark, args), iterations,
+                            state.real_ns() / static_cast<double>(iterations),
+                            state.cpu_ns() / static_cast<double>(iterations),
+                            per_second(state.items_processed()), per_second(state.bytes_processed()), state.label()};
+                }
+                
+                auto scale = seconds > 0 ? options().min_time_s * 1.4 / seconds : 100.0;
+                auto next = static_cast<std::int64_t>(static_cast<double>(iterations) * std::clamp(scale, 2.0, 100.0));
+                iterations = std::max(next, iterations + 1);
+            }
+        }
+        
+        inline void append_escaped(string& out, string_view text) {
+            for (auto c : text) {
+                if (c == '"' || c == '\\') {
+                    out += '\\';
+                }
+                out += c;
+            }
+        }
+        
+        inline string to_json(const vector<Result>& results) {
+            string out = "{\n  \"context\": {\n";
+            char buffer[64];
+            std::time_t now = std::time(nullptr);
+            std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S%z", std::localtime(&now));
+            out += "    \"date\": \"";
+            out += buffer;
+            out += "\",\n    \"library_build_type\": \"builtin\"\n  },\n  \"benchmarks\": [\n";
+            
+            for (size_type i = 0; i < results.size(); ++i) {
+                const auto& result = results[i];
+                out += "    {\n      \"name\": \"";
+                append_escaped(out, result.name);
+                out += "\",\n      \"run_name\": \"";
+                append_escaped(out, result.name);
+                out += "\",\n      \"run_type\": \"iteration\",\n";
+                std::snprintf(buffer, sizeof(buffer), "      \"iterations\": %lld,\n", static_cast<long long>(result.iterations));
+                out += buffer;
+                std::snprintf(buffer, sizeof(buffer), "      \"real_time\": %.4f,\n", result.real_ns);
+                out += buffer;
+                std::snprintf(buffer, sizeof(buffer), "      \"cpu_time\": %.4f,\n", result.cpu_ns);
+                out += buffer;
+                out += "      \"time_unit\": \"ns\"";
+                if (result.items_per_second > 0) {
+                    std::snprintf(buffer, sizeof(buffer), ",\n      \"items_per_second\": %.4f", result.items_per_second);
+                    out += buffer;
+                }
+                if (result.bytes_per_second > 0) {
+                    std::snprintf(buffer, sizeof(buffer), ",\n      \"bytes_per_second\": %.4f", result.bytes_per_second);
+                    out += buffer;
+                }
+                if (!result.label.empty()) {
+                    out += ",\n      \"label\": \"";
+                    append_escaped(out, result.label);
+                    out += '"';
+                }
+                out += i + 1 < results.size() ? "\n    },\n" : "\n    }\n";
+            }
+            out += "  ]\n}\n";
+            return out;
+        }
+        
+        inline void print_console(const Result& result) {
+            std::printf("%-48s %14.1f ns %14.1f ns %12lld", result.name.c_str(), result.real_ns, result.cpu_ns,
+                        static_cast<long long>(result.iterations));
+            if (result.bytes_per_second > 0) {
+                std::printf(" %10.2f MiB/s", result.bytes_per_second / (1024.0 * 1024.0));
+            }
+            if (result.items_per_second > 0) {
+                std::printf(" %12.0f items/s", result.items_per_second);
+            }
+            if (!result.label.empty()) {
+                std::printf(" %s", result.label.c_str());
+            }
+            std::printf("\n");
+        }
+    }
+    
+    inline Benchmark* RegisterBenchmark(const char* name, Benchmark::Function function) {
+        internal::registry().push_back(std::make_unique<Benchmark>(name, function));
+        return internal::registry().back().get();
+    }
+    
+    // Accepts the Google Benchmark flags the suite relies on
+    inline void Initialize(int* argc, char** argv) {
+        auto& options = internal::options();
+        for (int i = 1; i < *argc; ++i) {
+            string_view arg = argv[i];
+            auto value_of = [&](string_view flag) -> optional<string_view> {
+                if (arg.substr(0, flag.size()) == flag && arg.size() > flag.size() && arg[flag.size()] == '=') {
+                    return arg.substr(flag.size() + 1);
+                }
+                return std::nullopt;
+            };
+            
+            if (auto value = value_of("--benchmark_filter")) {
+                options.filter = string(*value);
+            } else if (auto value = value_of("--benchmark_format")) {
+                options.format = string(*value);
+            } else if (auto value = value_of("--benchmark_out")) {
+                options.out_path = string(*value);
+            } else if (auto value = value_of("--benchmark_out_format")) {
+                options.out_format = string(*value);
+            } else if (auto value = value_of("--benchmark_min_time")) {
+                options.min_time_s = std::max(0.001, std::strtod(string(*value).c_str(), nullptr));
+            } else {
+                std::fprintf(stderr, "micro_bench: ignoring unknown flag %s\n", argv[i]);
+            }
+        }
+    }
+    
+    inline size_type RunSpecifiedBenchmarks() {
+        const auto& options = internal::options();
+        bool console = options.format != "json";
+        if (console) {
+            std::printf("%-48s %17s %17s %12s\n", "Benchmark", "Time", "CPU", "Iterations");
+        }
+        
+        vector<internal::Result> results;
+        for (const auto& benchmark : internal::registry()) {
+            auto arg_sets = benchmark->arg_sets();
+            if (arg_sets.empty()) {
+                arg_sets.emplace_back();
+            }
+            for (const auto& args : arg_sets) {
+                // Substring match stands in for Google Benchmark's regex filter
+                if (!options.filter.empty() && internal::run_name(*benchmark, args).find(options.filter) == string::npos) {
+                    continue;
+                }
+                results.push_back(internal::run(*benchmark, args));
+                if (console) {
+                    internal::print_console(results.back());
+                    std::fflush(stdout);
+                }
+            }
+        }
+        
+        auto json = internal::to_json(results);
+        if (!console) {
+            std::fwrite(json.data(), 1, json.size(), stdout);
+        }
+        if (!options.out_path.empty()) {
+            if (auto* file = std::fopen(options.out_path.c_str(), "w")) {
+                std::fwrite(json.data(), 1, json.size(), file);
+                std::fclose(file);
+            }
+        }
+        return results.size();
+    }
+    
+    inline void Shutdown() {}
+}
+
+#define HTTP_BENCH_CONCAT_INNER(a, b) a##b
+#define HTTP_BENCH_CONCAT(a, b) HTTP_BENCH_CONCAT_INNER(a, b)
+#define BENCHMARK(function) \
+    static ::benchmark::Benchmark* HTTP_BENCH_CONCAT(benchmark_registration_, __LINE__) = \
+        ::benchmark::RegisterBenchmark(#function, function)
+#define BENCHMARK_MAIN() \
+    int main(int argc, char** argv) { \
+        ::benchmark::Initialize(&argc, argv); \
+        ::benchmark::RunSpecifiedBenchmarks(); \
+        ::benchmark::Shutdown(); \
+        return 0; \
+    }